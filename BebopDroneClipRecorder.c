@@ -0,0 +1,161 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file BebopDroneClipRecorder.c
+ * @brief Records clips of the video stream around the detections of the vision process
+ * @date 10/18/2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+
+#include <libARSAL/ARSAL.h>
+#include <libARSAL/ARSAL_Print.h>
+#include <libARNetwork/ARNetwork.h>
+#include <libARNetworkAL/ARNetworkAL.h>
+#include <libARDiscovery/ARDiscovery.h>
+
+#include "BebopDroneStartStream.h"
+
+#define TAG "BebopDroneClipRecorder"
+
+int startClipRecorder (BD_MANAGER_t *deviceManager, const char *directory)
+{
+    int failed = 0;
+    eARSAL_ERROR err = ARSAL_OK;
+    ARSAL_ClipRecorder_Config_t config;
+
+    ARSAL_PRINT(ARSAL_PRINT_INFO, TAG, "- Start clip recorder in %s", directory);
+
+    memset(&config, 0, sizeof(config));
+    config.directory = directory;
+    config.prefix = BD_CLIP_PREFIX;
+    config.ringSize = BD_CLIP_RING_SIZE;
+    config.preTriggerMs = BD_CLIP_PRE_TRIGGER_MS;
+    config.postTriggerMs = BD_CLIP_POST_TRIGGER_MS;
+    config.maxClipMs = BD_CLIP_MAX_MS;
+    config.writer = deviceManager->writer;
+
+    deviceManager->clipTriggerFd = -1;
+    deviceManager->clipRecorder = ARSAL_ClipRecorder_New(&config, &err);
+    if (err != ARSAL_OK)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Error while creating clip recorder: %s", ARSAL_Error_ToString(err));
+        failed = 1;
+    }
+
+    if (!failed)
+    {
+        deviceManager->clipTriggerFd = ARSAL_ClipRecorder_TriggerOpen(BD_CLIP_TRIGGER_SOCKET);
+        if (deviceManager->clipTriggerFd < 0)
+        {
+            failed = 1;
+        }
+    }
+
+    if (!failed)
+    {
+        if (ARSAL_Thread_Create(&(deviceManager->clipTriggerThread), clipTriggerRun, deviceManager) != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Creation of clip trigger thread failed.");
+            deviceManager->clipTriggerThread = NULL;
+            failed = 1;
+        }
+    }
+
+    return failed;
+}
+
+void stopClipRecorder (BD_MANAGER_t *deviceManager)
+{
+    ARSAL_ClipRecorder_Stats_t stats;
+
+    ARSAL_PRINT(ARSAL_PRINT_INFO, TAG, "- Stop clip recorder");
+
+    /* The trigger thread exits once deviceManager->run is cleared */
+    if (deviceManager->clipTriggerThread != NULL)
+    {
+        ARSAL_Thread_Join(deviceManager->clipTriggerThread, NULL);
+        ARSAL_Thread_Destroy(&(deviceManager->clipTriggerThread));
+        deviceManager->clipTriggerThread = NULL;
+    }
+
+    if (deviceManager->clipTriggerFd >= 0)
+    {
+        close(deviceManager->clipTriggerFd);
+        unlink(BD_CLIP_TRIGGER_SOCKET);
+        deviceManager->clipTriggerFd = -1;
+    }
+
+    if (deviceManager->clipRecorder != NULL)
+    {
+        ARSAL_ClipRecorder_GetStats(deviceManager->clipRecorder, &stats);
+        ARSAL_PRINT(ARSAL_PRINT_INFO, TAG, "- %u clips recorded (%u truncated), %llu bytes written",
+                    stats.clips, stats.truncatedClips, (unsigned long long)stats.bytesWritten);
+        ARSAL_ClipRecorder_Delete(&deviceManager->clipRecorder);
+    }
+}
+
+void *clipTriggerRun (void *data)
+{
+    BD_MANAGER_t *deviceManager = (BD_MANAGER_t *)data;
+    struct pollfd pfd;
+
+    pfd.fd = deviceManager->clipTriggerFd;
+    pfd.events = POLLIN;
+
+    while (deviceManager->run)
+    {
+        if ((poll(&pfd, 1, 100) > 0) && (pfd.revents & POLLIN))
+        {
+            ARSAL_ClipRecorder_TriggerReceive(deviceManager->clipRecorder, deviceManager->clipTriggerFd);
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Called with every completed frame, in place of dumping the whole stream to
+ * video_out: the frames are only kept in memory until a trigger asks for them.
+ */
+void clipRecorderPush (BD_MANAGER_t *deviceManager, uint8_t *frame, uint32_t frameSize, int isIFrame)
+{
+    if (deviceManager->clipRecorder == NULL)
+    {
+        return;
+    }
+
+    ARSAL_ClipRecorder_Push(deviceManager->clipRecorder, frame, frameSize, ARSAL_Time_GetMonotonicNs(),
+                            isIFrame ? ARSAL_CLIP_RECORDER_FLAG_KEY : 0);
+}
@@ -0,0 +1,275 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file BebopDroneFrameRing.c
+ * @brief Publishes the received video frames to the vision process through a shared memory frame ring
+ * @date 10/18/2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <libavcodec/avcodec.h>
+
+#include <libARSAL/ARSAL.h>
+#include <libARSAL/ARSAL_Print.h>
+#include <libARNetwork/ARNetwork.h>
+#include <libARNetworkAL/ARNetworkAL.h>
+#include <libARDiscovery/ARDiscovery.h>
+
+#include "BebopDroneStartStream.h"
+
+#define TAG "BebopDroneFrameRing"
+
+static int startDecoder (BD_MANAGER_t *deviceManager);
+static void stopDecoder (BD_MANAGER_t *deviceManager);
+static void publishDecoded (BD_MANAGER_t *deviceManager, const AVFrame *picture, ARSAL_Time_Ns_t timestamp, int isIFrame);
+
+int startFrameRing (BD_MANAGER_t *deviceManager, const char *name)
+{
+    int failed = 0;
+    eARSAL_ERROR err = ARSAL_OK;
+
+    ARSAL_PRINT(ARSAL_PRINT_INFO, TAG, "- Start frame ring %s", name);
+
+    deviceManager->decoderContext = NULL;
+    deviceManager->decodedFrame = NULL;
+    deviceManager->decoderPacket = NULL;
+
+    deviceManager->frameRing = ARSAL_FrameRing_New(name, BD_FRAME_RING_SLOTS, BD_FRAME_RING_SLOT_SIZE, &err);
+    if (err != ARSAL_OK)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Error while creating frame ring: %s", ARSAL_Error_ToString(err));
+        failed = 1;
+    }
+    memset(&deviceManager->frameRingFrame, 0, sizeof(deviceManager->frameRingFrame));
+
+    /* The vision process reads pictures, the stream is decoded before publishing */
+    if (!failed)
+    {
+        failed = startDecoder(deviceManager);
+    }
+
+    if (failed && (deviceManager->frameRing != NULL))
+    {
+        ARSAL_FrameRing_Delete(&deviceManager->frameRing);
+    }
+
+    return failed;
+}
+
+void stopFrameRing (BD_MANAGER_t *deviceManager)
+{
+    ARSAL_FrameRing_Stats_t stats;
+
+    if (deviceManager->frameRing == NULL)
+    {
+        return;
+    }
+
+    stopDecoder(deviceManager);
+
+    ARSAL_FrameRing_GetStats(deviceManager->frameRing, &stats);
+    ARSAL_PRINT(ARSAL_PRINT_INFO, TAG, "- Stop frame ring: %llu frames published, %llu dropped",
+                (unsigned long long)stats.published, (unsigned long long)stats.dropped);
+
+    if (deviceManager->frameRingFrame.data != NULL)
+    {
+        ARSAL_FrameRing_Abort(deviceManager->frameRing, &deviceManager->frameRingFrame);
+        deviceManager->frameRingFrame.data = NULL;
+    }
+    ARSAL_FrameRing_Delete(&deviceManager->frameRing);
+}
+
+/*
+ * Buffer for the stream reader to assemble the next access unit into. The
+ * ring holds decoded pictures, so the encoded frame stays in the private
+ * video buffer.
+ */
+uint8_t *frameRingNextBuffer (BD_MANAGER_t *deviceManager, uint32_t *capacity)
+{
+    *capacity = deviceManager->videoFrameSize;
+    return deviceManager->videoFrame;
+}
+
+/*
+ * Decodes a completed access unit and publishes the resulting picture as
+ * NV12. The decoder has no reordering on the Bebop stream (no B frames),
+ * so a picture comes out for every access unit once the first I frame is in.
+ */
+void frameRingPublish (BD_MANAGER_t *deviceManager, uint8_t *frame, uint32_t frameSize, int isIFrame)
+{
+    AVPacket *packet = deviceManager->decoderPacket;
+    ARSAL_Time_Ns_t timestamp = ARSAL_Time_GetMonotonicNs();
+
+    if ((deviceManager->frameRing == NULL) || (deviceManager->decoderContext == NULL))
+    {
+        return;
+    }
+
+    packet->data = frame;
+    packet->size = (int)frameSize;
+    packet->flags = isIFrame ? AV_PKT_FLAG_KEY : 0;
+
+    if (avcodec_send_packet(deviceManager->decoderContext, packet) != 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_WARNING, TAG, "Decoder rejected a frame of %u bytes", frameSize);
+        return;
+    }
+
+    while (avcodec_receive_frame(deviceManager->decoderContext, deviceManager->decodedFrame) == 0)
+    {
+        publishDecoded(deviceManager, deviceManager->decodedFrame, timestamp, isIFrame);
+    }
+}
+
+static int startDecoder (BD_MANAGER_t *deviceManager)
+{
+    AVCodec *codec = avcodec_find_decoder(AV_CODEC_ID_H264);
+
+    if (codec == NULL)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "No H.264 decoder available");
+        return 1;
+    }
+
+    deviceManager->decoderContext = avcodec_alloc_context3(codec);
+    deviceManager->decodedFrame = av_frame_alloc();
+    deviceManager->decoderPacket = av_packet_alloc();
+
+    if ((deviceManager->decoderContext == NULL) || (deviceManager->decodedFrame == NULL) || (deviceManager->decoderPacket == NULL))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Decoder allocation failed");
+        stopDecoder(deviceManager);
+        return 1;
+    }
+
+    /* Latency first: no frame threading, which would hold frames back */
+    deviceManager->decoderContext->thread_count = 1;
+    deviceManager->decoderContext->flags |= AV_CODEC_FLAG_LOW_DELAY;
+
+    if (avcodec_open2(deviceManager->decoderContext, codec, NULL) != 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Unable to open the H.264 decoder");
+        stopDecoder(deviceManager);
+        return 1;
+    }
+
+    return 0;
+}
+
+static void stopDecoder (BD_MANAGER_t *deviceManager)
+{
+    if (deviceManager->decoderContext != NULL)
+    {
+        avcodec_free_context(&deviceManager->decoderContext);
+    }
+    if (deviceManager->decodedFrame != NULL)
+    {
+        av_frame_free(&deviceManager->decodedFrame);
+    }
+    if (deviceManager->decoderPacket != NULL)
+    {
+        av_packet_free(&deviceManager->decoderPacket);
+    }
+}
+
+static void publishDecoded (BD_MANAGER_t *deviceManager, const AVFrame *picture, ARSAL_Time_Ns_t timestamp, int isIFrame)
+{
+    ARSAL_FrameRing_Frame_t *ringFrame = &deviceManager->frameRingFrame;
+    uint32_t width = (uint32_t)picture->width;
+    uint32_t height = (uint32_t)picture->height;
+    uint32_t size = width * height + 2 * (width / 2) * (height / 2);
+    uint8_t *y, *uv, *dst;
+    const uint8_t *u, *v;
+    uint32_t row, col;
+
+    if ((picture->format != AV_PIX_FMT_YUV420P) && (picture->format != AV_PIX_FMT_YUVJ420P) && (picture->format != AV_PIX_FMT_NV12))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_WARNING, TAG, "Unsupported decoded format %d", picture->format);
+        return;
+    }
+
+    /* No free slot: the readers are behind, the picture is dropped */
+    if (ARSAL_FrameRing_Acquire(deviceManager->frameRing, ringFrame) != ARSAL_OK)
+    {
+        return;
+    }
+
+    if (size > ringFrame->capacity)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_WARNING, TAG, "Picture of %ux%u does not fit in a ring slot", width, height);
+        ARSAL_FrameRing_Abort(deviceManager->frameRing, ringFrame);
+        ringFrame->data = NULL;
+        return;
+    }
+
+    /* Packed NV12: Y plane, then interleaved UV, stride = width */
+    y = ringFrame->data;
+    uv = y + width * height;
+
+    for (row = 0; row < height; row++)
+    {
+        memcpy(y + row * width, picture->data[0] + row * picture->linesize[0], width);
+    }
+
+    for (row = 0; row < height / 2; row++)
+    {
+        dst = uv + row * width;
+
+        if (picture->format == AV_PIX_FMT_NV12)
+        {
+            memcpy(dst, picture->data[1] + row * picture->linesize[1], width);
+            continue;
+        }
+
+        u = picture->data[1] + row * picture->linesize[1];
+        v = picture->data[2] + row * picture->linesize[2];
+
+        for (col = 0; col < width / 2; col++)
+        {
+            dst[2 * col] = u[col];
+            dst[2 * col + 1] = v[col];
+        }
+    }
+
+    ringFrame->size = size;
+    ringFrame->width = width;
+    ringFrame->height = height;
+    ringFrame->format = ARSAL_FRAMERING_FORMAT_NV12;
+    ringFrame->flags = isIFrame ? ARSAL_FRAMERING_FLAG_KEY : 0;
+    ringFrame->timestamp = timestamp;
+    if (ARSAL_FrameRing_Publish(deviceManager->frameRing, ringFrame) != ARSAL_OK)
+    {
+        ARSAL_FrameRing_Abort(deviceManager->frameRing, ringFrame);
+    }
+    ringFrame->data = NULL;
+}
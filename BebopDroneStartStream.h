@@ -31,6 +31,25 @@
 #ifndef _SDK_EXAMPLE_BD_H_
 #define _SDK_EXAMPLE_BD_H_
 
+#define BD_THREAD_ROLES_FILE "thread_roles.conf"    // cpus, policy and priority of each thread role, see --thread_roles=
+
+#define BD_FRAME_RING_NAME "/bebop_frames"          // shared memory name of the frame ring read by the vision process
+#define BD_FRAME_RING_SLOTS 8
+#define BD_FRAME_RING_SLOT_SIZE (1536 * 1024)       // one decoded NV12 picture, up to 1280x720
+
+#define BD_WRITER_CHUNK_SIZE (1024 * 1024)         // disk writes are issued in chunks of this size
+#define BD_WRITER_NB_CHUNKS 32                      // memory budget of all the files written in the background
+
+#define BD_CLIP_DIRECTORY "."                       // directory of the clips recorded around detections
+#define BD_CLIP_PREFIX "bebop_clip"
+#define BD_CLIP_TRIGGER_SOCKET "/tmp/bebop_clip.sock" // datagram socket the vision process sends its triggers to
+#define BD_CLIP_RING_SIZE (16 * 1024 * 1024)
+#define BD_CLIP_PRE_TRIGGER_MS 5000
+#define BD_CLIP_POST_TRIGGER_MS 5000
+#define BD_CLIP_MAX_MS 60000
+
+#define BD_STREAM_CONTROL_SOCKET "/tmp/bebop_stream.sock" // datagram socket the vision process requests stream settings on
+
 typedef struct READER_THREAD_DATA_t READER_THREAD_DATA_t;
 
 typedef struct
@@ -47,6 +66,21 @@ typedef struct
     uint32_t videoFrameSize;
     
     FILE *video_out;
+    ARSAL_Writer_t *writer;
+    ARSAL_Writer_Stream_t *videoStream;
+    
+    ARSAL_FrameRing_t *frameRing;
+    ARSAL_FrameRing_Frame_t frameRingFrame;
+    struct AVCodecContext *decoderContext;
+    struct AVFrame *decodedFrame;
+    struct AVPacket *decoderPacket;
+    
+    ARSAL_ClipRecorder_t *clipRecorder;
+    int clipTriggerFd;
+    ARSAL_Thread_t clipTriggerThread;
+    
+    int streamControlFd;
+    ARSAL_Thread_t streamControlThread;
     
     ARSAL_Thread_t *readerThreads;
     READER_THREAD_DATA_t *readerThreadsData;
@@ -62,6 +96,8 @@ struct READER_THREAD_DATA_t
 void sighandler(int signum);
 void *readerRun (void* data);
 
+int loadThreadRoles (int argc, char *argv[]);
+
 int ardiscoveryConnect (BD_MANAGER_t *deviceManager);
 eARDISCOVERY_ERROR ARDISCOVERY_Connection_SendJsonCallback (uint8_t *dataTx, uint32_t *dataTxSize, void *customData);
 eARDISCOVERY_ERROR ARDISCOVERY_Connection_ReceiveJsonCallback (uint8_t *dataRx, uint32_t dataRxSize, char *ip, void *customData);
@@ -73,6 +109,25 @@ void stopNetwork (BD_MANAGER_t *deviceManager);
 int startVideo (BD_MANAGER_t *deviceManager);
 void stopVideo (BD_MANAGER_t *deviceManager);
 
+int startFrameRing (BD_MANAGER_t *deviceManager, const char *name);
+void stopFrameRing (BD_MANAGER_t *deviceManager);
+uint8_t *frameRingNextBuffer (BD_MANAGER_t *deviceManager, uint32_t *capacity);
+void frameRingPublish (BD_MANAGER_t *deviceManager, uint8_t *frame, uint32_t frameSize, int isIFrame);
+
+int startWriter (BD_MANAGER_t *deviceManager, const char *videoPath);
+void stopWriter (BD_MANAGER_t *deviceManager);
+void videoOutWrite (BD_MANAGER_t *deviceManager, uint8_t *frame, uint32_t frameSize);
+
+int startClipRecorder (BD_MANAGER_t *deviceManager, const char *directory);
+void stopClipRecorder (BD_MANAGER_t *deviceManager);
+void *clipTriggerRun (void *data);
+void clipRecorderPush (BD_MANAGER_t *deviceManager, uint8_t *frame, uint32_t frameSize, int isIFrame);
+
+int startStreamControl (BD_MANAGER_t *deviceManager);
+void stopStreamControl (BD_MANAGER_t *deviceManager);
+void *streamControlRun (void *data);
+int sendStreamSettings (BD_MANAGER_t *deviceManager, int mode, int framerate);
+
 int sendBeginStream(BD_MANAGER_t *deviceManager);
 
 eARNETWORK_MANAGER_CALLBACK_RETURN arnetworkCmdCallback(int buffer_id, uint8_t *data, void *custom, eARNETWORK_MANAGER_CALLBACK_STATUS cause);
@@ -0,0 +1,231 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file BebopDroneStreamControl.c
+ * @brief Applies the stream settings requested by the vision process to the drone
+ * @date 10/18/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <libARSAL/ARSAL.h>
+#include <libARSAL/ARSAL_Print.h>
+#include <libARCommands/ARCommands.h>
+#include <libARNetwork/ARNetwork.h>
+#include <libARNetworkAL/ARNetworkAL.h>
+#include <libARDiscovery/ARDiscovery.h>
+
+#include "BebopDroneStartStream.h"
+
+#define TAG "BebopDroneStreamControl"
+
+#ifndef BD_NET_CD_ACK_ID
+#define BD_NET_CD_ACK_ID 11                         // acknowledged command buffer of the network configuration
+#endif
+
+/*
+ * Start after startNetwork(), the requests are sent on its command buffer,
+ * and stop before stopNetwork(). The receiver main() is not in this tree:
+ * until it calls these, the vision process requests are not applied.
+ */
+int startStreamControl (BD_MANAGER_t *deviceManager)
+{
+    struct sockaddr_un addr;
+    int failed = 0;
+
+    ARSAL_PRINT(ARSAL_PRINT_INFO, TAG, "- Start stream control on %s", BD_STREAM_CONTROL_SOCKET);
+
+    deviceManager->streamControlThread = NULL;
+    deviceManager->streamControlFd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (deviceManager->streamControlFd < 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Unable to create stream control socket: %s", strerror(errno));
+        failed = 1;
+    }
+
+    if (!failed)
+    {
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, BD_STREAM_CONTROL_SOCKET, sizeof(addr.sun_path) - 1);
+        unlink(BD_STREAM_CONTROL_SOCKET);
+        if (bind(deviceManager->streamControlFd, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Unable to bind stream control socket: %s", strerror(errno));
+            close(deviceManager->streamControlFd);
+            deviceManager->streamControlFd = -1;
+            failed = 1;
+        }
+    }
+
+    if (!failed)
+    {
+        if (ARSAL_Thread_Create(&(deviceManager->streamControlThread), streamControlRun, deviceManager) != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Creation of stream control thread failed.");
+            deviceManager->streamControlThread = NULL;
+            failed = 1;
+        }
+    }
+
+    return failed;
+}
+
+void stopStreamControl (BD_MANAGER_t *deviceManager)
+{
+    ARSAL_PRINT(ARSAL_PRINT_INFO, TAG, "- Stop stream control");
+
+    /* The control thread exits once deviceManager->run is cleared */
+    if (deviceManager->streamControlThread != NULL)
+    {
+        ARSAL_Thread_Join(deviceManager->streamControlThread, NULL);
+        ARSAL_Thread_Destroy(&(deviceManager->streamControlThread));
+        deviceManager->streamControlThread = NULL;
+    }
+
+    if (deviceManager->streamControlFd >= 0)
+    {
+        close(deviceManager->streamControlFd);
+        unlink(BD_STREAM_CONTROL_SOCKET);
+        deviceManager->streamControlFd = -1;
+    }
+}
+
+/*
+ * Requests are "stream <mode> <framerate>" datagrams, with mode the
+ * MediaStreaming.videoStreamMode value and framerate 24, 25 or 30.
+ * Only the last pending request matters, older ones are dropped.
+ */
+void *streamControlRun (void *data)
+{
+    BD_MANAGER_t *deviceManager = (BD_MANAGER_t *)data;
+    struct pollfd pfd;
+    char msg[64];
+    ssize_t size;
+    int mode = 0, framerate = 0, pending;
+
+    pfd.fd = deviceManager->streamControlFd;
+    pfd.events = POLLIN;
+
+    while (deviceManager->run)
+    {
+        if ((poll(&pfd, 1, 100) <= 0) || !(pfd.revents & POLLIN))
+        {
+            continue;
+        }
+
+        pending = 0;
+        while ((size = recv(deviceManager->streamControlFd, msg, sizeof(msg) - 1, 0)) > 0)
+        {
+            msg[size] = '\0';
+            if (sscanf(msg, "stream %d %d", &mode, &framerate) == 2)
+            {
+                pending = 1;
+            }
+            else
+            {
+                ARSAL_PRINT(ARSAL_PRINT_WARNING, TAG, "Unknown stream control request '%s'", msg);
+            }
+        }
+
+        if (pending)
+        {
+            sendStreamSettings(deviceManager, mode, framerate);
+        }
+    }
+
+    return NULL;
+}
+
+int sendStreamSettings (BD_MANAGER_t *deviceManager, int mode, int framerate)
+{
+    int sentStatus = 1;
+    uint8_t cmdBuffer[128];
+    int32_t cmdSize = 0;
+    eARCOMMANDS_GENERATOR_ERROR cmdError;
+    eARNETWORK_ERROR netError = ARNETWORK_ERROR;
+    eARCOMMANDS_ARDRONE3_PICTURESETTINGS_VIDEOFRAMERATE_FRAMERATE rate;
+
+    if ((mode < ARCOMMANDS_ARDRONE3_MEDIASTREAMING_VIDEOSTREAMMODE_MODE_LOW_LATENCY) ||
+        (mode >= ARCOMMANDS_ARDRONE3_MEDIASTREAMING_VIDEOSTREAMMODE_MODE_MAX))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_WARNING, TAG, "Invalid stream mode %d", mode);
+        return 0;
+    }
+
+    switch (framerate)
+    {
+    case 24: rate = ARCOMMANDS_ARDRONE3_PICTURESETTINGS_VIDEOFRAMERATE_FRAMERATE_24_FPS; break;
+    case 25: rate = ARCOMMANDS_ARDRONE3_PICTURESETTINGS_VIDEOFRAMERATE_FRAMERATE_25_FPS; break;
+    case 30: rate = ARCOMMANDS_ARDRONE3_PICTURESETTINGS_VIDEOFRAMERATE_FRAMERATE_30_FPS; break;
+    default:
+        ARSAL_PRINT(ARSAL_PRINT_WARNING, TAG, "Invalid framerate %d", framerate);
+        return 0;
+    }
+
+    ARSAL_PRINT(ARSAL_PRINT_INFO, TAG, "- Send stream mode %d, %d fps", mode, framerate);
+
+    cmdError = ARCOMMANDS_Generator_GenerateARDrone3MediaStreamingVideoStreamMode(cmdBuffer, sizeof(cmdBuffer), &cmdSize,
+                                                                                 (eARCOMMANDS_ARDRONE3_MEDIASTREAMING_VIDEOSTREAMMODE_MODE)mode);
+    if (cmdError == ARCOMMANDS_GENERATOR_OK)
+    {
+        netError = ARNETWORK_Manager_SendData(deviceManager->netManager, BD_NET_CD_ACK_ID, cmdBuffer, cmdSize, NULL, &(arnetworkCmdCallback), 1);
+    }
+
+    if ((cmdError != ARCOMMANDS_GENERATOR_OK) || (netError != ARNETWORK_OK))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_WARNING, TAG, "Failed to send stream mode command. cmdError:%d netError:%s", cmdError, ARNETWORK_Error_ToString(netError));
+        sentStatus = 0;
+    }
+
+    /* The frame size of the stream stays the same: the vision process keeps the geometry of its first frame */
+    netError = ARNETWORK_ERROR;
+    cmdError = ARCOMMANDS_Generator_GenerateARDrone3PictureSettingsVideoFramerate(cmdBuffer, sizeof(cmdBuffer), &cmdSize, rate);
+    if (cmdError == ARCOMMANDS_GENERATOR_OK)
+    {
+        netError = ARNETWORK_Manager_SendData(deviceManager->netManager, BD_NET_CD_ACK_ID, cmdBuffer, cmdSize, NULL, &(arnetworkCmdCallback), 1);
+    }
+
+    if ((cmdError != ARCOMMANDS_GENERATOR_OK) || (netError != ARNETWORK_OK))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_WARNING, TAG, "Failed to send framerate command. cmdError:%d netError:%s", cmdError, ARNETWORK_Error_ToString(netError));
+        sentStatus = 0;
+    }
+
+    return sentStatus;
+}
@@ -0,0 +1,88 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file BebopDroneThreadRoles.c
+ * @brief Loads the thread roles of the receiver from its command line
+ * @date 10/18/2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <libARSAL/ARSAL.h>
+#include <libARSAL/ARSAL_Print.h>
+#include <libARNetwork/ARNetwork.h>
+#include <libARNetworkAL/ARNetworkAL.h>
+#include <libARDiscovery/ARDiscovery.h>
+
+#include "BebopDroneStartStream.h"
+
+#define TAG "BebopDroneThreadRoles"
+
+#define THREAD_ROLES_OPTION "--thread_roles="
+
+/*
+ * Call first in main(), before any thread is created: the network, video,
+ * reader, writer and recorder threads take their attributes from the roles.
+ * --thread_roles=<file> overrides BD_THREAD_ROLES_FILE; a missing default
+ * file leaves every thread with the default attributes.
+ */
+int loadThreadRoles (int argc, char *argv[])
+{
+    const char *path = BD_THREAD_ROLES_FILE;
+    int explicitPath = 0;
+    int nbRoles;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], THREAD_ROLES_OPTION, strlen(THREAD_ROLES_OPTION)) == 0)
+        {
+            path = argv[i] + strlen(THREAD_ROLES_OPTION);
+            explicitPath = 1;
+        }
+    }
+
+    nbRoles = ARSAL_Thread_LoadRoles(path);
+    if (nbRoles >= 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_INFO, TAG, "%d thread roles loaded from %s", nbRoles, path);
+        return 0;
+    }
+    if (explicitPath || (errno != ENOENT))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Unable to load the thread roles from %s: %s", path, strerror(errno));
+        return -1;
+    }
+    ARSAL_PRINT(ARSAL_PRINT_WARNING, TAG, "No %s, threads use the default attributes", path);
+    return 0;
+}
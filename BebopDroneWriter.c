@@ -0,0 +1,128 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file BebopDroneWriter.c
+ * @brief Background disk writer shared by the video output and the clip recorder
+ * @date 10/18/2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <libARSAL/ARSAL.h>
+#include <libARSAL/ARSAL_Print.h>
+#include <libARNetwork/ARNetwork.h>
+#include <libARNetworkAL/ARNetworkAL.h>
+#include <libARDiscovery/ARDiscovery.h>
+
+#include "BebopDroneStartStream.h"
+
+#define TAG "BebopDroneWriter"
+
+/*
+ * Start the writer before the clip recorder, which routes its clips through
+ * it. videoPath may be NULL to not record the whole stream.
+ */
+int startWriter (BD_MANAGER_t *deviceManager, const char *videoPath)
+{
+    int failed = 0;
+    eARSAL_ERROR err = ARSAL_OK;
+    ARSAL_Writer_Config_t config;
+    ARSAL_Writer_Stream_Config_t streamConfig;
+
+    ARSAL_PRINT(ARSAL_PRINT_INFO, TAG, "- Start writer");
+
+    memset(&config, 0, sizeof(config));
+    config.chunkSize = BD_WRITER_CHUNK_SIZE;
+    config.nbChunks = BD_WRITER_NB_CHUNKS;
+    ARSAL_Thread_GetRoleAttr("disk_writer", &config.attr);
+
+    deviceManager->videoStream = NULL;
+    deviceManager->writer = ARSAL_Writer_New(&config, &err);
+    if (err != ARSAL_OK)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Error while creating writer: %s", ARSAL_Error_ToString(err));
+        failed = 1;
+    }
+
+    if ((!failed) && (videoPath != NULL))
+    {
+        /* The reader thread must never wait for the SD card: drop frames instead */
+        memset(&streamConfig, 0, sizeof(streamConfig));
+        streamConfig.backpressure = ARSAL_WRITER_BACKPRESSURE_DROP;
+        deviceManager->videoStream = ARSAL_Writer_Open(deviceManager->writer, videoPath, &streamConfig, &err);
+        if (err != ARSAL_OK)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Error while opening %s: %s", videoPath, ARSAL_Error_ToString(err));
+            failed = 1;
+        }
+    }
+
+    return failed;
+}
+
+void stopWriter (BD_MANAGER_t *deviceManager)
+{
+    ARSAL_Writer_Stats_t stats;
+
+    if (deviceManager->writer == NULL)
+    {
+        return;
+    }
+
+    if (deviceManager->videoStream != NULL)
+    {
+        ARSAL_Writer_Close(&deviceManager->videoStream);
+    }
+
+    ARSAL_Writer_GetStats(deviceManager->writer, &stats);
+    ARSAL_PRINT(ARSAL_PRINT_INFO, TAG, "- Stop writer: %llu bytes written, %llu dropped, max queue %u chunks, max write %llu us",
+                (unsigned long long)stats.bytesWritten, (unsigned long long)stats.bytesDropped, stats.maxQueueDepth,
+                (unsigned long long)(stats.maxWriteLatencyNs / 1000));
+
+    ARSAL_Writer_Delete(&deviceManager->writer);
+}
+
+/*
+ * Called with every completed frame, in place of fwrite() to video_out on the
+ * reader thread.
+ */
+void videoOutWrite (BD_MANAGER_t *deviceManager, uint8_t *frame, uint32_t frameSize)
+{
+    if (deviceManager->videoStream != NULL)
+    {
+        ARSAL_Writer_Write(deviceManager->videoStream, frame, frameSize);
+    }
+    else if (deviceManager->video_out != NULL)
+    {
+        fwrite(frame, frameSize, 1, deviceManager->video_out);
+    }
+}
@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "actionDispatcher.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+#define LOG_ACTION "[action] "
+
+#define ACTUATOR_POLL_MS 100		// the idle actuator thread checks for shutdown at this rate
+
+
+// constructor
+actionDispatcher::actionDispatcher() : mHead(0), mTail(0), mRun(false), mExecuted(0), mExpired(0), mReplaced(0)
+{
+	mThread     = NULL;
+	mDispatched = 0;
+	mDropped    = 0;
+
+	ARSAL_FutexSem_Init(&mSem, 0, 0);
+}
+
+
+// destructor
+actionDispatcher::~actionDispatcher()
+{
+	if( mThread != NULL )
+	{
+		mRun = false;
+		ARSAL_FutexSem_Post(&mSem);
+
+		ARSAL_Thread_Join(mThread, NULL);
+		ARSAL_Thread_Destroy(&mThread);
+	}
+
+	ARSAL_FutexSem_Destroy(&mSem);
+}
+
+
+// Create
+actionDispatcher* actionDispatcher::Create()
+{
+	return new actionDispatcher();
+}
+
+
+// Register
+bool actionDispatcher::Register( const char* label, const Handler& handler, int priority, uint32_t deadlineMs )
+{
+	if( !label || !handler || mThread != NULL )
+		return false;
+
+	Binding binding;
+
+	binding.label    = label;
+	binding.handler  = handler;
+	binding.priority = priority;
+	binding.deadline = MSEC_TO_NSEC((ARSAL_Time_Ns_t)deadlineMs);
+
+	mBindings.push_back(binding);
+	return true;
+}
+
+
+// Start
+bool actionDispatcher::Start()
+{
+	if( mThread != NULL )
+		return true;
+
+	ARSAL_Thread_Attr_t attr;
+	ARSAL_Thread_GetRoleAttr("actuator", &attr);
+
+	if( attr.name[0] == '\0' )
+		strncpy(attr.name, "actuator", sizeof(attr.name) - 1);
+
+	mRun = true;
+
+	if( ARSAL_Thread_CreateEx(&mThread, threadEntry, this, &attr) != 0 )
+	{
+		printf(LOG_ACTION "failed to start the actuator thread\n");
+		mThread = NULL;
+		mRun    = false;
+		return false;
+	}
+
+	return true;
+}
+
+
+// Resolve
+uint32_t actionDispatcher::Resolve( const imageNet* net )
+{
+	if( !net )
+		return 0;
+
+	const uint32_t numClasses = net->GetNumClasses();
+	std::vector<bool> bound(mBindings.size(), false);
+	uint32_t count = 0;
+
+	mClassTable.assign(numClasses, -1);
+
+	for( uint32_t c=0; c < numClasses; c++ )
+	{
+		const char* desc = net->GetClassDesc(c);
+
+		for( size_t b=0; b < mBindings.size() && desc != NULL; b++ )
+		{
+			if( mBindings[b].label == desc )
+			{
+				mClassTable[c] = b;
+				bound[b] = true;
+				count++;
+				break;
+			}
+		}
+	}
+
+	for( size_t b=0; b < mBindings.size(); b++ )
+	{
+		if( !bound[b] )
+			printf(LOG_ACTION "no class '%s' in the network, its action is never run\n", mBindings[b].label.c_str());
+	}
+
+	printf(LOG_ACTION "%u of %u classes bound to an action\n", count, numClasses);
+	return count;
+}
+
+
+// Dispatch
+bool actionDispatcher::Dispatch( int classID, float confidence, ARSAL_Time_Ns_t timestamp, uint32_t source, bool active, bool refresh )
+{
+	if( classID < 0 || classID >= (int)mClassTable.size() || mClassTable[classID] < 0 )
+		return false;
+
+	const uint32_t head = mHead.load(std::memory_order_relaxed);
+
+	// the second half of the queue is kept for the transitions, which can't be lost
+	if( head - mTail.load(std::memory_order_acquire) >= (refresh ? ACTION_QUEUE_SIZE / 2 : ACTION_QUEUE_SIZE) )
+	{
+		mDropped++;
+		return false;
+	}
+
+	const Binding& binding = mBindings[mClassTable[classID]];
+	Action& action = mQueue[head % ACTION_QUEUE_SIZE];
+
+	action.handler    = mClassTable[classID];
+	action.classID    = classID;
+	action.source     = source;
+	action.active     = active;
+	action.refresh    = refresh;
+	action.confidence = confidence;
+	action.timestamp  = timestamp;
+	action.deadline   = timestamp + binding.deadline;
+
+	mHead.store(head + 1, std::memory_order_release);
+	ARSAL_FutexSem_Post(&mSem);
+
+	mDispatched++;
+	return true;
+}
+
+
+// pop
+bool actionDispatcher::pop( Action* action )
+{
+	const uint32_t tail = mTail.load(std::memory_order_relaxed);
+
+	if( tail == mHead.load(std::memory_order_acquire) )
+		return false;
+
+	*action = mQueue[tail % ACTION_QUEUE_SIZE];
+	mTail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+
+// threadEntry
+void* actionDispatcher::threadEntry( void* arg )
+{
+	((actionDispatcher*)arg)->run();
+	return NULL;
+}
+
+
+// run
+void actionDispatcher::run()
+{
+	std::vector<Action> pending;	// transitions in order, at most one refresh per handler and source
+
+	pending.reserve(mBindings.size());
+
+	while( mRun )
+	{
+		if( pending.empty() )
+			ARSAL_FutexSem_WaitN(&mSem, ACTION_QUEUE_SIZE, ARSAL_Time_GetMonotonicNs() + MSEC_TO_NSEC((ARSAL_Time_Ns_t)ACTUATOR_POLL_MS));
+
+		// a refresh is superseded by any later action of the same handler and source
+		Action action;
+
+		while( pop(&action) )
+		{
+			size_t n = 0;
+
+			while( n < pending.size() && !(pending[n].refresh && pending[n].handler == action.handler && pending[n].source == action.source) )
+				n++;
+
+			if( n < pending.size() )
+			{
+				pending.erase(pending.begin() + n);
+				mReplaced++;
+			}
+
+			pending.push_back(action);
+		}
+
+		if( pending.empty() )
+			continue;
+
+		// highest priority first, earliest deadline among equals, in order for a handler
+		size_t next = 0;
+
+		for( size_t n=1; n < pending.size(); n++ )
+		{
+			const int p = mBindings[pending[n].handler].priority;
+			const int q = mBindings[pending[next].handler].priority;
+
+			if( p > q || (p == q && pending[n].deadline < pending[next].deadline) )
+				next = n;
+		}
+
+		action = pending[next];
+		pending.erase(pending.begin() + next);
+
+		const Binding& binding = mBindings[action.handler];
+		const ARSAL_Time_Ns_t now = ARSAL_Time_GetMonotonicNs();
+
+		if( now > action.deadline )
+		{
+			if( action.refresh )
+			{
+				mExpired++;
+				printf(LOG_ACTION "%s refresh dropped, %.1f ms after its frame\n", binding.label.c_str(), (now - action.timestamp) / 1000000.0f);
+				continue;
+			}
+
+			// the handler has to learn the class was entered or lost, even late
+			printf(LOG_ACTION "%s %s late, %.1f ms after its frame\n", binding.label.c_str(), action.active ? "entered" : "lost", (now - action.timestamp) / 1000000.0f);
+		}
+
+		binding.handler(action);
+		mExecuted++;
+	}
+}
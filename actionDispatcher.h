@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __ACTION_DISPATCHER_H__
+#define __ACTION_DISPATCHER_H__
+
+
+#include "imageNet.h"
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <libARSAL/ARSAL_Sem.h>
+#include <libARSAL/ARSAL_Thread.h>
+#include <libARSAL/ARSAL_Time.h>
+}
+
+
+/**
+ * Capacity of the action queue, a power of two
+ */
+#define ACTION_QUEUE_SIZE 64
+
+/**
+ * Default time an action stays relevant after the capture of its frame
+ */
+#define ACTION_DEFAULT_DEADLINE_MS 250
+
+
+/**
+ * Runs the actions bound to the recognized classes on an actuator thread,
+ * so a slow servo or socket never holds up the vision loop.
+ *
+ * Handlers are registered by class label, then Resolve() turns the labels
+ * of a network into a class ID table, once per model load: Dispatch() is
+ * then an array lookup and a push into a lock-free single producer, single
+ * consumer queue. The actuator thread runs the pending actions by priority,
+ * then by deadline. Refreshes of a class still active are only reminders:
+ * a newer one for the same handler and source replaces a pending one, and
+ * one whose deadline passed while waiting is dropped. Transitions (a class
+ * entered or lost) are never replaced nor dropped once queued, and run in
+ * order, so a handler always sees the end of what it started.
+ *
+ * Register(), Resolve() and Dispatch() are called from the vision loop only.
+ */
+class actionDispatcher
+{
+public:
+	/**
+	 * One recognized class, queued for its handler
+	 */
+	struct Action
+	{
+		uint32_t        handler;
+		int             classID;
+		uint32_t        source;		// camera of the frame, see multiCamera
+		bool            active;		// false once the class is no longer seen, see temporalFilter
+		bool            refresh;	// still active, nothing changed since the last action
+		float           confidence;
+		ARSAL_Time_Ns_t timestamp;	// capture time of the frame
+		ARSAL_Time_Ns_t deadline;	// dropped if not started by then
+	};
+
+	/**
+	 * Runs on the actuator thread, may block
+	 */
+	typedef std::function<void(const Action&)> Handler;
+
+	/**
+	 * Create a dispatcher, the actuator thread starts with Start().
+	 */
+	static actionDispatcher* Create();
+
+	/**
+	 * Destroy, the actions still queued are dropped
+	 */
+	~actionDispatcher();
+
+	/**
+	 * Bind a handler to a class label, before Start().
+	 * @param priority higher runs first
+	 */
+	bool Register( const char* label, const Handler& handler, int priority=0, uint32_t deadlineMs=ACTION_DEFAULT_DEADLINE_MS );
+
+	/**
+	 * Start the actuator thread
+	 */
+	bool Start();
+
+	/**
+	 * Map the class IDs of a network to the handlers, at every model load.
+	 * @returns the number of classes bound to a handler
+	 */
+	uint32_t Resolve( const imageNet* net );
+
+	/**
+	 * Queue the action of a class, if it has one.
+	 * @param active false when the class was lost
+	 * @param refresh true for a reminder that the class is still active,
+	 *                refreshes only take the first half of the queue
+	 * @returns false when the class has no handler or the queue is full
+	 */
+	bool Dispatch( int classID, float confidence, ARSAL_Time_Ns_t timestamp, uint32_t source=0, bool active=true, bool refresh=false );
+
+	/**
+	 * Statistics
+	 */
+	inline uint64_t GetNumDispatched() const		{ return mDispatched; }
+	inline uint64_t GetNumExecuted() const		{ return mExecuted; }
+	inline uint64_t GetNumExpired() const		{ return mExpired; }
+	inline uint64_t GetNumReplaced() const		{ return mReplaced; }
+	inline uint64_t GetNumDropped() const		{ return mDropped; }
+
+protected:
+	actionDispatcher();
+
+	struct Binding
+	{
+		std::string     label;
+		Handler         handler;
+		int             priority;
+		ARSAL_Time_Ns_t deadline;
+	};
+
+	void run();
+	bool pop( Action* action );
+
+	static void* threadEntry( void* arg );
+
+	std::vector<Binding> mBindings;
+	std::vector<int>     mClassTable;	// class ID to binding, -1 for none
+
+	// single producer (Dispatch), single consumer (actuator thread)
+	Action                mQueue[ACTION_QUEUE_SIZE];
+	std::atomic<uint32_t> mHead;		// next slot written
+	std::atomic<uint32_t> mTail;		// next slot read
+	ARSAL_FutexSem_t      mSem;
+
+	ARSAL_Thread_t    mThread;
+	std::atomic<bool> mRun;
+
+	uint64_t              mDispatched;
+	std::atomic<uint64_t> mExecuted;
+	std::atomic<uint64_t> mExpired;
+	std::atomic<uint64_t> mReplaced;
+	uint64_t              mDropped;
+};
+
+#endif
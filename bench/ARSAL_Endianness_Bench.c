@@ -0,0 +1,186 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file bench/ARSAL_Endianness_Bench.c
+ * @brief Bulk byte order conversion against the per-element scalar helpers
+ * @date 10/18/2026
+ *
+ * Usage: ARSAL_Endianness_Bench
+ *
+ * Swaps arrays of 16, 32 and 64 bits elements, small enough to stay in the
+ * L1 cache (a telemetry packet) and larger than the L2 (a block of sensor
+ * samples). Each size runs an element loop swapping one value at a time
+ * (floats and doubles punned through an integer, as the scalar dtoh* helpers
+ * do), ARSAL_Endianness_BswapArray*() out of
+ * place and in place, and memcpy, which is what htodArray*() reduces to
+ * when the host already uses the device byte order. Results are the best
+ * of BENCH_RUNS runs, in GB/s of converted data.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libARSAL/ARSAL_Time.h>
+#include <libARSAL/ARSAL_Endianness.h>
+
+#define BENCH_RUNS 7
+#define BENCH_BYTES_PER_RUN (64 * 1024 * 1024)
+
+static void scalar16 (void *dst, const void *src, size_t count)
+{
+    uint16_t *d = dst;
+    const uint16_t *s = src;
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        d[i] = __builtin_bswap16 (s[i]);
+    }
+}
+
+static void scalar32 (void *dst, const void *src, size_t count)
+{
+    float *d = dst;
+    const float *s = src;
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        uint32_t v;
+        memcpy (&v, &s[i], sizeof (v));
+        v = __builtin_bswap32 (v);
+        memcpy (&d[i], &v, sizeof (v));
+    }
+}
+
+static void scalar64 (void *dst, const void *src, size_t count)
+{
+    double *d = dst;
+    const double *s = src;
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        uint64_t v;
+        memcpy (&v, &s[i], sizeof (v));
+        v = __builtin_bswap64 (v);
+        memcpy (&d[i], &v, sizeof (v));
+    }
+}
+
+static void copy (void *dst, const void *src, size_t count)
+{
+    memcpy (dst, src, count);
+}
+
+typedef void (*convert_t) (void *dst, const void *src, size_t count);
+
+/* GB/s converting size bytes of elemSize elements, repeated over BENCH_BYTES_PER_RUN */
+static double measure (convert_t convert, void *dst, const void *src, size_t size, size_t elemSize)
+{
+    size_t repeat = BENCH_BYTES_PER_RUN / size;
+    size_t count = (convert == copy) ? size : size / elemSize;
+    ARSAL_Time_Ns_t best = 0;
+    size_t n;
+    int r;
+
+    for (r = 0; r < BENCH_RUNS; r++)
+    {
+        ARSAL_Time_Ns_t start = ARSAL_Time_GetMonotonicNs ();
+        ARSAL_Time_Ns_t elapsed;
+
+        for (n = 0; n < repeat; n++)
+        {
+            convert (dst, src, count);
+            __asm__ __volatile__ ("" : : "r" (dst) : "memory");
+        }
+
+        elapsed = ARSAL_Time_GetMonotonicNs () - start;
+        best = (r == 0 || elapsed < best) ? elapsed : best;
+    }
+
+    return (double)size * repeat / best;
+}
+
+int main (void)
+{
+    static const size_t sizes[] = { 4 * 1024, 4 * 1024 * 1024 };
+    static const size_t elemSizes[] = { 2, 4, 8 };
+    static const convert_t scalars[] = { scalar16, scalar32, scalar64 };
+    static const convert_t arrays[] = { ARSAL_Endianness_BswapArray16, ARSAL_Endianness_BswapArray32, ARSAL_Endianness_BswapArray64 };
+    size_t s, e, i;
+
+    printf ("size      bits  scalar GB/s  array GB/s  in place GB/s  memcpy GB/s  speedup\n");
+
+    for (s = 0; s < sizeof (sizes) / sizeof (sizes[0]); s++)
+    {
+        uint8_t *src = malloc (sizes[s]);
+        uint8_t *dst = malloc (sizes[s]);
+        uint8_t *ref = malloc (sizes[s]);
+
+        if ((src == NULL) || (dst == NULL) || (ref == NULL))
+        {
+            fprintf (stderr, "failed to allocate %zu bytes\n", sizes[s]);
+            return 1;
+        }
+
+        for (i = 0; i < sizes[s]; i++)
+        {
+            src[i] = (uint8_t)(i * 131 + 7);
+        }
+
+        for (e = 0; e < sizeof (elemSizes) / sizeof (elemSizes[0]); e++)
+        {
+            double scalar, array, inPlace, memCopy;
+
+            /* both paths must agree before they are timed */
+            scalars[e] (ref, src, sizes[s] / elemSizes[e]);
+            arrays[e] (dst, src, sizes[s] / elemSizes[e]);
+            if (memcmp (ref, dst, sizes[s]) != 0)
+            {
+                fprintf (stderr, "BswapArray%zu differs from the scalar conversion\n", elemSizes[e] * 8);
+                return 1;
+            }
+
+            scalar = measure (scalars[e], dst, src, sizes[s], elemSizes[e]);
+            array = measure (arrays[e], dst, src, sizes[s], elemSizes[e]);
+            inPlace = measure (arrays[e], dst, dst, sizes[s], elemSizes[e]);
+            memCopy = measure (copy, dst, src, sizes[s], elemSizes[e]);
+
+            printf ("%7zu K  %4zu  %11.2f  %10.2f  %13.2f  %11.2f  %6.2fx\n", sizes[s] / 1024, elemSizes[e] * 8,
+                    scalar, array, inPlace, memCopy, array / scalar);
+        }
+
+        free (src);
+        free (dst);
+        free (ref);
+    }
+
+    return 0;
+}
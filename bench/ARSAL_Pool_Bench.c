@@ -0,0 +1,269 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file bench/ARSAL_Pool_Bench.c
+ * @brief ARSAL_Pool against glibc malloc under a network-like load
+ * @date 10/18/2026
+ *
+ * Usage: ARSAL_Pool_Bench [nbThreads]
+ *
+ * Two loads, each run with malloc/free and with an ARSAL_Pool of
+ * BENCH_OBJECT_SIZE bytes objects:
+ * - churn: every thread allocates bursts of BENCH_BURST objects, writes
+ *   them and frees them, as the command and frame buffers of one thread;
+ * - handoff: pairs of threads, one allocating the objects and passing them
+ *   through a queue to the other, which frees them, as received fragments
+ *   handed from the network thread to the reader.
+ * Results are the best of BENCH_RUNS runs, in millions of alloc/free pairs
+ * per second over all the threads.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include <libARSAL/ARSAL_Thread.h>
+#include <libARSAL/ARSAL_Time.h>
+#include <libARSAL/ARSAL_Pool.h>
+
+#define BENCH_RUNS 5
+#define BENCH_OBJECT_SIZE 256
+#define BENCH_BURST 64
+#define BENCH_OPS_PER_THREAD (2 * 1000 * 1000)
+#define BENCH_QUEUE_SIZE 1024   /* power of two */
+#define BENCH_MAX_THREADS 64
+
+typedef struct
+{
+    ARSAL_Pool_t *pool;         /* NULL for malloc */
+} allocator_t;
+
+static inline void *benchAlloc (allocator_t *allocator)
+{
+    return (allocator->pool != NULL) ? ARSAL_Pool_Alloc (allocator->pool) : malloc (BENCH_OBJECT_SIZE);
+}
+
+static inline void benchFree (allocator_t *allocator, void *object)
+{
+    if (allocator->pool != NULL)
+    {
+        ARSAL_Pool_Free (allocator->pool, object);
+    }
+    else
+    {
+        free (object);
+    }
+}
+
+/* Single producer, single consumer queue of the handoff load */
+typedef struct
+{
+    void *slots[BENCH_QUEUE_SIZE];
+    size_t head;                /* written by the producer */
+    size_t tail;                /* written by the consumer */
+} queue_t;
+
+typedef struct
+{
+    allocator_t *allocator;
+    queue_t *queue;
+    int failed;
+} worker_t;
+
+static void *churnRun (void *arg)
+{
+    worker_t *worker = arg;
+    void *objects[BENCH_BURST];
+    int n, i;
+
+    for (n = 0; n < BENCH_OPS_PER_THREAD / BENCH_BURST; n++)
+    {
+        for (i = 0; i < BENCH_BURST; i++)
+        {
+            objects[i] = benchAlloc (worker->allocator);
+            if (objects[i] == NULL)
+            {
+                worker->failed = 1;
+                return NULL;
+            }
+            memset (objects[i], i, 64);
+        }
+        for (i = 0; i < BENCH_BURST; i++)
+        {
+            benchFree (worker->allocator, objects[i]);
+        }
+    }
+    return NULL;
+}
+
+static void *producerRun (void *arg)
+{
+    worker_t *worker = arg;
+    queue_t *queue = worker->queue;
+    size_t head;
+
+    for (head = 0; head < BENCH_OPS_PER_THREAD; head++)
+    {
+        void *object = benchAlloc (worker->allocator);
+        if (object == NULL)
+        {
+            worker->failed = 1;     /* NULL is still queued, the consumer frees it */
+        }
+        else
+        {
+            memset (object, (int)head, 64);
+        }
+
+        while (head - __atomic_load_n (&queue->tail, __ATOMIC_ACQUIRE) >= BENCH_QUEUE_SIZE)
+        {
+            sched_yield ();
+        }
+        queue->slots[head & (BENCH_QUEUE_SIZE - 1)] = object;
+        __atomic_store_n (&queue->head, head + 1, __ATOMIC_RELEASE);
+    }
+    return NULL;
+}
+
+static void *consumerRun (void *arg)
+{
+    worker_t *worker = arg;
+    queue_t *queue = worker->queue;
+    size_t tail;
+
+    for (tail = 0; tail < BENCH_OPS_PER_THREAD; tail++)
+    {
+        void *object;
+
+        while (__atomic_load_n (&queue->head, __ATOMIC_ACQUIRE) == tail)
+        {
+            sched_yield ();
+        }
+        object = queue->slots[tail & (BENCH_QUEUE_SIZE - 1)];
+        __atomic_store_n (&queue->tail, tail + 1, __ATOMIC_RELEASE);
+
+        benchFree (worker->allocator, object);
+    }
+    return NULL;
+}
+
+/* Millions of alloc/free pairs per second, best of BENCH_RUNS; 0 on failure */
+static double measure (allocator_t *allocator, int nbThreads, int handoff)
+{
+    ARSAL_Thread_t threads[BENCH_MAX_THREADS];
+    worker_t workers[BENCH_MAX_THREADS];
+    queue_t *queues = calloc (nbThreads, sizeof (queue_t));
+    ARSAL_Time_Ns_t best = 0;
+    int nbPairs;
+    int r, n;
+
+    if (queues == NULL)
+    {
+        return 0.0;
+    }
+
+    for (r = 0; r < BENCH_RUNS; r++)
+    {
+        ARSAL_Time_Ns_t start = ARSAL_Time_GetMonotonicNs (), elapsed;
+        int failed = 0;
+
+        memset (queues, 0, nbThreads * sizeof (queue_t));
+        for (n = 0; n < nbThreads; n++)
+        {
+            workers[n].allocator = allocator;
+            workers[n].queue = &queues[n / 2];
+            workers[n].failed = 0;
+            ARSAL_Thread_Create (&threads[n], !handoff ? churnRun : (n % 2 == 0) ? producerRun : consumerRun, &workers[n]);
+        }
+        for (n = 0; n < nbThreads; n++)
+        {
+            ARSAL_Thread_Join (threads[n], NULL);
+            ARSAL_Thread_Destroy (&threads[n]);
+            failed |= workers[n].failed;
+        }
+
+        elapsed = ARSAL_Time_GetMonotonicNs () - start;
+        if (failed)
+        {
+            free (queues);
+            return 0.0;
+        }
+        best = (r == 0 || elapsed < best) ? elapsed : best;
+    }
+
+    free (queues);
+    nbPairs = handoff ? nbThreads / 2 : nbThreads;
+    return (double)BENCH_OPS_PER_THREAD * nbPairs * 1000.0 / best;
+}
+
+int main (int argc, char *argv[])
+{
+    int maxThreads = (argc > 1) ? atoi (argv[1]) : (int)sysconf (_SC_NPROCESSORS_ONLN);
+    ARSAL_Pool_Config_t config;
+    allocator_t system = { NULL };
+    allocator_t pooled;
+    int nbThreads;
+
+    if ((maxThreads < 1) || (maxThreads > BENCH_MAX_THREADS))
+    {
+        fprintf (stderr, "usage: %s [nbThreads, 1 to %d]\n", argv[0], BENCH_MAX_THREADS);
+        return 1;
+    }
+
+    ARSAL_Pool_Config_Init (&config, BENCH_OBJECT_SIZE, 0);
+    config.name = "bench";
+    pooled.pool = ARSAL_Pool_New (&config, NULL);
+    if (pooled.pool == NULL)
+    {
+        fprintf (stderr, "failed to create the pool\n");
+        return 1;
+    }
+
+    printf ("%d bytes objects, Mops/s (alloc + free)\n\n", BENCH_OBJECT_SIZE);
+    printf ("load     threads  malloc  ARSAL_Pool  speedup\n");
+
+    for (nbThreads = 1; nbThreads <= maxThreads; nbThreads *= 2)
+    {
+        double mallocRate = measure (&system, nbThreads, 0);
+        double poolRate = measure (&pooled, nbThreads, 0);
+        printf ("churn    %7d  %6.1f  %10.1f  %6.2fx\n", nbThreads, mallocRate, poolRate, poolRate / mallocRate);
+    }
+    for (nbThreads = 2; nbThreads <= ((maxThreads < 2) ? 2 : maxThreads); nbThreads *= 2)
+    {
+        double mallocRate = measure (&system, nbThreads, 1);
+        double poolRate = measure (&pooled, nbThreads, 1);
+        printf ("handoff  %7d  %6.1f  %10.1f  %6.2fx\n", nbThreads, mallocRate, poolRate, poolRate / mallocRate);
+    }
+
+    ARSAL_Pool_Delete (&pooled.pool);
+    return 0;
+}
@@ -0,0 +1,245 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file bench/ARSAL_TaskPool_Bench.c
+ * @brief Scaling of ARSAL_TaskPool from 1 to N workers
+ * @date 10/18/2026
+ *
+ * Usage: ARSAL_TaskPool_Bench [maxWorkers]
+ *
+ * Runs an unbalanced parallel-for (the cost of an item grows along the
+ * range, as tiles around a target cost more than plain sky) and a fork/join
+ * recursion on 1 to maxWorkers workers (all the CPUs by default). The
+ * parallel-for is also run on the same number of threads with the range cut
+ * in equal static chunks, as a hand-rolled thread set would do. Times are
+ * the best of BENCH_RUNS runs; speedups are against the serial loop.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <libARSAL/ARSAL_Thread.h>
+#include <libARSAL/ARSAL_Time.h>
+#include <libARSAL/ARSAL_TaskPool.h>
+
+#define BENCH_RUNS 5
+#define BENCH_ITEMS (64 * 1024)
+#define BENCH_FIB 30
+#define BENCH_FIB_CUTOFF 16
+
+static volatile double sink;
+
+/* The cost of item i is proportional to i */
+static void itemsBody (size_t begin, size_t end, void *arg)
+{
+    double acc = 0.0;
+    size_t i;
+    int k;
+
+    (void)arg;
+    for (i = begin; i < end; i++)
+    {
+        for (k = 0; k < (int)(i / 256) + 1; k++)
+        {
+            acc += (double)(i ^ k) * 1e-9;
+        }
+    }
+    sink += acc;
+}
+
+typedef struct
+{
+    size_t begin;
+    size_t end;
+} staticChunk_t;
+
+static void *staticChunkRun (void *arg)
+{
+    staticChunk_t *chunk = arg;
+    itemsBody (chunk->begin, chunk->end, NULL);
+    return NULL;
+}
+
+/* Equal chunks, one thread each, created for the run */
+static void runStatic (int nbThreads)
+{
+    ARSAL_Thread_t threads[nbThreads];
+    staticChunk_t chunks[nbThreads];
+    int n;
+
+    for (n = 0; n < nbThreads; n++)
+    {
+        chunks[n].begin = (size_t)BENCH_ITEMS * n / nbThreads;
+        chunks[n].end = (size_t)BENCH_ITEMS * (n + 1) / nbThreads;
+        ARSAL_Thread_Create (&threads[n], staticChunkRun, &chunks[n]);
+    }
+    for (n = 0; n < nbThreads; n++)
+    {
+        ARSAL_Thread_Join (threads[n], NULL);
+        ARSAL_Thread_Destroy (&threads[n]);
+    }
+}
+
+typedef struct
+{
+    ARSAL_TaskPool_t *pool;
+    int n;
+    long result;
+} fibTask_t;
+
+static long fibSerial (int n)
+{
+    return (n < 2) ? n : fibSerial (n - 1) + fibSerial (n - 2);
+}
+
+static void fibRun (void *arg)
+{
+    fibTask_t *task = arg;
+    fibTask_t left, right;
+    ARSAL_TaskGroup_t group;
+
+    if (task->n < BENCH_FIB_CUTOFF)
+    {
+        task->result = fibSerial (task->n);
+        return;
+    }
+
+    left.pool = right.pool = task->pool;
+    left.n = task->n - 1;
+    right.n = task->n - 2;
+
+    ARSAL_TaskGroup_Init (&group, task->pool);
+    ARSAL_TaskGroup_Spawn (&group, fibRun, &left);
+    fibRun (&right);
+    ARSAL_TaskGroup_Wait (&group);
+
+    task->result = left.result + right.result;
+}
+
+static double bestMs (ARSAL_Time_Ns_t *times)
+{
+    ARSAL_Time_Ns_t best = times[0];
+    int r;
+
+    for (r = 1; r < BENCH_RUNS; r++)
+    {
+        best = (times[r] < best) ? times[r] : best;
+    }
+    return best / 1e6;
+}
+
+int main (int argc, char *argv[])
+{
+    int maxWorkers = (argc > 1) ? atoi (argv[1]) : (int)sysconf (_SC_NPROCESSORS_ONLN);
+    ARSAL_Time_Ns_t times[BENCH_RUNS], start;
+    double serialItems, serialFib;
+    int nbWorkers, r;
+
+    if (maxWorkers < 1)
+    {
+        fprintf (stderr, "usage: %s [maxWorkers]\n", argv[0]);
+        return 1;
+    }
+
+    for (r = 0; r < BENCH_RUNS; r++)
+    {
+        start = ARSAL_Time_GetMonotonicNs ();
+        itemsBody (0, BENCH_ITEMS, NULL);
+        times[r] = ARSAL_Time_GetMonotonicNs () - start;
+    }
+    serialItems = bestMs (times);
+
+    for (r = 0; r < BENCH_RUNS; r++)
+    {
+        start = ARSAL_Time_GetMonotonicNs ();
+        sink += fibSerial (BENCH_FIB);
+        times[r] = ARSAL_Time_GetMonotonicNs () - start;
+    }
+    serialFib = bestMs (times);
+
+    printf ("serial: parallel-for %.2f ms, fib(%d) %.2f ms\n\n", serialItems, BENCH_FIB, serialFib);
+    printf ("workers  parallel-for  speedup  static chunks  speedup  fork/join  speedup\n");
+
+    for (nbWorkers = 1; nbWorkers <= maxWorkers; nbWorkers++)
+    {
+        ARSAL_TaskPool_Config_t config;
+        ARSAL_TaskPool_t *pool;
+        fibTask_t fib;
+        double itemsMs, staticMs, fibMs;
+
+        ARSAL_Thread_Attr_Init (&config.attr);
+        config.nbWorkers = nbWorkers;
+        config.pinWorkers = 1;
+        config.dequeSize = 0;
+
+        pool = ARSAL_TaskPool_New (&config, NULL);
+        if (pool == NULL)
+        {
+            fprintf (stderr, "failed to create a pool of %d workers\n", nbWorkers);
+            return 1;
+        }
+
+        for (r = 0; r < BENCH_RUNS; r++)
+        {
+            start = ARSAL_Time_GetMonotonicNs ();
+            ARSAL_TaskPool_ParallelFor (pool, 0, BENCH_ITEMS, 0, itemsBody, NULL);
+            times[r] = ARSAL_Time_GetMonotonicNs () - start;
+        }
+        itemsMs = bestMs (times);
+
+        for (r = 0; r < BENCH_RUNS; r++)
+        {
+            start = ARSAL_Time_GetMonotonicNs ();
+            runStatic (nbWorkers);
+            times[r] = ARSAL_Time_GetMonotonicNs () - start;
+        }
+        staticMs = bestMs (times);
+
+        for (r = 0; r < BENCH_RUNS; r++)
+        {
+            fib.pool = pool;
+            fib.n = BENCH_FIB;
+            start = ARSAL_Time_GetMonotonicNs ();
+            fibRun (&fib);
+            times[r] = ARSAL_Time_GetMonotonicNs () - start;
+            sink += fib.result;
+        }
+        fibMs = bestMs (times);
+
+        printf ("%7d  %9.2f ms  %6.2fx  %10.2f ms  %6.2fx  %6.2f ms  %6.2fx\n", nbWorkers,
+                itemsMs, serialItems / itemsMs, staticMs, serialItems / staticMs, fibMs, serialFib / fibMs);
+
+        ARSAL_TaskPool_Delete (&pool);
+    }
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "cudaTiles.h"
+
+
+// gpuPreTilesMean
+__global__ void gpuPreTilesMean( float4* input, int iWidth, int iHeight, const int4* regions,
+						   float* output, int oWidth, int oHeight, float3 mean_value )
+{
+	const int x = blockIdx.x * blockDim.x + threadIdx.x;
+	const int y = blockIdx.y * blockDim.y + threadIdx.y;
+	const int n = blockIdx.z;
+
+	if( x >= oWidth || y >= oHeight )
+		return;
+
+	const int4 roi = regions[n];
+
+	// nearest sample of the region, clamped to the image
+	const int m_x = min(roi.x + (x * roi.z) / oWidth, iWidth - 1);
+	const int m_y = min(roi.y + (y * roi.w) / oHeight, iHeight - 1);
+
+	const float4 px  = input[m_y * iWidth + m_x];
+	const float3 bgr = make_float3(px.z - mean_value.x, px.y - mean_value.y, px.x - mean_value.z);
+
+	const int plane = oWidth * oHeight;
+	float* tile = output + n * plane * 3;
+
+	tile[plane * 0 + y * oWidth + x] = bgr.x;
+	tile[plane * 1 + y * oWidth + x] = bgr.y;
+	tile[plane * 2 + y * oWidth + x] = bgr.z;
+}
+
+
+// cudaPreTilesMean
+cudaError_t cudaPreTilesMean( float4* input, size_t inputWidth, size_t inputHeight,
+					    const int4* regions, uint32_t count,
+					    float* output, size_t outputWidth, size_t outputHeight,
+					    const float3& mean_value, cudaStream_t stream )
+{
+	if( !input || !regions || !output )
+		return cudaErrorInvalidDevicePointer;
+
+	if( inputWidth == 0 || outputWidth == 0 || inputHeight == 0 || outputHeight == 0 || count == 0 )
+		return cudaErrorInvalidValue;
+
+	// one grid layer per region, so a whole batch is a single launch
+	const dim3 blockDim(8, 8);
+	const dim3 gridDim(iDivUp(outputWidth, blockDim.x), iDivUp(outputHeight, blockDim.y), count);
+
+	gpuPreTilesMean<<<gridDim, blockDim, 0, stream>>>(input, inputWidth, inputHeight, regions, output, outputWidth, outputHeight, mean_value);
+
+	return CUDA(cudaGetLastError());
+}
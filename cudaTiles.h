@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __CUDA_TILES_H__
+#define __CUDA_TILES_H__
+
+
+#include "cudaUtility.h"
+
+
+/**
+ * Crop regions out of a float4 RGBA image, rescale each of them to the
+ * network input size and write them as consecutive planar BGR images with
+ * the mean subtracted, the layout imageNet expects for a batch.
+ *
+ * @param regions  device (or mapped) array of count regions, as (x, y, width, height)
+ * @param output   device buffer of count * 3 * outputWidth * outputHeight floats
+ * @ingroup util
+ */
+cudaError_t cudaPreTilesMean( float4* input, size_t inputWidth, size_t inputHeight,
+					    const int4* regions, uint32_t count,
+					    float* output, size_t outputWidth, size_t outputHeight,
+					    const float3& mean_value, cudaStream_t stream=NULL );
+
+#endif
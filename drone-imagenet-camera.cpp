@@ -21,20 +21,47 @@
  */
 
 #include "gstCamera.h"
+#include "ringCamera.h"
 
 #include "glDisplay.h"
 #include "glTexture.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <signal.h>
 #include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 
 #include "cudaNormalize.h"
+#include "cudaResize.h"
 #include "cudaFont.h"
 #include "imageNet.h"
+#include "tiledNet.h"
+#include "skyProposals.h"
+#include "gateModel.h"
+#include "modelHolder.h"
+#include "multiCamera.h"
+#include "latencyController.h"
+#include "actionDispatcher.h"
+#include "temporalFilter.h"
+
+extern "C" {
+#include <libARSAL/ARSAL_ClipRecorder.h>
+#include <libARSAL/ARSAL_Thread.h>
+}
 
 
 #define DEFAULT_CAMERA -1	// -1 for onboard camera, or change to index of /dev/video V4L2 camera (>=0)	
+#define DEFAULT_THREAD_ROLES "thread_roles.conf"	// cpus, policy and priority of each thread role (see ARSAL_Thread_LoadRoles)
+#define DEFAULT_CLIP_TRIGGER "/tmp/bebop_clip.sock"	// clip recorder socket of the stream receiver (BD_CLIP_TRIGGER_SOCKET)
+#define MAX_DETECTIONS 16	// tile detections kept per frame with --tiles
+#define MAX_PROPOSALS 8	// candidate crops classified per frame with --sky-roi
+#define CLIP_TRIGGER_PERIOD_MS 1000	// an active Target is refreshed at this rate, re-triggering the recorder to extend the clip
+#define TARGET_PRIORITY 10	// actions of a Target go before the other classes
+#define TARGET_DEADLINE_MS 200	// a servo action later than this after the capture aims at a stale position
+#define SERVO_COMMAND_SIZE 128	// longest servo command line
 		
 		
 		
@@ -50,6 +77,36 @@ void sig_handler(int signo)
 }
 
 
+// send a Target action to the servo controller listening on a unix datagram socket, as one text line:
+// "target <source> <active> <confidence> <capture timestamp ns>\n"
+static bool sendServoCommand( const char* path, const actionDispatcher::Action& action )
+{
+	struct sockaddr_un addr;
+
+	if( !path || strlen(path) >= sizeof(addr.sun_path) )
+		return false;
+
+	char cmd[SERVO_COMMAND_SIZE];
+	const int len = snprintf(cmd, sizeof(cmd), "target %u %i %.3f %llu\n", action.source, action.active ? 1 : 0,
+					     action.confidence, (unsigned long long)action.timestamp);
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path);
+
+	const int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+
+	if( fd < 0 )
+		return false;
+
+	// blocking is fine, this runs on the actuator thread
+	const bool sent = (sendto(fd, cmd, len, 0, (struct sockaddr*)&addr, sizeof(addr)) == len);
+
+	close(fd);
+	return sent;
+}
+
+
 int main( int argc, char** argv )
 {
 	printf("imagenet-camera\n  args (%i):  ", argc);
@@ -68,26 +125,139 @@ int main( int argc, char** argv )
 
 
 	/*
-	 * create the camera device
+	 * create the camera device, or read the frames published by the
+	 * stream receiver process with --ring=<shared memory name>, or with
+	 * --cameras=<csi,v4l2:1,ring:name,...> classify several sources at once
+	 */
+	const char* ringName = NULL;
+	const char* cameraList = NULL;
+	uint32_t deadlineMs = MULTI_DEFAULT_DEADLINE_MS;
+	const char* clipTrigger = DEFAULT_CLIP_TRIGGER;
+	const char* servoSocket = NULL;
+	bool useTiles = false;
+	bool useSky = false;
+	bool usePack = false;
+	const char* modelFile = NULL;
+	const char* modelSocket = MODEL_HOLDER_DEFAULT_SOCKET;
+	bool modelWatch = false;
+	const char* gatePath = NULL;
+	float gateThreshold = -1.0f;
+	float sloMs = 0.0f;
+	float enterThreshold = 0.6f;
+	float exitThreshold = 0.3f;
+	uint32_t dwellMs = 300;
+	const char* streamControl = LATENCY_DEFAULT_STREAM_SOCKET;
+	const char* threadRoles = DEFAULT_THREAD_ROLES;
+	bool threadRolesSet = false;
+
+	for( int i=1; i < argc; i++ )
+	{
+		if( strncmp(argv[i], "--thread_roles=", 15) == 0 )
+		{
+			threadRoles = argv[i] + 15;
+			threadRolesSet = true;
+		}
+		else if( strncmp(argv[i], "--ring=", 7) == 0 )
+			ringName = argv[i] + 7;
+		else if( strncmp(argv[i], "--cameras=", 10) == 0 )
+		{
+			cameraList = argv[i] + 10;
+			useTiles = true;	// the batched pass is a tiledNet one
+		}
+		else if( strncmp(argv[i], "--deadline_ms=", 14) == 0 )
+			deadlineMs = atoi(argv[i] + 14);
+		else if( strncmp(argv[i], "--clip-trigger=", 15) == 0 )
+			clipTrigger = argv[i] + 15;
+		else if( strncmp(argv[i], "--servo=", 8) == 0 )
+			servoSocket = argv[i][8] ? argv[i] + 8 : NULL;	// empty: no servo
+		else if( strncmp(argv[i], "--tiles", 7) == 0 )
+			useTiles = true;
+		else if( strcmp(argv[i], "--sky-roi") == 0 )
+			useSky = useTiles = true;
+		else if( strncmp(argv[i], "--pack=", 7) == 0 )
+		{
+			usePack = true;
+			modelFile = argv[i] + 7;
+		}
+		else if( strncmp(argv[i], "--model=", 8) == 0 && !usePack )
+			modelFile = argv[i] + 8;
+		else if( strncmp(argv[i], "--model-socket=", 15) == 0 )
+			modelSocket = argv[i] + 15;
+		else if( strcmp(argv[i], "--model-watch") == 0 )
+			modelWatch = true;
+		else if( strncmp(argv[i], "--gate=", 7) == 0 )
+			gatePath = argv[i] + 7;
+		else if( strncmp(argv[i], "--gate_threshold=", 17) == 0 )
+			gateThreshold = atof(argv[i] + 17);
+		else if( strncmp(argv[i], "--enter_threshold=", 18) == 0 )
+			enterThreshold = atof(argv[i] + 18);
+		else if( strncmp(argv[i], "--exit_threshold=", 17) == 0 )
+			exitThreshold = atof(argv[i] + 17);
+		else if( strncmp(argv[i], "--dwell_ms=", 11) == 0 )
+			dwellMs = atoi(argv[i] + 11);
+		else if( strncmp(argv[i], "--slo_ms=", 9) == 0 )
+			sloMs = atof(argv[i] + 9);
+		else if( strncmp(argv[i], "--stream-control=", 17) == 0 )
+			streamControl = argv[i][17] ? argv[i] + 17 : NULL;	// empty: leave the stream settings alone
+	}
+
+
+	/*
+	 * load the thread roles before any thread is created, a missing default
+	 * file leaves every thread with the default attributes
 	 */
-	gstCamera* camera = gstCamera::Create(DEFAULT_CAMERA);
+	const int nbRoles = ARSAL_Thread_LoadRoles(threadRoles);
+
+	if( nbRoles >= 0 )
+		printf("imagenet-camera:  %i thread roles loaded from %s\n", nbRoles, threadRoles);
+	else if( threadRolesSet )
+	{
+		printf("imagenet-camera:  failed to load thread roles from %s\n", threadRoles);
+		return 0;
+	}
+	else
+		printf("imagenet-camera:  no %s, threads use the default attributes\n", threadRoles);
+
+	gstCamera* camera = NULL;
+	ringCamera* ring = NULL;
+	multiCamera* cameras = NULL;
+
+	if( cameraList != NULL )
+		cameras = multiCamera::Create(cameraList, deadlineMs);
+	else if( ringName != NULL )
+		ring = ringCamera::Create(ringName);
+	else
+		camera = gstCamera::Create(DEFAULT_CAMERA);
 	
-	if( !camera )
+	if( !camera && !ring && !cameras )
 	{
 		printf("\nimagenet-camera:  failed to initialize video device\n");
 		return 0;
 	}
 	
+	// with several sources, the first one sizes the warm up and the buffers
+	const uint32_t width  = cameras ? cameras->GetWidth(0) : ring ? ring->GetWidth() : camera->GetWidth();
+	const uint32_t height = cameras ? cameras->GetHeight(0) : ring ? ring->GetHeight() : camera->GetHeight();
+
 	printf("\nimagenet-camera:  successfully initialized video device\n");
-	printf("    width:  %u\n", camera->GetWidth());
-	printf("   height:  %u\n", camera->GetHeight());
-	printf("    depth:  %u (bpp)\n\n", camera->GetPixelDepth());
+	printf("    width:  %u\n", width);
+	printf("   height:  %u\n", height);
+	printf("    depth:  %u (bpp)\n\n", cameras ? (uint32_t)sizeof(float4) * 8 : ring ? ring->GetPixelDepth() : camera->GetPixelDepth());
 	
 
 	/*
-	 * create imageNet
+	 * create imageNet, or with --tiles=<tiles per frame> a tiledNet which
+	 * also looks at full resolution tiles for small, distant targets
 	 */
-	imageNet* net = imageNet::Create(argc, argv);
+	auto createNet = [=]() -> imageNet*
+	{
+		if( useTiles || usePack )
+			return tiledNet::Create(argc, argv);	// --pack=<file from model-pack> is loaded without building anything
+
+		return imageNet::Create(argc, argv);
+	};
+
+	imageNet* net = createNet();
 	
 	if( !net )
 	{
@@ -95,19 +265,176 @@ int main( int argc, char** argv )
 		return 0;
 	}
 
+	tiledNet* tiled = useTiles ? (tiledNet*)net : NULL;
+
+
+	/*
+	 * the network can be replaced without stopping the capture: send "reload"
+	 * to --model-socket, or with --model-watch replace the --pack/--model file
+	 * (tensorNet rebuilds a new caffemodel only once its old .tensorcache is removed)
+	 */
+	modelHolder* holder = modelHolder::Create(net, createNet, width, height, modelSocket, modelWatch ? modelFile : NULL);
+
+	if( !holder )
+		printf("imagenet-camera:  failed to create the model holder, hot swap disabled\n");
+
+
+	/*
+	 * with --sky-roi, only the non-sky blobs found on the CPU are classified
+	 */
+	skyProposals* sky = NULL;
+
+	if( useSky )
+	{
+		sky = skyProposals::Create(width, height);
+
+		if( !sky )
+			printf("imagenet-camera:  failed to create sky proposals, classifying tiles\n");
+	}
+
+
+	/*
+	 * with --gate=<model from gate-train>, a cheap CPU model rejects the obvious
+	 * background first and only the rest goes to the network
+	 */
+	gateModel* gate = NULL;
+
+	if( gatePath != NULL )
+	{
+		gate = gateModel::Create(gatePath);
+
+		if( !gate )
+			printf("imagenet-camera:  failed to load the gate model, classifying every frame\n");
+		else if( gateThreshold >= 0.0f )
+			gate->SetThreshold(gateThreshold);
+	}
+
+
+	/*
+	 * with --slo_ms=<ms>, fewer tiles, a lower processing resolution, fewer
+	 * frames and at last a lighter stream from the drone (requested from the
+	 * stream receiver on --stream-control) keep the frame age under the objective
+	 */
+	latencyController* slo = NULL;
+	void* scaledRGBA = NULL;
+
+	if( sloMs > 0.0f && !cameras )
+	{
+		slo = latencyController::Create(sloMs, tiled ? tiled->GetTileBudget() : 2, streamControl);
+
+		if( !slo )
+			printf("imagenet-camera:  failed to create the latency controller\n");
+		else if( CUDA_FAILED(cudaMalloc(&scaledRGBA, width * height * sizeof(float4))) )
+		{
+			printf("imagenet-camera:  failed to allocate the downscaled frame, keeping the full resolution\n");
+			scaledRGBA = NULL;
+		}
+
+		if( slo != NULL && !ring )
+			printf("imagenet-camera:  frame age measured from Capture(), the camera pipeline latency is not counted\n");
+	}
+
+
+	/*
+	 * the actions of the recognized classes run on the actuator thread, bound
+	 * to the class IDs of the network at every model load. They only run when
+	 * a class is entered, refreshed or left, see the temporal filters below.
+	 */
+	actionDispatcher* actions = actionDispatcher::Create();
+
+	if( !servoSocket )
+		printf("imagenet-camera:  no servo controller (--servo=<socket>), Target actions are logged only\n");
+
+	// the recorder only has the stream of the receiver, other cameras do not cut clips
+	std::vector<bool> recorded(cameras ? cameras->GetNumSources() : 1, true);
+
+	for( size_t n=0; cameras != NULL && n < recorded.size(); n++ )
+		recorded[n] = cameras->IsRing(n);
+
+	actions->Register("Target", [clipTrigger, servoSocket, recorded]( const actionDispatcher::Action& action )
+	{
+		printf(action.active ? "Target\n" : "Target lost\n");
+
+		// aim the servo, or release it when the target is lost
+		if( servoSocket != NULL && !sendServoCommand(servoSocket, action) )
+			printf("imagenet-camera:  failed to send the servo command to %s\n", servoSocket);
+
+		// save the encoded stream around the detection, until the post trigger time after it was lost
+		if( action.source < recorded.size() && recorded[action.source] )
+			ARSAL_ClipRecorder_SendTrigger(clipTrigger, action.timestamp);
+	}, TARGET_PRIORITY, TARGET_DEADLINE_MS);
+
+	// recognized, but no servo action
+	const char* passive[] = { "Bebop", "PS4_Controller", "Monster" };
+
+	for( size_t n=0; n < sizeof(passive) / sizeof(passive[0]); n++ )
+	{
+		const char* label = passive[n];
+
+		actions->Register(label, [label]( const actionDispatcher::Action& action )
+		{
+			printf(action.active ? "%s\n" : "%s lost\n", label);
+		});
+	}
+
+	const imageNet* boundNet = net;
+	actions->Resolve(net);
+
+	if( !actions->Start() )
+		printf("imagenet-camera:  failed to start the actuator thread, actions are queued but not run\n");
+
+
+	/*
+	 * decisions go through a temporal filter per source: a class has to be
+	 * seen with --enter_threshold for a while to become active, then to fall
+	 * under --exit_threshold, and stays in a state at least --dwell_ms
+	 */
+	std::vector<temporalFilter*> filters(cameras ? cameras->GetNumSources() : 1, (temporalFilter*)NULL);
+
+	for( size_t n=0; n < filters.size(); n++ )
+	{
+		filters[n] = temporalFilter::Create(net->GetNumClasses());
+
+		if( filters[n] != NULL )
+		{
+			filters[n]->SetThresholds(enterThreshold, exitThreshold);
+			filters[n]->SetDwell(dwellMs);
+			filters[n]->SetRefresh(CLIP_TRIGGER_PERIOD_MS);
+		}
+	}
+
+	// only the transitions of a class go to its action
+	auto filterFrame = [&]( uint32_t source, int classID, float classConfidence, ARSAL_Time_Ns_t timestamp )
+	{
+		if( filters[source] == NULL )
+			return;
+
+		temporalFilter::Transition transitions[FILTER_MAX_TRANSITIONS];
+		const uint32_t count = filters[source]->Update(classID, classConfidence, timestamp, transitions);
+
+		for( uint32_t n=0; n < count; n++ )
+		{
+			if( !transitions[n].refresh )
+				printf("imagenet-camera:  [%u] %s %s (score %.2f)\n", source, net->GetClassDesc(transitions[n].classID),
+					  transitions[n].active ? "entered" : "left", transitions[n].score);
+
+			actions->Dispatch(transitions[n].classID, transitions[n].score, transitions[n].timestamp, source, transitions[n].active, transitions[n].refresh);
+		}
+	};
+
 
 	/*
 	 * create openGL window
 	 */
-	glDisplay* display = glDisplay::Create();
+	glDisplay* display = cameras ? NULL : glDisplay::Create();	// several sources run headless
 	glTexture* texture = NULL;
 	
-	if( !display ) {
+	if( !display && !cameras ) {
 		printf("\nimagenet-camera:  failed to create openGL display\n");
 	}
-	else
+	else if( display != NULL )
 	{
-		texture = glTexture::Create(camera->GetWidth(), camera->GetHeight(), GL_RGBA32F_ARB/*GL_RGBA8*/);
+		texture = glTexture::Create(width, height, GL_RGBA32F_ARB/*GL_RGBA8*/);
 
 		if( !texture )
 			printf("imagenet-camera:  failed to create openGL texture\n");
@@ -123,7 +450,7 @@ int main( int argc, char** argv )
 	/*
 	 * start streaming
 	 */
-	if( !camera->Open() )
+	if( camera != NULL && !camera->Open() )
 	{
 		printf("\nimagenet-camera:  failed to open camera for streaming\n");
 		return 0;
@@ -136,60 +463,225 @@ int main( int argc, char** argv )
 	 * processing loop
 	 */
 	float confidence = 0.0f;
+	uint64_t numFrames = 0, netFrames = 0, netHits = 0;
 	
 	while( !signal_recieved )
 	{
 		void* imgCPU  = NULL;
 		void* imgCUDA = NULL;
+
+		// between frames, the network may have been swapped
+		if( holder != NULL )
+		{
+			net   = holder->Acquire();
+			tiled = useTiles ? (tiledNet*)net : NULL;
+		}
+
+		// the class IDs of a new network may be different
+		if( net != boundNet )
+		{
+			actions->Resolve(net);
+			boundNet = net;
+
+			for( size_t n=0; n < filters.size(); n++ )
+			{
+				if( filters[n] != NULL )
+					filters[n]->Reset(net->GetNumClasses());
+			}
+		}
+
+		// several sources: one batched pass over their latest frames
+		if( cameras != NULL )
+		{
+			multiCamera::Result results[MULTI_MAX_SOURCES];
+			const int count = cameras->Process(tiled, results);
+
+			if( count < 0 )
+				printf("imagenet-camera:  failed to classify the sources\n");
+
+			for( int n=0; n < count; n++ )
+			{
+				filterFrame(results[n].source, results[n].classID, results[n].confidence, results[n].timestamp);
+
+				if( results[n].classID < 0 )
+					continue;
+
+				printf("imagenet-camera:  [%s] %2.5f%% class #%i (%s)\n", cameras->GetName(results[n].source),
+					  results[n].confidence * 100.0f, results[n].classID, net->GetClassDesc(results[n].classID));
+			}
+
+			continue;
+		}
 		
 		// get the latest frame
-		if( !camera->Capture(&imgCPU, &imgCUDA, 1000) )
+		if( ring != NULL )
+		{
+			// frames are read in place from the shared memory ring
+			if( !ring->Capture(&imgCPU, &imgCUDA, 1000) )
+			{
+				printf("\nimagenet-camera:  no frame from the stream receiver\n");
+				continue;
+			}
+		}
+		else if( !camera->Capture(&imgCPU, &imgCUDA, 1000) )
 			printf("\nimagenet-camera:  failed to capture frame\n");
+
+		// clips are cut around the frame that was classified, not the time the result came out.
+		// The ring carries the reception time of the stream receiver; gstCamera does not expose
+		// the GstBuffer PTS, so its frames are stamped when Capture() returns and their age
+		// leaves out the latency of the capture pipeline before the appsink
+		const ARSAL_Time_Ns_t frameTime = ring ? ring->GetTimestamp() : ARSAL_Time_GetMonotonicNs();
+
+		// behind the latency objective, only one frame in GetCadence() is processed
+		if( slo != NULL && !slo->Admit() )
+		{
+			if( ring != NULL )
+				ring->Release();
+
+			continue;
+		}
+
+		// segment the sky while the frame is still in the ring slot
+		const bool rgb = (ring != NULL && ring->GetFormat() == ARSAL_FRAMERING_FORMAT_RGB8);
+		tiledNet::Region proposals[MAX_PROPOSALS];
+		int numProposals = -1;
+
+		if( sky != NULL && imgCPU != NULL )
+			numProposals = sky->Process(imgCPU, rgb ? skyProposals::RGB8 : skyProposals::NV12, proposals, MAX_PROPOSALS);
+
+		// cascade: the proposals, or the whole frame, only go on if they pass the gate
+		bool escalate = true;
+
+		if( gate != NULL && imgCPU != NULL )
+		{
+			const gateModel::Format format = rgb ? gateModel::RGB8 : gateModel::NV12;
+
+			if( numProposals >= 0 )
+			{
+				int kept = 0;
+
+				for( int n=0; n < numProposals; n++ )
+				{
+					if( gate->Pass(imgCPU, format, width, height, proposals[n]) )
+						proposals[kept++] = proposals[n];
+				}
+
+				numProposals = kept;
+			}
+			else
+			{
+				const tiledNet::Region frame = { 0, 0, (int)width, (int)height };
+				escalate = gate->Pass(imgCPU, format, width, height, frame);
+			}
+		}
+
+		numFrames++;
+		netFrames += (escalate && numProposals != 0);
+
 		//else
 		//	printf("imagenet-camera:  recieved new frame  CPU=0x%p  GPU=0x%p\n", imgCPU, imgCUDA);
 		
 		// convert from YUV to RGBA
 		void* imgRGBA = NULL;
 		
-		if( !camera->ConvertRGBA(imgCUDA, &imgRGBA) )
+		if( ring != NULL )
+		{
+			if( !ring->ConvertRGBA(imgCUDA, &imgRGBA) )
+				printf("imagenet-camera:  failed to convert shared frame to RGBA\n");
+
+			// the slot goes back to the receiver as soon as it is converted
+			ring->Release();
+
+			if( !imgRGBA )
+				continue;
+		}
+		else if( !camera->ConvertRGBA(imgCUDA, &imgRGBA) )
 			printf("imagenet-camera:  failed to convert from NV12 to RGBA\n");
 
+		// behind the latency objective, the network gets a downscaled copy and fewer tiles
+		float*   procRGBA   = (float*)imgRGBA;
+		uint32_t procWidth  = width;
+		uint32_t procHeight = height;
+
+		if( slo != NULL && slo->GetScale() < 1.0f && scaledRGBA != NULL && imgRGBA != NULL )
+		{
+			const float scale = slo->GetScale();
+			const uint32_t scaledWidth  = (uint32_t)(width * scale);
+			const uint32_t scaledHeight = (uint32_t)(height * scale);
+
+			if( !CUDA_FAILED(cudaResizeRGBA((float4*)imgRGBA, width * sizeof(float4), width, height,
+									  (float4*)scaledRGBA, scaledWidth * sizeof(float4), scaledWidth, scaledHeight)) )
+			{
+				procRGBA   = (float*)scaledRGBA;
+				procWidth  = scaledWidth;
+				procHeight = scaledHeight;
+
+				// the proposals were found on the full frame
+				for( int n=0; n < numProposals; n++ )
+				{
+					proposals[n].x      = (int)(proposals[n].x * scale);
+					proposals[n].y      = (int)(proposals[n].y * scale);
+					proposals[n].width  = (int)(proposals[n].width * scale);
+					proposals[n].height = (int)(proposals[n].height * scale);
+				}
+			}
+		}
+
+		const float procScale = (float)width / procWidth;
+
+		if( slo != NULL && tiled != NULL )
+			tiled->SetTileBudget(slo->GetTileBudget());
+
 		// classify image
-		const int img_class = net->Classify((float*)imgRGBA, camera->GetWidth(), camera->GetHeight(), &confidence);
+		tiledNet::Detection detections[MAX_DETECTIONS];
+		uint32_t numDetections = 0;
+		int img_class = -1;
+
+		if( !escalate )
+		{
+			// background according to the gate
+		}
+		else if( tiled != NULL && numProposals >= 0 )
+		{
+			// mostly sky: nothing to classify but the blobs
+			numDetections = MAX_DETECTIONS;
+			img_class = tiled->DetectRegions(procRGBA, procWidth, procHeight, proposals, numProposals, detections, &numDetections, &confidence);
+		}
+		else if( tiled != NULL )
+		{
+			numDetections = MAX_DETECTIONS;
+			img_class = tiled->Detect(procRGBA, procWidth, procHeight, detections, &numDetections, &confidence);
+		}
+		else
+			img_class = net->Classify(procRGBA, procWidth, procHeight, &confidence);
+
+		// every processed frame counts, the ones where nothing was recognized too
+		filterFrame(0, img_class, confidence, frameTime);
 	
 		if( img_class >= 0 )
 		{
+			netHits++;
 			printf("imagenet-camera:  %2.5f%% class #%i (%s)\n", confidence * 100.0f, img_class, net->GetClassDesc(img_class));	
 
 			if( font != NULL )
 			{
 				char str[256];
-				sprintf(str, "%05.2f%% %s", confidence * 100.0f, net->GetClassDesc(img_class));
-				std::string class_str(net->GetClassDesc(img_class));
-
-					if("Target" == class_str){
-					          cout << "Target" << endl;
-					          // Invoke servo action
-					}
-					
-					else if("Bebop" == class_str){
-					         cout << "Bebop" << endl;
-					         // Do not invoke servo action
-					}
-					else if("PS4_Controller" == class_str){
-					         cout << "PS4_Controller" << endl;
-					         // Do not invoke servo action
-					}
-					else if("Monster" == class_str){
-					         cout << "Monster" << endl;
-					         // Do not invoke servo action
-					}
-					
-					else {
-					         // Catch anything else here
-					}
-				font->RenderOverlay((float4*)imgRGBA, (float4*)imgRGBA, camera->GetWidth(), camera->GetHeight(),
-								    str, 0, 0, make_float4(255.0f, 255.0f, 255.0f, 255.0f));
+
+				// the class label stays up as long as the class is active, not just for this frame
+				if( filters[0] == NULL || filters[0]->IsActive(img_class) )
+				{
+					sprintf(str, "%05.2f%% %s", confidence * 100.0f, net->GetClassDesc(img_class));
+					font->RenderOverlay((float4*)imgRGBA, (float4*)imgRGBA, width, height,
+									    str, 0, 0, make_float4(255.0f, 255.0f, 255.0f, 255.0f));
+				}
+
+				// label the tiles where something was recognized
+				for( uint32_t n=0; n < numDetections; n++ )
+				{
+					sprintf(str, "%s %02.0f%%", net->GetClassDesc(detections[n].classID), detections[n].confidence * 100.0f);
+					font->RenderOverlay((float4*)imgRGBA, (float4*)imgRGBA, width, height,
+									    str, detections[n].box.x * procScale, detections[n].box.y * procScale, make_float4(255.0f, 255.0f, 0.0f, 255.0f));
+				}
 			}
 			
 			if( display != NULL )
@@ -213,7 +705,7 @@ int main( int argc, char** argv )
 				// rescale image pixel intensities for display
 				CUDA(cudaNormalizeRGBA((float4*)imgRGBA, make_float2(0.0f, 255.0f), 
 								   (float4*)imgRGBA, make_float2(0.0f, 1.0f), 
-		 						   camera->GetWidth(), camera->GetHeight()));
+		 						   width, height));
 
 				// map from CUDA to openGL using GL interop
 				void* tex_map = texture->MapCUDA();
@@ -230,8 +722,46 @@ int main( int argc, char** argv )
 
 			display->EndRender();
 		}
+
+		// the frame is done once its result is out
+		if( slo != NULL )
+			slo->Update(ARSAL_Time_GetMonotonicNs() - frameTime);
 	}
 	
+	if( gate != NULL && numFrames > 0 )
+	{
+		printf("\nimagenet-camera:  cascade, gate passed %llu/%llu (%.1f%%), network ran on %.1f%% of %llu frames, recognized something in %.1f%% of them\n",
+			  (unsigned long long)gate->GetNumPassed(), (unsigned long long)gate->GetNumEvaluated(), gate->GetPassRate() * 100.0f,
+			  100.0 * netFrames / numFrames, (unsigned long long)numFrames, netFrames ? 100.0 * netHits / netFrames : 0.0);
+	}
+
+	if( cameras != NULL && cameras->GetNumBatches() > 0 )
+	{
+		printf("\nimagenet-camera:  %llu frames in %llu passes (%.2f per pass), %llu past the deadline\n",
+			  (unsigned long long)cameras->GetNumFrames(), (unsigned long long)cameras->GetNumBatches(),
+			  (double)cameras->GetNumFrames() / cameras->GetNumBatches(), (unsigned long long)cameras->GetNumLate());
+
+		for( uint32_t n=0; n < cameras->GetNumSources(); n++ )
+			printf("imagenet-camera:  %s dropped %llu frames\n", cameras->GetName(n), (unsigned long long)cameras->GetDropped(n));
+	}
+
+	if( slo != NULL && slo->GetNumWindows() > 0 )
+	{
+		printf("\nimagenet-camera:  latency objective missed in %llu/%llu windows, ended at quality level %u/%u\n",
+			  (unsigned long long)slo->GetViolations(), (unsigned long long)slo->GetNumWindows(), slo->GetLevel(), slo->GetNumLevels() - 1);
+	}
+
+	printf("\nimagenet-camera:  actions %llu dispatched, %llu run, %llu replaced by a newer one, %llu past their deadline, %llu dropped on a full queue\n",
+		  (unsigned long long)actions->GetNumDispatched(), (unsigned long long)actions->GetNumExecuted(), (unsigned long long)actions->GetNumReplaced(),
+		  (unsigned long long)actions->GetNumExpired(), (unsigned long long)actions->GetNumDropped());
+
+	for( size_t n=0; n < filters.size(); n++ )
+	{
+		if( filters[n] != NULL && filters[n]->GetNumFrames() > 0 )
+			printf("imagenet-camera:  [%zu] %llu transitions over %llu frames\n", n,
+				  (unsigned long long)filters[n]->GetNumTransitions(), (unsigned long long)filters[n]->GetNumFrames());
+	}
+
 	printf("\nimagenet-camera:  un-initializing video device\n");
 	
 	
@@ -244,6 +774,57 @@ int main( int argc, char** argv )
 		camera = NULL;
 	}
 
+	if( ring != NULL )
+	{
+		delete ring;
+		ring = NULL;
+	}
+
+	if( cameras != NULL )
+	{
+		delete cameras;
+		cameras = NULL;
+	}
+
+	if( sky != NULL )
+	{
+		delete sky;
+		sky = NULL;
+	}
+
+	if( gate != NULL )
+	{
+		delete gate;
+		gate = NULL;
+	}
+
+	if( slo != NULL )
+	{
+		delete slo;
+		slo = NULL;
+	}
+
+	if( scaledRGBA != NULL )
+	{
+		CUDA(cudaFree(scaledRGBA));
+		scaledRGBA = NULL;
+	}
+
+	if( actions != NULL )
+	{
+		delete actions;
+		actions = NULL;
+	}
+
+	for( size_t n=0; n < filters.size(); n++ )
+		delete filters[n];
+
+	if( holder != NULL )
+	{
+		delete holder;
+		holder = NULL;
+	}
+
 	if( display != NULL )
 	{
 		delete display;
@@ -0,0 +1,464 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "gateModel.h"
+#include "loadImage.h"
+#include "commandLine.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+extern "C" {
+#include <libARSAL/ARSAL_Time.h>
+}
+
+
+#define DEFAULT_ANNOTATIONS "Annotations"
+#define DEFAULT_OUTPUT "gate.model"
+#define DEFAULT_RECALL 0.98f	// cascade recall kept when picking the threshold
+#define DEFAULT_BACKGROUND 0.95f	// share of background frames and crops in flight
+#define DEFAULT_NET_MS 10.0f	// cost of the full network per frame or crop
+#define DEFAULT_CROPS 8	// background crops sampled per image
+
+
+/*
+ * Train the gate of the classifier cascade (gateModel) on the Annotations.
+ *
+ * Targets are the annotated boxes, as tight boxes and as the padded square
+ * crops skyProposals hands to the network, plus the whole frames holding
+ * them. Background is the whole negative frames and random crops away
+ * from the boxes. A quarter of the images is held out to pick the threshold
+ * and to report the pass rates and the cost/recall trade-off.
+ *
+ * The images are converted to video range NV12 before the features are
+ * computed, so the gate is trained on what the camera hands it at runtime.
+ *
+ * gate-train [--annotations=Annotations] [--output=gate.model] [--recall=0.98]
+ *            [--background=0.95] [--net_ms=10] [--crops=8]
+ */
+
+
+struct Sample
+{
+	float   features[GATE_NUM_FEATURES];
+	uint8_t label;
+	bool    holdout;
+};
+
+
+struct Image
+{
+	std::string path;
+	std::vector<gateModel::Region> boxes;
+};
+
+
+// <annotations>/<set>_img_file.txt and <set>_roi_file.txt, returns the images missing on disk
+static uint32_t loadSet( const std::string& root, const char* set, std::vector<Image>& images )
+{
+	const std::string imgList = root + "/" + set + "_img_file.txt";
+	const std::string roiList = root + "/" + set + "_roi_file.txt";
+
+	FILE* file = fopen(imgList.c_str(), "r");
+
+	if( !file )
+	{
+		printf("gate-train:  failed to open %s\n", imgList.c_str());
+		return 0;
+	}
+
+	std::map<int, size_t> index;
+	uint32_t missing = 0;
+	char line[1024];
+
+	while( fgets(line, sizeof(line), file) != NULL )
+	{
+		int  id = 0;
+		char path[512];
+
+		if( sscanf(line, "%i %511s", &id, path) != 2 )
+			continue;
+
+		Image image;
+		image.path = root + "/" + path;
+
+		if( access(image.path.c_str(), R_OK) != 0 )
+		{
+			printf("gate-train:  %s lists %s, which is missing\n", imgList.c_str(), image.path.c_str());
+			missing++;
+			continue;
+		}
+
+		index[id] = images.size();
+		images.push_back(image);
+	}
+
+	fclose(file);
+
+	if( !(file = fopen(roiList.c_str(), "r")) )
+	{
+		printf("gate-train:  failed to open %s\n", roiList.c_str());
+		return missing;
+	}
+
+	// <id> |roiAndLabel x1 y1 x2 y2 label [x1 y1 x2 y2 label ...]
+	while( fgets(line, sizeof(line), file) != NULL )
+	{
+		char* tag = strstr(line, "|roiAndLabel");
+		int id = 0;
+
+		if( !tag || sscanf(line, "%i", &id) != 1 || index.find(id) == index.end() )
+			continue;
+
+		char* p = tag + strlen("|roiAndLabel");
+		float x1, y1, x2, y2, label;
+		int n;
+
+		while( sscanf(p, "%f %f %f %f %f%n", &x1, &y1, &x2, &y2, &label, &n) == 5 )
+		{
+			gateModel::Region box = { (int)x1, (int)y1, (int)(x2 - x1), (int)(y2 - y1) };
+
+			if( label > 0.0f && box.width > 0 && box.height > 0 )
+				images[index[id]].boxes.push_back(box);
+
+			p += n;
+		}
+	}
+
+	fclose(file);
+	return missing;
+}
+
+
+static void loadNegatives( const std::string& directory, std::vector<Image>& images )
+{
+	DIR* dir = opendir(directory.c_str());
+
+	if( !dir )
+		return;
+
+	std::vector<std::string> found;
+	struct dirent* entry;
+
+	while( (entry = readdir(dir)) != NULL )
+	{
+		const char* ext = strrchr(entry->d_name, '.');
+
+		if( ext != NULL && (strcasecmp(ext, ".jpg") == 0 || strcasecmp(ext, ".png") == 0) )
+			found.push_back(directory + "/" + entry->d_name);
+	}
+
+	closedir(dir);
+	std::sort(found.begin(), found.end());
+
+	for( size_t n=0; n < found.size(); n++ )
+	{
+		Image image;
+		image.path = found[n];
+		images.push_back(image);
+	}
+}
+
+
+// video range BT.601 NV12, as the camera delivers it (even dimensions, stride = width)
+static void toNV12( const float4* rgba, int stride, int width, int height, std::vector<uint8_t>& nv12 )
+{
+	nv12.resize(width * height * 3 / 2);
+
+	uint8_t* luma   = nv12.data();
+	uint8_t* chroma = luma + width * height;
+
+	for( int y=0; y < height; y++ )
+	{
+		for( int x=0; x < width; x++ )
+		{
+			const float4 px = rgba[y * stride + x];
+			luma[y * width + x] = (uint8_t)std::min(std::max(16.0f + 0.257f * px.x + 0.504f * px.y + 0.098f * px.z + 0.5f, 0.0f), 255.0f);
+		}
+	}
+
+	// chroma of each 2x2 block
+	for( int y=0; y < height; y += 2 )
+	{
+		for( int x=0; x < width; x += 2 )
+		{
+			const float4 a = rgba[y * stride + x];
+			const float4 b = rgba[y * stride + x + 1];
+			const float4 c = rgba[(y + 1) * stride + x];
+			const float4 d = rgba[(y + 1) * stride + x + 1];
+
+			const float r = (a.x + b.x + c.x + d.x) * 0.25f;
+			const float g = (a.y + b.y + c.y + d.y) * 0.25f;
+			const float l = (a.z + b.z + c.z + d.z) * 0.25f;
+
+			uint8_t* uv = chroma + (y / 2) * width + x;
+
+			uv[0] = (uint8_t)std::min(std::max(128.0f - 0.148f * r - 0.291f * g + 0.439f * l + 0.5f, 0.0f), 255.0f);
+			uv[1] = (uint8_t)std::min(std::max(128.0f + 0.439f * r - 0.368f * g - 0.071f * l + 0.5f, 0.0f), 255.0f);
+		}
+	}
+}
+
+
+static bool overlaps( const gateModel::Region& a, const gateModel::Region& b )
+{
+	return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+
+// the crop skyProposals would make around a box
+static gateModel::Region padded( const gateModel::Region& box, int width, int height )
+{
+	const int side = std::min(std::max(std::max(box.width, box.height) * 2, 64), std::min(width, height));
+	const int x    = std::min(std::max(box.x + box.width / 2 - side / 2, 0), width - side);
+	const int y    = std::min(std::max(box.y + box.height / 2 - side / 2, 0), height - side);
+
+	const gateModel::Region region = { x, y, side, side };
+	return region;
+}
+
+
+int main( int argc, char** argv )
+{
+	commandLine cmdLine(argc, argv);
+
+	const std::string root = cmdLine.GetString("annotations") ? cmdLine.GetString("annotations") : DEFAULT_ANNOTATIONS;
+	const char* output     = cmdLine.GetString("output") ? cmdLine.GetString("output") : DEFAULT_OUTPUT;
+
+	const float targetRecall = cmdLine.GetFloat("recall", DEFAULT_RECALL);
+	const float background   = cmdLine.GetFloat("background", DEFAULT_BACKGROUND);
+	const float netMs        = cmdLine.GetFloat("net_ms", DEFAULT_NET_MS);
+	const int   crops        = cmdLine.GetInt("crops", DEFAULT_CROPS);
+
+	std::vector<Image> images;
+
+	uint32_t missing = 0;
+
+	missing += loadSet(root, "train", images);
+	missing += loadSet(root, "test", images);
+	loadNegatives(root + "/negative", images);
+
+	if( missing > 0 )
+		printf("gate-train:  %u annotated images are missing, train from an Annotations directory holding them (--annotations)\n", missing);
+
+
+	/*
+	 * features of the targets and of the background
+	 */
+	std::vector<Sample> samples;
+	unsigned int seed = 1;
+	double featureNs  = 0.0;
+	uint32_t loaded   = 0;
+	std::vector<uint8_t> nv12;
+
+	for( size_t n=0; n < images.size(); n++ )
+	{
+		float4* imgCPU  = NULL;
+		float4* imgCUDA = NULL;
+		int stride = 0, height = 0;
+
+		if( !loadImageRGBA(images[n].path.c_str(), &imgCPU, &imgCUDA, &stride, &height) )
+		{
+			printf("gate-train:  skipping %s\n", images[n].path.c_str());
+			continue;
+		}
+
+		const int width = stride & ~1;
+		height &= ~1;
+
+		toNV12(imgCPU, stride, width, height, nv12);
+		CUDA(cudaFreeHost(imgCPU));
+
+		const bool holdout = (loaded++ % 4) == 3;
+		const std::vector<gateModel::Region>& boxes = images[n].boxes;
+
+		std::vector<gateModel::Region> regions;
+		std::vector<uint8_t> labels;
+
+		const gateModel::Region frame = { 0, 0, width, height };
+
+		regions.push_back(frame);
+		labels.push_back(!boxes.empty());
+
+		for( size_t b=0; b < boxes.size(); b++ )
+		{
+			regions.push_back(boxes[b]);
+			labels.push_back(1);
+
+			regions.push_back(padded(boxes[b], width, height));
+			labels.push_back(1);
+		}
+
+		// background crops, the size of the crops around targets
+		for( int c=0, tries=0; c < crops && tries < crops * 10; tries++ )
+		{
+			const int side = std::min(64 << (rand_r(&seed) % 4), std::min(width, height));
+
+			const gateModel::Region crop = { (int)(rand_r(&seed) % (width - side + 1)), (int)(rand_r(&seed) % (height - side + 1)), side, side };
+
+			bool clear = true;
+
+			for( size_t b=0; b < boxes.size() && clear; b++ )
+				clear = !overlaps(crop, boxes[b]);
+
+			if( !clear )
+				continue;
+
+			regions.push_back(crop);
+			labels.push_back(0);
+			c++;
+		}
+
+		for( size_t r=0; r < regions.size(); r++ )
+		{
+			Sample sample;
+
+			const ARSAL_Time_Ns_t start = ARSAL_Time_GetMonotonicNs();
+			gateModel::Features(nv12.data(), gateModel::NV12, width, height, regions[r], sample.features);
+			featureNs += ARSAL_Time_GetMonotonicNs() - start;
+
+			sample.label   = labels[r];
+			sample.holdout = holdout;
+			samples.push_back(sample);
+		}
+	}
+
+	uint32_t numTargets = 0;
+
+	for( size_t n=0; n < samples.size(); n++ )
+		numTargets += samples[n].label;
+
+	if( numTargets == 0 || numTargets == samples.size() )
+	{
+		printf("gate-train:  no %s samples loaded from %s, nothing to train on\n", numTargets ? "background" : "target", root.c_str());
+		return 1;
+	}
+
+
+	/*
+	 * train on the images not held out
+	 */
+	std::vector<float>   trainFeatures;
+	std::vector<uint8_t> trainLabels;
+
+	uint32_t heldTargets = 0, heldBackground = 0;
+
+	for( size_t n=0; n < samples.size(); n++ )
+	{
+		if( samples[n].holdout )
+		{
+			heldTargets    += samples[n].label;
+			heldBackground += !samples[n].label;
+			continue;
+		}
+
+		trainFeatures.insert(trainFeatures.end(), samples[n].features, samples[n].features + GATE_NUM_FEATURES);
+		trainLabels.push_back(samples[n].label);
+	}
+
+	gateModel* model = gateModel::Train(trainFeatures.data(), trainLabels.data(), trainLabels.size());
+
+	if( !model )
+		return 1;
+
+	// report on the held out samples, or on everything when they lack a class
+	const bool useHoldout = (heldTargets > 0 && heldBackground > 0);
+
+	if( !useHoldout )
+		printf("gate-train:  warning, too few images to hold some out, reporting on the training samples\n");
+
+	std::vector<float>   scores;
+	std::vector<uint8_t> labels;
+
+	for( size_t n=0; n < samples.size(); n++ )
+	{
+		if( useHoldout && !samples[n].holdout )
+			continue;
+
+		const ARSAL_Time_Ns_t start = ARSAL_Time_GetMonotonicNs();
+		scores.push_back(model->Score(samples[n].features));
+		featureNs += ARSAL_Time_GetMonotonicNs() - start;
+
+		labels.push_back(samples[n].label);
+	}
+
+	const double gateMs = featureNs / samples.size() / 1000000.0;
+	const uint32_t targets = std::count(labels.begin(), labels.end(), 1);
+
+
+	/*
+	 * cost/recall trade-off: the full network runs on what passes the gate
+	 */
+	printf("\n%zu samples from %u images, %u targets / %zu evaluated%s\n", samples.size(), loaded, targets, labels.size(), useHoldout ? " (held out)" : "");
+	printf("gate %.4f ms, network %.2f ms, %.0f%% background\n\n", gateMs, netMs, background * 100.0f);
+	printf("threshold  target pass  background pass  cascade cost\n");
+
+	float chosen = 0.0f;
+
+	for( int t=1; t < 20; t++ )
+	{
+		const float threshold = t * 0.05f;
+		uint32_t passTarget = 0, passBackground = 0;
+
+		for( size_t n=0; n < scores.size(); n++ )
+		{
+			if( scores[n] >= threshold )
+				(labels[n] ? passTarget : passBackground)++;
+		}
+
+		const float recall  = (float)passTarget / targets;
+		const float bgPass  = (float)passBackground / (labels.size() - targets);
+		const float escalate = background * bgPass + (1.0f - background) * recall;
+		const float cost    = (gateMs + escalate * netMs) / netMs;
+
+		printf("   %.2f      %6.2f%%        %6.2f%%         %6.2f%%\n", threshold, recall * 100.0f, bgPass * 100.0f, cost * 100.0f);
+
+		if( recall >= targetRecall )
+			chosen = threshold;
+	}
+
+	if( chosen == 0.0f )
+	{
+		chosen = 0.05f;
+		printf("\ngate-train:  no threshold keeps %.0f%% recall, using %.2f\n", targetRecall * 100.0f, chosen);
+	}
+
+	printf("\ngate-train:  threshold %.2f, the highest keeping %.0f%% of the targets (cost is relative to the network alone)\n", chosen, targetRecall * 100.0f);
+
+	model->SetThreshold(chosen);
+
+	if( !model->Save(output) )
+		return 1;
+
+	printf("gate-train:  saved %s\n", output);
+
+	delete model;
+	return 0;
+}
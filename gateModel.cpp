@@ -0,0 +1,442 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "gateModel.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+
+#define LOG_GATE "[gate] "
+
+// samples averaged per patch pixel and axis, so large regions stay cheap
+#define GATE_SAMPLES 4
+
+
+/*
+ * pixel readers, returning Y, U and V (0 to 255)
+ */
+struct fetchNV12
+{
+	const uint8_t* luma;
+	const uint8_t* chroma;
+	uint32_t width;
+
+	inline void operator()( uint32_t x, uint32_t y, float& Y, float& U, float& V ) const
+	{
+		const uint8_t* uv = chroma + (y / 2) * width + (x & ~1u);
+
+		Y = luma[y * width + x];
+		U = uv[0];
+		V = uv[1];
+	}
+};
+
+static inline void rgbToYUV( float r, float g, float b, float& Y, float& U, float& V )
+{
+	Y =  0.299f * r + 0.587f * g + 0.114f * b;
+	U = -0.169f * r - 0.331f * g + 0.500f * b + 128.0f;
+	V =  0.500f * r - 0.419f * g - 0.081f * b + 128.0f;
+}
+
+struct fetchRGB8
+{
+	const uint8_t* rgb;
+	uint32_t width;
+
+	inline void operator()( uint32_t x, uint32_t y, float& Y, float& U, float& V ) const
+	{
+		const uint8_t* px = rgb + (y * width + x) * 3;
+		rgbToYUV(px[0], px[1], px[2], Y, U, V);
+	}
+};
+
+struct fetchRGBA32F
+{
+	const float* rgba;
+	uint32_t width;
+
+	inline void operator()( uint32_t x, uint32_t y, float& Y, float& U, float& V ) const
+	{
+		const float* px = rgba + (y * width + x) * 4;
+		rgbToYUV(px[0], px[1], px[2], Y, U, V);
+	}
+};
+
+
+// box filter the region down to the patch, a few samples per patch pixel
+template<typename Fetch>
+static void resample( const Fetch& fetch, uint32_t width, uint32_t height, const gateModel::Region& region,
+				  float* Y, float* U, float* V )
+{
+	const int x0 = std::min(std::max(region.x, 0), (int)width - 1);
+	const int y0 = std::min(std::max(region.y, 0), (int)height - 1);
+	const int x1 = std::max(std::min(region.x + region.width, (int)width), x0 + 1);
+	const int y1 = std::max(std::min(region.y + region.height, (int)height), y0 + 1);
+
+	const float cellWidth  = (float)(x1 - x0) / GATE_PATCH_SIZE;
+	const float cellHeight = (float)(y1 - y0) / GATE_PATCH_SIZE;
+
+	for( int py=0; py < GATE_PATCH_SIZE; py++ )
+	{
+		for( int px=0; px < GATE_PATCH_SIZE; px++ )
+		{
+			float sy = 0.0f, su = 0.0f, sv = 0.0f;
+
+			for( int j=0; j < GATE_SAMPLES; j++ )
+			{
+				const uint32_t y = std::min(y0 + (int)((py + (j + 0.5f) / GATE_SAMPLES) * cellHeight), y1 - 1);
+
+				for( int i=0; i < GATE_SAMPLES; i++ )
+				{
+					const uint32_t x = std::min(x0 + (int)((px + (i + 0.5f) / GATE_SAMPLES) * cellWidth), x1 - 1);
+
+					float fy, fu, fv;
+					fetch(x, y, fy, fu, fv);
+
+					sy += fy; su += fu; sv += fv;
+				}
+			}
+
+			const int n = py * GATE_PATCH_SIZE + px;
+			const float scale = 1.0f / (GATE_SAMPLES * GATE_SAMPLES);
+
+			Y[n] = sy * scale;
+			U[n] = su * scale;
+			V[n] = sv * scale;
+		}
+	}
+}
+
+
+// constructor
+gateModel::gateModel()
+{
+	for( int n=0; n < GATE_NUM_FEATURES; n++ )
+	{
+		mMean[n]    = 0.0f;
+		mScale[n]   = 1.0f;
+		mWeights[n] = 0.0f;
+	}
+
+	mBias      = 0.0f;
+	mThreshold = 0.5f;
+	mEvaluated = 0;
+	mPassed    = 0;
+}
+
+
+// destructor
+gateModel::~gateModel()
+{
+
+}
+
+
+// Features
+void gateModel::Features( const void* frame, Format format, uint32_t width, uint32_t height, const Region& region, float* features )
+{
+	const int size = GATE_PATCH_SIZE;
+
+	float Y[size * size];
+	float U[size * size];
+	float V[size * size];
+	float G[size * size];
+
+	if( format == NV12 )
+	{
+		const fetchNV12 fetch = { (const uint8_t*)frame, (const uint8_t*)frame + width * height, width };
+		resample(fetch, width, height, region, Y, U, V);
+	}
+	else if( format == RGB8 )
+	{
+		const fetchRGB8 fetch = { (const uint8_t*)frame, width };
+		resample(fetch, width, height, region, Y, U, V);
+	}
+	else
+	{
+		const fetchRGBA32F fetch = { (const float*)frame, width };
+		resample(fetch, width, height, region, Y, U, V);
+	}
+
+	// luma gradient, backward differences on the last row and column
+	for( int y=0; y < size; y++ )
+	{
+		for( int x=0; x < size; x++ )
+		{
+			const int n  = y * size + x;
+			const int dx = (x + 1 < size) ? 1 : -1;
+			const int dy = (y + 1 < size) ? size : -size;
+
+			G[n] = fabsf(Y[n + dx] - Y[n]) + fabsf(Y[n + dy] - Y[n]);
+		}
+	}
+
+	// 4x4 pooling
+	const int pool = size / 4;
+	float* f = features;
+
+	const float* planes[4] = { Y, G, U, V };
+
+	for( int p=0; p < 4; p++ )
+	{
+		for( int by=0; by < 4; by++ )
+		{
+			for( int bx=0; bx < 4; bx++ )
+			{
+				float sum = 0.0f;
+
+				for( int y=by * pool; y < (by + 1) * pool; y++ )
+					for( int x=bx * pool; x < (bx + 1) * pool; x++ )
+						sum += planes[p][y * size + x];
+
+				*f++ = sum / (pool * pool);
+			}
+		}
+	}
+
+	// a target is a compact blob: the center differs from the border
+	float mean = 0.0f, var = 0.0f;
+	float center[4] = { 0, 0, 0, 0 };
+	float border[4] = { 0, 0, 0, 0 };
+	int   numCenter = 0;
+
+	for( int y=0; y < size; y++ )
+	{
+		for( int x=0; x < size; x++ )
+		{
+			const int  n = y * size + x;
+			const bool c = (x >= size / 4 && x < size * 3 / 4 && y >= size / 4 && y < size * 3 / 4);
+
+			float* acc = c ? center : border;
+
+			acc[0] += Y[n];
+			acc[1] += U[n];
+			acc[2] += V[n];
+			acc[3] += G[n];
+
+			numCenter += c;
+			mean += Y[n];
+		}
+	}
+
+	mean /= size * size;
+
+	for( int n=0; n < size * size; n++ )
+		var += (Y[n] - mean) * (Y[n] - mean);
+
+	*f++ = sqrtf(var / (size * size));
+
+	for( int c=0; c < 4; c++ )
+		*f++ = center[c] / numCenter - border[c] / (size * size - numCenter);
+}
+
+
+// Score
+float gateModel::Score( const float* features ) const
+{
+	float sum = mBias;
+
+	for( int n=0; n < GATE_NUM_FEATURES; n++ )
+		sum += mWeights[n] * (features[n] - mMean[n]) * mScale[n];
+
+	return 1.0f / (1.0f + expf(-sum));
+}
+
+
+// Pass
+bool gateModel::Pass( const void* frame, Format format, uint32_t width, uint32_t height, const Region& region )
+{
+	float features[GATE_NUM_FEATURES];
+
+	Features(frame, format, width, height, region, features);
+
+	const bool pass = (Score(features) >= mThreshold);
+
+	mEvaluated++;
+	mPassed += pass;
+
+	return pass;
+}
+
+
+// Train
+gateModel* gateModel::Train( const float* features, const uint8_t* labels, uint32_t count, uint32_t iterations, float regularization )
+{
+	uint32_t positives = 0;
+
+	for( uint32_t n=0; labels != NULL && n < count; n++ )
+		positives += (labels[n] != 0);
+
+	if( !features || positives == 0 || positives == count )
+	{
+		printf(LOG_GATE "training needs both target and background samples\n");
+		return NULL;
+	}
+
+	gateModel* model = new gateModel();
+
+	// normalize the features to zero mean, unit variance
+	for( int k=0; k < GATE_NUM_FEATURES; k++ )
+	{
+		double sum = 0.0, sq = 0.0;
+
+		for( uint32_t n=0; n < count; n++ )
+		{
+			const double v = features[n * GATE_NUM_FEATURES + k];
+			sum += v;
+			sq  += v * v;
+		}
+
+		const double mean = sum / count;
+		const double var  = sq / count - mean * mean;
+
+		model->mMean[k]  = mean;
+		model->mScale[k] = 1.0 / sqrt(std::max(var, 1e-6));
+	}
+
+	// batch gradient descent on the class balanced logistic loss
+	const float weightPositive = 0.5f / positives;
+	const float weightNegative = 0.5f / (count - positives);
+	const float rate = 1.0f;
+
+	std::vector<float> x(count * GATE_NUM_FEATURES);
+
+	for( uint32_t n=0; n < count; n++ )
+		for( int k=0; k < GATE_NUM_FEATURES; k++ )
+			x[n * GATE_NUM_FEATURES + k] = (features[n * GATE_NUM_FEATURES + k] - model->mMean[k]) * model->mScale[k];
+
+	for( uint32_t it=0; it < iterations; it++ )
+	{
+		float gradient[GATE_NUM_FEATURES];
+		float gradientBias = 0.0f;
+
+		for( int k=0; k < GATE_NUM_FEATURES; k++ )
+			gradient[k] = regularization * model->mWeights[k];
+
+		for( uint32_t n=0; n < count; n++ )
+		{
+			const float* xn = &x[n * GATE_NUM_FEATURES];
+			float sum = model->mBias;
+
+			for( int k=0; k < GATE_NUM_FEATURES; k++ )
+				sum += model->mWeights[k] * xn[k];
+
+			const float p = 1.0f / (1.0f + expf(-sum));
+			const float e = (p - (labels[n] ? 1.0f : 0.0f)) * (labels[n] ? weightPositive : weightNegative);
+
+			for( int k=0; k < GATE_NUM_FEATURES; k++ )
+				gradient[k] += e * xn[k];
+
+			gradientBias += e;
+		}
+
+		for( int k=0; k < GATE_NUM_FEATURES; k++ )
+			model->mWeights[k] -= rate * gradient[k];
+
+		model->mBias -= rate * gradientBias;
+	}
+
+	printf(LOG_GATE "trained on %u samples (%u targets)\n", count, positives);
+	return model;
+}
+
+
+// Save
+bool gateModel::Save( const char* path ) const
+{
+	FILE* file = path ? fopen(path, "w") : NULL;
+
+	if( !file )
+	{
+		printf(LOG_GATE "failed to create %s\n", path ? path : "(null)");
+		return false;
+	}
+
+	fprintf(file, "gate %i %i\n", GATE_PATCH_SIZE, GATE_NUM_FEATURES);
+	fprintf(file, "threshold %.9g\n", mThreshold);
+	fprintf(file, "bias %.9g\n", mBias);
+
+	const char*  names[3]  = { "mean", "scale", "weights" };
+	const float* values[3] = { mMean, mScale, mWeights };
+
+	for( int v=0; v < 3; v++ )
+	{
+		fprintf(file, "%s", names[v]);
+
+		for( int n=0; n < GATE_NUM_FEATURES; n++ )
+			fprintf(file, " %.9g", values[v][n]);
+
+		fprintf(file, "\n");
+	}
+
+	const bool ok = (ferror(file) == 0);
+
+	fclose(file);
+	return ok;
+}
+
+
+// Create
+gateModel* gateModel::Create( const char* path )
+{
+	FILE* file = path ? fopen(path, "r") : NULL;
+
+	if( !file )
+	{
+		printf(LOG_GATE "failed to open %s\n", path ? path : "(null)");
+		return NULL;
+	}
+
+	gateModel* model = new gateModel();
+
+	int patch = 0, numFeatures = 0;
+	bool ok = (fscanf(file, " gate %i %i", &patch, &numFeatures) == 2 && patch == GATE_PATCH_SIZE && numFeatures == GATE_NUM_FEATURES)
+		   && fscanf(file, " threshold %f", &model->mThreshold) == 1
+		   && fscanf(file, " bias %f", &model->mBias) == 1;
+
+	const char* names[3]  = { "mean", "scale", "weights" };
+	float*      values[3] = { model->mMean, model->mScale, model->mWeights };
+
+	for( int v=0; v < 3 && ok; v++ )
+	{
+		char name[16];
+		ok = (fscanf(file, " %15s", name) == 1 && strcmp(name, names[v]) == 0);
+
+		for( int n=0; n < GATE_NUM_FEATURES && ok; n++ )
+			ok = (fscanf(file, " %f", &values[v][n]) == 1);
+	}
+
+	fclose(file);
+
+	if( !ok )
+	{
+		printf(LOG_GATE "%s is not a gate model with %i features\n", path, GATE_NUM_FEATURES);
+		delete model;
+		return NULL;
+	}
+
+	printf(LOG_GATE "loaded %s, threshold %.3f\n", path, model->mThreshold);
+	return model;
+}
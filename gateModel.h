@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __GATE_MODEL_H__
+#define __GATE_MODEL_H__
+
+
+#include "tiledNet.h"
+
+#include <vector>
+
+
+/**
+ * Side of the patch a region is resampled to before the features are computed
+ */
+#define GATE_PATCH_SIZE 16
+
+/**
+ * Number of features: Y, gradient, U and V pooled on a 4x4 grid, plus
+ * the contrast statistics of the patch
+ */
+#define GATE_NUM_FEATURES (4 * 16 + 5)
+
+
+/**
+ * Cheap first stage of a classifier cascade.
+ *
+ * A logistic regression on pooled color and gradient features of a small
+ * resampled patch, evaluated on the CPU in a few microseconds. It only has
+ * to reject the obvious background (uniform sky, flat regions) so that the
+ * full network runs on the frames and crops which may hold a target; the
+ * threshold trades the recall of the cascade against the network cost.
+ *
+ * Models are trained from the Annotations with gate-train.
+ */
+class gateModel
+{
+public:
+	/**
+	 * Layout of the frame
+	 */
+	enum Format
+	{
+		NV12,		/**< Y plane then interleaved UV plane, stride = width (CPU memory) */
+		RGB8,		/**< Packed 8 bits RGB (CPU memory) */
+		RGBA32F		/**< float4 RGBA, 0 to 255 (CPU or mapped memory) */
+	};
+
+	typedef tiledNet::Region Region;
+
+	/**
+	 * Load a model saved by Save()
+	 */
+	static gateModel* Create( const char* path );
+
+	/**
+	 * Train a model on labelled feature vectors, see Features().
+	 * @param features count * GATE_NUM_FEATURES values
+	 * @param labels count labels, non-zero for a target
+	 */
+	static gateModel* Train( const float* features, const uint8_t* labels, uint32_t count,
+						uint32_t iterations=2000, float regularization=0.001f );
+
+	/**
+	 * Destroy
+	 */
+	~gateModel();
+
+	/**
+	 * Save the model, with its threshold
+	 */
+	bool Save( const char* path ) const;
+
+	/**
+	 * Compute the features of a region of a frame.
+	 * @param features array of GATE_NUM_FEATURES values
+	 */
+	static void Features( const void* frame, Format format, uint32_t width, uint32_t height, const Region& region, float* features );
+
+	/**
+	 * Probability that the features are those of a target
+	 */
+	float Score( const float* features ) const;
+
+	/**
+	 * Score a region of a frame and count it in the pass rate.
+	 * @returns true if the region should go to the full network
+	 */
+	bool Pass( const void* frame, Format format, uint32_t width, uint32_t height, const Region& region );
+
+	/**
+	 * Score above which a region goes to the full network
+	 */
+	inline void  SetThreshold( float threshold )		{ mThreshold = threshold; }
+	inline float GetThreshold() const			{ return mThreshold; }
+
+	/**
+	 * Regions scored by Pass(), and how many passed
+	 */
+	inline uint64_t GetNumEvaluated() const		{ return mEvaluated; }
+	inline uint64_t GetNumPassed() const			{ return mPassed; }
+	inline float    GetPassRate() const			{ return mEvaluated ? (float)mPassed / mEvaluated : 0.0f; }
+
+protected:
+	gateModel();
+
+	float mMean[GATE_NUM_FEATURES];		// feature normalization
+	float mScale[GATE_NUM_FEATURES];
+	float mWeights[GATE_NUM_FEATURES];
+	float mBias;
+	float mThreshold;
+
+	uint64_t mEvaluated;
+	uint64_t mPassed;
+};
+
+
+#endif
@@ -0,0 +1,449 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "int8Calibrator.h"
+#include "cudaMappedMemory.h"
+#include "commandLine.h"
+#include "imageNet.h"
+
+#include "NvCaffeParser.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <libARSAL/ARSAL_Time.h>
+}
+
+
+#define DEFAULT_ENGINE_BATCH 2	// imageNet::Create() default; use --max_batch=<tiles> for tiledNet
+#define DEFAULT_CALIBRATION_BATCH 8
+#define DEFAULT_HOLDOUT 5	// without --eval, one image in 5 is kept out of the calibration to evaluate on
+#define WORKSPACE_SIZE (16 << 20)
+
+
+/*
+ * Post-training INT8 quantization of an imageNet model.
+ *
+ * Builds the FP32 engine and an INT8 engine calibrated on the Annotations
+ * images, writes the INT8 engine next to the FP32 engine cache of tensorNet
+ * (<model>.<max batch>.int8.tensorcache, which tensorNet never picks up on
+ * its own), and reports how far the INT8 results are from FP32 on images
+ * the calibration did not see: the --eval directories, or else one image in
+ * --holdout of the --images ones. The INT8 engine is then loaded explicitly
+ * through a pack: model-pack --precision=INT8, then --pack=<model>.pack.
+ *
+ * int8-calibrate --prototxt=<deploy> --model=<caffemodel> --labels=<labels>
+ *                [--input_blob=data] [--output_blob=prob] [--max_batch=2]
+ *                [--images=<dirs>] [--eval=<dirs> | --holdout=5] [--batch_size=8]
+ *                [--cache=<model>.calibration] [--engine=<path>]
+ *                [--report=<file>] [--recalibrate]
+ */
+
+
+class Logger : public nvinfer1::ILogger
+{
+	void log( Severity severity, const char* msg )
+	{
+		if( severity != Severity::kINFO )
+			printf("[TRT] %s\n", msg);
+	}
+} gLogger;
+
+
+// parse the caffe model and build an engine, in INT8 when a calibrator is given
+static nvinfer1::ICudaEngine* buildEngine( const char* prototxt, const char* model, const char* output,
+								   uint32_t maxBatchSize, int8Calibrator* calibrator )
+{
+	nvinfer1::IBuilder* builder = nvinfer1::createInferBuilder(gLogger);
+	nvinfer1::INetworkDefinition* network = builder->createNetwork();
+	nvcaffeparser1::ICaffeParser* parser = nvcaffeparser1::createCaffeParser();
+
+	nvinfer1::ICudaEngine* engine = NULL;
+	const nvcaffeparser1::IBlobNameToTensor* blobs = parser->parse(prototxt, model, *network, nvinfer1::DataType::kFLOAT);
+
+	if( !blobs || !blobs->find(output) )
+	{
+		printf("int8-calibrate:  failed to parse %s, or no output blob '%s'\n", model, output);
+		goto cleanup;
+	}
+
+	network->markOutput(*blobs->find(output));
+
+	builder->setMaxBatchSize(maxBatchSize);
+	builder->setMaxWorkspaceSize(WORKSPACE_SIZE);
+
+	if( calibrator != NULL )
+	{
+		if( !builder->platformHasFastInt8() )
+			printf("int8-calibrate:  warning, this GPU has no fast INT8 path, the engine may be slower than FP32\n");
+
+		builder->setInt8Mode(true);
+		builder->setInt8Calibrator(calibrator);
+	}
+
+	engine = builder->buildCudaEngine(*network);
+
+	if( !engine )
+		printf("int8-calibrate:  failed to build the %s engine\n", calibrator ? "INT8" : "FP32");
+
+cleanup:
+	parser->destroy();
+	network->destroy();
+	builder->destroy();
+
+	return engine;
+}
+
+
+/*
+ * engine with its bindings, run on one input at a time
+ */
+struct Runner
+{
+	nvinfer1::ICudaEngine*       engine;
+	nvinfer1::IExecutionContext* context;
+	void*    bindings[2];
+	float*   outputCPU;
+	uint32_t numClasses;
+	double   totalMs;
+};
+
+
+static bool initRunner( Runner& runner, nvinfer1::ICudaEngine* engine, const char* input, const char* output, float* inputCUDA )
+{
+	memset(&runner, 0, sizeof(Runner));
+
+	const int inputIndex  = engine->getBindingIndex(input);
+	const int outputIndex = engine->getBindingIndex(output);
+
+	if( engine->getNbBindings() != 2 || inputIndex < 0 || outputIndex < 0 )
+	{
+		printf("int8-calibrate:  expected the bindings '%s' and '%s'\n", input, output);
+		return false;
+	}
+
+	const nvinfer1::Dims dims = engine->getBindingDimensions(outputIndex);
+
+	runner.numClasses = 1;
+
+	for( int n=0; n < dims.nbDims; n++ )
+		runner.numClasses *= dims.d[n];
+
+	void* outputCUDA = NULL;
+
+	if( !cudaAllocMapped((void**)&runner.outputCPU, &outputCUDA, runner.numClasses * sizeof(float)) )
+		return false;
+
+	runner.engine  = engine;
+	runner.context = engine->createExecutionContext();
+	runner.bindings[inputIndex]  = inputCUDA;
+	runner.bindings[outputIndex] = outputCUDA;
+
+	return runner.context != NULL;
+}
+
+
+static int runClassify( Runner& runner, float* confidence )
+{
+	const ARSAL_Time_Ns_t start = ARSAL_Time_GetMonotonicNs();
+
+	if( !runner.context->execute(1, runner.bindings) )
+		return -1;
+
+	runner.totalMs += (ARSAL_Time_GetMonotonicNs() - start) / 1000000.0;
+
+	int best = 0;
+
+	for( uint32_t n=1; n < runner.numClasses; n++ )
+	{
+		if( runner.outputCPU[n] > runner.outputCPU[best] )
+			best = n;
+	}
+
+	*confidence = runner.outputCPU[best];
+	return best;
+}
+
+
+static void loadLabels( const char* path, std::vector<std::string>& labels )
+{
+	FILE* file = path ? fopen(path, "r") : NULL;
+
+	if( !file )
+		return;
+
+	char line[512];
+
+	while( fgets(line, sizeof(line), file) != NULL )
+	{
+		line[strcspn(line, "\r\n")] = 0;
+		labels.push_back(line);
+	}
+
+	fclose(file);
+}
+
+
+// print to the console and to the report file
+static FILE* reportFile = NULL;
+
+#define REPORT(...) do { printf(__VA_ARGS__); if( reportFile ) fprintf(reportFile, __VA_ARGS__); } while(0)
+
+
+int main( int argc, char** argv )
+{
+	commandLine cmdLine(argc, argv);
+
+	const char* prototxt = cmdLine.GetString("prototxt");
+	const char* model    = cmdLine.GetString("model");
+	const char* input    = cmdLine.GetString("input_blob");
+	const char* output   = cmdLine.GetString("output_blob");
+	const char* images   = cmdLine.GetString("images");
+	const char* eval     = cmdLine.GetString("eval");
+
+	if( !prototxt || !model )
+	{
+		printf("int8-calibrate:  --prototxt and --model are required\n");
+		return 1;
+	}
+
+	if( !input )  input  = IMAGENET_DEFAULT_INPUT;
+	if( !output ) output = IMAGENET_DEFAULT_OUTPUT;
+	if( !images ) images = INT8_DEFAULT_IMAGES;
+
+	int maxBatch  = cmdLine.GetInt("max_batch", DEFAULT_ENGINE_BATCH);
+	int batchSize = cmdLine.GetInt("batch_size", DEFAULT_CALIBRATION_BATCH);
+	int holdout   = cmdLine.GetInt("holdout", DEFAULT_HOLDOUT);
+
+	if( maxBatch < 1 )  maxBatch  = DEFAULT_ENGINE_BATCH;
+	if( batchSize < 1 ) batchSize = DEFAULT_CALIBRATION_BATCH;
+	if( holdout < 2 )   holdout   = DEFAULT_HOLDOUT;
+
+	const std::string cache  = cmdLine.GetString("cache") ? cmdLine.GetString("cache") : std::string(model) + ".calibration";
+	const std::string engine = cmdLine.GetString("engine") ? cmdLine.GetString("engine") : std::string(model) + "." + std::to_string(maxBatch) + ".int8.tensorcache";
+
+
+	/*
+	 * calibration and evaluation sets, disjoint: scoring on the images the
+	 * scales were fitted to hides the quantization error
+	 */
+	std::vector<std::string> calibImages;
+	std::vector<std::string> evalImages;
+
+	if( !int8Calibrator::ListImages(images, calibImages) )
+		return 1;
+
+	if( eval != NULL )
+	{
+		if( !int8Calibrator::ListImages(eval, evalImages) )
+			return 1;
+
+		const std::set<std::string> calibSet(calibImages.begin(), calibImages.end());
+
+		for( size_t n=0; n < evalImages.size(); n++ )
+		{
+			if( calibSet.count(evalImages[n]) > 0 )
+			{
+				printf("int8-calibrate:  %s is in both --images and --eval, the sets must be disjoint\n", evalImages[n].c_str());
+				return 1;
+			}
+		}
+	}
+	else
+	{
+		std::vector<std::string> kept;
+
+		for( size_t n=0; n < calibImages.size(); n++ )
+			(n % holdout == (size_t)holdout - 1 ? evalImages : kept).push_back(calibImages[n]);
+
+		calibImages.swap(kept);
+		printf("int8-calibrate:  no --eval, %zu of the images held out for the evaluation\n", evalImages.size());
+	}
+
+	if( calibImages.empty() || evalImages.empty() )
+	{
+		printf("int8-calibrate:  %zu calibration and %zu evaluation images, both sets are needed\n", calibImages.size(), evalImages.size());
+		return 1;
+	}
+
+
+	/*
+	 * FP32 reference engine, which also gives the input geometry
+	 */
+	nvinfer1::ICudaEngine* fp32 = buildEngine(prototxt, model, output, maxBatch, NULL);
+
+	if( !fp32 )
+		return 1;
+
+	const int inputIndex = fp32->getBindingIndex(input);
+
+	if( inputIndex < 0 )
+	{
+		printf("int8-calibrate:  no input blob '%s'\n", input);
+		return 1;
+	}
+
+	const nvinfer1::Dims inputDims = fp32->getBindingDimensions(inputIndex);
+
+	if( inputDims.nbDims != 3 || inputDims.d[0] != 3 )
+	{
+		printf("int8-calibrate:  expected a 3 channels CHW input\n");
+		return 1;
+	}
+
+	const uint32_t width  = inputDims.d[2];
+	const uint32_t height = inputDims.d[1];
+
+
+	/*
+	 * calibrate and build the INT8 engine
+	 */
+	int8Calibrator* calibrator = int8Calibrator::Create(calibImages, batchSize, width, height, cache.c_str());
+
+	if( !calibrator )
+		return 1;
+
+	calibrator->SetRecalibrate(cmdLine.GetFlag("recalibrate"));
+
+	nvinfer1::ICudaEngine* int8 = buildEngine(prototxt, model, output, maxBatch, calibrator);
+
+	if( !int8 )
+		return 1;
+
+	nvinfer1::IHostMemory* serialized = int8->serialize();
+	FILE* engineFile = fopen(engine.c_str(), "wb");
+
+	if( !serialized || !engineFile || fwrite(serialized->data(), 1, serialized->size(), engineFile) != serialized->size() )
+	{
+		printf("int8-calibrate:  failed to write the INT8 engine to %s\n", engine.c_str());
+		return 1;
+	}
+
+	fclose(engineFile);
+	serialized->destroy();
+
+	printf("int8-calibrate:  INT8 engine written to %s, pack it with model-pack --precision=INT8 --max_batch=%i to load it\n", engine.c_str(), maxBatch);
+
+
+	/*
+	 * accuracy delta against FP32
+	 */
+	std::vector<std::string> labels;
+
+	loadLabels(cmdLine.GetString("labels"), labels);
+
+	float* inputCUDA = NULL;
+
+	if( CUDA_FAILED(cudaMalloc((void**)&inputCUDA, 3 * width * height * sizeof(float))) )
+		return 1;
+
+	Runner ref, quant;
+
+	if( !initRunner(ref, fp32, input, output, inputCUDA) || !initRunner(quant, int8, input, output, inputCUDA) )
+		return 1;
+
+	const uint32_t numClasses = ref.numClasses;
+
+	std::vector<uint32_t> refCount(numClasses, 0);
+	std::vector<uint32_t> quantCount(numClasses, 0);
+	std::vector<uint32_t> flips(numClasses, 0);
+
+	uint32_t evaluated = 0, agree = 0;
+	double sumDelta = 0.0, maxDelta = 0.0, sumL1 = 0.0;
+
+	if( cmdLine.GetString("report") != NULL )
+		reportFile = fopen(cmdLine.GetString("report"), "w");
+
+	REPORT("image\tfp32\tconfidence\tint8\tconfidence\n");
+
+	for( size_t n=0; n < evalImages.size(); n++ )
+	{
+		if( !calibrator->Preprocess(evalImages[n].c_str(), inputCUDA) )
+			continue;
+
+		float refConfidence = 0.0f, quantConfidence = 0.0f;
+
+		const int refClass   = runClassify(ref, &refConfidence);
+		const int quantClass = runClassify(quant, &quantConfidence);
+
+		if( refClass < 0 || quantClass < 0 )
+		{
+			printf("int8-calibrate:  failed to execute %s\n", evalImages[n].c_str());
+			continue;
+		}
+
+		evaluated++;
+		refCount[refClass]++;
+		quantCount[quantClass]++;
+
+		if( refClass == quantClass )
+			agree++;
+		else
+			flips[refClass]++;
+
+		// confidence delta on the FP32 answer, and over the whole distribution
+		const double delta = fabs(ref.outputCPU[refClass] - quant.outputCPU[refClass]);
+
+		sumDelta += delta;
+		maxDelta  = std::max(maxDelta, delta);
+
+		for( uint32_t c=0; c < numClasses; c++ )
+			sumL1 += fabs(ref.outputCPU[c] - quant.outputCPU[c]);
+
+		REPORT("%s\t%i\t%.4f\t%i\t%.4f%s\n", evalImages[n].c_str(), refClass, refConfidence, quantClass, quantConfidence,
+			  refClass != quantClass ? "\tFLIP" : "");
+	}
+
+	if( evaluated == 0 )
+	{
+		printf("int8-calibrate:  no image could be evaluated\n");
+		return 1;
+	}
+
+	REPORT("\n%u images, calibrated on %u\n", evaluated, calibrator->GetNumCalibrated());
+	REPORT("top-1 agreement    %6.2f%%\n", 100.0 * agree / evaluated);
+	REPORT("confidence delta   mean %.4f  max %.4f\n", sumDelta / evaluated, maxDelta);
+	REPORT("distribution L1    mean %.4f\n", sumL1 / evaluated);
+	REPORT("latency (batch 1)  fp32 %.3f ms  int8 %.3f ms\n", ref.totalMs / evaluated, quant.totalMs / evaluated);
+	REPORT("\nclass\tfp32\tint8\tflipped\n");
+
+	for( uint32_t c=0; c < numClasses; c++ )
+		REPORT("%s\t%u\t%u\t%u\n", c < labels.size() ? labels[c].c_str() : std::to_string(c).c_str(), refCount[c], quantCount[c], flips[c]);
+
+	if( reportFile != NULL )
+		fclose(reportFile);
+
+	ref.context->destroy();
+	quant.context->destroy();
+	fp32->destroy();
+	int8->destroy();
+	delete calibrator;
+
+	nvcaffeparser1::shutdownProtobufLibrary();
+	return 0;
+}
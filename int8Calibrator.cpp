@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "int8Calibrator.h"
+#include "cudaTiles.h"
+#include "cudaMappedMemory.h"
+#include "loadImage.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <dirent.h>
+#include <algorithm>
+
+
+#define LOG_INT8 "[int8] "
+
+
+// constructor
+int8Calibrator::int8Calibrator()
+{
+	mBatchCUDA     = NULL;
+	mRegionCPU     = NULL;
+	mRegionCUDA    = NULL;
+	mBatchSize     = 0;
+	mWidth         = 0;
+	mHeight        = 0;
+	mNext          = 0;
+	mNumCalibrated = 0;
+	mRecalibrate   = false;
+}
+
+
+// destructor
+int8Calibrator::~int8Calibrator()
+{
+	if( mBatchCUDA != NULL )
+	{
+		CUDA(cudaFree(mBatchCUDA));
+		mBatchCUDA = NULL;
+	}
+
+	if( mRegionCPU != NULL )
+	{
+		CUDA(cudaFreeHost(mRegionCPU));
+		mRegionCPU = NULL;
+	}
+}
+
+
+// Create
+int8Calibrator* int8Calibrator::Create( const std::vector<std::string>& images, uint32_t batchSize,
+								uint32_t width, uint32_t height, const char* cache )
+{
+	if( batchSize == 0 || width == 0 || height == 0 || !cache )
+		return NULL;
+
+	int8Calibrator* calib = new int8Calibrator();
+
+	calib->mImages    = images;
+	calib->mCachePath = cache;
+	calib->mBatchSize = batchSize;
+	calib->mWidth     = width;
+	calib->mHeight    = height;
+
+	if( CUDA_FAILED(cudaMalloc((void**)&calib->mBatchCUDA, batchSize * 3 * width * height * sizeof(float))) )
+	{
+		printf(LOG_INT8 "failed to allocate a batch of %u inputs\n", batchSize);
+		delete calib;
+		return NULL;
+	}
+
+	// the whole image is the one region of cudaPreTilesMean()
+	if( !cudaAllocMapped((void**)&calib->mRegionCPU, (void**)&calib->mRegionCUDA, sizeof(int4)) )
+	{
+		delete calib;
+		return NULL;
+	}
+
+	printf(LOG_INT8 "%zu calibration images, batches of %u, cache %s\n", images.size(), batchSize, cache);
+	return calib;
+}
+
+
+// ListImages
+bool int8Calibrator::ListImages( const char* directories, std::vector<std::string>& images )
+{
+	if( !directories )
+		return false;
+
+	std::string list(directories);
+	size_t begin = 0;
+
+	while( begin <= list.size() )
+	{
+		size_t end = list.find(',', begin);
+
+		if( end == std::string::npos )
+			end = list.size();
+
+		const std::string directory = list.substr(begin, end - begin);
+		begin = end + 1;
+
+		if( directory.empty() )
+			continue;
+
+		DIR* dir = opendir(directory.c_str());
+
+		if( !dir )
+		{
+			printf(LOG_INT8 "failed to open %s\n", directory.c_str());
+			return false;
+		}
+
+		std::vector<std::string> found;
+		struct dirent* entry;
+
+		while( (entry = readdir(dir)) != NULL )
+		{
+			const char* ext = strrchr(entry->d_name, '.');
+
+			if( ext != NULL && (strcasecmp(ext, ".jpg") == 0 || strcasecmp(ext, ".jpeg") == 0 || strcasecmp(ext, ".png") == 0) )
+				found.push_back(directory + "/" + entry->d_name);
+		}
+
+		closedir(dir);
+
+		std::sort(found.begin(), found.end());
+		images.insert(images.end(), found.begin(), found.end());
+	}
+
+	return true;
+}
+
+
+// Preprocess
+bool int8Calibrator::Preprocess( const char* path, float* output )
+{
+	float4* imgCPU  = NULL;
+	float4* imgCUDA = NULL;
+	int     width   = 0;
+	int     height  = 0;
+
+	if( !loadImageRGBA(path, &imgCPU, &imgCUDA, &width, &height) )
+	{
+		printf(LOG_INT8 "failed to load %s\n", path);
+		return false;
+	}
+
+	*mRegionCPU = make_int4(0, 0, width, height);
+
+	// same mean as imageNet::Classify()
+	const bool ok = !CUDA_FAILED(cudaPreTilesMean(imgCUDA, width, height, mRegionCUDA, 1, output, mWidth, mHeight,
+									      make_float3(104.0069879317889f, 116.6687676607272f, 122.6789143406786f)))
+				 && !CUDA_FAILED(cudaDeviceSynchronize());
+
+	CUDA(cudaFreeHost(imgCPU));
+	return ok;
+}
+
+
+// getBatchSize
+int int8Calibrator::getBatchSize() const
+{
+	return mBatchSize;
+}
+
+
+// getBatch
+bool int8Calibrator::getBatch( void* bindings[], const char* names[], int nbBindings )
+{
+	if( nbBindings != 1 )
+	{
+		printf(LOG_INT8 "networks with %i inputs are not supported\n", nbBindings);
+		return false;
+	}
+
+	const size_t inputSize = 3 * mWidth * mHeight;
+	uint32_t count = 0;
+
+	// unreadable images are skipped, a partial last batch is dropped
+	while( count < mBatchSize && mNext < mImages.size() )
+	{
+		if( Preprocess(mImages[mNext].c_str(), mBatchCUDA + count * inputSize) )
+			count++;
+
+		mNext++;
+	}
+
+	if( count < mBatchSize )
+		return false;
+
+	mNumCalibrated += count;
+	printf(LOG_INT8 "calibrating %u/%zu\n", mNext, mImages.size());
+
+	bindings[0] = mBatchCUDA;
+	return true;
+}
+
+
+// readCalibrationCache
+const void* int8Calibrator::readCalibrationCache( size_t& length )
+{
+	length = 0;
+	mCache.clear();
+
+	if( mRecalibrate )
+		return NULL;
+
+	FILE* file = fopen(mCachePath.c_str(), "rb");
+
+	if( !file )
+		return NULL;
+
+	char buffer[4096];
+	size_t n;
+
+	while( (n = fread(buffer, 1, sizeof(buffer), file)) > 0 )
+		mCache.insert(mCache.end(), buffer, buffer + n);
+
+	fclose(file);
+
+	if( mCache.empty() )
+		return NULL;
+
+	printf(LOG_INT8 "using calibration cache %s\n", mCachePath.c_str());
+
+	length = mCache.size();
+	return &mCache[0];
+}
+
+
+// writeCalibrationCache
+void int8Calibrator::writeCalibrationCache( const void* cache, size_t length )
+{
+	FILE* file = fopen(mCachePath.c_str(), "wb");
+
+	if( !file || fwrite(cache, 1, length, file) != length )
+		printf(LOG_INT8 "failed to write calibration cache %s\n", mCachePath.c_str());
+	else
+		printf(LOG_INT8 "wrote calibration cache %s (%zu bytes)\n", mCachePath.c_str(), length);
+
+	if( file != NULL )
+		fclose(file);
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __INT8_CALIBRATOR_H__
+#define __INT8_CALIBRATOR_H__
+
+
+#include "cudaUtility.h"
+#include "NvInfer.h"
+
+#include <string>
+#include <vector>
+
+
+/**
+ * Images of the default calibration set, comma separated directories
+ */
+#define INT8_DEFAULT_IMAGES "Annotations/negative,Annotations/testImages"
+
+
+/**
+ * Post-training INT8 calibration for TensorRT.
+ *
+ * Feeds a set of images, preprocessed exactly like imageNet::Classify()
+ * (rescaled to the network input, planar BGR minus the mean), to the
+ * TensorRT builder which measures the activation ranges and picks the
+ * INT8 scales minimizing the information loss. The resulting table is
+ * saved to a calibration cache and reused by the next builds, so the
+ * images are only read once per model.
+ */
+class int8Calibrator : public nvinfer1::IInt8EntropyCalibrator
+{
+public:
+	/**
+	 * Create a calibrator for a network input of width x height.
+	 * @param images image paths, see ListImages()
+	 * @param cache path of the calibration cache, read if it exists, written after calibration
+	 */
+	static int8Calibrator* Create( const std::vector<std::string>& images, uint32_t batchSize,
+							 uint32_t width, uint32_t height, const char* cache );
+
+	/**
+	 * Destroy
+	 */
+	virtual ~int8Calibrator();
+
+	/**
+	 * Append the jpg and png images of comma separated directories, sorted by name.
+	 * @returns false if a directory could not be read
+	 */
+	static bool ListImages( const char* directories, std::vector<std::string>& images );
+
+	/**
+	 * Load an image and preprocess it into one network input.
+	 * @param output device buffer of 3 * width * height floats
+	 */
+	bool Preprocess( const char* path, float* output );
+
+	/**
+	 * Ignore the calibration cache and calibrate from the images again
+	 */
+	inline void SetRecalibrate( bool recalibrate )		{ mRecalibrate = recalibrate; }
+
+	/**
+	 * Number of images which went to the builder
+	 */
+	inline uint32_t GetNumCalibrated() const			{ return mNumCalibrated; }
+
+	// IInt8EntropyCalibrator
+	virtual int getBatchSize() const;
+	virtual bool getBatch( void* bindings[], const char* names[], int nbBindings );
+	virtual const void* readCalibrationCache( size_t& length );
+	virtual void writeCalibrationCache( const void* cache, size_t length );
+
+protected:
+	int8Calibrator();
+
+	std::vector<std::string> mImages;
+	std::vector<char>        mCache;
+	std::string              mCachePath;
+
+	float*   mBatchCUDA;
+	int4*    mRegionCPU;
+	int4*    mRegionCUDA;
+
+	uint32_t mBatchSize;
+	uint32_t mWidth;
+	uint32_t mHeight;
+	uint32_t mNext;
+	uint32_t mNumCalibrated;
+	bool     mRecalibrate;
+};
+
+
+#endif
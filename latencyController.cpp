@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "latencyController.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+
+#define LOG_SLO "[slo] "
+
+
+/*
+ * quality levels, best first: the cheap knobs go first, the stream
+ * settings of the drone last since they take a while to apply
+ */
+static const latencyController::Level defaultLevels[] =
+{
+	//  scale  tiles  cadence  stream mode                                               fps
+	{ 1.00f, 1.0f,  1,       latencyController::STREAM_LOW_LATENCY,                    30 },
+	{ 1.00f, 0.5f,  1,       latencyController::STREAM_LOW_LATENCY,                    30 },
+	{ 0.75f, 0.5f,  1,       latencyController::STREAM_LOW_LATENCY,                    30 },
+	{ 0.50f, 0.0f,  1,       latencyController::STREAM_LOW_LATENCY,                    30 },
+	{ 0.50f, 0.0f,  2,       latencyController::STREAM_LOW_LATENCY,                    24 },
+	{ 0.50f, 0.0f,  3,       latencyController::STREAM_HIGH_RELIABILITY_LOW_FRAMERATE, 24 },
+};
+
+static const char* streamModeNames[] = { "low latency", "high reliability", "high reliability low framerate" };
+
+
+// constructor
+latencyController::latencyController()
+{
+	mLevel           = 0;
+	mSLO             = 0;
+	mTileBudget      = 2;
+	mHeadroom        = 0.6f;
+	mUpWindows       = 3;
+	mWindow          = LATENCY_DEFAULT_WINDOW;
+	mHeadroomWindows = 0;
+	mFrames          = 0;
+	mViolations      = 0;
+	mWindows         = 0;
+	mStreamMode      = STREAM_LOW_LATENCY;
+	mFramerate       = 30;
+}
+
+
+// destructor
+latencyController::~latencyController()
+{
+
+}
+
+
+// Create
+latencyController* latencyController::Create( float sloMs, uint32_t tileBudget, const char* streamSocket )
+{
+	if( sloMs <= 0.0f )
+		return NULL;
+
+	latencyController* ctrl = new latencyController();
+
+	ctrl->mLevels.assign(defaultLevels, defaultLevels + sizeof(defaultLevels) / sizeof(defaultLevels[0]));
+	ctrl->mSLO        = (ARSAL_Time_Ns_t)(sloMs * 1000000.0f);
+	ctrl->mTileBudget = tileBudget;
+
+	if( streamSocket != NULL )
+		ctrl->mStreamSocket = streamSocket;
+
+	ctrl->mAges.reserve(ctrl->mWindow);
+
+	printf(LOG_SLO "%.1f ms latency objective, %zu quality levels%s%s\n", sloMs, ctrl->mLevels.size(),
+		  streamSocket ? ", stream settings sent to " : "", streamSocket ? streamSocket : "");
+
+	return ctrl;
+}
+
+
+// GetTileBudget
+uint32_t latencyController::GetTileBudget() const
+{
+	const uint32_t budget = (uint32_t)(mTileBudget * mLevels[mLevel].tiles + 0.5f);
+	return budget < 2 ? 2 : budget;
+}
+
+
+// Admit
+bool latencyController::Admit()
+{
+	return (mFrames++ % mLevels[mLevel].cadence) == 0;
+}
+
+
+// Update
+void latencyController::Update( ARSAL_Time_Ns_t age )
+{
+	mAges.push_back(age / 1000000.0f);
+
+	if( mAges.size() < mWindow )
+		return;
+
+	std::sort(mAges.begin(), mAges.end());
+
+	const size_t count = mAges.size();
+	const float  p50   = mAges[count / 2];
+	const float  p90   = mAges[count * 9 / 10];
+	const float  max   = mAges[count - 1];
+	const float  slo   = mSLO / 1000000.0f;
+
+	mAges.clear();
+	mWindows++;
+
+	if( p90 > slo )
+	{
+		mViolations++;
+		mHeadroomWindows = 0;
+
+		if( mLevel + 1 < mLevels.size() )
+			setLevel(mLevel + 1, "over the objective", p50, p90, max);
+		else
+			printf(LOG_SLO "p90 %.1f ms over the %.1f ms objective at the lowest quality, holding\n", p90, slo);
+	}
+	else if( p90 < mHeadroom * slo )
+	{
+		if( ++mHeadroomWindows >= mUpWindows && mLevel > 0 )
+			setLevel(mLevel - 1, "headroom", p50, p90, max);
+	}
+	else
+		mHeadroomWindows = 0;
+}
+
+
+// setLevel
+void latencyController::setLevel( uint32_t level, const char* reason, float p50, float p90, float max )
+{
+	const bool down = level > mLevel;
+
+	mLevel           = level;
+	mHeadroomWindows = 0;
+	mFrames          = 0;
+
+	// the next window only measures frames processed at the new level
+	mAges.clear();
+
+	const Level& l = mLevels[level];
+
+	printf(LOG_SLO "step %s to level %u/%zu (%s, p50 %.1f ms, p90 %.1f ms, max %.1f ms, objective %.1f ms): "
+		  "scale %.2f, %u tiles, 1 frame in %u, stream %s %u fps\n",
+		  down ? "down" : "up", level, mLevels.size() - 1, reason, p50, p90, max, mSLO / 1000000.0f,
+		  l.scale, GetTileBudget(), l.cadence, streamModeNames[l.streamMode], l.framerate);
+
+	if( l.streamMode != mStreamMode || l.framerate != mFramerate )
+		sendStreamSettings();
+}
+
+
+// sendStreamSettings
+void latencyController::sendStreamSettings()
+{
+	const Level& l = mLevels[mLevel];
+
+	if( mStreamSocket.empty() )
+		return;
+
+	struct sockaddr_un addr;
+
+	if( mStreamSocket.size() >= sizeof(addr.sun_path) )
+		return;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, mStreamSocket.c_str());
+
+	char message[64];
+	const int size = snprintf(message, sizeof(message), "stream %i %u", (int)l.streamMode, l.framerate);
+
+	const int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+
+	if( fd < 0 || sendto(fd, message, size, MSG_DONTWAIT, (struct sockaddr*)&addr, sizeof(addr)) != size )
+	{
+		// retried at the next change, the controller keeps working on its own knobs
+		printf(LOG_SLO "failed to request the stream settings from %s\n", mStreamSocket.c_str());
+	}
+	else
+	{
+		printf(LOG_SLO "requested stream %s %u fps\n", streamModeNames[l.streamMode], l.framerate);
+		mStreamMode = l.streamMode;
+		mFramerate  = l.framerate;
+	}
+
+	if( fd >= 0 )
+		close(fd);
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __LATENCY_CONTROLLER_H__
+#define __LATENCY_CONTROLLER_H__
+
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <libARSAL/ARSAL_Time.h>
+}
+
+
+/**
+ * Default stream settings socket of the stream receiver (BD_STREAM_CONTROL_SOCKET)
+ */
+#define LATENCY_DEFAULT_STREAM_SOCKET "/tmp/bebop_stream.sock"
+
+/**
+ * Frames per decision window
+ */
+#define LATENCY_DEFAULT_WINDOW 30
+
+
+/**
+ * Keeps the age of the frames, capture to result, under a latency SLO.
+ *
+ * The ages of the processed frames are collected over a window. When the
+ * 90th percentile of a window is over the SLO, quality steps down one level:
+ * fewer tiles, then a lower processing resolution, then only every n-th
+ * frame processed, and at the bottom the Bebop is asked for a lighter stream
+ * (frame rate, stream mode) through the stream receiver. When it stays under
+ * a fraction of the SLO (the headroom) for several windows in a row, quality
+ * steps back up one level. Every change is logged with the measured ages.
+ */
+class latencyController
+{
+public:
+	/**
+	 * Values of MediaStreaming.videoStreamMode
+	 */
+	enum StreamMode
+	{
+		STREAM_LOW_LATENCY = 0,
+		STREAM_HIGH_RELIABILITY,
+		STREAM_HIGH_RELIABILITY_LOW_FRAMERATE
+	};
+
+	/**
+	 * One quality level
+	 */
+	struct Level
+	{
+		float      scale;		// processing resolution, fraction of the frame size
+		float      tiles;		// fraction of the tile budget, at least two tiles
+		uint32_t   cadence;		// one frame processed out of cadence
+		StreamMode streamMode;
+		uint32_t   framerate;	// PictureSettings.VideoFramerate, 24, 25 or 30
+	};
+
+	/**
+	 * Create a controller, starting at the best quality.
+	 * @param sloMs latency objective, capture to result
+	 * @param tileBudget tiles per frame at the best quality
+	 * @param streamSocket stream receiver socket to send the stream settings to, NULL not to change them
+	 */
+	static latencyController* Create( float sloMs, uint32_t tileBudget, const char* streamSocket=LATENCY_DEFAULT_STREAM_SOCKET );
+
+	/**
+	 * Destroy
+	 */
+	~latencyController();
+
+	/**
+	 * Whether to process the next frame, according to the cadence.
+	 */
+	bool Admit();
+
+	/**
+	 * Age of a processed frame, from its capture to its result.
+	 * Decides at the end of every window.
+	 */
+	void Update( ARSAL_Time_Ns_t age );
+
+	/**
+	 * Settings of the current level
+	 */
+	inline float    GetScale() const		{ return mLevels[mLevel].scale; }
+	inline uint32_t GetCadence() const	{ return mLevels[mLevel].cadence; }
+	uint32_t        GetTileBudget() const;
+
+	/**
+	 * Current level, 0 is the best quality
+	 */
+	inline uint32_t GetLevel() const		{ return mLevel; }
+	inline uint32_t GetNumLevels() const	{ return mLevels.size(); }
+
+	/**
+	 * Windows whose 90th percentile was over the SLO
+	 */
+	inline uint64_t GetViolations() const	{ return mViolations; }
+	inline uint64_t GetNumWindows() const	{ return mWindows; }
+
+	/**
+	 * Fraction of the SLO under which quality may step up (default 0.6)
+	 */
+	inline void SetHeadroom( float headroom )	{ mHeadroom = headroom; }
+
+	/**
+	 * Windows in a row with headroom before stepping up (default 3)
+	 */
+	inline void SetUpWindows( uint32_t windows )	{ mUpWindows = windows; }
+
+	/**
+	 * Frames per decision window (default LATENCY_DEFAULT_WINDOW)
+	 */
+	inline void SetWindow( uint32_t frames )		{ mWindow = frames > 0 ? frames : 1; }
+
+protected:
+	latencyController();
+
+	void setLevel( uint32_t level, const char* reason, float p50, float p90, float max );
+	void sendStreamSettings();
+
+	std::vector<Level> mLevels;
+	uint32_t mLevel;
+
+	ARSAL_Time_Ns_t mSLO;
+	uint32_t mTileBudget;
+	float    mHeadroom;
+	uint32_t mUpWindows;
+	uint32_t mWindow;
+	uint32_t mHeadroomWindows;
+	uint64_t mFrames;
+	uint64_t mViolations;
+	uint64_t mWindows;
+
+	std::vector<float> mAges;		// ms, current window
+
+	std::string mStreamSocket;
+	StreamMode  mStreamMode;		// last settings sent
+	uint32_t    mFramerate;
+};
+
+#endif
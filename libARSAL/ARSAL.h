@@ -37,13 +37,20 @@
 #ifndef _ARSAL_H_
 #define _ARSAL_H_
 
+#include <libARSAL/ARSAL_ClipRecorder.h>
+#include <libARSAL/ARSAL_Dump.h>
 #include <libARSAL/ARSAL_Endianness.h>
+#include <libARSAL/ARSAL_FrameRing.h>
 #include <libARSAL/ARSAL_Ftw.h>
 #include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Pool.h>
 #include <libARSAL/ARSAL_Print.h>
 #include <libARSAL/ARSAL_Sem.h>
 #include <libARSAL/ARSAL_Socket.h>
+#include <libARSAL/ARSAL_TaskPool.h>
 #include <libARSAL/ARSAL_Thread.h>
 #include <libARSAL/ARSAL_Time.h>
+#include <libARSAL/ARSAL_TimerWheel.h>
+#include <libARSAL/ARSAL_Writer.h>
 
 #endif /* _ARSAL_H_ */
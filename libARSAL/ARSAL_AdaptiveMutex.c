@@ -0,0 +1,408 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_AdaptiveMutex.c
+ * @brief Adaptive spinning mutex with optional contention profiling
+ * @date 10/18/2026
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <libARSAL/ARSAL_Futex.h>
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Time.h>
+
+/* Bounds of the self-tuned spin count (same heuristic as glibc adaptive mutexes) */
+#define ARSAL_ADAPTIVE_MUTEX_MAX_SPINS      100
+#define ARSAL_ADAPTIVE_MUTEX_CACHE_LINE     64
+
+/* Futex word states */
+#define ARSAL_ADAPTIVE_MUTEX_UNLOCKED       0
+#define ARSAL_ADAPTIVE_MUTEX_LOCKED         1
+#define ARSAL_ADAPTIVE_MUTEX_CONTENDED      2
+
+#ifdef ARSAL_MUTEX_PROFILING
+#define ARSAL_ADAPTIVE_MUTEX_NB_SITES       8
+#define ARSAL_ADAPTIVE_MUTEX_NAME_SIZE      32
+
+typedef struct
+{
+    const char *func;
+    int line;
+    uint64_t acquisitions;
+    uint64_t waitNs;
+} ARSAL_AdaptiveMutex_Site_t;
+
+typedef struct ARSAL_AdaptiveMutex_Profile_t
+{
+    char name[ARSAL_ADAPTIVE_MUTEX_NAME_SIZE];
+    uint64_t acquisitions;
+    uint64_t contended;
+    uint64_t waitNs;
+    uint64_t maxWaitNs;
+    uint64_t holdNs;
+    uint64_t maxHoldNs;
+    ARSAL_Time_Ns_t lockTime;
+    ARSAL_AdaptiveMutex_Site_t sites[ARSAL_ADAPTIVE_MUTEX_NB_SITES];
+    struct ARSAL_AdaptiveMutex_Profile_t *prev;
+    struct ARSAL_AdaptiveMutex_Profile_t *next;
+} ARSAL_AdaptiveMutex_Profile_t;
+#endif
+
+typedef struct
+{
+    volatile uint32_t state;
+    int32_t spins;
+#ifdef ARSAL_MUTEX_PROFILING
+    ARSAL_AdaptiveMutex_Profile_t profile;
+#endif
+} ARSAL_AdaptiveMutex_Impl_t;
+
+#ifdef ARSAL_MUTEX_PROFILING
+/* Registry of live profiled mutexes, protected by a plain spinlock so the
+ * profiler does not depend on the primitive it measures */
+static ARSAL_AdaptiveMutex_Profile_t *ARSAL_AdaptiveMutex_Registry = NULL;
+static volatile uint32_t ARSAL_AdaptiveMutex_RegistryLock = 0;
+
+static void ARSAL_AdaptiveMutex_RegistryAcquire(void)
+{
+    while (__atomic_exchange_n(&ARSAL_AdaptiveMutex_RegistryLock, 1, __ATOMIC_ACQUIRE) != 0)
+    {
+        ARSAL_CPU_RELAX();
+    }
+}
+
+static void ARSAL_AdaptiveMutex_RegistryRelease(void)
+{
+    __atomic_store_n(&ARSAL_AdaptiveMutex_RegistryLock, 0, __ATOMIC_RELEASE);
+}
+
+static void ARSAL_AdaptiveMutex_RecordAcquire(ARSAL_AdaptiveMutex_Impl_t *impl, const char *func, int line, int contended, ARSAL_Time_Ns_t start)
+{
+    ARSAL_AdaptiveMutex_Profile_t *profile = &impl->profile;
+    ARSAL_Time_Ns_t now = ARSAL_Time_GetNs();
+    uint64_t wait = contended ? (uint64_t)ARSAL_Time_DiffNs(start, now) : 0;
+    int i;
+
+    /* Runs with the mutex held: no extra synchronization needed */
+    profile->lockTime = now;
+    profile->acquisitions++;
+    if (contended)
+    {
+        profile->contended++;
+        profile->waitNs += wait;
+        if (wait > profile->maxWaitNs)
+        {
+            profile->maxWaitNs = wait;
+        }
+    }
+
+    if (func == NULL)
+    {
+        return;
+    }
+    for (i = 0; i < ARSAL_ADAPTIVE_MUTEX_NB_SITES; i++)
+    {
+        ARSAL_AdaptiveMutex_Site_t *site = &profile->sites[i];
+        if (site->func == NULL)
+        {
+            site->func = func;
+            site->line = line;
+        }
+        if ((site->line == line) && (site->func == func || strcmp(site->func, func) == 0))
+        {
+            site->acquisitions++;
+            site->waitNs += wait;
+            break;
+        }
+    }
+}
+
+static void ARSAL_AdaptiveMutex_RecordRelease(ARSAL_AdaptiveMutex_Impl_t *impl)
+{
+    ARSAL_AdaptiveMutex_Profile_t *profile = &impl->profile;
+    uint64_t hold = (uint64_t)ARSAL_Time_ElapsedNs(profile->lockTime);
+
+    profile->holdNs += hold;
+    if (hold > profile->maxHoldNs)
+    {
+        profile->maxHoldNs = hold;
+    }
+}
+#endif
+
+int ARSAL_AdaptiveMutex_Init(ARSAL_AdaptiveMutex_t *mutex, const char *name)
+{
+    ARSAL_AdaptiveMutex_Impl_t *impl = NULL;
+
+    if (mutex == NULL)
+    {
+        return EINVAL;
+    }
+
+    /* One cache line per lock to avoid false sharing between hot locks */
+    if (posix_memalign((void **)&impl, ARSAL_ADAPTIVE_MUTEX_CACHE_LINE, sizeof(*impl)) != 0)
+    {
+        return ENOMEM;
+    }
+    memset(impl, 0, sizeof(*impl));
+    impl->state = ARSAL_ADAPTIVE_MUTEX_UNLOCKED;
+
+#ifdef ARSAL_MUTEX_PROFILING
+    strncpy(impl->profile.name, (name != NULL) ? name : "(unnamed)", ARSAL_ADAPTIVE_MUTEX_NAME_SIZE - 1);
+    ARSAL_AdaptiveMutex_RegistryAcquire();
+    impl->profile.next = ARSAL_AdaptiveMutex_Registry;
+    if (ARSAL_AdaptiveMutex_Registry != NULL)
+    {
+        ARSAL_AdaptiveMutex_Registry->prev = &impl->profile;
+    }
+    ARSAL_AdaptiveMutex_Registry = &impl->profile;
+    ARSAL_AdaptiveMutex_RegistryRelease();
+#else
+    (void)name;
+#endif
+
+    *mutex = impl;
+    return 0;
+}
+
+int ARSAL_AdaptiveMutex_Destroy(ARSAL_AdaptiveMutex_t *mutex)
+{
+    ARSAL_AdaptiveMutex_Impl_t *impl;
+
+    if ((mutex == NULL) || (*mutex == NULL))
+    {
+        return EINVAL;
+    }
+    impl = *mutex;
+    if (impl->state != ARSAL_ADAPTIVE_MUTEX_UNLOCKED)
+    {
+        return EBUSY;
+    }
+
+#ifdef ARSAL_MUTEX_PROFILING
+    ARSAL_AdaptiveMutex_RegistryAcquire();
+    if (impl->profile.prev != NULL)
+    {
+        impl->profile.prev->next = impl->profile.next;
+    }
+    else
+    {
+        ARSAL_AdaptiveMutex_Registry = impl->profile.next;
+    }
+    if (impl->profile.next != NULL)
+    {
+        impl->profile.next->prev = impl->profile.prev;
+    }
+    ARSAL_AdaptiveMutex_RegistryRelease();
+#endif
+
+    free(impl);
+    *mutex = NULL;
+    return 0;
+}
+
+int ARSAL_AdaptiveMutex_LockEx(ARSAL_AdaptiveMutex_t *mutex, const char *func, int line)
+{
+    ARSAL_AdaptiveMutex_Impl_t *impl;
+    uint32_t expected = ARSAL_ADAPTIVE_MUTEX_UNLOCKED;
+    uint32_t state;
+    int32_t maxSpins, count;
+#ifdef ARSAL_MUTEX_PROFILING
+    ARSAL_Time_Ns_t start;
+#endif
+
+    if ((mutex == NULL) || (*mutex == NULL))
+    {
+        return EINVAL;
+    }
+    impl = *mutex;
+
+    /* Uncontended fast path */
+    if (__atomic_compare_exchange_n(&impl->state, &expected, ARSAL_ADAPTIVE_MUTEX_LOCKED, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+#ifdef ARSAL_MUTEX_PROFILING
+        ARSAL_AdaptiveMutex_RecordAcquire(impl, func, line, 0, 0);
+#else
+        (void)func;
+        (void)line;
+#endif
+        return 0;
+    }
+
+#ifdef ARSAL_MUTEX_PROFILING
+    start = ARSAL_Time_GetNs();
+#endif
+
+    /* Spin phase: read-only polling, the spin budget follows the average
+     * number of iterations that previously sufficed */
+    maxSpins = impl->spins * 2 + 10;
+    if (maxSpins > ARSAL_ADAPTIVE_MUTEX_MAX_SPINS)
+    {
+        maxSpins = ARSAL_ADAPTIVE_MUTEX_MAX_SPINS;
+    }
+    for (count = 0; count < maxSpins; count++)
+    {
+        if (__atomic_load_n(&impl->state, __ATOMIC_RELAXED) == ARSAL_ADAPTIVE_MUTEX_UNLOCKED)
+        {
+            expected = ARSAL_ADAPTIVE_MUTEX_UNLOCKED;
+            if (__atomic_compare_exchange_n(&impl->state, &expected, ARSAL_ADAPTIVE_MUTEX_LOCKED, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        ARSAL_CPU_RELAX();
+    }
+    impl->spins += (count - impl->spins) / 8;
+
+    /* Park phase: mark the lock as contended so the owner wakes us */
+    if (count >= maxSpins)
+    {
+        state = __atomic_exchange_n(&impl->state, ARSAL_ADAPTIVE_MUTEX_CONTENDED, __ATOMIC_ACQUIRE);
+        while (state != ARSAL_ADAPTIVE_MUTEX_UNLOCKED)
+        {
+            ARSAL_Futex_Wait(&impl->state, ARSAL_ADAPTIVE_MUTEX_CONTENDED, NULL, 0);
+            state = __atomic_exchange_n(&impl->state, ARSAL_ADAPTIVE_MUTEX_CONTENDED, __ATOMIC_ACQUIRE);
+        }
+    }
+
+#ifdef ARSAL_MUTEX_PROFILING
+    ARSAL_AdaptiveMutex_RecordAcquire(impl, func, line, 1, start);
+#endif
+    return 0;
+}
+
+int ARSAL_AdaptiveMutex_Trylock(ARSAL_AdaptiveMutex_t *mutex)
+{
+    ARSAL_AdaptiveMutex_Impl_t *impl;
+    uint32_t expected = ARSAL_ADAPTIVE_MUTEX_UNLOCKED;
+
+    if ((mutex == NULL) || (*mutex == NULL))
+    {
+        return EINVAL;
+    }
+    impl = *mutex;
+
+    if (!__atomic_compare_exchange_n(&impl->state, &expected, ARSAL_ADAPTIVE_MUTEX_LOCKED, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+        return EBUSY;
+    }
+#ifdef ARSAL_MUTEX_PROFILING
+    ARSAL_AdaptiveMutex_RecordAcquire(impl, NULL, 0, 0, 0);
+#endif
+    return 0;
+}
+
+int ARSAL_AdaptiveMutex_Unlock(ARSAL_AdaptiveMutex_t *mutex)
+{
+    ARSAL_AdaptiveMutex_Impl_t *impl;
+
+    if ((mutex == NULL) || (*mutex == NULL))
+    {
+        return EINVAL;
+    }
+    impl = *mutex;
+
+#ifdef ARSAL_MUTEX_PROFILING
+    ARSAL_AdaptiveMutex_RecordRelease(impl);
+#endif
+
+    if (__atomic_exchange_n(&impl->state, ARSAL_ADAPTIVE_MUTEX_UNLOCKED, __ATOMIC_RELEASE) == ARSAL_ADAPTIVE_MUTEX_CONTENDED)
+    {
+        ARSAL_Futex_Wake(&impl->state, 1, 0);
+    }
+    return 0;
+}
+
+#ifdef ARSAL_MUTEX_PROFILING
+static int ARSAL_AdaptiveMutex_CompareWait(const void *a, const void *b)
+{
+    const ARSAL_AdaptiveMutex_Profile_t *pa = *(const ARSAL_AdaptiveMutex_Profile_t * const *)a;
+    const ARSAL_AdaptiveMutex_Profile_t *pb = *(const ARSAL_AdaptiveMutex_Profile_t * const *)b;
+
+    return (pa->waitNs < pb->waitNs) - (pa->waitNs > pb->waitNs);
+}
+#endif
+
+void ARSAL_AdaptiveMutex_DumpProfile(FILE *file)
+{
+#ifdef ARSAL_MUTEX_PROFILING
+    ARSAL_AdaptiveMutex_Profile_t *profile;
+    ARSAL_AdaptiveMutex_Profile_t **sorted;
+    int count = 0, i, j;
+
+    if (file == NULL)
+    {
+        return;
+    }
+
+    /* Counters are read without taking each lock: the report is approximate
+     * but dumping it never perturbs the measured locks */
+    ARSAL_AdaptiveMutex_RegistryAcquire();
+    for (profile = ARSAL_AdaptiveMutex_Registry; profile != NULL; profile = profile->next)
+    {
+        count++;
+    }
+    sorted = malloc((count > 0 ? count : 1) * sizeof(*sorted));
+    if (sorted == NULL)
+    {
+        ARSAL_AdaptiveMutex_RegistryRelease();
+        return;
+    }
+    for (i = 0, profile = ARSAL_AdaptiveMutex_Registry; profile != NULL; profile = profile->next)
+    {
+        sorted[i++] = profile;
+    }
+    qsort(sorted, count, sizeof(*sorted), ARSAL_AdaptiveMutex_CompareWait);
+
+    fprintf(file, "%-32s %12s %8s %12s %10s %12s %10s\n",
+            "lock", "acquired", "cont%", "wait(us)", "maxw(us)", "hold(us)", "maxh(us)");
+    for (i = 0; i < count; i++)
+    {
+        profile = sorted[i];
+        fprintf(file, "%-32s %12" PRIu64 " %7.2f%% %12" PRIu64 " %10" PRIu64 " %12" PRIu64 " %10" PRIu64 "\n",
+                profile->name, profile->acquisitions,
+                (profile->acquisitions > 0) ? 100.0 * (double)profile->contended / (double)profile->acquisitions : 0.0,
+                NSEC_TO_USEC(profile->waitNs), NSEC_TO_USEC(profile->maxWaitNs),
+                NSEC_TO_USEC(profile->holdNs), NSEC_TO_USEC(profile->maxHoldNs));
+        for (j = 0; (j < ARSAL_ADAPTIVE_MUTEX_NB_SITES) && (profile->sites[j].func != NULL); j++)
+        {
+            fprintf(file, "    %s:%d %" PRIu64 " acquisitions, %" PRIu64 " us waited\n",
+                    profile->sites[j].func, profile->sites[j].line,
+                    profile->sites[j].acquisitions, NSEC_TO_USEC(profile->sites[j].waitNs));
+        }
+    }
+    ARSAL_AdaptiveMutex_RegistryRelease();
+    free(sorted);
+#else
+    (void)file;
+#endif
+}
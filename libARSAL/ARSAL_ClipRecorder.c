@@ -0,0 +1,776 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_ClipRecorder.c
+ * @brief Pre-trigger recorder of encoded video clips
+ * @date 10/18/2026
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <libARSAL/ARSAL_ClipRecorder.h>
+#include <libARSAL/ARSAL_Endianness.h>
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_Thread.h>
+#include <libARSAL/ARSAL_Writer.h>
+
+#define ARSAL_CLIP_RECORDER_TAG "ARSAL_ClipRecorder"
+
+/* Access units written per writev() */
+#define ARSAL_CLIP_RECORDER_WRITE_BATCH     64
+
+/* A clip whose stream stopped is closed after this delay past its end (ms) */
+#define ARSAL_CLIP_RECORDER_STALL_MS        2000
+
+/* Trigger datagram: magic (4) | reserved (4) | timestamp (8), little endian */
+#define ARSAL_CLIP_RECORDER_TRIGGER_MAGIC   0x50494c43 /* "CLIP" */
+#define ARSAL_CLIP_RECORDER_TRIGGER_SIZE    16
+
+typedef struct
+{
+    size_t offset;              /* Offset of the data in the ring */
+    uint32_t size;
+    uint32_t flags;
+    ARSAL_Time_Ns_t timestamp;
+} ARSAL_ClipRecorder_Unit_t;
+
+struct ARSAL_ClipRecorder_t
+{
+    char *directory;
+    char *prefix;
+    char *extension;
+    ARSAL_Writer_t *writer;
+    ARSAL_Time_Ns_t preTriggerNs;
+    ARSAL_Time_Ns_t postTriggerNs;
+    ARSAL_Time_Ns_t maxClipNs;
+
+    /* Byte ring: each access unit is contiguous, the unused end of the ring
+     * is skipped when one does not fit before it */
+    uint8_t *ring;
+    size_t ringSize;
+    size_t writeOffset;
+
+    /* Access units [first, next) are in the ring, unit seq is units[seq % nbUnits] */
+    ARSAL_ClipRecorder_Unit_t *units;
+    uint64_t nbUnits;
+    uint64_t first;
+    uint64_t next;
+
+    /* Clip state. While recording, units from readSeq on are pinned: Push()
+     * never evicts them */
+    int recording;
+    int waitKey;                /* No key frame yet, skip units until one comes */
+    int overrun;                /* A unit was dropped, the clip ends before it */
+    uint64_t readSeq;
+    uint64_t endSeq;            /* Units before it were written by the previous clip */
+    ARSAL_Time_Ns_t clipStart;
+    ARSAL_Time_Ns_t clipEnd;
+
+    ARSAL_Mutex_t mutex;
+    ARSAL_Cond_t writerCond;
+    int run;
+
+    ARSAL_ClipRecorder_Stats_t stats;
+    ARSAL_Thread_t writerThread;
+};
+
+static inline ARSAL_ClipRecorder_Unit_t *ARSAL_ClipRecorder_GetUnit(ARSAL_ClipRecorder_t *recorder, uint64_t seq)
+{
+    return &recorder->units[seq % recorder->nbUnits];
+}
+
+/**
+ * @brief Open a new clip file named after the current local time
+ * @note Called without the mutex held
+ * @param[out] stream The writer stream of the file, when the recorder has a writer
+ * @return The file descriptor, when the recorder has no writer, 0 if it has one, or -1 on error
+ */
+static int ARSAL_ClipRecorder_OpenFile(ARSAL_ClipRecorder_t *recorder, ARSAL_Writer_Stream_t **stream)
+{
+    ARSAL_Writer_Stream_Config_t config;
+    char path[512];
+    char date[32];
+    struct timespec now;
+    struct tm localTime;
+    int fd, i;
+
+    ARSAL_Time_GetLocalTime(&now, &localTime);
+    strftime(date, sizeof(date), "%Y%m%d_%H%M%S", &localTime);
+
+    /* Several clips can start within a second */
+    for (i = 0; i < 100; i++)
+    {
+        if (i == 0)
+        {
+            snprintf(path, sizeof(path), "%s/%s_%s.%s", recorder->directory, recorder->prefix, date, recorder->extension);
+        }
+        else
+        {
+            snprintf(path, sizeof(path), "%s/%s_%s_%d.%s", recorder->directory, recorder->prefix, date, i, recorder->extension);
+        }
+        fd = open(path, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if ((fd >= 0) || (errno != EEXIST))
+        {
+            break;
+        }
+    }
+
+    if (fd < 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSAL_CLIP_RECORDER_TAG, "Unable to open '%s': %s", path, strerror(errno));
+        return -1;
+    }
+
+    if (recorder->writer != NULL)
+    {
+        /* The name is reserved, the writer reopens it. Clip data is pinned
+         * in the ring until written, so waiting for chunks is fine here */
+        close(fd);
+        memset(&config, 0, sizeof(config));
+        config.backpressure = ARSAL_WRITER_BACKPRESSURE_BLOCK;
+        *stream = ARSAL_Writer_Open(recorder->writer, path, &config, NULL);
+        fd = (*stream != NULL) ? 0 : -1;
+    }
+
+    if (fd >= 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_INFO, ARSAL_CLIP_RECORDER_TAG, "Recording clip '%s'", path);
+    }
+    return fd;
+}
+
+/**
+ * @brief Write access units to the clip file
+ * @note Called without the mutex held, the units are pinned
+ * @return 0 on success, -1 if the data could not be written
+ */
+static int ARSAL_ClipRecorder_WriteUnits(int fd, ARSAL_Writer_Stream_t *stream, struct iovec *iov, int iovcnt)
+{
+    int i;
+
+    if (stream != NULL)
+    {
+        for (i = 0; i < iovcnt; i++)
+        {
+            if (ARSAL_Writer_Write(stream, iov[i].iov_base, iov[i].iov_len) != ARSAL_OK)
+            {
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    while (iovcnt > 0)
+    {
+        ssize_t ret = writev(fd, iov, iovcnt);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSAL_CLIP_RECORDER_TAG, "Clip write error: %s", strerror(errno));
+            return -1;
+        }
+
+        /* Skip what a short write did write */
+        while ((iovcnt > 0) && ((size_t)ret >= iov->iov_len))
+        {
+            ret -= (ssize_t)iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0)
+        {
+            iov->iov_base = (uint8_t *)iov->iov_base + ret;
+            iov->iov_len -= (size_t)ret;
+        }
+    }
+    return 0;
+}
+
+static void *ARSAL_ClipRecorder_WriterRun(void *arg)
+{
+    ARSAL_ClipRecorder_t *recorder = arg;
+    struct iovec iov[ARSAL_CLIP_RECORDER_WRITE_BATCH];
+    ARSAL_Writer_Stream_t *stream = NULL;
+    int fd = -1;
+    int failed = 0;
+
+    ARSAL_Mutex_Lock(&recorder->mutex);
+    for (;;)
+    {
+        uint64_t seq, end;
+        size_t bytes = 0;
+        int iovcnt = 0;
+        int finish = 0;
+        int ret;
+
+        if (!recorder->recording)
+        {
+            if (!recorder->run)
+            {
+                break;
+            }
+            ARSAL_Cond_Wait(&recorder->writerCond, &recorder->mutex);
+            continue;
+        }
+
+        if (recorder->waitKey)
+        {
+            while ((recorder->readSeq < recorder->next) &&
+                   !(ARSAL_ClipRecorder_GetUnit(recorder, recorder->readSeq)->flags & ARSAL_CLIP_RECORDER_FLAG_KEY))
+            {
+                recorder->readSeq++;
+            }
+            if (recorder->readSeq < recorder->next)
+            {
+                recorder->waitKey = 0;
+            }
+        }
+
+        /* Collect the units of the clip available now */
+        end = recorder->waitKey ? recorder->readSeq : recorder->next;
+        for (seq = recorder->readSeq; (seq < end) && (iovcnt < ARSAL_CLIP_RECORDER_WRITE_BATCH); seq++)
+        {
+            ARSAL_ClipRecorder_Unit_t *unit = ARSAL_ClipRecorder_GetUnit(recorder, seq);
+            if (unit->timestamp > recorder->clipEnd)
+            {
+                finish = 1;
+                break;
+            }
+            iov[iovcnt].iov_base = recorder->ring + unit->offset;
+            iov[iovcnt].iov_len = unit->size;
+            bytes += unit->size;
+            iovcnt++;
+        }
+
+        if ((iovcnt == 0) && (!finish))
+        {
+            if ((recorder->overrun) || (!recorder->run) ||
+                (ARSAL_Time_GetMonotonicNs() > recorder->clipEnd + MSEC_TO_NSEC((uint64_t)ARSAL_CLIP_RECORDER_STALL_MS)))
+            {
+                finish = 1;
+            }
+            else
+            {
+                ARSAL_Cond_Timedwait(&recorder->writerCond, &recorder->mutex, 100);
+                continue;
+            }
+        }
+
+        if (iovcnt > 0)
+        {
+            ARSAL_Mutex_Unlock(&recorder->mutex);
+
+            if ((fd < 0) && (!failed))
+            {
+                fd = ARSAL_ClipRecorder_OpenFile(recorder, &stream);
+                failed = (fd < 0);
+            }
+            ret = failed ? -1 : ARSAL_ClipRecorder_WriteUnits(fd, stream, iov, iovcnt);
+
+            ARSAL_Mutex_Lock(&recorder->mutex);
+            recorder->readSeq += (uint64_t)iovcnt;
+            if (ret == 0)
+            {
+                recorder->stats.bytesWritten += bytes;
+            }
+            else
+            {
+                /* The rest of the clip is skipped, but still pinned until its end */
+                if (!failed)
+                {
+                    recorder->stats.writeErrors++;
+                }
+                failed = 1;
+            }
+            continue;
+        }
+
+        /* End of the clip */
+        if (recorder->overrun)
+        {
+            recorder->stats.truncatedClips++;
+        }
+        if (fd >= 0)
+        {
+            recorder->stats.clips++;
+        }
+        else if (failed)
+        {
+            recorder->stats.writeErrors++;
+        }
+        recorder->recording = 0;
+        recorder->overrun = 0;
+        recorder->endSeq = recorder->readSeq;
+        ARSAL_Mutex_Unlock(&recorder->mutex);
+
+        if (stream != NULL)
+        {
+            /* The writer reports the errors of the writes it did in the background */
+            ret = ARSAL_Writer_Close(&stream);
+        }
+        else
+        {
+            ret = (fd >= 0) ? close(fd) : 0;
+        }
+        fd = -1;
+        failed = 0;
+
+        ARSAL_Mutex_Lock(&recorder->mutex);
+        if (ret != 0)
+        {
+            recorder->stats.writeErrors++;
+        }
+    }
+    ARSAL_Mutex_Unlock(&recorder->mutex);
+
+    return NULL;
+}
+
+ARSAL_ClipRecorder_t *ARSAL_ClipRecorder_New(const ARSAL_ClipRecorder_Config_t *config, eARSAL_ERROR *error)
+{
+    ARSAL_ClipRecorder_t *recorder = NULL;
+    eARSAL_ERROR err = ARSAL_OK;
+
+    if ((config == NULL) || (config->directory == NULL) || (config->prefix == NULL))
+    {
+        err = ARSAL_ERROR_BAD_PARAMETER;
+    }
+
+    if (err == ARSAL_OK)
+    {
+        recorder = calloc(1, sizeof(*recorder));
+        if (recorder == NULL)
+        {
+            err = ARSAL_ERROR_ALLOC;
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        recorder->ringSize = (config->ringSize > 0) ? config->ringSize : ARSAL_CLIP_RECORDER_DEFAULT_RING_SIZE;
+        recorder->preTriggerNs = MSEC_TO_NSEC((uint64_t)((config->preTriggerMs > 0) ? config->preTriggerMs : ARSAL_CLIP_RECORDER_DEFAULT_PRE_TRIGGER_MS));
+        recorder->postTriggerNs = MSEC_TO_NSEC((uint64_t)((config->postTriggerMs > 0) ? config->postTriggerMs : ARSAL_CLIP_RECORDER_DEFAULT_POST_TRIGGER_MS));
+        recorder->maxClipNs = MSEC_TO_NSEC((uint64_t)config->maxClipMs);
+        recorder->writer = config->writer;
+        /* Room for access units of 256 bytes on average, far more than a stream needs */
+        recorder->nbUnits = (recorder->ringSize / 256 > 256) ? recorder->ringSize / 256 : 256;
+        recorder->directory = strdup(config->directory);
+        recorder->prefix = strdup(config->prefix);
+        recorder->extension = strdup((config->extension != NULL) ? config->extension : "h264");
+        recorder->ring = malloc(recorder->ringSize);
+        recorder->units = calloc(recorder->nbUnits, sizeof(*recorder->units));
+        if ((recorder->directory == NULL) || (recorder->prefix == NULL) || (recorder->extension == NULL) ||
+            (recorder->ring == NULL) || (recorder->units == NULL))
+        {
+            err = ARSAL_ERROR_ALLOC;
+        }
+        else
+        {
+            /* Touch the ring now so Push() never page faults on it */
+            memset(recorder->ring, 0, recorder->ringSize);
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        if ((ARSAL_Mutex_Init(&recorder->mutex) != 0) ||
+            (ARSAL_Cond_Init(&recorder->writerCond) != 0))
+        {
+            err = ARSAL_ERROR_SYSTEM;
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        recorder->run = 1;
+        if (ARSAL_Thread_Create(&recorder->writerThread, ARSAL_ClipRecorder_WriterRun, recorder) != 0)
+        {
+            recorder->writerThread = NULL;
+            err = ARSAL_ERROR_SYSTEM;
+        }
+    }
+
+    if (err != ARSAL_OK)
+    {
+        ARSAL_ClipRecorder_Delete(&recorder);
+    }
+
+    if (error != NULL)
+    {
+        *error = err;
+    }
+    return recorder;
+}
+
+void ARSAL_ClipRecorder_Delete(ARSAL_ClipRecorder_t **recorder)
+{
+    ARSAL_ClipRecorder_t *r;
+
+    if ((recorder == NULL) || (*recorder == NULL))
+    {
+        return;
+    }
+    r = *recorder;
+
+    if (r->writerThread != NULL)
+    {
+        ARSAL_Mutex_Lock(&r->mutex);
+        r->run = 0;
+        ARSAL_Cond_Signal(&r->writerCond);
+        ARSAL_Mutex_Unlock(&r->mutex);
+        ARSAL_Thread_Join(r->writerThread, NULL);
+        ARSAL_Thread_Destroy(&r->writerThread);
+    }
+
+    if (r->mutex != NULL)
+    {
+        ARSAL_Mutex_Destroy(&r->mutex);
+    }
+    if (r->writerCond != NULL)
+    {
+        ARSAL_Cond_Destroy(&r->writerCond);
+    }
+    free(r->units);
+    free(r->ring);
+    free(r->extension);
+    free(r->prefix);
+    free(r->directory);
+    free(r);
+    *recorder = NULL;
+}
+
+/**
+ * @brief Find where size bytes fit in the ring without evicting anything
+ * @note Called with the mutex held
+ * @return 0 and the offset in *offset if they fit, -1 otherwise
+ */
+static int ARSAL_ClipRecorder_Place(ARSAL_ClipRecorder_t *recorder, size_t size, size_t *offset)
+{
+    size_t tail = recorder->writeOffset;
+    size_t oldest;
+
+    if (recorder->first == recorder->next)
+    {
+        *offset = 0;
+        return 0;
+    }
+    if (recorder->next - recorder->first >= recorder->nbUnits)
+    {
+        return -1;
+    }
+
+    /* The ring is full when tail catches up with the oldest unit, so a unit
+     * never fills the free space exactly up to it */
+    oldest = ARSAL_ClipRecorder_GetUnit(recorder, recorder->first)->offset;
+    if (tail > oldest)
+    {
+        if (size <= recorder->ringSize - tail)
+        {
+            *offset = tail;
+            return 0;
+        }
+        if (size < oldest)
+        {
+            *offset = 0;
+            return 0;
+        }
+    }
+    else if ((tail < oldest) && (size < oldest - tail))
+    {
+        *offset = tail;
+        return 0;
+    }
+    return -1;
+}
+
+eARSAL_ERROR ARSAL_ClipRecorder_Push(ARSAL_ClipRecorder_t *recorder, const void *data, size_t size, ARSAL_Time_Ns_t timestamp, uint32_t flags)
+{
+    ARSAL_ClipRecorder_Unit_t *unit;
+    eARSAL_ERROR err = ARSAL_OK;
+    size_t offset = 0;
+
+    if ((recorder == NULL) || (data == NULL) || (size == 0))
+    {
+        return ARSAL_ERROR_BAD_PARAMETER;
+    }
+
+    ARSAL_Mutex_Lock(&recorder->mutex);
+
+    recorder->stats.accessUnits++;
+    recorder->stats.bytes += size;
+
+    /* A unit larger than a quarter of the ring would flush most of the
+     * pre-trigger history by itself */
+    if (size > recorder->ringSize / 4)
+    {
+        err = ARSAL_ERROR_CLIP_OVERFLOW;
+    }
+
+    while ((err == ARSAL_OK) && (ARSAL_ClipRecorder_Place(recorder, size, &offset) != 0))
+    {
+        if ((recorder->recording) && (recorder->first >= recorder->readSeq))
+        {
+            /* The writer is behind: keep what the clip still needs and end it here */
+            recorder->overrun = 1;
+            err = ARSAL_ERROR_CLIP_OVERFLOW;
+        }
+        else
+        {
+            recorder->first++;
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        if ((recorder->recording) && (recorder->overrun))
+        {
+            /* Do not let the clip go on past the gap */
+            err = ARSAL_ERROR_CLIP_OVERFLOW;
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        memcpy(recorder->ring + offset, data, size);
+        unit = ARSAL_ClipRecorder_GetUnit(recorder, recorder->next);
+        unit->offset = offset;
+        unit->size = (uint32_t)size;
+        unit->flags = flags;
+        unit->timestamp = timestamp;
+        recorder->writeOffset = offset + size;
+        if (recorder->writeOffset == recorder->ringSize)
+        {
+            recorder->writeOffset = 0;
+        }
+        recorder->next++;
+        if (recorder->recording)
+        {
+            ARSAL_Cond_Signal(&recorder->writerCond);
+        }
+    }
+    else
+    {
+        recorder->stats.droppedUnits++;
+    }
+
+    ARSAL_Mutex_Unlock(&recorder->mutex);
+
+    return err;
+}
+
+eARSAL_ERROR ARSAL_ClipRecorder_Trigger(ARSAL_ClipRecorder_t *recorder, ARSAL_Time_Ns_t timestamp)
+{
+    ARSAL_Time_Ns_t end, threshold;
+    uint64_t seq, start, oldestKey;
+    int found = 0;
+
+    if (recorder == NULL)
+    {
+        return ARSAL_ERROR_BAD_PARAMETER;
+    }
+
+    ARSAL_Mutex_Lock(&recorder->mutex);
+
+    recorder->stats.triggers++;
+    end = timestamp + recorder->postTriggerNs;
+
+    if (recorder->recording)
+    {
+        /* Extend the clip being recorded */
+        if ((recorder->maxClipNs > 0) && (end > recorder->clipStart + recorder->maxClipNs))
+        {
+            end = recorder->clipStart + recorder->maxClipNs;
+        }
+        if (end > recorder->clipEnd)
+        {
+            recorder->clipEnd = end;
+        }
+    }
+    else
+    {
+        /* Start on the newest key frame at least preTrigger before the event,
+         * or on the oldest one kept if the history is shorter, without going
+         * back into what the previous clip already wrote */
+        threshold = (timestamp > recorder->preTriggerNs) ? timestamp - recorder->preTriggerNs : 0;
+        start = (recorder->endSeq > recorder->first) ? recorder->endSeq : recorder->first;
+        oldestKey = recorder->next;
+        for (seq = recorder->next; seq > start; seq--)
+        {
+            ARSAL_ClipRecorder_Unit_t *unit = ARSAL_ClipRecorder_GetUnit(recorder, seq - 1);
+            if (unit->flags & ARSAL_CLIP_RECORDER_FLAG_KEY)
+            {
+                oldestKey = seq - 1;
+                if (unit->timestamp <= threshold)
+                {
+                    found = 1;
+                    break;
+                }
+            }
+        }
+
+        recorder->readSeq = oldestKey;
+        recorder->waitKey = (oldestKey == recorder->next);
+        recorder->clipStart = found ? ARSAL_ClipRecorder_GetUnit(recorder, oldestKey)->timestamp : threshold;
+        recorder->clipEnd = end;
+        if ((recorder->maxClipNs > 0) && (recorder->clipEnd > recorder->clipStart + recorder->maxClipNs))
+        {
+            recorder->clipEnd = recorder->clipStart + recorder->maxClipNs;
+        }
+        recorder->overrun = 0;
+        recorder->recording = 1;
+        ARSAL_Cond_Signal(&recorder->writerCond);
+    }
+
+    ARSAL_Mutex_Unlock(&recorder->mutex);
+
+    return ARSAL_OK;
+}
+
+int ARSAL_ClipRecorder_TriggerOpen(const char *path)
+{
+    struct sockaddr_un addr;
+    int fd;
+
+    if ((path == NULL) || (strlen(path) >= sizeof(addr.sun_path)))
+    {
+        return -1;
+    }
+
+    fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSAL_CLIP_RECORDER_TAG, "Unable to create trigger socket: %s", strerror(errno));
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSAL_CLIP_RECORDER_TAG, "Unable to bind trigger socket '%s': %s", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int ARSAL_ClipRecorder_TriggerReceive(ARSAL_ClipRecorder_t *recorder, int fd)
+{
+    uint8_t msg[ARSAL_CLIP_RECORDER_TRIGGER_SIZE];
+    uint32_t magic;
+    uint64_t timestamp;
+    int count = 0;
+    ssize_t ret;
+
+    for (;;)
+    {
+        ret = recv(fd, msg, sizeof(msg), 0);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        if (ret != ARSAL_CLIP_RECORDER_TRIGGER_SIZE)
+        {
+            continue;
+        }
+        memcpy(&magic, msg, sizeof(magic));
+        memcpy(&timestamp, msg + 8, sizeof(timestamp));
+        if (dtohl(magic) != ARSAL_CLIP_RECORDER_TRIGGER_MAGIC)
+        {
+            continue;
+        }
+        ARSAL_ClipRecorder_Trigger(recorder, (ARSAL_Time_Ns_t)dtohll(timestamp));
+        count++;
+    }
+    return count;
+}
+
+eARSAL_ERROR ARSAL_ClipRecorder_SendTrigger(const char *path, ARSAL_Time_Ns_t timestamp)
+{
+    uint8_t msg[ARSAL_CLIP_RECORDER_TRIGGER_SIZE];
+    struct sockaddr_un addr;
+    uint32_t magic = htodl(ARSAL_CLIP_RECORDER_TRIGGER_MAGIC);
+    uint64_t ts = htodll((uint64_t)timestamp);
+    eARSAL_ERROR err = ARSAL_OK;
+    int fd;
+
+    if ((path == NULL) || (strlen(path) >= sizeof(addr.sun_path)))
+    {
+        return ARSAL_ERROR_BAD_PARAMETER;
+    }
+
+    memset(msg, 0, sizeof(msg));
+    memcpy(msg, &magic, sizeof(magic));
+    memcpy(msg + 8, &ts, sizeof(ts));
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        return ARSAL_ERROR_SYSTEM;
+    }
+    if (sendto(fd, msg, sizeof(msg), MSG_DONTWAIT, (struct sockaddr *)&addr, sizeof(addr)) != (ssize_t)sizeof(msg))
+    {
+        err = ARSAL_ERROR_SYSTEM;
+    }
+    close(fd);
+    return err;
+}
+
+void ARSAL_ClipRecorder_GetStats(ARSAL_ClipRecorder_t *recorder, ARSAL_ClipRecorder_Stats_t *stats)
+{
+    if ((recorder == NULL) || (stats == NULL))
+    {
+        return;
+    }
+    ARSAL_Mutex_Lock(&recorder->mutex);
+    *stats = recorder->stats;
+    ARSAL_Mutex_Unlock(&recorder->mutex);
+}
@@ -0,0 +1,188 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_ClipRecorder.h
+ * @brief Pre-trigger recorder of encoded video clips
+ * @date 10/18/2026
+ *
+ * The recorder keeps the last seconds of an encoded stream (H.264 access
+ * units) in a memory ring bounded in bytes. Nothing touches the disk until a
+ * trigger: the clip then starts at the newest key frame at least
+ * preTriggerMs before the trigger, and goes on until postTriggerMs after it.
+ * Triggers received while a clip is recorded extend it. Clips are written by
+ * a background thread, so pushing an access unit never waits for disk I/O.
+ *
+ * Triggers can come from another process through a datagram socket, see
+ * ARSAL_ClipRecorder_TriggerOpen() and ARSAL_ClipRecorder_SendTrigger().
+ */
+#ifndef _ARSAL_CLIP_RECORDER_H_
+#define _ARSAL_CLIP_RECORDER_H_
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <libARSAL/ARSAL_Error.h>
+#include <libARSAL/ARSAL_Time.h>
+#include <libARSAL/ARSAL_Writer.h>
+
+/**
+ * @brief Default size of the in-memory ring (bytes)
+ */
+#define ARSAL_CLIP_RECORDER_DEFAULT_RING_SIZE       (16 * 1024 * 1024)
+
+/**
+ * @brief Default duration kept before the trigger (ms)
+ */
+#define ARSAL_CLIP_RECORDER_DEFAULT_PRE_TRIGGER_MS  5000
+
+/**
+ * @brief Default duration recorded after the trigger (ms)
+ */
+#define ARSAL_CLIP_RECORDER_DEFAULT_POST_TRIGGER_MS 5000
+
+/**
+ * @brief Clip recorder object type
+ */
+typedef struct ARSAL_ClipRecorder_t ARSAL_ClipRecorder_t;
+
+/**
+ * @brief Access unit flags
+ */
+typedef enum
+{
+    ARSAL_CLIP_RECORDER_FLAG_KEY = 1,   /**< Key frame (IDR for H.264), a clip can start on it */
+} eARSAL_CLIP_RECORDER_FLAG;
+
+/**
+ * @brief Clip recorder configuration
+ * @see ARSAL_ClipRecorder_New ()
+ */
+typedef struct
+{
+    const char *directory;      /**< Directory of the clip files */
+    const char *prefix;         /**< Clip file names are <prefix>_<YYYYmmdd_HHMMSS>.<extension> */
+    const char *extension;      /**< Clip file extension. NULL for "h264" */
+    size_t ringSize;            /**< Size of the in-memory ring. 0 for default */
+    uint32_t preTriggerMs;      /**< Duration kept before the trigger. 0 for default */
+    uint32_t postTriggerMs;     /**< Duration recorded after the last trigger. 0 for default */
+    uint32_t maxClipMs;         /**< Maximum clip duration, triggers do not extend it further. 0 for no limit */
+    ARSAL_Writer_t *writer;     /**< Writer the clips go through (see ARSAL_Writer.h). NULL to write them directly */
+} ARSAL_ClipRecorder_Config_t;
+
+/**
+ * @brief Clip recorder statistics
+ * @see ARSAL_ClipRecorder_GetStats ()
+ */
+typedef struct
+{
+    uint64_t accessUnits;       /**< Number of access units pushed */
+    uint64_t bytes;             /**< Number of bytes pushed */
+    uint64_t droppedUnits;      /**< Number of access units dropped: too large, or the ring was full of unwritten clip data */
+    uint64_t triggers;          /**< Number of triggers */
+    uint32_t clips;             /**< Number of clips written */
+    uint32_t truncatedClips;    /**< Number of clips cut short because the writer could not keep up */
+    uint64_t bytesWritten;      /**< Number of bytes written to clip files */
+    uint32_t writeErrors;       /**< Number of failed opens or writes */
+} ARSAL_ClipRecorder_Stats_t;
+
+/**
+ * @brief Create a new clip recorder and start its writer thread
+ * @warning This function allocates memory
+ * @param config The clip recorder configuration
+ * @param[out] error A pointer on the error output (optional, may be NULL)
+ * @return Pointer on the new clip recorder, or NULL on error
+ * @see ARSAL_ClipRecorder_Delete ()
+ */
+ARSAL_ClipRecorder_t *ARSAL_ClipRecorder_New(const ARSAL_ClipRecorder_Config_t *config, eARSAL_ERROR *error);
+
+/**
+ * @brief Finish the clip being written, stop the writer thread and delete the clip recorder
+ * @warning This function frees memory
+ * @param recorder The address of the pointer on the clip recorder
+ * @see ARSAL_ClipRecorder_New ()
+ */
+void ARSAL_ClipRecorder_Delete(ARSAL_ClipRecorder_t **recorder);
+
+/**
+ * @brief Push an access unit
+ *
+ * The data is copied into the ring, evicting the oldest access units. Only
+ * one thread may push. This function never waits for disk I/O: if the ring
+ * is full of data a clip still has to write, the access unit is dropped and
+ * the clip is ended before it.
+ *
+ * @param recorder The clip recorder
+ * @param data The access unit
+ * @param size The size of the access unit
+ * @param timestamp The access unit time (see ARSAL_Time_GetMonotonicNs())
+ * @param flags The access unit flags (see eARSAL_CLIP_RECORDER_FLAG)
+ * @retval ARSAL_OK if the access unit was stored, ARSAL_ERROR_CLIP_OVERFLOW if it was dropped. Otherwise, it returns an error number of eARSAL_ERROR
+ */
+eARSAL_ERROR ARSAL_ClipRecorder_Push(ARSAL_ClipRecorder_t *recorder, const void *data, size_t size, ARSAL_Time_Ns_t timestamp, uint32_t flags);
+
+/**
+ * @brief Record a clip around an event
+ * @param recorder The clip recorder
+ * @param timestamp The event time, on the access unit clock (see ARSAL_Time_GetMonotonicNs())
+ * @retval On success, returns ARSAL_OK. Otherwise, it returns an error number of eARSAL_ERROR
+ */
+eARSAL_ERROR ARSAL_ClipRecorder_Trigger(ARSAL_ClipRecorder_t *recorder, ARSAL_Time_Ns_t timestamp);
+
+/**
+ * @brief Open a datagram socket receiving triggers from other processes
+ * @param path The socket path (an existing socket file is replaced)
+ * @return The socket file descriptor, to poll then pass to ARSAL_ClipRecorder_TriggerReceive(), or -1 on error
+ */
+int ARSAL_ClipRecorder_TriggerOpen(const char *path);
+
+/**
+ * @brief Read the pending triggers from a socket opened with ARSAL_ClipRecorder_TriggerOpen()
+ * @param recorder The clip recorder
+ * @param fd The trigger socket (non blocking)
+ * @return The number of triggers read
+ */
+int ARSAL_ClipRecorder_TriggerReceive(ARSAL_ClipRecorder_t *recorder, int fd);
+
+/**
+ * @brief Send a trigger to the recorder listening on a socket
+ * @param path The socket path given to ARSAL_ClipRecorder_TriggerOpen()
+ * @param timestamp The event time (see ARSAL_Time_GetMonotonicNs(), the clock is shared by every process)
+ * @retval On success, returns ARSAL_OK. Otherwise, it returns an error number of eARSAL_ERROR
+ */
+eARSAL_ERROR ARSAL_ClipRecorder_SendTrigger(const char *path, ARSAL_Time_Ns_t timestamp);
+
+/**
+ * @brief Get the clip recorder statistics
+ * @param recorder The clip recorder
+ * @param[out] stats The statistics
+ */
+void ARSAL_ClipRecorder_GetStats(ARSAL_ClipRecorder_t *recorder, ARSAL_ClipRecorder_Stats_t *stats);
+
+#endif /* _ARSAL_CLIP_RECORDER_H_ */
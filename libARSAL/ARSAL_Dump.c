@@ -0,0 +1,562 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_Dump.c
+ * @brief Asynchronous binary data dump with file rotation
+ * @date 10/18/2026
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <libARSAL/ARSAL_Dump.h>
+#include <libARSAL/ARSAL_Endianness.h>
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_Thread.h>
+#include <libARSAL/ARSAL_Time.h>
+#include <libARSAL/ARSAL_Writer.h>
+
+#define ARSAL_DUMP_TAG "ARSAL_Dump"
+
+struct ARSAL_Dump_t
+{
+    char *basePath;
+    size_t writeSize;
+    uint32_t flushPeriodMs;
+    size_t rotateSize;
+    uint32_t rotatePeriodMs;
+    int rotateCount;
+
+    /* Ring: positions are free running, the offset in the ring is pos % ringSize */
+    uint8_t *ring;
+    size_t ringSize;
+    uint64_t head;      /* Written by producers, under mutex */
+    uint64_t tail;      /* Written by the writer thread, under mutex */
+
+    ARSAL_Mutex_t mutex;
+    ARSAL_Cond_t writerCond;
+    ARSAL_Cond_t flushCond;
+    int writerWaiting;
+    uint64_t flushTarget;   /* Position ARSAL_Dump_Flush() callers wait for */
+    uint64_t flushed;       /* Position up to which the data is written, not only queued */
+    int rotateRequest;
+    int rotatePending;      /* The file is rotated once tail reaches rotateAt */
+    uint64_t rotateAt;      /* Value of head when the rotation was decided: a record boundary */
+    int run;
+
+    /* Owned by the writer thread */
+    ARSAL_Writer_t *writer;
+    ARSAL_Writer_Stream_t *stream;
+    int fd;
+    size_t fileSize;
+    struct timespec fileOpenTime;
+    struct timespec lastWriteTime;
+
+    ARSAL_Dump_Stats_t stats;
+    ARSAL_Thread_t writerThread;
+};
+
+static size_t ARSAL_Dump_RoundUp(size_t value, size_t align)
+{
+    return ((value + align - 1) / align) * align;
+}
+
+static void ARSAL_Dump_RingCopy(ARSAL_Dump_t *dump, uint64_t pos, const void *src, size_t len)
+{
+    size_t offset = (size_t)(pos % dump->ringSize);
+    size_t first = dump->ringSize - offset;
+
+    if (first >= len)
+    {
+        memcpy(dump->ring + offset, src, len);
+    }
+    else
+    {
+        memcpy(dump->ring + offset, src, first);
+        memcpy(dump->ring, (const uint8_t *)src + first, len - first);
+    }
+}
+
+static int ARSAL_Dump_OpenFile(ARSAL_Dump_t *dump)
+{
+    ARSAL_Writer_Stream_Config_t config;
+
+    if (dump->writer != NULL)
+    {
+        /* The dump thread can wait for the writer, the producers never wait for it */
+        memset(&config, 0, sizeof(config));
+        config.backpressure = ARSAL_WRITER_BACKPRESSURE_BLOCK;
+        dump->stream = ARSAL_Writer_Open(dump->writer, dump->basePath, &config, NULL);
+        if (dump->stream == NULL)
+        {
+            return -1;
+        }
+        dump->fileSize = 0;
+        ARSAL_Time_GetTime(&dump->fileOpenTime);
+        return 0;
+    }
+
+    dump->fd = open(dump->basePath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (dump->fd < 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSAL_DUMP_TAG, "Unable to open '%s': %s", dump->basePath, strerror(errno));
+        return -1;
+    }
+    dump->fileSize = 0;
+    ARSAL_Time_GetTime(&dump->fileOpenTime);
+    return 0;
+}
+
+static void ARSAL_Dump_RotateFile(ARSAL_Dump_t *dump)
+{
+    if (dump->stream != NULL)
+    {
+        ARSAL_Writer_Close(&dump->stream);
+    }
+    if (dump->fd >= 0)
+    {
+        close(dump->fd);
+        dump->fd = -1;
+    }
+    ARSAL_Print_DumpRotateFiles(dump->basePath, dump->rotateCount);
+    /* Restart the size and period even if the new file cannot be opened */
+    dump->fileSize = 0;
+    ARSAL_Time_GetTime(&dump->fileOpenTime);
+    ARSAL_Dump_OpenFile(dump);
+    dump->stats.rotations++;
+}
+
+/**
+ * @brief Write len bytes of the ring starting at tail (must not wrap) to the file
+ * @note Called without the mutex held
+ * @return 0 on success, -1 if the data could not be written
+ */
+static int ARSAL_Dump_WriteSegment(ARSAL_Dump_t *dump, uint64_t tail, size_t len)
+{
+    const uint8_t *src = dump->ring + (size_t)(tail % dump->ringSize);
+    size_t done = 0;
+
+    if (dump->stream != NULL)
+    {
+        if (ARSAL_Writer_Write(dump->stream, src, len) != ARSAL_OK)
+        {
+            return -1;
+        }
+        dump->fileSize += len;
+        return 0;
+    }
+
+    if (dump->fd < 0)
+    {
+        return -1;
+    }
+
+    while (done < len)
+    {
+        ssize_t ret = write(dump->fd, src + done, len - done);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSAL_DUMP_TAG, "Write error on '%s': %s", dump->basePath, strerror(errno));
+            return -1;
+        }
+        done += (size_t)ret;
+    }
+    dump->fileSize += len;
+    return 0;
+}
+
+static void *ARSAL_Dump_WriterRun(void *arg)
+{
+    ARSAL_Dump_t *dump = arg;
+    struct timespec now;
+
+    ARSAL_Time_GetTime(&dump->lastWriteTime);
+
+    ARSAL_Mutex_Lock(&dump->mutex);
+    for (;;)
+    {
+        uint64_t pending = dump->head - dump->tail;
+        uint64_t tail, target;
+        size_t len, offset;
+        int drain, ret;
+
+        ARSAL_Time_GetTime(&now);
+
+        /* Every value of head ends a whole record: the file is rotated when
+         * tail reaches the head seen at decision time, never mid-record */
+        if ((!dump->rotatePending) &&
+            ((dump->rotateRequest) ||
+             ((dump->rotateSize > 0) && (dump->fileSize + pending >= dump->rotateSize)) ||
+             ((dump->rotatePeriodMs > 0) && (dump->fileSize + pending > 0) &&
+              (ARSAL_Time_ComputeTimespecMsTimeDiff(&dump->fileOpenTime, &now) >= (int32_t)dump->rotatePeriodMs))))
+        {
+            dump->rotateRequest = 0;
+            dump->rotatePending = 1;
+            dump->rotateAt = dump->head;
+        }
+
+        if ((dump->flushed < dump->flushTarget) && (dump->tail >= dump->flushTarget))
+        {
+            /* ARSAL_Dump_Flush() waits for the data to be written, not only queued */
+            target = dump->flushTarget;
+            ARSAL_Mutex_Unlock(&dump->mutex);
+            if ((dump->stream != NULL) && (ARSAL_Writer_Flush(dump->stream, 0) != ARSAL_OK))
+            {
+                ARSAL_Mutex_Lock(&dump->mutex);
+                dump->stats.writeErrors++;
+            }
+            else
+            {
+                ARSAL_Mutex_Lock(&dump->mutex);
+            }
+            dump->flushed = target;
+            ARSAL_Cond_Broadcast(&dump->flushCond);
+            continue;
+        }
+
+        if ((dump->rotatePending) && (dump->tail == dump->rotateAt))
+        {
+            ARSAL_Mutex_Unlock(&dump->mutex);
+            ARSAL_Dump_RotateFile(dump);
+            ARSAL_Mutex_Lock(&dump->mutex);
+            dump->rotatePending = 0;
+            continue;
+        }
+
+        if (pending == 0)
+        {
+            dump->lastWriteTime = now;
+            if (!dump->run)
+            {
+                break;
+            }
+        }
+
+        drain = (!dump->run) || (dump->tail < dump->flushTarget) || (dump->rotatePending) ||
+            (ARSAL_Time_ComputeTimespecMsTimeDiff(&dump->lastWriteTime, &now) >= (int32_t)dump->flushPeriodMs);
+
+        /* Outside of drains, writes stop on a writeSize boundary of the ring,
+         * so once the writer has caught up every write is a whole number of
+         * aligned chunks. A pending rotation bounds the write to its record
+         * boundary. */
+        tail = dump->tail;
+        offset = (size_t)(tail % dump->ringSize);
+        len = dump->ringSize - offset;
+        if (len > pending)
+        {
+            len = (size_t)pending;
+        }
+        if ((dump->rotatePending) && (tail + len > dump->rotateAt))
+        {
+            len = (size_t)(dump->rotateAt - tail);
+        }
+        if ((!drain) && (len > 0))
+        {
+            /* No boundary before the end of the pending data: wait for more */
+            size_t cut = (offset + len) % dump->writeSize;
+            len = (cut <= len) ? len - cut : 0;
+        }
+
+        if (len == 0)
+        {
+            dump->writerWaiting = 1;
+            ARSAL_Cond_Timedwait(&dump->writerCond, &dump->mutex, (int)dump->flushPeriodMs);
+            dump->writerWaiting = 0;
+            continue;
+        }
+        ARSAL_Mutex_Unlock(&dump->mutex);
+
+        ret = ARSAL_Dump_WriteSegment(dump, tail, len);
+
+        ARSAL_Mutex_Lock(&dump->mutex);
+        dump->tail += len;
+        if (ret == 0)
+        {
+            dump->stats.bytesWritten += len;
+        }
+        else
+        {
+            dump->stats.writeErrors++;
+        }
+        dump->lastWriteTime = now;
+    }
+    ARSAL_Mutex_Unlock(&dump->mutex);
+
+    return NULL;
+}
+
+ARSAL_Dump_t *ARSAL_Dump_New(const ARSAL_Dump_Config_t *config, eARSAL_ERROR *error)
+{
+    ARSAL_Dump_t *dump = NULL;
+    eARSAL_ERROR err = ARSAL_OK;
+    void *ring = NULL;
+
+    if ((config == NULL) || (config->basePath == NULL))
+    {
+        err = ARSAL_ERROR_BAD_PARAMETER;
+    }
+
+    if (err == ARSAL_OK)
+    {
+        dump = calloc(1, sizeof(*dump));
+        if (dump == NULL)
+        {
+            err = ARSAL_ERROR_ALLOC;
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        dump->fd = -1;
+        dump->writeSize = ARSAL_Dump_RoundUp((config->writeSize > 0) ? config->writeSize : ARSAL_DUMP_DEFAULT_WRITE_SIZE, ARSAL_DUMP_ALIGNMENT);
+        dump->ringSize = ARSAL_Dump_RoundUp((config->ringSize > 0) ? config->ringSize : ARSAL_DUMP_DEFAULT_RING_SIZE, dump->writeSize);
+        dump->flushPeriodMs = (config->flushPeriodMs > 0) ? config->flushPeriodMs : ARSAL_DUMP_DEFAULT_FLUSH_PERIOD_MS;
+        dump->rotateSize = config->rotateSize;
+        dump->rotatePeriodMs = config->rotatePeriodMs;
+        dump->rotateCount = config->rotateCount;
+        dump->writer = config->writer;
+        dump->basePath = strdup(config->basePath);
+        if ((dump->basePath == NULL) || (posix_memalign(&ring, ARSAL_DUMP_ALIGNMENT, dump->ringSize) != 0))
+        {
+            err = ARSAL_ERROR_ALLOC;
+        }
+        else
+        {
+            /* Touch the ring now so the hot path never page faults on it */
+            dump->ring = ring;
+            memset(dump->ring, 0, dump->ringSize);
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        if ((ARSAL_Mutex_Init(&dump->mutex) != 0) ||
+            (ARSAL_Cond_Init(&dump->writerCond) != 0) ||
+            (ARSAL_Cond_Init(&dump->flushCond) != 0))
+        {
+            err = ARSAL_ERROR_SYSTEM;
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        if (ARSAL_Dump_OpenFile(dump) != 0)
+        {
+            err = ARSAL_ERROR_FILE;
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        dump->run = 1;
+        if (ARSAL_Thread_Create(&dump->writerThread, ARSAL_Dump_WriterRun, dump) != 0)
+        {
+            dump->writerThread = NULL;
+            err = ARSAL_ERROR_SYSTEM;
+        }
+    }
+
+    if (err != ARSAL_OK)
+    {
+        ARSAL_Dump_Delete(&dump);
+    }
+
+    if (error != NULL)
+    {
+        *error = err;
+    }
+    return dump;
+}
+
+void ARSAL_Dump_Delete(ARSAL_Dump_t **dump)
+{
+    ARSAL_Dump_t *d;
+
+    if ((dump == NULL) || (*dump == NULL))
+    {
+        return;
+    }
+    d = *dump;
+
+    if (d->writerThread != NULL)
+    {
+        ARSAL_Mutex_Lock(&d->mutex);
+        d->run = 0;
+        ARSAL_Cond_Signal(&d->writerCond);
+        ARSAL_Mutex_Unlock(&d->mutex);
+        ARSAL_Thread_Join(d->writerThread, NULL);
+        ARSAL_Thread_Destroy(&d->writerThread);
+    }
+
+    if (d->stream != NULL)
+    {
+        ARSAL_Writer_Close(&d->stream);
+    }
+    if (d->fd >= 0)
+    {
+        close(d->fd);
+    }
+    if (d->mutex != NULL)
+    {
+        ARSAL_Mutex_Destroy(&d->mutex);
+    }
+    if (d->writerCond != NULL)
+    {
+        ARSAL_Cond_Destroy(&d->writerCond);
+    }
+    if (d->flushCond != NULL)
+    {
+        ARSAL_Cond_Destroy(&d->flushCond);
+    }
+    free(d->ring);
+    free(d->basePath);
+    free(d);
+    *dump = NULL;
+}
+
+eARSAL_ERROR ARSAL_Dump_Data(ARSAL_Dump_t *dump, uint8_t tag, const void *data, size_t size, size_t sizeDump, const struct timespec *ts)
+{
+    uint8_t header[ARSAL_DUMP_RECORD_HEADER_SIZE];
+    struct timespec now;
+    uint32_t field;
+    size_t recordSize;
+    int wake;
+
+    if ((dump == NULL) || ((data == NULL) && (size > 0)))
+    {
+        return ARSAL_ERROR_BAD_PARAMETER;
+    }
+
+    if ((sizeDump == 0) || (sizeDump > size))
+    {
+        sizeDump = size;
+    }
+    if (ts == NULL)
+    {
+        ARSAL_Time_GetTime(&now);
+        ts = &now;
+    }
+
+    memset(header, 0, sizeof(header));
+    header[0] = tag;
+    field = htodl((uint32_t)size);
+    memcpy(&header[4], &field, 4);
+    field = htodl((uint32_t)sizeDump);
+    memcpy(&header[8], &field, 4);
+    field = htodl((uint32_t)ts->tv_sec);
+    memcpy(&header[12], &field, 4);
+    field = htodl((uint32_t)ts->tv_nsec);
+    memcpy(&header[16], &field, 4);
+    recordSize = sizeof(header) + sizeDump;
+
+    ARSAL_Mutex_Lock(&dump->mutex);
+    if (recordSize > dump->ringSize - (size_t)(dump->head - dump->tail))
+    {
+        dump->stats.droppedRecords++;
+        dump->stats.droppedBytes += recordSize;
+        ARSAL_Mutex_Unlock(&dump->mutex);
+        return ARSAL_ERROR_DUMP_OVERFLOW;
+    }
+    ARSAL_Dump_RingCopy(dump, dump->head, header, sizeof(header));
+    ARSAL_Dump_RingCopy(dump, dump->head + sizeof(header), data, sizeDump);
+    dump->head += recordSize;
+    dump->stats.records++;
+    dump->stats.bytesQueued += recordSize;
+    wake = dump->writerWaiting && ((dump->head - dump->tail) >= dump->writeSize);
+    ARSAL_Mutex_Unlock(&dump->mutex);
+
+    if (wake)
+    {
+        ARSAL_Cond_Signal(&dump->writerCond);
+    }
+    return ARSAL_OK;
+}
+
+eARSAL_ERROR ARSAL_Dump_Flush(ARSAL_Dump_t *dump)
+{
+    uint64_t target;
+
+    if (dump == NULL)
+    {
+        return ARSAL_ERROR_BAD_PARAMETER;
+    }
+
+    ARSAL_Mutex_Lock(&dump->mutex);
+    target = dump->head;
+    if (dump->flushed < target)
+    {
+        if (dump->flushTarget < target)
+        {
+            dump->flushTarget = target;
+        }
+        ARSAL_Cond_Signal(&dump->writerCond);
+        while ((dump->flushed < target) && (dump->run))
+        {
+            ARSAL_Cond_Wait(&dump->flushCond, &dump->mutex);
+        }
+    }
+    ARSAL_Mutex_Unlock(&dump->mutex);
+
+    return ARSAL_OK;
+}
+
+eARSAL_ERROR ARSAL_Dump_Rotate(ARSAL_Dump_t *dump)
+{
+    if (dump == NULL)
+    {
+        return ARSAL_ERROR_BAD_PARAMETER;
+    }
+
+    ARSAL_Mutex_Lock(&dump->mutex);
+    dump->rotateRequest = 1;
+    ARSAL_Cond_Signal(&dump->writerCond);
+    ARSAL_Mutex_Unlock(&dump->mutex);
+
+    return ARSAL_OK;
+}
+
+void ARSAL_Dump_GetStats(ARSAL_Dump_t *dump, ARSAL_Dump_Stats_t *stats)
+{
+    if ((dump == NULL) || (stats == NULL))
+    {
+        return;
+    }
+
+    ARSAL_Mutex_Lock(&dump->mutex);
+    *stats = dump->stats;
+    ARSAL_Mutex_Unlock(&dump->mutex);
+}
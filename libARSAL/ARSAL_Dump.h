@@ -0,0 +1,168 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_Dump.h
+ * @brief Asynchronous binary data dump with file rotation
+ * @date 10/18/2026
+ */
+#ifndef _ARSAL_DUMP_H_
+#define _ARSAL_DUMP_H_
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <time.h>
+#include <libARSAL/ARSAL_Error.h>
+#include <libARSAL/ARSAL_Writer.h>
+
+/**
+ * @brief Default size of the in-memory ring (bytes)
+ */
+#define ARSAL_DUMP_DEFAULT_RING_SIZE        (4 * 1024 * 1024)
+
+/**
+ * @brief Default size of a single write issued by the writer thread (bytes)
+ */
+#define ARSAL_DUMP_DEFAULT_WRITE_SIZE       (256 * 1024)
+
+/**
+ * @brief Alignment of the ring buffer and of the full-size writes (bytes)
+ */
+#define ARSAL_DUMP_ALIGNMENT                4096
+
+/**
+ * @brief Maximum time (ms) a record can stay in the ring before being written
+ */
+#define ARSAL_DUMP_DEFAULT_FLUSH_PERIOD_MS  500
+
+/**
+ * @brief Size of the header prepended to each dumped record (bytes)
+ *
+ * The header is little endian:
+ * `tag (1) | reserved (3) | size (4) | sizeDump (4) | ts.tv_sec (4) | ts.tv_nsec (4)`
+ * and is followed by sizeDump bytes of data.
+ */
+#define ARSAL_DUMP_RECORD_HEADER_SIZE       20
+
+/**
+ * @brief Dump object type
+ */
+typedef struct ARSAL_Dump_t ARSAL_Dump_t;
+
+/**
+ * @brief Dump configuration
+ * @see ARSAL_Dump_New ()
+ */
+typedef struct
+{
+    const char *basePath;       /**< Path of the dump file. Rotated files are named <basePath>.1, <basePath>.2 ... */
+    size_t ringSize;            /**< Size of the in-memory ring, rounded up to a multiple of writeSize. 0 for default */
+    size_t writeSize;           /**< Size of a full write, rounded up to ARSAL_DUMP_ALIGNMENT. 0 for default */
+    uint32_t flushPeriodMs;     /**< Maximum delay before pending data is written. 0 for default */
+    size_t rotateSize;          /**< Rotate the file once it reaches this size (bytes), at the next record boundary. 0 to disable */
+    uint32_t rotatePeriodMs;    /**< Rotate the file after this delay (ms), at the next record boundary. 0 to disable */
+    int rotateCount;            /**< Number of rotated files to keep (see ARSAL_Print_DumpRotateFiles ()) */
+    ARSAL_Writer_t *writer;     /**< Writer the file goes through (see ARSAL_Writer.h). NULL to write it directly */
+} ARSAL_Dump_Config_t;
+
+/**
+ * @brief Dump statistics
+ * @see ARSAL_Dump_GetStats ()
+ */
+typedef struct
+{
+    uint64_t records;           /**< Number of records queued */
+    uint64_t bytesQueued;       /**< Number of bytes queued, headers included */
+    uint64_t bytesWritten;      /**< Number of bytes written to disk */
+    uint64_t droppedRecords;    /**< Number of records dropped because the ring was full */
+    uint64_t droppedBytes;      /**< Number of bytes dropped because the ring was full */
+    uint32_t rotations;         /**< Number of file rotations */
+    uint32_t writeErrors;       /**< Number of failed writes */
+} ARSAL_Dump_Stats_t;
+
+/**
+ * @brief Create a new dump and start its writer thread
+ * @warning This function allocates memory
+ * @param config The dump configuration
+ * @param[out] error A pointer on the error output (optional, may be NULL)
+ * @return Pointer on the new dump, or NULL on error
+ * @see ARSAL_Dump_Delete ()
+ */
+ARSAL_Dump_t *ARSAL_Dump_New(const ARSAL_Dump_Config_t *config, eARSAL_ERROR *error);
+
+/**
+ * @brief Flush pending data, stop the writer thread and delete the dump
+ * @warning This function frees memory
+ * @param dump The address of the pointer on the dump
+ * @see ARSAL_Dump_New ()
+ */
+void ARSAL_Dump_Delete(ARSAL_Dump_t **dump);
+
+/**
+ * @brief Queue data to be dumped
+ *
+ * This is the asynchronous counterpart of ARSAL_Print_DumpData(). The data is
+ * copied into the ring and written later by the writer thread. This function
+ * never waits for disk I/O: if the ring is full the record is dropped and
+ * counted in the statistics.
+ *
+ * @param dump The dump
+ * @param tag 1-byte identifier of data.
+ * @param data data buffer.
+ * @param size size of data.
+ * @param sizeDump size of data to actually dump. 0 to dump everything.
+ * @param ts timestamp of data. NULL to use current time
+ * @retval ARSAL_OK if the record was queued, ARSAL_ERROR_DUMP_OVERFLOW if it was dropped. Otherwise, it returns an error number of eARSAL_ERROR
+ * @see ARSAL_Print_DumpData ()
+ */
+eARSAL_ERROR ARSAL_Dump_Data(ARSAL_Dump_t *dump, uint8_t tag, const void *data, size_t size, size_t sizeDump, const struct timespec *ts);
+
+/**
+ * @brief Ask the writer thread to write all pending data and wait for it
+ * @param dump The dump
+ * @retval On success, returns ARSAL_OK. Otherwise, it returns an error number of eARSAL_ERROR
+ */
+eARSAL_ERROR ARSAL_Dump_Flush(ARSAL_Dump_t *dump);
+
+/**
+ * @brief Ask the writer thread to rotate the dump file
+ * @param dump The dump
+ * @retval On success, returns ARSAL_OK. Otherwise, it returns an error number of eARSAL_ERROR
+ */
+eARSAL_ERROR ARSAL_Dump_Rotate(ARSAL_Dump_t *dump);
+
+/**
+ * @brief Get the dump statistics
+ * @param dump The dump
+ * @param[out] stats The statistics
+ */
+void ARSAL_Dump_GetStats(ARSAL_Dump_t *dump, ARSAL_Dump_Stats_t *stats);
+
+#endif /* _ARSAL_DUMP_H_ */
@@ -0,0 +1,235 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_Endianness.c
+ * @brief Vectorized bulk byte order conversion
+ * @date 10/18/2026
+ */
+#include <string.h>
+#include <libARSAL/ARSAL_Endianness.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ARSAL_ENDIANNESS_X86 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define ARSAL_ENDIANNESS_NEON 1
+#endif
+
+/*
+ * Scalar tails (and whole arrays on other architectures)
+ */
+
+static void ARSAL_Endianness_ScalarSwap16 (uint8_t *dst, const uint8_t *src, size_t count)
+{
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        uint16_t v;
+        memcpy (&v, src + 2 * i, 2);
+        v = __builtin_bswap16 (v);
+        memcpy (dst + 2 * i, &v, 2);
+    }
+}
+
+static void ARSAL_Endianness_ScalarSwap32 (uint8_t *dst, const uint8_t *src, size_t count)
+{
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        uint32_t v;
+        memcpy (&v, src + 4 * i, 4);
+        v = __builtin_bswap32 (v);
+        memcpy (dst + 4 * i, &v, 4);
+    }
+}
+
+static void ARSAL_Endianness_ScalarSwap64 (uint8_t *dst, const uint8_t *src, size_t count)
+{
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        uint64_t v;
+        memcpy (&v, src + 8 * i, 8);
+        v = __builtin_bswap64 (v);
+        memcpy (dst + 8 * i, &v, 8);
+    }
+}
+
+#if defined(ARSAL_ENDIANNESS_X86)
+/*
+ * x86: pshufb with a per element-size mask, AVX2 chosen at runtime
+ */
+
+static const uint8_t ARSAL_Endianness_Mask16[32] = {
+    1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+    1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+};
+static const uint8_t ARSAL_Endianness_Mask32[32] = {
+    3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+    3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+};
+static const uint8_t ARSAL_Endianness_Mask64[32] = {
+    7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+    7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+};
+
+/**
+ * @brief Swap size bytes (rounded down to 32 bytes) with AVX2
+ * @return The number of bytes processed
+ */
+__attribute__((target("avx2")))
+static size_t ARSAL_Endianness_ShuffleAvx2 (uint8_t *dst, const uint8_t *src, size_t size, const uint8_t *mask)
+{
+    const __m256i shuffle = _mm256_loadu_si256 ((const __m256i *)mask);
+    size_t done = 0;
+
+    for (; done + 64 <= size; done += 64)
+    {
+        __m256i a = _mm256_loadu_si256 ((const __m256i *)(src + done));
+        __m256i b = _mm256_loadu_si256 ((const __m256i *)(src + done + 32));
+        _mm256_storeu_si256 ((__m256i *)(dst + done), _mm256_shuffle_epi8 (a, shuffle));
+        _mm256_storeu_si256 ((__m256i *)(dst + done + 32), _mm256_shuffle_epi8 (b, shuffle));
+    }
+    for (; done + 32 <= size; done += 32)
+    {
+        __m256i a = _mm256_loadu_si256 ((const __m256i *)(src + done));
+        _mm256_storeu_si256 ((__m256i *)(dst + done), _mm256_shuffle_epi8 (a, shuffle));
+    }
+    return done;
+}
+
+/**
+ * @brief Swap size bytes (rounded down to 16 bytes) with SSSE3
+ * @return The number of bytes processed
+ */
+__attribute__((target("ssse3")))
+static size_t ARSAL_Endianness_ShuffleSsse3 (uint8_t *dst, const uint8_t *src, size_t size, const uint8_t *mask)
+{
+    const __m128i shuffle = _mm_loadu_si128 ((const __m128i *)mask);
+    size_t done = 0;
+
+    for (; done + 16 <= size; done += 16)
+    {
+        __m128i a = _mm_loadu_si128 ((const __m128i *)(src + done));
+        _mm_storeu_si128 ((__m128i *)(dst + done), _mm_shuffle_epi8 (a, shuffle));
+    }
+    return done;
+}
+
+static size_t ARSAL_Endianness_Shuffle (uint8_t *dst, const uint8_t *src, size_t size, const uint8_t *mask)
+{
+    static int level = -1;
+    size_t done = 0;
+
+    if (level < 0)
+    {
+        /* Benign race: every thread computes the same value */
+        __builtin_cpu_init ();
+        level = __builtin_cpu_supports ("avx2") ? 2 : (__builtin_cpu_supports ("ssse3") ? 1 : 0);
+    }
+
+    if (level >= 2)
+    {
+        done = ARSAL_Endianness_ShuffleAvx2 (dst, src, size, mask);
+    }
+    if (level >= 1)
+    {
+        done += ARSAL_Endianness_ShuffleSsse3 (dst + done, src + done, size - done, mask);
+    }
+    return done;
+}
+
+#define ARSAL_ENDIANNESS_VECTOR16(d, s, size) ARSAL_Endianness_Shuffle ((d), (s), (size), ARSAL_Endianness_Mask16)
+#define ARSAL_ENDIANNESS_VECTOR32(d, s, size) ARSAL_Endianness_Shuffle ((d), (s), (size), ARSAL_Endianness_Mask32)
+#define ARSAL_ENDIANNESS_VECTOR64(d, s, size) ARSAL_Endianness_Shuffle ((d), (s), (size), ARSAL_Endianness_Mask64)
+
+#elif defined(ARSAL_ENDIANNESS_NEON)
+/*
+ * NEON: vrev16/32/64 on 16 bytes vectors
+ */
+
+#define ARSAL_ENDIANNESS_NEON_SWAP(name, rev)                                       \
+    static size_t name (uint8_t *dst, const uint8_t *src, size_t size)              \
+    {                                                                               \
+        size_t done = 0;                                                            \
+        for (; done + 32 <= size; done += 32)                                       \
+        {                                                                           \
+            uint8x16_t a = vld1q_u8 (src + done);                                   \
+            uint8x16_t b = vld1q_u8 (src + done + 16);                              \
+            vst1q_u8 (dst + done, rev (a));                                         \
+            vst1q_u8 (dst + done + 16, rev (b));                                    \
+        }                                                                           \
+        for (; done + 16 <= size; done += 16)                                       \
+        {                                                                           \
+            vst1q_u8 (dst + done, rev (vld1q_u8 (src + done)));                     \
+        }                                                                           \
+        return done;                                                                \
+    }
+
+ARSAL_ENDIANNESS_NEON_SWAP (ARSAL_Endianness_Neon16, vrev16q_u8)
+ARSAL_ENDIANNESS_NEON_SWAP (ARSAL_Endianness_Neon32, vrev32q_u8)
+ARSAL_ENDIANNESS_NEON_SWAP (ARSAL_Endianness_Neon64, vrev64q_u8)
+
+#define ARSAL_ENDIANNESS_VECTOR16(d, s, size) ARSAL_Endianness_Neon16 ((d), (s), (size))
+#define ARSAL_ENDIANNESS_VECTOR32(d, s, size) ARSAL_Endianness_Neon32 ((d), (s), (size))
+#define ARSAL_ENDIANNESS_VECTOR64(d, s, size) ARSAL_Endianness_Neon64 ((d), (s), (size))
+
+#else
+
+#define ARSAL_ENDIANNESS_VECTOR16(d, s, size) ((void)(d), (void)(s), (void)(size), (size_t)0)
+#define ARSAL_ENDIANNESS_VECTOR32(d, s, size) ((void)(d), (void)(s), (void)(size), (size_t)0)
+#define ARSAL_ENDIANNESS_VECTOR64(d, s, size) ((void)(d), (void)(s), (void)(size), (size_t)0)
+
+#endif
+
+/*
+ * Public functions: vector body then scalar tail. Each vector block is
+ * loaded before being stored, so dst == src is safe.
+ */
+
+void ARSAL_Endianness_BswapArray16 (void *dst, const void *src, size_t count)
+{
+    size_t done = ARSAL_ENDIANNESS_VECTOR16 ((uint8_t *)dst, (const uint8_t *)src, count * 2);
+    ARSAL_Endianness_ScalarSwap16 ((uint8_t *)dst + done, (const uint8_t *)src + done, count - done / 2);
+}
+
+void ARSAL_Endianness_BswapArray32 (void *dst, const void *src, size_t count)
+{
+    size_t done = ARSAL_ENDIANNESS_VECTOR32 ((uint8_t *)dst, (const uint8_t *)src, count * 4);
+    ARSAL_Endianness_ScalarSwap32 ((uint8_t *)dst + done, (const uint8_t *)src + done, count - done / 4);
+}
+
+void ARSAL_Endianness_BswapArray64 (void *dst, const void *src, size_t count)
+{
+    size_t done = ARSAL_ENDIANNESS_VECTOR64 ((uint8_t *)dst, (const uint8_t *)src, count * 8);
+    ARSAL_Endianness_ScalarSwap64 ((uint8_t *)dst + done, (const uint8_t *)src + done, count - done / 8);
+}
@@ -539,4 +539,120 @@ static inline double ARSAL_Endianness_bswapd (double orig)
 
 #endif // __APPLE__
 
+/*
+ * BULK CONVERSION FUNCTIONS
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @brief Non zero when the host already uses the device endianness (bulk conversions are plain copies)
+ */
+#ifndef ARSAL_ENDIANNESS_HOST_IS_DEVICE
+# if defined(__APPLE__)
+#  if (defined(__LITTLE_ENDIAN__) && __DEVICE_ENDIAN == __LITTLE_ENDIAN) || (defined(__BIG_ENDIAN__) && __DEVICE_ENDIAN == __BIG_ENDIAN)
+#   define ARSAL_ENDIANNESS_HOST_IS_DEVICE 1
+#  else
+#   define ARSAL_ENDIANNESS_HOST_IS_DEVICE 0
+#  endif
+# elif __BYTE_ORDER == __DEVICE_ENDIAN
+#  define ARSAL_ENDIANNESS_HOST_IS_DEVICE 1
+# else
+#  define ARSAL_ENDIANNESS_HOST_IS_DEVICE 0
+# endif
+#endif
+
+/**
+ * @brief Swap the byte order of an array of 2 bytes elements
+ *
+ * Uses SSSE3/AVX2 (selected at runtime) or NEON shuffles when available.
+ *
+ * @param dst Destination array. May be equal to src for an in-place conversion, must not overlap it otherwise
+ * @param src Source array. No alignment is required
+ * @param count Number of elements
+ */
+void ARSAL_Endianness_BswapArray16 (void *dst, const void *src, size_t count);
+
+/**
+ * @brief Swap the byte order of an array of 4 bytes elements (int32, uint32, float)
+ * @see ARSAL_Endianness_BswapArray16 ()
+ * @param dst Destination array. May be equal to src for an in-place conversion, must not overlap it otherwise
+ * @param src Source array. No alignment is required
+ * @param count Number of elements
+ */
+void ARSAL_Endianness_BswapArray32 (void *dst, const void *src, size_t count);
+
+/**
+ * @brief Swap the byte order of an array of 8 bytes elements (int64, uint64, double)
+ * @see ARSAL_Endianness_BswapArray16 ()
+ * @param dst Destination array. May be equal to src for an in-place conversion, must not overlap it otherwise
+ * @param src Source array. No alignment is required
+ * @param count Number of elements
+ */
+void ARSAL_Endianness_BswapArray64 (void *dst, const void *src, size_t count);
+
+/**
+ * @brief INTERNAL FUNCTION : Copy an array when no conversion is needed
+ * @param dst Destination array
+ * @param src Source array
+ * @param size Size in bytes
+ */
+static inline void ARSAL_Endianness_CopyArray (void *dst, const void *src, size_t size)
+{
+    if (dst != src)
+    {
+        memcpy (dst, src, size);
+    }
+}
+
+#if ARSAL_ENDIANNESS_HOST_IS_DEVICE
+/**
+ * @brief Convert an array of 2 bytes elements to device endianness (in-place if dst == src)
+ */
+#define htodArray16(dst, src, count) ARSAL_Endianness_CopyArray((dst), (src), (size_t)(count) * 2)
+/**
+ * @brief Convert an array of 4 bytes elements (int32, uint32, float) to device endianness (in-place if dst == src)
+ */
+#define htodArray32(dst, src, count) ARSAL_Endianness_CopyArray((dst), (src), (size_t)(count) * 4)
+/**
+ * @brief Convert an array of 8 bytes elements (int64, uint64, double) to device endianness (in-place if dst == src)
+ */
+#define htodArray64(dst, src, count) ARSAL_Endianness_CopyArray((dst), (src), (size_t)(count) * 8)
+#else
+#define htodArray16(dst, src, count) ARSAL_Endianness_BswapArray16((dst), (src), (count))
+#define htodArray32(dst, src, count) ARSAL_Endianness_BswapArray32((dst), (src), (count))
+#define htodArray64(dst, src, count) ARSAL_Endianness_BswapArray64((dst), (src), (count))
+#endif
+
+/**
+ * @brief Convert an array of 2 bytes elements from device endianness (in-place if dst == src)
+ */
+#define dtohArray16(dst, src, count) htodArray16((dst), (src), (count))
+/**
+ * @brief Convert an array of 4 bytes elements (int32, uint32, float) from device endianness (in-place if dst == src)
+ */
+#define dtohArray32(dst, src, count) htodArray32((dst), (src), (count))
+/**
+ * @brief Convert an array of 8 bytes elements (int64, uint64, double) from device endianness (in-place if dst == src)
+ */
+#define dtohArray64(dst, src, count) htodArray64((dst), (src), (count))
+
+/**
+ * @brief Convert an array of IEEE-754 floats to device endianness (in-place if dst == src)
+ */
+#define htodArrayf(dst, src, count) htodArray32((dst), (src), (count))
+/**
+ * @brief Convert an array of IEEE-754 doubles to device endianness (in-place if dst == src)
+ */
+#define htodArrayd(dst, src, count) htodArray64((dst), (src), (count))
+/**
+ * @brief Convert an array of IEEE-754 floats from device endianness (in-place if dst == src)
+ */
+#define dtohArrayf(dst, src, count) dtohArray32((dst), (src), (count))
+/**
+ * @brief Convert an array of IEEE-754 doubles from device endianness (in-place if dst == src)
+ */
+#define dtohArrayd(dst, src, count) dtohArray64((dst), (src), (count))
+
 #endif /* _ARSAL_ENDIANNESS_H_ */
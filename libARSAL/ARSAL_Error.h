@@ -46,6 +46,20 @@ typedef enum
     
     ARSAL_ERROR_MD5 = -2000,                   /**< ARSAL md5 error */
 
+    ARSAL_ERROR_DUMP = -3000,                  /**< ARSAL dump error */
+    ARSAL_ERROR_DUMP_OVERFLOW,                 /**< ARSAL dump ring is full, data was dropped */
+
+    ARSAL_ERROR_FRAMERING = -4000,             /**< ARSAL frame ring error */
+    ARSAL_ERROR_FRAMERING_FULL,                /**< ARSAL frame ring has no free slot, the frame is dropped */
+    ARSAL_ERROR_FRAMERING_TIMEOUT,             /**< ARSAL frame ring had no new frame before the deadline */
+    ARSAL_ERROR_FRAMERING_VERSION,             /**< ARSAL frame ring segment has an unknown layout */
+
+    ARSAL_ERROR_CLIP = -4500,                  /**< ARSAL clip recorder error */
+    ARSAL_ERROR_CLIP_OVERFLOW,                 /**< ARSAL clip recorder ring is full of unwritten data, the access unit is dropped */
+
+    ARSAL_ERROR_WRITER = -4600,                /**< ARSAL writer error */
+    ARSAL_ERROR_WRITER_FULL,                   /**< ARSAL writer has no free buffer, the data is dropped */
+
     ARSAL_ERROR_BLE_CONNECTION = -5000,        /**< BLE connection generic error */
     ARSAL_ERROR_BLE_NOT_CONNECTED,             /**< BLE is not connected */
     ARSAL_ERROR_BLE_DISCONNECTION,             /**< BLE disconnection error */
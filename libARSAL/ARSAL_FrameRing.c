@@ -0,0 +1,673 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_FrameRing.c
+ * @brief Zero-copy frame ring shared between processes
+ * @date 10/18/2026
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <libARSAL/ARSAL_Futex.h>
+#include <libARSAL/ARSAL_FrameRing.h>
+#include <libARSAL/ARSAL_Print.h>
+
+#define ARSAL_FRAMERING_TAG "ARSAL_FrameRing"
+
+#define ARSAL_FRAMERING_MAGIC           0x474E5246u     /* "FRNG" */
+#define ARSAL_FRAMERING_MAX_SLOTS       0xFFFF
+#define ARSAL_FRAMERING_SLOT_BITS       16
+#define ARSAL_FRAMERING_PAGE_SIZE       4096
+#define ARSAL_FRAMERING_CACHE_LINE      64
+/* Slot owner: 0 when free, the consumer token, or the publisher mark */
+#define ARSAL_FRAMERING_OWNER_FREE      0u
+#define ARSAL_FRAMERING_OWNER_PUBLISHER UINT32_MAX
+
+/* Shared segment layout: header, slot descriptors, page aligned slots */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t nbSlots;
+    volatile uint32_t nextConsumer;     /**< Last consumer token handed out */
+    uint64_t slotSize;
+    uint64_t slotStride;
+    uint64_t dataOffset;
+    uint64_t totalSize;
+    volatile uint64_t latest;           /**< Sequence << 16 | slot of the latest frame, 0 before the first */
+    volatile uint64_t published;
+    volatile uint64_t dropped;
+    volatile uint64_t reclaimed;
+    volatile uint32_t publishCount;     /**< Futex word, incremented on each publish */
+    volatile uint32_t waiters;
+    uint32_t nextSlot;                  /**< Publisher only */
+} __attribute__((aligned(ARSAL_FRAMERING_CACHE_LINE))) ARSAL_FrameRing_Header_t;
+
+typedef struct
+{
+    volatile uint32_t owner;
+    uint32_t size;
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;
+    uint32_t flags;
+    volatile uint64_t sequence;
+    uint64_t timestamp;
+    volatile uint64_t lease;            /**< Monotonic time until which the consumer owner holds the slot */
+} __attribute__((aligned(ARSAL_FRAMERING_CACHE_LINE))) ARSAL_FrameRing_Slot_t;
+
+struct ARSAL_FrameRing_t
+{
+    int fd;
+    uint8_t *base;
+    size_t size;
+    ARSAL_FrameRing_Header_t *header;
+    ARSAL_FrameRing_Slot_t *slots;
+    int publisher;
+    char *name;
+    uint32_t owner;                     /**< Consumer token, unique in the segment (pids are not, across namespaces) */
+    uint32_t nbSlots;                   /**< Layout, checked when mapped */
+    size_t slotSize;
+    size_t slotStride;
+    size_t dataOffset;
+    uint64_t skipped;
+};
+
+static size_t ARSAL_FrameRing_RoundUp(size_t value, size_t align)
+{
+    return (value + align - 1) & ~(align - 1);
+}
+
+static uint8_t *ARSAL_FrameRing_SlotData(ARSAL_FrameRing_t *ring, uint32_t slot)
+{
+    return ring->base + ring->dataOffset + slot * ring->slotStride;
+}
+
+static void ARSAL_FrameRing_FillFrame(ARSAL_FrameRing_t *ring, uint32_t index, ARSAL_FrameRing_Frame_t *frame)
+{
+    ARSAL_FrameRing_Slot_t *slot = &ring->slots[index];
+
+    frame->data = ARSAL_FrameRing_SlotData(ring, index);
+    frame->capacity = ring->slotSize;
+    frame->size = slot->size;
+    frame->width = slot->width;
+    frame->height = slot->height;
+    frame->format = slot->format;
+    frame->flags = slot->flags;
+    frame->timestamp = slot->timestamp;
+    frame->sequence = slot->sequence;
+    frame->slot = index;
+}
+
+static void ARSAL_FrameRing_Free(ARSAL_FrameRing_t *ring)
+{
+    if (ring->base != NULL)
+    {
+        munmap(ring->base, ring->size);
+    }
+    if (ring->fd >= 0)
+    {
+        close(ring->fd);
+    }
+    free(ring->name);
+    free(ring);
+}
+
+/**
+ * @brief Check the layout written by the publisher against the mapped size
+ * @note The layout is read once and kept in the handle: the segment is writable by other processes
+ */
+static int ARSAL_FrameRing_CheckLayout(ARSAL_FrameRing_t *ring, uint32_t nbSlots, uint64_t slotSize, uint64_t slotStride, uint64_t dataOffset, uint64_t totalSize)
+{
+    uint64_t slotsEnd, dataSize, end;
+
+    if ((nbSlots < 2) || (nbSlots > ARSAL_FRAMERING_MAX_SLOTS) || (slotSize == 0) || (slotSize > slotStride) ||
+        ((slotStride % ARSAL_FRAMERING_PAGE_SIZE) != 0) || ((dataOffset % ARSAL_FRAMERING_PAGE_SIZE) != 0))
+    {
+        return 0;
+    }
+    slotsEnd = sizeof(ARSAL_FrameRing_Header_t) + (uint64_t)nbSlots * sizeof(ARSAL_FrameRing_Slot_t);
+    if ((dataOffset < slotsEnd) ||
+        __builtin_mul_overflow((uint64_t)nbSlots, slotStride, &dataSize) ||
+        __builtin_add_overflow(dataOffset, dataSize, &end) ||
+        (end != totalSize) || (totalSize > ring->size))
+    {
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Map the segment of fd and check its layout
+ */
+static eARSAL_ERROR ARSAL_FrameRing_Map(ARSAL_FrameRing_t *ring)
+{
+    struct stat st;
+    ARSAL_FrameRing_Header_t *header;
+    uint32_t nbSlots;
+    uint64_t slotSize, slotStride, dataOffset, totalSize;
+
+    if ((fstat(ring->fd, &st) != 0) || ((size_t)st.st_size < sizeof(ARSAL_FrameRing_Header_t)))
+    {
+        return ARSAL_ERROR_FRAMERING;
+    }
+    ring->size = (size_t)st.st_size;
+    ring->base = mmap(NULL, ring->size, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd, 0);
+    if (ring->base == MAP_FAILED)
+    {
+        ring->base = NULL;
+        return ARSAL_ERROR_SYSTEM;
+    }
+
+    header = (ARSAL_FrameRing_Header_t *)ring->base;
+    if ((__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != ARSAL_FRAMERING_MAGIC) ||
+        (header->version != ARSAL_FRAMERING_VERSION))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSAL_FRAMERING_TAG, "Segment is not a frame ring of version %d", ARSAL_FRAMERING_VERSION);
+        return ARSAL_ERROR_FRAMERING_VERSION;
+    }
+
+    nbSlots = header->nbSlots;
+    slotSize = header->slotSize;
+    slotStride = header->slotStride;
+    dataOffset = header->dataOffset;
+    totalSize = header->totalSize;
+    if (!ARSAL_FrameRing_CheckLayout(ring, nbSlots, slotSize, slotStride, dataOffset, totalSize))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSAL_FRAMERING_TAG, "Invalid layout: %u slots of %" PRIu64 " (stride %" PRIu64 ") at %" PRIu64 ", total %" PRIu64 " in a segment of %zu",
+                    nbSlots, slotSize, slotStride, dataOffset, totalSize, ring->size);
+        return ARSAL_ERROR_FRAMERING;
+    }
+    ring->nbSlots = nbSlots;
+    ring->slotSize = (size_t)slotSize;
+    ring->slotStride = (size_t)slotStride;
+    ring->dataOffset = (size_t)dataOffset;
+    ring->header = header;
+    ring->slots = (ARSAL_FrameRing_Slot_t *)(ring->base + sizeof(ARSAL_FrameRing_Header_t));
+
+    /* Token 0 and the publisher mark are reserved */
+    do
+    {
+        ring->owner = __atomic_add_fetch(&header->nextConsumer, 1, __ATOMIC_RELAXED);
+    } while ((ring->owner == ARSAL_FRAMERING_OWNER_FREE) || (ring->owner == ARSAL_FRAMERING_OWNER_PUBLISHER));
+    return ARSAL_OK;
+}
+
+static ARSAL_FrameRing_t *ARSAL_FrameRing_Alloc(const char *name)
+{
+    ARSAL_FrameRing_t *ring = calloc(1, sizeof(*ring));
+
+    if (ring != NULL)
+    {
+        ring->fd = -1;
+        if (name != NULL)
+        {
+            ring->name = strdup(name);
+            if (ring->name == NULL)
+            {
+                free(ring);
+                ring = NULL;
+            }
+        }
+    }
+    return ring;
+}
+
+/*
+ * Public API
+ */
+
+ARSAL_FrameRing_t *ARSAL_FrameRing_New(const char *name, uint32_t nbSlots, size_t slotSize, eARSAL_ERROR *error)
+{
+    ARSAL_FrameRing_t *ring = NULL;
+    ARSAL_FrameRing_Header_t *header;
+    eARSAL_ERROR err = ARSAL_OK;
+    size_t dataOffset, slotStride, totalSize;
+
+    if ((nbSlots < 2) || (nbSlots > ARSAL_FRAMERING_MAX_SLOTS) || (slotSize == 0))
+    {
+        err = ARSAL_ERROR_BAD_PARAMETER;
+    }
+
+    if (err == ARSAL_OK)
+    {
+        ring = ARSAL_FrameRing_Alloc(name);
+        if (ring == NULL)
+        {
+            err = ARSAL_ERROR_ALLOC;
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        ring->publisher = 1;
+        if (name != NULL)
+        {
+            /* A stale segment of a crashed publisher is replaced */
+            shm_unlink(name);
+            ring->fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        }
+        else
+        {
+            ring->fd = memfd_create("ARSAL_FrameRing", MFD_CLOEXEC);
+        }
+        if (ring->fd < 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSAL_FRAMERING_TAG, "Can't create shared memory %s: %s", (name != NULL) ? name : "(memfd)", strerror(errno));
+            err = ARSAL_ERROR_SYSTEM;
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        dataOffset = ARSAL_FrameRing_RoundUp(sizeof(ARSAL_FrameRing_Header_t) + nbSlots * sizeof(ARSAL_FrameRing_Slot_t), ARSAL_FRAMERING_PAGE_SIZE);
+        slotStride = ARSAL_FrameRing_RoundUp(slotSize, ARSAL_FRAMERING_PAGE_SIZE);
+        totalSize = dataOffset + nbSlots * slotStride;
+        ring->size = totalSize;
+        if (ftruncate(ring->fd, (off_t)totalSize) != 0)
+        {
+            err = ARSAL_ERROR_SYSTEM;
+        }
+        else
+        {
+            ring->base = mmap(NULL, totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd, 0);
+            if (ring->base == MAP_FAILED)
+            {
+                ring->base = NULL;
+                err = ARSAL_ERROR_SYSTEM;
+            }
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        /* The segment is zero filled: all slots free, no frame yet */
+        header = (ARSAL_FrameRing_Header_t *)ring->base;
+        header->version = ARSAL_FRAMERING_VERSION;
+        header->nbSlots = nbSlots;
+        header->slotSize = slotSize;
+        header->slotStride = slotStride;
+        header->dataOffset = dataOffset;
+        header->totalSize = totalSize;
+        __atomic_store_n(&header->magic, ARSAL_FRAMERING_MAGIC, __ATOMIC_RELEASE);
+        ring->header = header;
+        ring->slots = (ARSAL_FrameRing_Slot_t *)(ring->base + sizeof(ARSAL_FrameRing_Header_t));
+        ring->nbSlots = nbSlots;
+        ring->slotSize = slotSize;
+        ring->slotStride = slotStride;
+        ring->dataOffset = dataOffset;
+    }
+
+    if ((err != ARSAL_OK) && (ring != NULL))
+    {
+        if ((name != NULL) && (ring->fd >= 0))
+        {
+            shm_unlink(name);
+        }
+        ARSAL_FrameRing_Free(ring);
+        ring = NULL;
+    }
+
+    if (error != NULL)
+    {
+        *error = err;
+    }
+    return ring;
+}
+
+ARSAL_FrameRing_t *ARSAL_FrameRing_Open(const char *name, eARSAL_ERROR *error)
+{
+    ARSAL_FrameRing_t *ring = NULL;
+    eARSAL_ERROR err = ARSAL_OK;
+
+    if (name == NULL)
+    {
+        err = ARSAL_ERROR_BAD_PARAMETER;
+    }
+
+    if (err == ARSAL_OK)
+    {
+        ring = ARSAL_FrameRing_Alloc(NULL);
+        if (ring == NULL)
+        {
+            err = ARSAL_ERROR_ALLOC;
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        ring->fd = shm_open(name, O_RDWR | O_CLOEXEC, 0);
+        if (ring->fd < 0)
+        {
+            err = ARSAL_ERROR_FRAMERING;
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        err = ARSAL_FrameRing_Map(ring);
+    }
+
+    if ((err != ARSAL_OK) && (ring != NULL))
+    {
+        ARSAL_FrameRing_Free(ring);
+        ring = NULL;
+    }
+
+    if (error != NULL)
+    {
+        *error = err;
+    }
+    return ring;
+}
+
+ARSAL_FrameRing_t *ARSAL_FrameRing_OpenFd(int fd, eARSAL_ERROR *error)
+{
+    ARSAL_FrameRing_t *ring = NULL;
+    eARSAL_ERROR err = ARSAL_OK;
+
+    if (fd < 0)
+    {
+        err = ARSAL_ERROR_BAD_PARAMETER;
+    }
+
+    if (err == ARSAL_OK)
+    {
+        ring = ARSAL_FrameRing_Alloc(NULL);
+        if (ring == NULL)
+        {
+            err = ARSAL_ERROR_ALLOC;
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        ring->fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+        err = (ring->fd < 0) ? ARSAL_ERROR_SYSTEM : ARSAL_FrameRing_Map(ring);
+    }
+
+    if ((err != ARSAL_OK) && (ring != NULL))
+    {
+        ARSAL_FrameRing_Free(ring);
+        ring = NULL;
+    }
+
+    if (error != NULL)
+    {
+        *error = err;
+    }
+    return ring;
+}
+
+void ARSAL_FrameRing_Delete(ARSAL_FrameRing_t **ring)
+{
+    if ((ring == NULL) || (*ring == NULL))
+    {
+        return;
+    }
+    if ((*ring)->publisher && ((*ring)->name != NULL))
+    {
+        shm_unlink((*ring)->name);
+    }
+    ARSAL_FrameRing_Free(*ring);
+    *ring = NULL;
+}
+
+int ARSAL_FrameRing_GetFd(ARSAL_FrameRing_t *ring)
+{
+    return (ring != NULL) ? ring->fd : -1;
+}
+
+void *ARSAL_FrameRing_GetSegment(ARSAL_FrameRing_t *ring, size_t *size)
+{
+    if (ring == NULL)
+    {
+        return NULL;
+    }
+    if (size != NULL)
+    {
+        *size = ring->size;
+    }
+    return ring->base;
+}
+
+eARSAL_ERROR ARSAL_FrameRing_Acquire(ARSAL_FrameRing_t *ring, ARSAL_FrameRing_Frame_t *frame)
+{
+    ARSAL_FrameRing_Header_t *header;
+    ARSAL_Time_Ns_t now = 0;
+    uint32_t i;
+
+    if ((ring == NULL) || (frame == NULL) || !ring->publisher)
+    {
+        return ARSAL_ERROR_BAD_PARAMETER;
+    }
+    header = ring->header;
+
+    /* Round robin from the oldest slot, so the latest frame is overwritten last */
+    for (i = 0; i < ring->nbSlots; i++)
+    {
+        uint32_t index = (header->nextSlot + i) % ring->nbSlots;
+        ARSAL_FrameRing_Slot_t *slot = &ring->slots[index];
+        uint32_t owner = __atomic_load_n(&slot->owner, __ATOMIC_ACQUIRE);
+
+        if (owner == ARSAL_FRAMERING_OWNER_PUBLISHER)
+        {
+            continue;
+        }
+        if (owner != ARSAL_FRAMERING_OWNER_FREE)
+        {
+            /* A consumer past its lease is considered dead */
+            if (now == 0)
+            {
+                now = ARSAL_Time_GetMonotonicNs();
+            }
+            if (now < __atomic_load_n(&slot->lease, __ATOMIC_ACQUIRE))
+            {
+                continue;
+            }
+        }
+        if (__atomic_compare_exchange_n(&slot->owner, &owner, ARSAL_FRAMERING_OWNER_PUBLISHER, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            if (owner != ARSAL_FRAMERING_OWNER_FREE)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSAL_FRAMERING_TAG, "Slot %u reclaimed from consumer %u, lease expired", index, owner);
+                __atomic_add_fetch(&header->reclaimed, 1, __ATOMIC_RELAXED);
+            }
+            header->nextSlot = (index + 1) % ring->nbSlots;
+            memset(frame, 0, sizeof(*frame));
+            frame->data = ARSAL_FrameRing_SlotData(ring, index);
+            frame->capacity = ring->slotSize;
+            frame->slot = index;
+            return ARSAL_OK;
+        }
+    }
+
+    __atomic_add_fetch(&header->dropped, 1, __ATOMIC_RELAXED);
+    return ARSAL_ERROR_FRAMERING_FULL;
+}
+
+eARSAL_ERROR ARSAL_FrameRing_Publish(ARSAL_FrameRing_t *ring, ARSAL_FrameRing_Frame_t *frame)
+{
+    ARSAL_FrameRing_Header_t *header;
+    ARSAL_FrameRing_Slot_t *slot;
+    uint64_t sequence;
+
+    if ((ring == NULL) || (frame == NULL) || !ring->publisher ||
+        (frame->slot >= ring->nbSlots) || (frame->size > ring->slotSize))
+    {
+        return ARSAL_ERROR_BAD_PARAMETER;
+    }
+    header = ring->header;
+    slot = &ring->slots[frame->slot];
+
+    sequence = header->published + 1;
+    slot->size = frame->size;
+    slot->width = frame->width;
+    slot->height = frame->height;
+    slot->format = frame->format;
+    slot->flags = frame->flags;
+    slot->timestamp = frame->timestamp;
+    __atomic_store_n(&slot->sequence, sequence, __ATOMIC_RELEASE);
+    __atomic_store_n(&slot->owner, ARSAL_FRAMERING_OWNER_FREE, __ATOMIC_RELEASE);
+
+    __atomic_store_n(&header->published, sequence, __ATOMIC_RELAXED);
+    __atomic_store_n(&header->latest, (sequence << ARSAL_FRAMERING_SLOT_BITS) | frame->slot, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&header->publishCount, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&header->waiters, __ATOMIC_SEQ_CST) > 0)
+    {
+        ARSAL_Futex_Wake(&header->publishCount, INT_MAX, 1);
+    }
+
+    frame->sequence = sequence;
+    return ARSAL_OK;
+}
+
+void ARSAL_FrameRing_Abort(ARSAL_FrameRing_t *ring, ARSAL_FrameRing_Frame_t *frame)
+{
+    if ((ring == NULL) || (frame == NULL) || !ring->publisher || (frame->slot >= ring->nbSlots))
+    {
+        return;
+    }
+    /* The slot content is unchanged only if nothing was written: forget its frame */
+    __atomic_store_n(&ring->slots[frame->slot].sequence, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring->slots[frame->slot].owner, ARSAL_FRAMERING_OWNER_FREE, __ATOMIC_RELEASE);
+}
+
+eARSAL_ERROR ARSAL_FrameRing_WaitLatest(ARSAL_FrameRing_t *ring, ARSAL_FrameRing_Frame_t *frame, uint64_t after, ARSAL_Time_Ns_t deadline)
+{
+    ARSAL_FrameRing_Header_t *header;
+    struct timespec ts;
+
+    if ((ring == NULL) || (frame == NULL) || ring->publisher)
+    {
+        return ARSAL_ERROR_BAD_PARAMETER;
+    }
+    header = ring->header;
+    NSEC_TO_TIMESPEC(deadline, &ts);
+
+    for (;;)
+    {
+        uint32_t count = __atomic_load_n(&header->publishCount, __ATOMIC_SEQ_CST);
+        uint64_t latest = __atomic_load_n(&header->latest, __ATOMIC_ACQUIRE);
+        uint64_t sequence = latest >> ARSAL_FRAMERING_SLOT_BITS;
+        uint32_t index = (uint32_t)(latest & ARSAL_FRAMERING_MAX_SLOTS);
+
+        if ((latest != 0) && (sequence > after) && (index < ring->nbSlots))
+        {
+            ARSAL_FrameRing_Slot_t *slot = &ring->slots[index];
+            uint32_t owner = ARSAL_FRAMERING_OWNER_FREE;
+
+            /* The lease is set before the slot is owned, the publisher never sees an owner without one */
+            __atomic_store_n(&slot->lease, ARSAL_Time_GetMonotonicNs() + ARSAL_FRAMERING_LEASE_NS, __ATOMIC_RELAXED);
+            if (__atomic_compare_exchange_n(&slot->owner, &owner, ring->owner, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+            {
+                uint64_t slotSequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+
+                if (slotSequence == sequence)
+                {
+                    if ((after > 0) && (sequence > after + 1))
+                    {
+                        ring->skipped += sequence - after - 1;
+                    }
+                    ARSAL_FrameRing_FillFrame(ring, index, frame);
+                    return ARSAL_OK;
+                }
+                __atomic_store_n(&slot->owner, ARSAL_FRAMERING_OWNER_FREE, __ATOMIC_RELEASE);
+                if (slotSequence > sequence)
+                {
+                    /* Re-used for a newer frame between the two loads: retry */
+                    continue;
+                }
+                /* Aborted by the publisher (sequence 0): wait for the next publish */
+            }
+            /* Owned by the publisher rewriting it: a newer frame is coming */
+        }
+
+        if ((deadline != 0) && (ARSAL_Time_GetMonotonicNs() >= deadline))
+        {
+            return ARSAL_ERROR_FRAMERING_TIMEOUT;
+        }
+        __atomic_add_fetch(&header->waiters, 1, __ATOMIC_SEQ_CST);
+        ARSAL_Futex_Wait(&header->publishCount, count, (deadline != 0) ? &ts : NULL, 1);
+        __atomic_sub_fetch(&header->waiters, 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+void ARSAL_FrameRing_Release(ARSAL_FrameRing_t *ring, ARSAL_FrameRing_Frame_t *frame)
+{
+    uint32_t owner;
+
+    if ((ring == NULL) || (frame == NULL) || ring->publisher || (frame->slot >= ring->nbSlots))
+    {
+        return;
+    }
+    owner = ring->owner;
+    __atomic_compare_exchange_n(&ring->slots[frame->slot].owner, &owner, ARSAL_FRAMERING_OWNER_FREE, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+    frame->data = NULL;
+}
+
+eARSAL_ERROR ARSAL_FrameRing_Renew(ARSAL_FrameRing_t *ring, ARSAL_FrameRing_Frame_t *frame)
+{
+    ARSAL_FrameRing_Slot_t *slot;
+
+    if ((ring == NULL) || (frame == NULL) || ring->publisher || (frame->slot >= ring->nbSlots))
+    {
+        return ARSAL_ERROR_BAD_PARAMETER;
+    }
+    slot = &ring->slots[frame->slot];
+    __atomic_store_n(&slot->lease, ARSAL_Time_GetMonotonicNs() + ARSAL_FRAMERING_LEASE_NS, __ATOMIC_RELEASE);
+    /* Checked after the store: the publisher reclaimed the slot before it, or will see the new lease */
+    if ((__atomic_load_n(&slot->owner, __ATOMIC_SEQ_CST) != ring->owner) ||
+        (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != frame->sequence))
+    {
+        return ARSAL_ERROR_FRAMERING;
+    }
+    return ARSAL_OK;
+}
+
+void ARSAL_FrameRing_GetStats(ARSAL_FrameRing_t *ring, ARSAL_FrameRing_Stats_t *stats)
+{
+    if ((ring == NULL) || (stats == NULL))
+    {
+        return;
+    }
+    stats->published = __atomic_load_n(&ring->header->published, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&ring->header->dropped, __ATOMIC_RELAXED);
+    stats->reclaimed = __atomic_load_n(&ring->header->reclaimed, __ATOMIC_RELAXED);
+    stats->skipped = ring->skipped;
+}
@@ -0,0 +1,234 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_FrameRing.h
+ * @brief Zero-copy frame ring shared between processes
+ * @date 10/18/2026
+ *
+ * One publisher process writes frames straight into the slots of a shared
+ * memory segment (shm_open() name or memfd), consumer processes get the
+ * latest frame in place. A slot is owned either by the publisher while it
+ * is written or by one consumer while it is used, so a frame never changes
+ * under its reader; the publisher skips owned slots, and reclaims those of
+ * consumers whose lease expired (dead, or holding a frame for too long).
+ */
+#ifndef _ARSAL_FRAMERING_H_
+#define _ARSAL_FRAMERING_H_
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <libARSAL/ARSAL_Error.h>
+#include <libARSAL/ARSAL_Time.h>
+
+/**
+ * @brief Layout version of the shared segment
+ */
+#define ARSAL_FRAMERING_VERSION     2
+
+/**
+ * @brief Time a consumer owns a frame before the publisher may reclaim its slot
+ * @see ARSAL_FrameRing_Renew ()
+ */
+#define ARSAL_FRAMERING_LEASE_NS    (2000LL * 1000 * 1000)
+
+/**
+ * @brief Frame ring type (process local handle)
+ */
+typedef struct ARSAL_FrameRing_t ARSAL_FrameRing_t;
+
+/**
+ * @brief Frame formats
+ */
+typedef enum
+{
+    ARSAL_FRAMERING_FORMAT_RAW = 0,     /**< Opaque data */
+    ARSAL_FRAMERING_FORMAT_H264,        /**< H.264 access unit, Annex B */
+    ARSAL_FRAMERING_FORMAT_NV12,        /**< Y plane then interleaved UV plane, stride = width */
+    ARSAL_FRAMERING_FORMAT_RGB8,        /**< Packed 8 bits RGB */
+    ARSAL_FRAMERING_FORMAT_RGBA8,       /**< Packed 8 bits RGBA */
+} eARSAL_FRAMERING_FORMAT;
+
+/**
+ * @brief Frame flags
+ */
+typedef enum
+{
+    ARSAL_FRAMERING_FLAG_KEY = 1,       /**< Key frame (IDR for H.264) */
+} eARSAL_FRAMERING_FLAG;
+
+/**
+ * @brief Frame, pointing into a slot of the shared segment
+ */
+typedef struct
+{
+    uint8_t *data;                  /**< Frame data, in the shared segment */
+    size_t capacity;                /**< Size of the slot */
+    uint32_t size;                  /**< Size of the frame data */
+    uint32_t width;                 /**< Width (pixels, 0 when not applicable) */
+    uint32_t height;                /**< Height (pixels, 0 when not applicable) */
+    uint32_t format;                /**< Format (see eARSAL_FRAMERING_FORMAT) */
+    uint32_t flags;                 /**< Flags (see eARSAL_FRAMERING_FLAG) */
+    ARSAL_Time_Ns_t timestamp;      /**< Capture or reception time (see ARSAL_Time_GetMonotonicNs()) */
+    uint64_t sequence;              /**< Sequence number, from 1, set on publish */
+    uint32_t slot;                  /**< Slot index */
+} ARSAL_FrameRing_Frame_t;
+
+/**
+ * @brief Frame ring statistics
+ */
+typedef struct
+{
+    uint64_t published;             /**< Frames published */
+    uint64_t dropped;               /**< Frames dropped by the publisher because every slot was owned */
+    uint64_t reclaimed;             /**< Slots reclaimed from consumers past their lease */
+    uint64_t skipped;               /**< Frames this consumer never saw because newer ones were published */
+} ARSAL_FrameRing_Stats_t;
+
+/**
+ * @brief Create a frame ring as its publisher
+ * @warning This function allocates memory
+ * @param name The shared memory name ("/name"), or NULL for an anonymous memfd to pass with ARSAL_FrameRing_GetFd()
+ * @param nbSlots The number of slots (at least 2 + the number of consumers)
+ * @param slotSize The capacity of each slot (bytes)
+ * @param[out] error A pointer on the error output (optional, may be NULL)
+ * @return Pointer on the new frame ring, or NULL on error
+ * @see ARSAL_FrameRing_Delete ()
+ */
+ARSAL_FrameRing_t *ARSAL_FrameRing_New(const char *name, uint32_t nbSlots, size_t slotSize, eARSAL_ERROR *error);
+
+/**
+ * @brief Open a frame ring created by another process, as a consumer
+ * @warning This function allocates memory
+ * @param name The shared memory name given to ARSAL_FrameRing_New()
+ * @param[out] error A pointer on the error output (optional, may be NULL)
+ * @return Pointer on the frame ring, or NULL on error
+ * @see ARSAL_FrameRing_Delete ()
+ */
+ARSAL_FrameRing_t *ARSAL_FrameRing_Open(const char *name, eARSAL_ERROR *error);
+
+/**
+ * @brief Open a frame ring from a file descriptor received from the publisher, as a consumer
+ * @warning This function allocates memory
+ * @param fd The file descriptor (duplicated, the caller keeps ownership)
+ * @param[out] error A pointer on the error output (optional, may be NULL)
+ * @return Pointer on the frame ring, or NULL on error
+ * @see ARSAL_FrameRing_Delete ()
+ */
+ARSAL_FrameRing_t *ARSAL_FrameRing_OpenFd(int fd, eARSAL_ERROR *error);
+
+/**
+ * @brief Close a frame ring. The publisher also removes the shared memory name
+ * @warning This function frees memory
+ * @param ring The address of the pointer on the frame ring
+ */
+void ARSAL_FrameRing_Delete(ARSAL_FrameRing_t **ring);
+
+/**
+ * @brief Get the file descriptor of the shared segment (to pass to a consumer)
+ * @param ring The frame ring
+ * @return The file descriptor
+ */
+int ARSAL_FrameRing_GetFd(ARSAL_FrameRing_t *ring);
+
+/**
+ * @brief Get the mapping of the shared segment in this process
+ *
+ * Lets a consumer register the whole segment once with a GPU driver, so
+ * frames are read in place by the GPU too.
+ *
+ * @param ring The frame ring
+ * @param[out] size The size of the mapping (optional, may be NULL)
+ * @return The address of the mapping
+ */
+void *ARSAL_FrameRing_GetSegment(ARSAL_FrameRing_t *ring, size_t *size);
+
+/**
+ * @brief Publisher: get a free slot to write the next frame into
+ * @param ring The frame ring
+ * @param[out] frame The frame, data and capacity set
+ * @retval On success, returns ARSAL_OK. If all slots are owned, returns ARSAL_ERROR_FRAMERING_FULL. Otherwise, it returns an error number of eARSAL_ERROR
+ * @see ARSAL_FrameRing_Publish (), ARSAL_FrameRing_Abort ()
+ */
+eARSAL_ERROR ARSAL_FrameRing_Acquire(ARSAL_FrameRing_t *ring, ARSAL_FrameRing_Frame_t *frame);
+
+/**
+ * @brief Publisher: make an acquired frame the latest one and wake the consumers
+ * @param ring The frame ring
+ * @param frame The frame, with size, width, height, format, flags and timestamp set
+ * @retval On success, returns ARSAL_OK. Otherwise, it returns an error number of eARSAL_ERROR
+ */
+eARSAL_ERROR ARSAL_FrameRing_Publish(ARSAL_FrameRing_t *ring, ARSAL_FrameRing_Frame_t *frame);
+
+/**
+ * @brief Publisher: give an acquired slot back without publishing it
+ * @param ring The frame ring
+ * @param frame The frame
+ */
+void ARSAL_FrameRing_Abort(ARSAL_FrameRing_t *ring, ARSAL_FrameRing_Frame_t *frame);
+
+/**
+ * @brief Consumer: get the latest frame newer than a given sequence, in place
+ *
+ * The slot is owned by the calling handle until ARSAL_FrameRing_Release(),
+ * for at most ARSAL_FRAMERING_LEASE_NS unless renewed.
+ * Frames published meanwhile are skipped, not queued.
+ *
+ * @param ring The frame ring
+ * @param[out] frame The frame
+ * @param after Sequence of the last frame processed (0 for any)
+ * @param deadline Absolute monotonic deadline, 0 to wait forever
+ * @retval On success, returns ARSAL_OK. If no new frame came before the deadline, returns ARSAL_ERROR_FRAMERING_TIMEOUT. Otherwise, it returns an error number of eARSAL_ERROR
+ */
+eARSAL_ERROR ARSAL_FrameRing_WaitLatest(ARSAL_FrameRing_t *ring, ARSAL_FrameRing_Frame_t *frame, uint64_t after, ARSAL_Time_Ns_t deadline);
+
+/**
+ * @brief Consumer: give back the slot of a frame returned by ARSAL_FrameRing_WaitLatest()
+ * @param ring The frame ring
+ * @param frame The frame
+ */
+void ARSAL_FrameRing_Release(ARSAL_FrameRing_t *ring, ARSAL_FrameRing_Frame_t *frame);
+
+/**
+ * @brief Consumer: extend the lease of a frame held longer than ARSAL_FRAMERING_LEASE_NS
+ * @param ring The frame ring
+ * @param frame The frame
+ * @retval On success, returns ARSAL_OK. If the slot was already reclaimed, returns ARSAL_ERROR_FRAMERING (the frame data may have changed)
+ */
+eARSAL_ERROR ARSAL_FrameRing_Renew(ARSAL_FrameRing_t *ring, ARSAL_FrameRing_Frame_t *frame);
+
+/**
+ * @brief Get the statistics of a frame ring
+ * @param ring The frame ring
+ * @param[out] stats The statistics
+ */
+void ARSAL_FrameRing_GetStats(ARSAL_FrameRing_t *ring, ARSAL_FrameRing_Stats_t *stats);
+
+#endif /* _ARSAL_FRAMERING_H_ */
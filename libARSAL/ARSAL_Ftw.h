@@ -39,6 +39,7 @@
 #define _ARSAL_FTW_H_
 
 #include <sys/stat.h>
+#include <libARSAL/ARSAL_TaskPool.h>
 
  /**
  * @brief ARSAL_FTW_t structure equal to "struct FTW"
@@ -60,6 +61,8 @@ typedef enum
 {
     ARSAL_FTW_F = 0,
     ARSAL_FTW_D,
+    ARSAL_FTW_DNR,      /**< Directory which can't be read (parallel walkers only) */
+    ARSAL_FTW_SL,       /**< Symbolic link, never followed (parallel walkers only) */
 } eARSAL_FTW_TYPE;
 
 /**
@@ -70,6 +73,7 @@ typedef enum
 {
     ARSAL_FTW_NOFLAGS = 0,
     ARSAL_FTW_ACTIONRETVAL = 16,
+    ARSAL_FTW_NOSTAT = 256,     /**< Don't stat entries, types come from the directory entries and sb is NULL (ARSAL_Nftw_Parallel() only) */
 } eARSAL_FTW_FLAG;
 
 /**
@@ -126,6 +130,40 @@ int ARSAL_Ftw(const char *dirpath, ARSAL_FtwCallback cb, int nopenfd);
  */
 int ARSAL_Nftw(const char *dirpath, ARSAL_NftwCallback cb, int nopenfd, eARSAL_FTW_FLAG flags);
 
+/**
+ * @brief Recursively descends the directory hierarchy with concurrent subtree workers
+ *
+ * Directories are read with large getdents64() buffers and each
+ * subdirectory is walked by its own task on the pool, so the callback is
+ * called concurrently from several threads and must be thread safe. A
+ * directory is reported before its content, but siblings and subtrees come
+ * in no particular order. With ARSAL_FTW_ACTIONRETVAL, ARSAL_FTW_SKIP_SUBTREE
+ * returned for a directory prevents its descent and ARSAL_FTW_STOP ends the
+ * walk; otherwise any non zero value ends the walk. Once the walk is ended,
+ * callbacks already running complete but no other is started. Symbolic
+ * links are reported as ARSAL_FTW_SL and never followed.
+ *
+ * @param pool The task pool running the walk, or NULL to walk in the calling thread
+ * @param dirpath The directory to descend
+ * @param cb The callback recursively on each element of run through the directories
+ * @param nopenfd The maximum number of directories opened at the same time
+ * @param flags The flag of the type of tree explore (ARSAL_FTW_ACTIONRETVAL, ARSAL_FTW_NOSTAT)
+ * @retval On success, returns 0. Otherwise, it returns -1, or the callback value which ended the walk
+ * @see ARSAL_Nftw ()
+ */
+int ARSAL_Nftw_Parallel(ARSAL_TaskPool_t *pool, const char *dirpath, ARSAL_NftwCallback cb, int nopenfd, eARSAL_FTW_FLAG flags);
+
+/**
+ * @brief Recursively descends the directory hierarchy with concurrent subtree workers
+ * @param pool The task pool running the walk, or NULL to walk in the calling thread
+ * @param dirpath The directory to descend
+ * @param cb The callback recursively on each element of run through the directories, called concurrently
+ * @param nopenfd The maximum number of directories opened at the same time
+ * @retval On success, returns 0. Otherwise, it returns -1, or the callback value which ended the walk
+ * @see ARSAL_Nftw_Parallel (), ARSAL_Ftw ()
+ */
+int ARSAL_Ftw_Parallel(ARSAL_TaskPool_t *pool, const char *dirpath, ARSAL_FtwCallback cb, int nopenfd);
+
 #endif /* _ARSAL_FTW_H_ */
 
 
@@ -0,0 +1,370 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_FtwParallel.c
+ * @brief Parallel directory hierarchy walker
+ * @date 10/18/2026
+ */
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/syscall.h>
+#include <libARSAL/ARSAL_Ftw.h>
+#include <libARSAL/ARSAL_Sem.h>
+
+/* Large enough to read most directories in one or two calls, which matters
+ * on SD cards and network mounts where each call is a round trip */
+#define ARSAL_FTW_DIRENT_BUFFER_SIZE    (64 * 1024)
+#define ARSAL_FTW_DEFAULT_NOPENFD       64
+
+struct ARSAL_FTW_Dirent64
+{
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+typedef struct
+{
+    ARSAL_TaskGroup_t group;
+    ARSAL_FutexSem_t openfd;
+    ARSAL_NftwCallback ncb;
+    ARSAL_FtwCallback cb;
+    int flags;
+    volatile int result;        /**< 0 while walking, else value returned by the walk */
+    struct ARSAL_FTW_Task *pending;     /**< Directories left to walk when there is no pool */
+} ARSAL_FTW_Walk_t;
+
+typedef struct ARSAL_FTW_Task
+{
+    ARSAL_FTW_Walk_t *walk;
+    struct ARSAL_FTW_Task *next;
+    struct stat st;
+    int level;
+    int base;
+    char path[];
+} ARSAL_FTW_Task_t;
+
+/* Directory slots held by the current thread: a task run inline by
+ * ARSAL_TaskGroup_Spawn() (full deque) must not wait for a slot its own
+ * caller holds */
+static __thread int ARSAL_FTW_HeldSlots = 0;
+
+static void ARSAL_FTW_WalkDirectory(void *arg);
+
+static int ARSAL_FTW_Stopped(ARSAL_FTW_Walk_t *walk)
+{
+    return __atomic_load_n(&walk->result, __ATOMIC_RELAXED) != 0;
+}
+
+/**
+ * @brief Call the user callback
+ * @return 1 to descend (directories only), 0 otherwise
+ */
+static int ARSAL_FTW_Call(ARSAL_FTW_Walk_t *walk, const char *path, const struct stat *st, eARSAL_FTW_TYPE type, int base, int level)
+{
+    ARSAL_FTW_t ftwbuf;
+    int ret;
+
+    if (ARSAL_FTW_Stopped(walk))
+    {
+        return 0;
+    }
+
+    if (walk->ncb != NULL)
+    {
+        ftwbuf.base = base;
+        ftwbuf.level = level;
+        ret = walk->ncb(path, (walk->flags & ARSAL_FTW_NOSTAT) ? NULL : st, type, &ftwbuf);
+    }
+    else
+    {
+        ret = walk->cb(path, st, type);
+    }
+
+    if (walk->flags & ARSAL_FTW_ACTIONRETVAL)
+    {
+        if (ret == ARSAL_FTW_STOP)
+        {
+            int expected = 0;
+            __atomic_compare_exchange_n(&walk->result, &expected, ret, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+            return 0;
+        }
+        return (ret != ARSAL_FTW_SKIP_SUBTREE);
+    }
+    if (ret != 0)
+    {
+        int expected = 0;
+        __atomic_compare_exchange_n(&walk->result, &expected, ret, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+        return 0;
+    }
+    return 1;
+}
+
+static void ARSAL_FTW_Schedule(ARSAL_FTW_Walk_t *walk, ARSAL_FTW_Task_t *task)
+{
+    if (walk->group.pool == NULL)
+    {
+        task->next = walk->pending;
+        walk->pending = task;
+    }
+    else if (ARSAL_TaskGroup_Spawn(&walk->group, ARSAL_FTW_WalkDirectory, task) != ARSAL_OK)
+    {
+        ARSAL_FTW_WalkDirectory(task);
+    }
+}
+
+static void ARSAL_FTW_ReleaseSlot(ARSAL_FTW_Walk_t *walk, int slot)
+{
+    if (slot)
+    {
+        ARSAL_FTW_HeldSlots--;
+        ARSAL_FutexSem_Post(&walk->openfd);
+    }
+}
+
+static ARSAL_FTW_Task_t *ARSAL_FTW_NewTask(ARSAL_FTW_Walk_t *walk, const char *dir, size_t dirLen, const char *name, int level)
+{
+    size_t nameLen = strlen(name);
+    int slash = (dirLen > 0) && (dir[dirLen - 1] != '/');
+    ARSAL_FTW_Task_t *task = malloc(sizeof(*task) + dirLen + slash + nameLen + 1);
+
+    if (task != NULL)
+    {
+        task->walk = walk;
+        task->next = NULL;
+        task->level = level;
+        task->base = (int)(dirLen + slash);
+        memcpy(task->path, dir, dirLen);
+        if (slash)
+        {
+            task->path[dirLen] = '/';
+        }
+        memcpy(task->path + dirLen + slash, name, nameLen + 1);
+    }
+    return task;
+}
+
+/**
+ * @brief Report a directory, then its entries, spawning one task per subdirectory
+ */
+static void ARSAL_FTW_WalkDirectory(void *arg)
+{
+    ARSAL_FTW_Task_t *task = arg;
+    ARSAL_FTW_Walk_t *walk = task->walk;
+    size_t pathLen = strlen(task->path);
+    char *buffer = NULL;
+    int fd = -1;
+    int slot;
+
+    if (ARSAL_FTW_Stopped(walk))
+    {
+        free(task);
+        return;
+    }
+
+    /* Over the limit rather than deadlocked when nested */
+    slot = (ARSAL_FTW_HeldSlots == 0) ? (ARSAL_FutexSem_Wait(&walk->openfd) == 0) : (ARSAL_FutexSem_Trywait(&walk->openfd) == 0);
+    ARSAL_FTW_HeldSlots += slot;
+    fd = open(task->path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    buffer = (fd >= 0) ? malloc(ARSAL_FTW_DIRENT_BUFFER_SIZE) : NULL;
+    if (buffer == NULL)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        ARSAL_FTW_ReleaseSlot(walk, slot);
+        ARSAL_FTW_Call(walk, task->path, &task->st, ARSAL_FTW_DNR, task->base, task->level);
+        free(task);
+        return;
+    }
+
+    if (ARSAL_FTW_Call(walk, task->path, &task->st, ARSAL_FTW_D, task->base, task->level))
+    {
+        long nread;
+
+        while (!ARSAL_FTW_Stopped(walk) &&
+               ((nread = syscall(SYS_getdents64, fd, buffer, ARSAL_FTW_DIRENT_BUFFER_SIZE)) > 0))
+        {
+            long pos;
+
+            for (pos = 0; (pos < nread) && !ARSAL_FTW_Stopped(walk); )
+            {
+                struct ARSAL_FTW_Dirent64 *entry = (struct ARSAL_FTW_Dirent64 *)(buffer + pos);
+                ARSAL_FTW_Task_t *child;
+                eARSAL_FTW_TYPE type;
+                unsigned char dtype = entry->d_type;
+
+                pos += entry->d_reclen;
+                if ((entry->d_name[0] == '.') &&
+                    ((entry->d_name[1] == '\0') || ((entry->d_name[1] == '.') && (entry->d_name[2] == '\0'))))
+                {
+                    continue;
+                }
+
+                child = ARSAL_FTW_NewTask(walk, task->path, pathLen, entry->d_name, task->level + 1);
+                if (child == NULL)
+                {
+                    int expected = 0;
+                    __atomic_compare_exchange_n(&walk->result, &expected, -1, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+                    break;
+                }
+
+                /* Only stat when asked to, or when the filesystem doesn't fill d_type */
+                if (!(walk->flags & ARSAL_FTW_NOSTAT) || (dtype == DT_UNKNOWN))
+                {
+                    if (fstatat(fd, entry->d_name, &child->st, AT_SYMLINK_NOFOLLOW) == 0)
+                    {
+                        dtype = S_ISDIR(child->st.st_mode) ? DT_DIR : (S_ISLNK(child->st.st_mode) ? DT_LNK : DT_REG);
+                    }
+                    else
+                    {
+                        /* Entry removed meanwhile */
+                        free(child);
+                        continue;
+                    }
+                }
+
+                if (dtype == DT_DIR)
+                {
+                    /* Reported by its own task, which knows whether it can be read */
+                    ARSAL_FTW_Schedule(walk, child);
+                    continue;
+                }
+
+                type = (dtype == DT_LNK) ? ARSAL_FTW_SL : ARSAL_FTW_F;
+                ARSAL_FTW_Call(walk, child->path, &child->st, type, child->base, child->level);
+                free(child);
+            }
+        }
+    }
+
+    free(buffer);
+    close(fd);
+    ARSAL_FTW_ReleaseSlot(walk, slot);
+    free(task);
+}
+
+static int ARSAL_FTW_Walk(ARSAL_TaskPool_t *pool, const char *dirpath, ARSAL_NftwCallback ncb, ARSAL_FtwCallback cb, int nopenfd, int flags)
+{
+    ARSAL_FTW_Walk_t walk;
+    ARSAL_FTW_Task_t *root;
+    size_t len;
+    const char *name;
+
+    if ((dirpath == NULL) || (dirpath[0] == '\0') || ((ncb == NULL) && (cb == NULL)))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    memset(&walk, 0, sizeof(walk));
+    walk.ncb = ncb;
+    walk.cb = cb;
+    walk.flags = flags;
+    ARSAL_TaskGroup_Init(&walk.group, pool);
+    ARSAL_FutexSem_Init(&walk.openfd, 0, (nopenfd > 0) ? nopenfd : ARSAL_FTW_DEFAULT_NOPENFD);
+
+    /* Trailing slashes don't belong to the name */
+    len = strlen(dirpath);
+    while ((len > 1) && (dirpath[len - 1] == '/'))
+    {
+        len--;
+    }
+    name = dirpath + len;
+    while ((name > dirpath) && (name[-1] != '/'))
+    {
+        name--;
+    }
+    root = malloc(sizeof(*root) + len + 1);
+    if (root == NULL)
+    {
+        ARSAL_FutexSem_Destroy(&walk.openfd);
+        errno = ENOMEM;
+        return -1;
+    }
+    root->walk = &walk;
+    root->next = NULL;
+    root->level = 0;
+    root->base = (int)(name - dirpath);
+    memcpy(root->path, dirpath, len);
+    root->path[len] = '\0';
+
+    /* The root itself is always followed, like nftw() without FTW_PHYS */
+    if (stat(root->path, &root->st) != 0)
+    {
+        free(root);
+        ARSAL_FutexSem_Destroy(&walk.openfd);
+        return -1;
+    }
+    if (!S_ISDIR(root->st.st_mode))
+    {
+        ARSAL_FTW_Call(&walk, root->path, &root->st, ARSAL_FTW_F, root->base, 0);
+        free(root);
+        ARSAL_FutexSem_Destroy(&walk.openfd);
+        return walk.result;
+    }
+
+    ARSAL_FTW_Schedule(&walk, root);
+    if (pool != NULL)
+    {
+        ARSAL_TaskGroup_Wait(&walk.group);
+    }
+    else
+    {
+        while (walk.pending != NULL)
+        {
+            ARSAL_FTW_Task_t *task = walk.pending;
+            walk.pending = task->next;
+            ARSAL_FTW_WalkDirectory(task);
+        }
+    }
+
+    ARSAL_FutexSem_Destroy(&walk.openfd);
+    return walk.result;
+}
+
+int ARSAL_Nftw_Parallel(ARSAL_TaskPool_t *pool, const char *dirpath, ARSAL_NftwCallback cb, int nopenfd, eARSAL_FTW_FLAG flags)
+{
+    return ARSAL_FTW_Walk(pool, dirpath, cb, NULL, nopenfd, flags);
+}
+
+int ARSAL_Ftw_Parallel(ARSAL_TaskPool_t *pool, const char *dirpath, ARSAL_FtwCallback cb, int nopenfd)
+{
+    return ARSAL_FTW_Walk(pool, dirpath, NULL, cb, nopenfd, ARSAL_FTW_NOFLAGS);
+}
@@ -0,0 +1,86 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_Futex.h
+ * @brief Thin wrappers around the Linux futex syscall, used by the user space synchronization primitives
+ * @date 10/18/2026
+ */
+#ifndef _ARSAL_FUTEX_H_
+#define _ARSAL_FUTEX_H_
+
+#include <inttypes.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+/**
+ * @brief Hint the CPU that we are in a spin-wait loop
+ */
+#if defined(__x86_64__) || defined(__i386__)
+#define ARSAL_CPU_RELAX() __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define ARSAL_CPU_RELAX() __asm__ __volatile__ ("yield" ::: "memory")
+#else
+#define ARSAL_CPU_RELAX() __asm__ __volatile__ ("" ::: "memory")
+#endif
+
+/**
+ * @brief Wait on a futex word
+ *
+ * @param addr The futex word
+ * @param expected Sleep only if *addr still equals expected
+ * @param deadline Absolute CLOCK_MONOTONIC deadline (NULL to wait forever)
+ * @param shared Non zero if the word lives in memory shared between processes
+ * @retval 0 when woken up. Otherwise, -1 and errno is set (EAGAIN if *addr != expected, ETIMEDOUT, EINTR)
+ */
+static inline int ARSAL_Futex_Wait(volatile uint32_t *addr, uint32_t expected, const struct timespec *deadline, int shared)
+{
+    int op = FUTEX_WAIT_BITSET | (shared ? 0 : FUTEX_PRIVATE_FLAG);
+    return (int)syscall(SYS_futex, addr, op, expected, deadline, NULL, FUTEX_BITSET_MATCH_ANY);
+}
+
+/**
+ * @brief Wake threads waiting on a futex word
+ *
+ * @param addr The futex word
+ * @param count Maximum number of waiters to wake (INT32_MAX for all)
+ * @param shared Non zero if the word lives in memory shared between processes
+ * @retval The number of woken waiters. Otherwise, -1 and errno is set
+ */
+static inline int ARSAL_Futex_Wake(volatile uint32_t *addr, int count, int shared)
+{
+    int op = FUTEX_WAKE | (shared ? 0 : FUTEX_PRIVATE_FLAG);
+    return (int)syscall(SYS_futex, addr, op, count, NULL, NULL, 0);
+}
+
+#endif /* _ARSAL_FUTEX_H_ */
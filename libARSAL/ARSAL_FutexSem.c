@@ -0,0 +1,239 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_FutexSem.c
+ * @brief Futex based semaphore
+ * @date 10/18/2026
+ */
+#include <errno.h>
+#include <limits.h>
+#include <libARSAL/ARSAL_Futex.h>
+#include <libARSAL/ARSAL_Sem.h>
+
+/**
+ * @brief Take up to count units without blocking
+ * @return The number of units taken, 0 if the value was 0
+ */
+static uint32_t ARSAL_FutexSem_TryTake(ARSAL_FutexSem_t *sem, uint32_t count)
+{
+    uint32_t value = __atomic_load_n(&sem->value, __ATOMIC_RELAXED);
+
+    while (value > 0)
+    {
+        uint32_t take = (value < count) ? value : count;
+        if (__atomic_compare_exchange_n(&sem->value, &value, value - take, 1, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            return take;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Common wait path
+ * @return The number of units taken, or -1 with errno set
+ */
+static int ARSAL_FutexSem_Take(ARSAL_FutexSem_t *sem, uint32_t count, ARSAL_Time_Ns_t deadline)
+{
+    struct timespec ts;
+    uint32_t taken;
+    int ret = 0;
+    int err = ETIMEDOUT;
+
+    if ((sem == NULL) || (count == 0))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* Fast path, entirely in user space */
+    taken = ARSAL_FutexSem_TryTake(sem, count);
+    if (taken > 0)
+    {
+        return (int)taken;
+    }
+
+    if (deadline != 0)
+    {
+        NSEC_TO_TIMESPEC(deadline, &ts);
+    }
+
+    /* The waiters increment and the value load must be ordered against the
+     * poster's value increment and waiters load (seq_cst on both sides) */
+    __atomic_add_fetch(&sem->waiters, 1, __ATOMIC_SEQ_CST);
+    for (;;)
+    {
+        taken = ARSAL_FutexSem_TryTake(sem, count);
+        if (taken > 0)
+        {
+            ret = (int)taken;
+            break;
+        }
+        if ((ARSAL_Futex_Wait(&sem->value, 0, (deadline != 0) ? &ts : NULL, sem->shared) != 0) &&
+            (errno != EAGAIN) && (errno != EINTR))
+        {
+            /* ETIMEDOUT, or a futex error (EFAULT, EINVAL, ENOSYS...) that
+             * would fail again at once: a post may have raced with it, give
+             * it a last chance, then report the error instead of spinning */
+            err = errno;
+            taken = ARSAL_FutexSem_TryTake(sem, count);
+            ret = (taken > 0) ? (int)taken : -1;
+            break;
+        }
+        /* EAGAIN (value changed), EINTR or a wakeup: retry */
+    }
+    __atomic_sub_fetch(&sem->waiters, 1, __ATOMIC_RELAXED);
+
+    if (ret < 0)
+    {
+        errno = err;
+    }
+    return ret;
+}
+
+int ARSAL_FutexSem_Init(ARSAL_FutexSem_t *sem, int shared, int value)
+{
+    if ((sem == NULL) || (value < 0))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    sem->value = (uint32_t)value;
+    sem->waiters = 0;
+    sem->shared = shared ? 1 : 0;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return 0;
+}
+
+int ARSAL_FutexSem_Destroy(ARSAL_FutexSem_t *sem)
+{
+    if (sem == NULL)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    if (__atomic_load_n(&sem->waiters, __ATOMIC_ACQUIRE) != 0)
+    {
+        errno = EBUSY;
+        return -1;
+    }
+    return 0;
+}
+
+int ARSAL_FutexSem_Wait(ARSAL_FutexSem_t *sem)
+{
+    return (ARSAL_FutexSem_Take(sem, 1, 0) < 0) ? -1 : 0;
+}
+
+int ARSAL_FutexSem_Trywait(ARSAL_FutexSem_t *sem)
+{
+    if (sem == NULL)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    if (ARSAL_FutexSem_TryTake(sem, 1) == 0)
+    {
+        errno = EAGAIN;
+        return -1;
+    }
+    return 0;
+}
+
+int ARSAL_FutexSem_Timedwait(ARSAL_FutexSem_t *sem, ARSAL_Time_Ns_t deadline)
+{
+    if (deadline == 0)
+    {
+        /* 0 means "forever" internally, but here it is a deadline long gone */
+        if (ARSAL_FutexSem_Trywait(sem) == 0)
+        {
+            return 0;
+        }
+        errno = ETIMEDOUT;
+        return -1;
+    }
+    return (ARSAL_FutexSem_Take(sem, 1, deadline) < 0) ? -1 : 0;
+}
+
+int ARSAL_FutexSem_WaitN(ARSAL_FutexSem_t *sem, int count, ARSAL_Time_Ns_t deadline)
+{
+    if (count <= 0)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    return ARSAL_FutexSem_Take(sem, (uint32_t)count, deadline);
+}
+
+int ARSAL_FutexSem_Post(ARSAL_FutexSem_t *sem)
+{
+    return ARSAL_FutexSem_PostN(sem, 1);
+}
+
+int ARSAL_FutexSem_PostN(ARSAL_FutexSem_t *sem, int count)
+{
+    uint32_t value;
+
+    if ((sem == NULL) || (count <= 0))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    value = __atomic_load_n(&sem->value, __ATOMIC_RELAXED);
+    do
+    {
+        if (value > (uint32_t)INT_MAX - (uint32_t)count)
+        {
+            errno = EOVERFLOW;
+            return -1;
+        }
+    } while (!__atomic_compare_exchange_n(&sem->value, &value, value + (uint32_t)count, 1, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+
+    /* Only pay for the syscall when somebody sleeps */
+    if (__atomic_load_n(&sem->waiters, __ATOMIC_SEQ_CST) > 0)
+    {
+        ARSAL_Futex_Wake(&sem->value, count, sem->shared);
+    }
+    return 0;
+}
+
+int ARSAL_FutexSem_Getvalue(ARSAL_FutexSem_t *sem, int *value)
+{
+    if ((sem == NULL) || (value == NULL))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    *value = (int)__atomic_load_n(&sem->value, __ATOMIC_RELAXED);
+    return 0;
+}
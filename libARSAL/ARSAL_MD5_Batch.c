@@ -0,0 +1,691 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_MD5_Batch.c
+ * @brief Streaming and multi-buffer file digests
+ * @date 10/18/2026
+ */
+/* 64-bit file offsets on 32-bit targets too */
+#define _FILE_OFFSET_BITS 64
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <libARSAL/ARSAL_MD5_Manager.h>
+
+/* Number of files hashed together, one per 32-bit lane of a 128-bit vector
+ * (SSE2 on x86, NEON on ARM, through the GCC vector extensions) */
+#define ARSAL_MD5_LANES         4
+#define ARSAL_MD5_BLOCK_SIZE    64
+/* Files per task of a batch: more than the lanes so a lane freed by a short
+ * file is refilled instead of idling */
+#define ARSAL_MD5_BATCH_GRAIN   (2 * ARSAL_MD5_LANES)
+
+typedef uint32_t ARSAL_MD5_Vec_t __attribute__((vector_size(4 * ARSAL_MD5_LANES)));
+
+static const uint32_t ARSAL_MD5_K[64] =
+{
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+};
+
+static const int ARSAL_MD5_S[64] =
+{
+    7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+    5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+    4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+    6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21,
+};
+
+/*
+ * Memory mapped input with the MD5 padding appended. The file is mapped one
+ * window at a time, so the address space used does not depend on the file
+ * size (32-bit targets, many lanes of large files)
+ */
+
+/* Mapped window: a multiple of the page size and of the MD5 and XXH64
+ * block sizes, so a block never spans two windows */
+#define ARSAL_MD5_WINDOW_SIZE   (1024 * 1024)
+
+typedef struct
+{
+    int fd;
+    uint64_t size;
+    uint64_t offset;                /* Next byte to hash */
+    const uint8_t *window;
+    uint64_t windowOffset;          /* File offset of window[0] */
+    size_t windowSize;
+    uint8_t tail[2 * ARSAL_MD5_BLOCK_SIZE];
+    int tailBlocks;
+    int tailIndex;
+} ARSAL_MD5_Input_t;
+
+static int ARSAL_MD5_InputOpen(ARSAL_MD5_Input_t *input, const char *filePath)
+{
+    struct stat st;
+
+    memset(input, 0, sizeof(*input));
+    input->fd = open(filePath, O_RDONLY | O_CLOEXEC);
+    if (input->fd < 0)
+    {
+        return -1;
+    }
+    if ((fstat(input->fd, &st) != 0) || !S_ISREG(st.st_mode))
+    {
+        close(input->fd);
+        return -1;
+    }
+    input->size = (uint64_t)st.st_size;
+    /* Aggressive read-ahead: the file is read once, front to back */
+    posix_fadvise(input->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    return 0;
+}
+
+static void ARSAL_MD5_InputUnmap(ARSAL_MD5_Input_t *input)
+{
+    if (input->window != NULL)
+    {
+        munmap((void *)input->window, input->windowSize);
+        input->window = NULL;
+        input->windowSize = 0;
+    }
+}
+
+static void ARSAL_MD5_InputClose(ARSAL_MD5_Input_t *input)
+{
+    ARSAL_MD5_InputUnmap(input);
+    if (input->fd >= 0)
+    {
+        close(input->fd);
+        input->fd = -1;
+    }
+}
+
+/**
+ * @brief Map the window holding the byte at offset (offset < size)
+ * @return Pointer on the byte at offset, NULL on error
+ */
+static const uint8_t *ARSAL_MD5_InputMap(ARSAL_MD5_Input_t *input, uint64_t offset)
+{
+    uint64_t windowOffset = offset - (offset % ARSAL_MD5_WINDOW_SIZE);
+    void *map;
+
+    if ((input->window == NULL) || (windowOffset != input->windowOffset))
+    {
+        ARSAL_MD5_InputUnmap(input);
+        input->windowOffset = windowOffset;
+        input->windowSize = (input->size - windowOffset < ARSAL_MD5_WINDOW_SIZE) ? (size_t)(input->size - windowOffset) : ARSAL_MD5_WINDOW_SIZE;
+        map = mmap(NULL, input->windowSize, PROT_READ, MAP_PRIVATE, input->fd, (off_t)windowOffset);
+        if (map == MAP_FAILED)
+        {
+            input->windowSize = 0;
+            return NULL;
+        }
+        madvise(map, input->windowSize, MADV_SEQUENTIAL);
+        madvise(map, input->windowSize, MADV_WILLNEED);
+        input->window = map;
+    }
+    return input->window + (size_t)(offset - windowOffset);
+}
+
+/**
+ * @brief Next 64 bytes block of the padded message, NULL at the end or on error
+ */
+static const uint8_t *ARSAL_MD5_InputNextBlock(ARSAL_MD5_Input_t *input)
+{
+    if (input->offset + ARSAL_MD5_BLOCK_SIZE <= input->size)
+    {
+        const uint8_t *block = ARSAL_MD5_InputMap(input, input->offset);
+        input->offset += ARSAL_MD5_BLOCK_SIZE;
+        return block;
+    }
+
+    if (input->tailBlocks == 0)
+    {
+        size_t remaining = (size_t)(input->size - input->offset);
+        uint64_t bits = input->size * 8;
+        size_t total = (remaining + 1 + 8 <= ARSAL_MD5_BLOCK_SIZE) ? ARSAL_MD5_BLOCK_SIZE : 2 * ARSAL_MD5_BLOCK_SIZE;
+        int i;
+
+        memset(input->tail, 0, sizeof(input->tail));
+        if (remaining > 0)
+        {
+            const uint8_t *data = ARSAL_MD5_InputMap(input, input->offset);
+            if (data == NULL)
+            {
+                return NULL;
+            }
+            memcpy(input->tail, data, remaining);
+        }
+        ARSAL_MD5_InputUnmap(input);
+        input->tail[remaining] = 0x80;
+        for (i = 0; i < 8; i++)
+        {
+            input->tail[total - 8 + i] = (uint8_t)(bits >> (8 * i));
+        }
+        input->offset = input->size;
+        input->tailBlocks = (int)(total / ARSAL_MD5_BLOCK_SIZE);
+    }
+
+    if (input->tailIndex < input->tailBlocks)
+    {
+        return input->tail + ARSAL_MD5_BLOCK_SIZE * input->tailIndex++;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Whether the whole file was read (NextBlock() returning NULL early means a mapping error)
+ */
+static int ARSAL_MD5_InputComplete(const ARSAL_MD5_Input_t *input)
+{
+    return (input->tailBlocks > 0) && (input->tailIndex == input->tailBlocks);
+}
+
+/*
+ * MD5 compression, 4 independent messages at once
+ */
+
+#define ARSAL_MD5_ROTL(x, s) (((x) << (s)) | ((x) >> (32 - (s))))
+
+static void ARSAL_MD5_Compress(ARSAL_MD5_Vec_t state[4], const ARSAL_MD5_Vec_t m[16])
+{
+    ARSAL_MD5_Vec_t a = state[0], b = state[1], c = state[2], d = state[3];
+    int i;
+
+    for (i = 0; i < 64; i++)
+    {
+        ARSAL_MD5_Vec_t f, tmp;
+        int g;
+
+        if (i < 16)
+        {
+            f = (b & c) | (~b & d);
+            g = i;
+        }
+        else if (i < 32)
+        {
+            f = (d & b) | (~d & c);
+            g = (5 * i + 1) & 15;
+        }
+        else if (i < 48)
+        {
+            f = b ^ c ^ d;
+            g = (3 * i + 5) & 15;
+        }
+        else
+        {
+            f = c ^ (b | ~d);
+            g = (7 * i) & 15;
+        }
+        tmp = d;
+        d = c;
+        c = b;
+        f = f + a + ARSAL_MD5_K[i] + m[g];
+        b = b + ARSAL_MD5_ROTL(f, ARSAL_MD5_S[i]);
+        a = tmp;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+}
+
+static void ARSAL_MD5_StateInit(ARSAL_MD5_Vec_t state[4], int lane)
+{
+    state[0][lane] = 0x67452301;
+    state[1][lane] = 0xefcdab89;
+    state[2][lane] = 0x98badcfe;
+    state[3][lane] = 0x10325476;
+}
+
+static void ARSAL_MD5_StateStore(const ARSAL_MD5_Vec_t state[4], int lane, uint8_t *digest)
+{
+    int i, j;
+
+    for (i = 0; i < 4; i++)
+    {
+        for (j = 0; j < 4; j++)
+        {
+            digest[4 * i + j] = (uint8_t)(state[i][lane] >> (8 * j));
+        }
+    }
+}
+
+/*
+ * XXH64
+ */
+
+#define ARSAL_XXH64_P1 0x9E3779B185EBCA87ULL
+#define ARSAL_XXH64_P2 0xC2B2AE3D27D4EB4FULL
+#define ARSAL_XXH64_P3 0x165667B19E3779F9ULL
+#define ARSAL_XXH64_P4 0x85EBCA77C2B2AE63ULL
+#define ARSAL_XXH64_P5 0x27D4EB2F165667C5ULL
+
+static uint64_t ARSAL_XXH64_Rotl(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static uint64_t ARSAL_XXH64_Read64(const uint8_t *p)
+{
+    uint64_t v = 0;
+    int i;
+    for (i = 7; i >= 0; i--)
+    {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+static uint32_t ARSAL_XXH64_Read32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t ARSAL_XXH64_Round(uint64_t acc, uint64_t input)
+{
+    acc += input * ARSAL_XXH64_P2;
+    acc = ARSAL_XXH64_Rotl(acc, 31);
+    return acc * ARSAL_XXH64_P1;
+}
+
+static uint64_t ARSAL_XXH64_Merge(uint64_t acc, uint64_t val)
+{
+    acc ^= ARSAL_XXH64_Round(0, val);
+    return acc * ARSAL_XXH64_P1 + ARSAL_XXH64_P4;
+}
+
+typedef struct
+{
+    uint64_t v[4];
+    uint64_t length;
+} ARSAL_XXH64_State_t;
+
+static void ARSAL_XXH64_Init(ARSAL_XXH64_State_t *state)
+{
+    state->v[0] = ARSAL_XXH64_P1 + ARSAL_XXH64_P2;
+    state->v[1] = ARSAL_XXH64_P2;
+    state->v[2] = 0;
+    state->v[3] = 0 - ARSAL_XXH64_P1;
+    state->length = 0;
+}
+
+/**
+ * @brief Hash the 32 bytes stripes of [p, p + len), len multiple of 32
+ */
+static void ARSAL_XXH64_Update(ARSAL_XXH64_State_t *state, const uint8_t *p, size_t len)
+{
+    const uint8_t *end = p + len;
+
+    state->length += len;
+    while (p < end)
+    {
+        state->v[0] = ARSAL_XXH64_Round(state->v[0], ARSAL_XXH64_Read64(p));
+        state->v[1] = ARSAL_XXH64_Round(state->v[1], ARSAL_XXH64_Read64(p + 8));
+        state->v[2] = ARSAL_XXH64_Round(state->v[2], ARSAL_XXH64_Read64(p + 16));
+        state->v[3] = ARSAL_XXH64_Round(state->v[3], ARSAL_XXH64_Read64(p + 24));
+        p += 32;
+    }
+}
+
+/**
+ * @brief Hash the last len (< 32) bytes and return the digest
+ */
+static uint64_t ARSAL_XXH64_Final(const ARSAL_XXH64_State_t *state, const uint8_t *p, size_t len)
+{
+    const uint8_t *end = p + len;
+    uint64_t h;
+
+    if (state->length >= 32)
+    {
+        h = ARSAL_XXH64_Rotl(state->v[0], 1) + ARSAL_XXH64_Rotl(state->v[1], 7) + ARSAL_XXH64_Rotl(state->v[2], 12) + ARSAL_XXH64_Rotl(state->v[3], 18);
+        h = ARSAL_XXH64_Merge(h, state->v[0]);
+        h = ARSAL_XXH64_Merge(h, state->v[1]);
+        h = ARSAL_XXH64_Merge(h, state->v[2]);
+        h = ARSAL_XXH64_Merge(h, state->v[3]);
+    }
+    else
+    {
+        h = ARSAL_XXH64_P5;
+    }
+
+    h += state->length + len;
+    while (p + 8 <= end)
+    {
+        h ^= ARSAL_XXH64_Round(0, ARSAL_XXH64_Read64(p));
+        h = ARSAL_XXH64_Rotl(h, 27) * ARSAL_XXH64_P1 + ARSAL_XXH64_P4;
+        p += 8;
+    }
+    if (p + 4 <= end)
+    {
+        h ^= (uint64_t)ARSAL_XXH64_Read32(p) * ARSAL_XXH64_P1;
+        h = ARSAL_XXH64_Rotl(h, 23) * ARSAL_XXH64_P2 + ARSAL_XXH64_P3;
+        p += 4;
+    }
+    while (p < end)
+    {
+        h ^= (*p) * ARSAL_XXH64_P5;
+        h = ARSAL_XXH64_Rotl(h, 11) * ARSAL_XXH64_P1;
+        p++;
+    }
+
+    h ^= h >> 33;
+    h *= ARSAL_XXH64_P2;
+    h ^= h >> 29;
+    h *= ARSAL_XXH64_P3;
+    h ^= h >> 32;
+    return h;
+}
+
+/*
+ * Batch processing
+ */
+
+static int ARSAL_MD5_HexValue(char c)
+{
+    if ((c >= '0') && (c <= '9'))
+    {
+        return c - '0';
+    }
+    c = (char)tolower((unsigned char)c);
+    if ((c >= 'a') && (c <= 'f'))
+    {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+static void ARSAL_MD5_Finish(ARSAL_MD5_BatchEntry_t *entry, int length)
+{
+    int i;
+
+    entry->error = ARSAL_OK;
+    if (entry->expected == NULL)
+    {
+        return;
+    }
+    if ((int)strlen(entry->expected) != 2 * length)
+    {
+        entry->error = ARSAL_ERROR_MD5;
+        return;
+    }
+    for (i = 0; i < length; i++)
+    {
+        int hi = ARSAL_MD5_HexValue(entry->expected[2 * i]);
+        int lo = ARSAL_MD5_HexValue(entry->expected[2 * i + 1]);
+        if ((hi < 0) || (lo < 0) || (entry->digest[i] != (uint8_t)((hi << 4) | lo)))
+        {
+            entry->error = ARSAL_ERROR_MD5;
+            return;
+        }
+    }
+}
+
+static void ARSAL_MD5_ProcessXxh64(ARSAL_MD5_BatchEntry_t *entry)
+{
+    ARSAL_MD5_Input_t input;
+    ARSAL_XXH64_State_t state;
+    const uint8_t *data = NULL;
+    size_t len = 0;
+    uint64_t h;
+    int i;
+
+    if (ARSAL_MD5_InputOpen(&input, entry->filePath) != 0)
+    {
+        entry->error = ARSAL_ERROR_FILE;
+        return;
+    }
+
+    /* Whole stripes window by window, the last bytes of the file at the end */
+    ARSAL_XXH64_Init(&state);
+    while (input.offset < input.size)
+    {
+        data = ARSAL_MD5_InputMap(&input, input.offset);
+        if (data == NULL)
+        {
+            ARSAL_MD5_InputClose(&input);
+            entry->error = ARSAL_ERROR_FILE;
+            return;
+        }
+        len = input.windowSize - (size_t)(input.offset - input.windowOffset);
+        input.offset += len;
+        if (input.offset < input.size)
+        {
+            ARSAL_XXH64_Update(&state, data, len);
+            len = 0;
+        }
+        else
+        {
+            ARSAL_XXH64_Update(&state, data, len & ~(size_t)31);
+            data += len & ~(size_t)31;
+            len &= 31;
+        }
+    }
+    h = ARSAL_XXH64_Final(&state, data, len);
+    ARSAL_MD5_InputClose(&input);
+
+    memset(entry->digest, 0, sizeof(entry->digest));
+    for (i = 0; i < ARSAL_XXH64_LENGTH; i++)
+    {
+        entry->digest[i] = (uint8_t)(h >> (8 * (ARSAL_XXH64_LENGTH - 1 - i)));
+    }
+    ARSAL_MD5_Finish(entry, ARSAL_XXH64_LENGTH);
+}
+
+/**
+ * @brief MD5 of entries [0, count), ARSAL_MD5_LANES files at a time
+ */
+static void ARSAL_MD5_ProcessMd5(ARSAL_MD5_BatchEntry_t *entries, size_t count)
+{
+    ARSAL_MD5_Input_t inputs[ARSAL_MD5_LANES];
+    ARSAL_MD5_BatchEntry_t *laneEntry[ARSAL_MD5_LANES];
+    ARSAL_MD5_Vec_t state[4];
+    ARSAL_MD5_Vec_t saved[4];
+    ARSAL_MD5_Vec_t m[16];
+    size_t next = 0;
+    int active = 0;
+    int lane, j;
+
+    memset(state, 0, sizeof(state));
+    for (lane = 0; lane < ARSAL_MD5_LANES; lane++)
+    {
+        laneEntry[lane] = NULL;
+    }
+
+    for (;;)
+    {
+        const uint8_t *blocks[ARSAL_MD5_LANES];
+
+        /* Refill idle lanes and fetch one block per lane */
+        for (lane = 0; lane < ARSAL_MD5_LANES; lane++)
+        {
+            blocks[lane] = NULL;
+            while ((laneEntry[lane] == NULL) && (next < count))
+            {
+                ARSAL_MD5_BatchEntry_t *entry = &entries[next++];
+                if (ARSAL_MD5_InputOpen(&inputs[lane], entry->filePath) != 0)
+                {
+                    entry->error = ARSAL_ERROR_FILE;
+                    continue;
+                }
+                laneEntry[lane] = entry;
+                ARSAL_MD5_StateInit(state, lane);
+                active++;
+            }
+            if (laneEntry[lane] != NULL)
+            {
+                blocks[lane] = ARSAL_MD5_InputNextBlock(&inputs[lane]);
+                if (blocks[lane] == NULL)
+                {
+                    /* Message complete: store, then refill on next round */
+                    ARSAL_MD5_StateStore(state, lane, laneEntry[lane]->digest);
+                    if (ARSAL_MD5_InputComplete(&inputs[lane]))
+                    {
+                        ARSAL_MD5_Finish(laneEntry[lane], ARSAL_MD5_LENGTH);
+                    }
+                    else
+                    {
+                        laneEntry[lane]->error = ARSAL_ERROR_FILE;
+                    }
+                    ARSAL_MD5_InputClose(&inputs[lane]);
+                    laneEntry[lane] = NULL;
+                    active--;
+                    lane--;
+                }
+            }
+        }
+
+        if (active == 0)
+        {
+            break;
+        }
+
+        /* Transpose: word j of every lane's block into vector j (little endian words) */
+        for (j = 0; j < 16; j++)
+        {
+            for (lane = 0; lane < ARSAL_MD5_LANES; lane++)
+            {
+                const uint8_t *p = blocks[lane];
+                m[j][lane] = (p != NULL) ?
+                    ((uint32_t)p[4 * j] | ((uint32_t)p[4 * j + 1] << 8) | ((uint32_t)p[4 * j + 2] << 16) | ((uint32_t)p[4 * j + 3] << 24)) : 0;
+            }
+        }
+
+        memcpy(saved, state, sizeof(saved));
+        ARSAL_MD5_Compress(state, m);
+        /* Idle lanes keep their (meaningless) state untouched */
+        for (lane = 0; lane < ARSAL_MD5_LANES; lane++)
+        {
+            if (blocks[lane] == NULL)
+            {
+                for (j = 0; j < 4; j++)
+                {
+                    state[j][lane] = saved[j][lane];
+                }
+            }
+        }
+    }
+}
+
+typedef struct
+{
+    ARSAL_MD5_BatchEntry_t *entries;
+    eARSAL_MD5_DIGEST digestType;
+} ARSAL_MD5_BatchContext_t;
+
+static void ARSAL_MD5_BatchRange(size_t begin, size_t end, void *arg)
+{
+    ARSAL_MD5_BatchContext_t *context = arg;
+    size_t i;
+
+    if (context->digestType == ARSAL_MD5_DIGEST_MD5)
+    {
+        ARSAL_MD5_ProcessMd5(&context->entries[begin], end - begin);
+    }
+    else
+    {
+        for (i = begin; i < end; i++)
+        {
+            ARSAL_MD5_ProcessXxh64(&context->entries[i]);
+        }
+    }
+}
+
+eARSAL_ERROR ARSAL_MD5_Manager_ComputeBatch(ARSAL_TaskPool_t *pool, ARSAL_MD5_BatchEntry_t *entries, int nbEntries, eARSAL_MD5_DIGEST digestType)
+{
+    ARSAL_MD5_BatchContext_t context;
+    eARSAL_ERROR error;
+    int i;
+
+    if ((entries == NULL) || (nbEntries < 0) ||
+        ((digestType != ARSAL_MD5_DIGEST_MD5) && (digestType != ARSAL_MD5_DIGEST_XXH64)))
+    {
+        return ARSAL_ERROR_BAD_PARAMETER;
+    }
+
+    context.entries = entries;
+    context.digestType = digestType;
+    if (pool != NULL)
+    {
+        error = ARSAL_TaskPool_ParallelFor(pool, 0, (size_t)nbEntries,
+                                           (digestType == ARSAL_MD5_DIGEST_MD5) ? ARSAL_MD5_BATCH_GRAIN : 1,
+                                           ARSAL_MD5_BatchRange, &context);
+        if (error != ARSAL_OK)
+        {
+            return error;
+        }
+    }
+    else
+    {
+        ARSAL_MD5_BatchRange(0, (size_t)nbEntries, &context);
+    }
+
+    for (i = 0; i < nbEntries; i++)
+    {
+        if (entries[i].error != ARSAL_OK)
+        {
+            return entries[i].error;
+        }
+    }
+    return ARSAL_OK;
+}
+
+eARSAL_ERROR ARSAL_MD5_Manager_ComputeFile(const char *filePath, eARSAL_MD5_DIGEST digestType, uint8_t *digest, int digestSize)
+{
+    ARSAL_MD5_BatchEntry_t entry;
+    int length = (digestType == ARSAL_MD5_DIGEST_MD5) ? ARSAL_MD5_LENGTH : ARSAL_XXH64_LENGTH;
+    eARSAL_ERROR error;
+
+    if ((filePath == NULL) || (digest == NULL) || (digestSize < length))
+    {
+        return ARSAL_ERROR_BAD_PARAMETER;
+    }
+
+    memset(&entry, 0, sizeof(entry));
+    entry.filePath = filePath;
+    error = ARSAL_MD5_Manager_ComputeBatch(NULL, &entry, 1, digestType);
+    if (error == ARSAL_OK)
+    {
+        memcpy(digest, entry.digest, length);
+    }
+    return error;
+}
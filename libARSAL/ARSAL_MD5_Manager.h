@@ -38,9 +38,34 @@
 #ifndef _ARSAL_MD5_H_
 #define _ARSAL_MD5_H_
 
+#include <inttypes.h>
 #include "libARSAL/ARSAL_Error.h"
+#include "libARSAL/ARSAL_TaskPool.h"
 
 #define ARSAL_MD5_LENGTH        16
+#define ARSAL_XXH64_LENGTH      8
+
+/**
+ * @brief Digest algorithm used by the streaming and batch functions
+ * @see ARSAL_MD5_Manager_ComputeBatch ()
+ */
+typedef enum
+{
+    ARSAL_MD5_DIGEST_MD5 = 0,   /**< MD5, ARSAL_MD5_LENGTH bytes */
+    ARSAL_MD5_DIGEST_XXH64,     /**< XXH64 (seed 0), ARSAL_XXH64_LENGTH bytes, stored big endian like its canonical form. Not cryptographic, for integrity checks only */
+} eARSAL_MD5_DIGEST;
+
+/**
+ * @brief One file of a batch
+ * @see ARSAL_MD5_Manager_ComputeBatch ()
+ */
+typedef struct
+{
+    const char *filePath;               /**< The file path */
+    const char *expected;               /**< Expected digest as an hex string, or NULL to only compute */
+    uint8_t digest[ARSAL_MD5_LENGTH];   /**< [out] The digest */
+    eARSAL_ERROR error;                 /**< [out] ARSAL_OK, ARSAL_ERROR_FILE if the file could not be read, ARSAL_ERROR_MD5 if the digest does not match expected */
+} ARSAL_MD5_BatchEntry_t;
 
 /**
  * @brief Check an MD5
@@ -132,6 +157,30 @@ eARSAL_ERROR ARSAL_MD5_Manager_Check(ARSAL_MD5_Manager_t *manager, const char *f
  */
 eARSAL_ERROR ARSAL_MD5_Manager_Compute(ARSAL_MD5_Manager_t *manager, const char *filePath, uint8_t *md5, int md5Size);
 
+/**
+ * @brief Compute the digest of a file with a streaming, memory mapped read
+ * @param filePath The file path
+ * @param digestType The digest algorithm
+ * @param[out] digest The buffer to receive the digest
+ * @param digestSize digest buffer length (at least ARSAL_MD5_LENGTH or ARSAL_XXH64_LENGTH)
+ * @retval On success, returns ARSAL_OK. Otherwise, it returns an error number of eARSAL_ERROR
+ */
+eARSAL_ERROR ARSAL_MD5_Manager_ComputeFile(const char *filePath, eARSAL_MD5_DIGEST digestType, uint8_t *digest, int digestSize);
+
+/**
+ * @brief Compute (and optionally check) the digests of many files
+ *
+ * Files are memory mapped with sequential read-ahead. MD5 digests of several
+ * files are computed together, one file per SIMD lane. The batch is spread
+ * over the workers of pool.
+ *
+ * @param pool The task pool (NULL to run in the calling thread)
+ * @param entries The files. The result of each file is stored in its entry
+ * @param nbEntries The number of entries
+ * @param digestType The digest algorithm
+ * @retval ARSAL_OK if every file was read and matched its expected digest. Otherwise, the error of the first failed entry
+ */
+eARSAL_ERROR ARSAL_MD5_Manager_ComputeBatch(ARSAL_TaskPool_t *pool, ARSAL_MD5_BatchEntry_t *entries, int nbEntries, eARSAL_MD5_DIGEST digestType);
 
 #endif /* _ARSAL_MD5_H_ */
 
@@ -37,6 +37,8 @@
 #ifndef _ARSAL_MUTEX_H_
 #define _ARSAL_MUTEX_H_
 
+#include <stdio.h>
+
 /**
  * @brief Define a mutex type.
  */
@@ -138,4 +140,88 @@ int ARSAL_Cond_Signal(ARSAL_Cond_t *cond);
  */
 int ARSAL_Cond_Broadcast(ARSAL_Cond_t *cond);
 
+/**
+ * @brief Define an adaptive mutex type.
+ *
+ * An adaptive mutex spins for a short, self-tuned, number of iterations
+ * before sleeping on a futex. It suits short critical sections shared by a
+ * few threads, where a context switch costs more than the wait itself.
+ *
+ * When the library and the user code are built with ARSAL_MUTEX_PROFILING
+ * defined, each lock records its wait time, hold time and acquirer call
+ * sites. See ARSAL_AdaptiveMutex_DumpProfile().
+ */
+typedef void* ARSAL_AdaptiveMutex_t;
+
+/**
+ * @brief Initializes an adaptive mutex.
+ *
+ * @param mutex The mutex to initialize
+ * @param name A name used in the profiling report (optional, may be NULL)
+ * @retval On success, ARSAL_AdaptiveMutex_Init() returns 0. Otherwise, it returns an error number (See errno.h)
+ */
+int ARSAL_AdaptiveMutex_Init(ARSAL_AdaptiveMutex_t *mutex, const char *name);
+
+/**
+ * @brief Destroys an adaptive mutex
+ *
+ * @param mutex The mutex to destroy
+ * @retval On success, ARSAL_AdaptiveMutex_Destroy() returns 0. Otherwise, it returns an error number (See errno.h)
+ */
+int ARSAL_AdaptiveMutex_Destroy(ARSAL_AdaptiveMutex_t *mutex);
+
+/**
+ * @brief Locks an adaptive mutex, recording the call site
+ * @warning This function should not be used directly
+ * @see ARSAL_AdaptiveMutex_Lock()
+ *
+ * @param mutex The mutex to lock
+ * @param func The function of the call site (may be NULL)
+ * @param line The line of the call site
+ * @retval On success, ARSAL_AdaptiveMutex_LockEx() returns 0. Otherwise, it returns an error number (See errno.h)
+ */
+int ARSAL_AdaptiveMutex_LockEx(ARSAL_AdaptiveMutex_t *mutex, const char *func, int line);
+
+/**
+ * @brief Locks an adaptive mutex
+ *
+ * @param mutex The mutex to lock
+ * @retval On success, ARSAL_AdaptiveMutex_Lock() returns 0. Otherwise, it returns an error number (See errno.h)
+ */
+#ifdef ARSAL_MUTEX_PROFILING
+#define ARSAL_AdaptiveMutex_Lock(mutex) \
+    ARSAL_AdaptiveMutex_LockEx(mutex, __FUNCTION__, __LINE__)
+#else
+#define ARSAL_AdaptiveMutex_Lock(mutex) \
+    ARSAL_AdaptiveMutex_LockEx(mutex, NULL, 0)
+#endif
+
+/**
+ * @brief Tries to lock an adaptive mutex
+ *
+ * @param mutex The mutex to lock
+ * @retval On success, ARSAL_AdaptiveMutex_Trylock() returns 0. If the mutex is already locked, it returns EBUSY
+ */
+int ARSAL_AdaptiveMutex_Trylock(ARSAL_AdaptiveMutex_t *mutex);
+
+/**
+ * @brief Unlocks an adaptive mutex
+ *
+ * @param mutex The mutex to unlock
+ * @retval On success, ARSAL_AdaptiveMutex_Unlock() returns 0. Otherwise, it returns an error number (See errno.h)
+ */
+int ARSAL_AdaptiveMutex_Unlock(ARSAL_AdaptiveMutex_t *mutex);
+
+/**
+ * @brief Writes the contention report of all live adaptive mutexes
+ *
+ * Locks are sorted by total wait time. For each lock the report gives the
+ * number of acquisitions, the contended ratio, wait and hold times and the
+ * call sites that waited the most.
+ * Does nothing unless the library was built with ARSAL_MUTEX_PROFILING.
+ *
+ * @param file The output file
+ */
+void ARSAL_AdaptiveMutex_DumpProfile(FILE *file);
+
 #endif // _ARSAL_MUTEX_H_
@@ -0,0 +1,668 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_Pool.c
+ * @brief Fixed-size object pool allocator with per-thread caches
+ * @date 10/18/2026
+ *
+ * Objects are carved from slabs aligned on their (power of two) size, so
+ * the slab of any object is found by masking its address. Free objects
+ * not cached by a thread are kept in a lock-free LIFO whose head is a
+ * 32-bit object index tagged with a 32-bit counter against ABA. Each
+ * thread keeps up to two magazines of objects and only exchanges whole
+ * magazines with the global list.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_Pool.h>
+
+#define ARSAL_POOL_TAG "ARSAL_Pool"
+
+#define ARSAL_POOL_NAME_SIZE            32
+#define ARSAL_POOL_MAX_SLABS            65536
+#define ARSAL_POOL_MIN_OBJECTS_PER_SLAB 8
+/* First bytes of a free object hold the free list link, they are not poisoned */
+#define ARSAL_POOL_LINK_SIZE            sizeof(uint32_t)
+#define ARSAL_POOL_MAX_LEAKS_LISTED     16
+
+/* Object states in debug mode */
+#define ARSAL_POOL_STATE_FREE           0
+#define ARSAL_POOL_STATE_LIVE           1
+
+typedef struct
+{
+    ARSAL_Pool_t *pool;
+    uint32_t index;
+    uint32_t nbObjects;
+    uint8_t *objects;
+    uint8_t *states;        /**< Debug mode object states */
+} ARSAL_Pool_Slab_t;
+
+typedef struct ARSAL_Pool_Cache_t
+{
+    ARSAL_Pool_t *pool;
+    struct ARSAL_Pool_Cache_t *next;
+    struct ARSAL_Pool_Cache_t *prev;
+    uint64_t allocs;
+    uint64_t frees;
+    int count;
+    void *objects[];        /**< Two magazines */
+} ARSAL_Pool_Cache_t;
+
+struct ARSAL_Pool_t
+{
+    volatile uint64_t freeHead;     /**< Tag (32) | index + 1 (32), 0 index when empty */
+    char pad[64 - sizeof(uint64_t)];
+    size_t objectSize;
+    size_t stride;
+    size_t slabSize;
+    size_t headerSize;
+    size_t objectsPerSlab;
+    size_t maxObjects;
+    int magazineSize;
+    int debug;
+    char name[ARSAL_POOL_NAME_SIZE];
+    ARSAL_Pool_Slab_t **slabs;
+    size_t maxSlabs;
+    volatile size_t nbSlabs;
+    size_t capacity;
+    ARSAL_Mutex_t mutex;            /**< Protects growth, cache list and dead cache counters */
+    pthread_key_t key;
+    ARSAL_Pool_Cache_t *caches;
+    uint64_t deadAllocs;
+    uint64_t deadFrees;
+    volatile uint64_t uncachedAllocs;   /**< Allocations and frees done without a thread cache (no memory for it) */
+    volatile uint64_t uncachedFrees;
+    volatile uint64_t failures;
+    volatile uint64_t errors;
+};
+
+static size_t ARSAL_Pool_RoundUp(size_t value, size_t align)
+{
+    return (value + align - 1) & ~(align - 1);
+}
+
+static ARSAL_Pool_Slab_t *ARSAL_Pool_SlabOf(ARSAL_Pool_t *pool, const void *object)
+{
+    return (ARSAL_Pool_Slab_t *)((uintptr_t)object & ~(uintptr_t)(pool->slabSize - 1));
+}
+
+static void *ARSAL_Pool_Resolve(ARSAL_Pool_t *pool, uint32_t index)
+{
+    ARSAL_Pool_Slab_t *slab = pool->slabs[index / pool->objectsPerSlab];
+    return slab->objects + (index % pool->objectsPerSlab) * pool->stride;
+}
+
+static uint32_t ARSAL_Pool_IndexOf(ARSAL_Pool_t *pool, const void *object)
+{
+    ARSAL_Pool_Slab_t *slab = ARSAL_Pool_SlabOf(pool, object);
+    return (uint32_t)(slab->index * pool->objectsPerSlab + ((const uint8_t *)object - slab->objects) / pool->stride);
+}
+
+/*
+ * Lock-free global free list
+ */
+
+static void ARSAL_Pool_PushChain(ARSAL_Pool_t *pool, void **objects, int count)
+{
+    uint64_t old, new;
+    uint32_t first;
+    int i;
+
+    if (count <= 0)
+    {
+        return;
+    }
+    for (i = 0; i < count - 1; i++)
+    {
+        *(uint32_t *)objects[i] = ARSAL_Pool_IndexOf(pool, objects[i + 1]) + 1;
+    }
+    first = ARSAL_Pool_IndexOf(pool, objects[0]) + 1;
+
+    old = __atomic_load_n(&pool->freeHead, __ATOMIC_RELAXED);
+    do
+    {
+        *(uint32_t *)objects[count - 1] = (uint32_t)old;
+        new = (((old >> 32) + 1) << 32) | first;
+    } while (!__atomic_compare_exchange_n(&pool->freeHead, &old, new, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+static int ARSAL_Pool_PopChain(ARSAL_Pool_t *pool, void **objects, int count)
+{
+    int n = 0;
+
+    while (n < count)
+    {
+        uint64_t old = __atomic_load_n(&pool->freeHead, __ATOMIC_ACQUIRE);
+        uint64_t new;
+        void *object;
+
+        do
+        {
+            if ((uint32_t)old == 0)
+            {
+                return n;
+            }
+            object = ARSAL_Pool_Resolve(pool, (uint32_t)old - 1);
+            /* May read a link being overwritten by the thread which popped
+             * the object meanwhile: the tag then makes the exchange fail */
+            new = (((old >> 32) + 1) << 32) | __atomic_load_n((volatile uint32_t *)object, __ATOMIC_RELAXED);
+        } while (!__atomic_compare_exchange_n(&pool->freeHead, &old, new, 1, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+
+        objects[n++] = object;
+    }
+    return n;
+}
+
+/**
+ * @brief Add a slab, give up to count of its objects and push the others on the free list
+ */
+static int ARSAL_Pool_Grow(ARSAL_Pool_t *pool, void **objects, int count)
+{
+    ARSAL_Pool_Slab_t *slab = NULL;
+    size_t nbObjects;
+    size_t i;
+    int n = 0;
+
+    ARSAL_Mutex_Lock(&pool->mutex);
+
+    /* Another thread may have grown the pool meanwhile */
+    n = ARSAL_Pool_PopChain(pool, objects, count);
+    if (n > 0)
+    {
+        ARSAL_Mutex_Unlock(&pool->mutex);
+        return n;
+    }
+
+    nbObjects = pool->objectsPerSlab;
+    if ((pool->maxObjects > 0) && (pool->capacity + nbObjects > pool->maxObjects))
+    {
+        nbObjects = pool->maxObjects - pool->capacity;
+    }
+    if ((nbObjects > 0) && (pool->nbSlabs < pool->maxSlabs) &&
+        (posix_memalign((void **)&slab, pool->slabSize, pool->slabSize) == 0))
+    {
+        slab->pool = pool;
+        slab->index = (uint32_t)pool->nbSlabs;
+        slab->nbObjects = (uint32_t)nbObjects;
+        slab->objects = (uint8_t *)slab + pool->headerSize;
+        slab->states = NULL;
+        if (pool->debug)
+        {
+            slab->states = calloc(pool->objectsPerSlab, 1);
+            for (i = 0; i < nbObjects; i++)
+            {
+                memset(slab->objects + i * pool->stride + ARSAL_POOL_LINK_SIZE, ARSAL_POOL_POISON_FREE, pool->objectSize - ARSAL_POOL_LINK_SIZE);
+            }
+        }
+        if (pool->debug && (slab->states == NULL))
+        {
+            free(slab);
+            slab = NULL;
+        }
+    }
+    if (slab == NULL)
+    {
+        ARSAL_Mutex_Unlock(&pool->mutex);
+        return 0;
+    }
+
+    /* Publish the slab before any of its objects can be resolved */
+    pool->slabs[slab->index] = slab;
+    __atomic_store_n(&pool->nbSlabs, pool->nbSlabs + 1, __ATOMIC_RELEASE);
+    pool->capacity += nbObjects;
+
+    for (i = 0; (i < nbObjects) && (n < count); i++)
+    {
+        objects[n++] = slab->objects + i * pool->stride;
+    }
+    if (i < nbObjects)
+    {
+        /* Link the remaining objects in place and push them at once */
+        uint32_t first = slab->index * (uint32_t)pool->objectsPerSlab + (uint32_t)i;
+        uint32_t last = slab->index * (uint32_t)pool->objectsPerSlab + (uint32_t)nbObjects - 1;
+        uint64_t old, new;
+        uint32_t k;
+
+        for (k = first; k < last; k++)
+        {
+            *(uint32_t *)ARSAL_Pool_Resolve(pool, k) = k + 2;
+        }
+        old = __atomic_load_n(&pool->freeHead, __ATOMIC_RELAXED);
+        do
+        {
+            *(uint32_t *)ARSAL_Pool_Resolve(pool, last) = (uint32_t)old;
+            new = (((old >> 32) + 1) << 32) | (first + 1);
+        } while (!__atomic_compare_exchange_n(&pool->freeHead, &old, new, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    }
+
+    ARSAL_Mutex_Unlock(&pool->mutex);
+    return n;
+}
+
+/*
+ * Thread caches
+ */
+
+static void ARSAL_Pool_CacheRelease(ARSAL_Pool_t *pool, ARSAL_Pool_Cache_t *cache)
+{
+    ARSAL_Pool_PushChain(pool, cache->objects, cache->count);
+    cache->count = 0;
+
+    ARSAL_Mutex_Lock(&pool->mutex);
+    pool->deadAllocs += cache->allocs;
+    pool->deadFrees += cache->frees;
+    if (cache->prev != NULL)
+    {
+        cache->prev->next = cache->next;
+    }
+    else
+    {
+        pool->caches = cache->next;
+    }
+    if (cache->next != NULL)
+    {
+        cache->next->prev = cache->prev;
+    }
+    ARSAL_Mutex_Unlock(&pool->mutex);
+    free(cache);
+}
+
+static void ARSAL_Pool_ThreadExit(void *arg)
+{
+    ARSAL_Pool_Cache_t *cache = arg;
+    ARSAL_Pool_CacheRelease(cache->pool, cache);
+}
+
+static ARSAL_Pool_Cache_t *ARSAL_Pool_GetCache(ARSAL_Pool_t *pool)
+{
+    ARSAL_Pool_Cache_t *cache = pthread_getspecific(pool->key);
+
+    if (cache == NULL)
+    {
+        cache = calloc(1, sizeof(*cache) + 2 * pool->magazineSize * sizeof(void *));
+        if (cache != NULL)
+        {
+            cache->pool = pool;
+            ARSAL_Mutex_Lock(&pool->mutex);
+            cache->next = pool->caches;
+            if (pool->caches != NULL)
+            {
+                pool->caches->prev = cache;
+            }
+            pool->caches = cache;
+            ARSAL_Mutex_Unlock(&pool->mutex);
+            pthread_setspecific(pool->key, cache);
+        }
+    }
+    return cache;
+}
+
+/*
+ * Debug checks
+ */
+
+static void ARSAL_Pool_CheckAlloc(ARSAL_Pool_t *pool, uint8_t *object)
+{
+    ARSAL_Pool_Slab_t *slab = ARSAL_Pool_SlabOf(pool, object);
+    size_t index = (object - slab->objects) / pool->stride;
+    size_t i;
+
+    __atomic_store_n(&slab->states[index], ARSAL_POOL_STATE_LIVE, __ATOMIC_RELAXED);
+    for (i = ARSAL_POOL_LINK_SIZE; i < pool->objectSize; i++)
+    {
+        if (object[i] != ARSAL_POOL_POISON_FREE)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSAL_POOL_TAG, "%s: object %p written after free (offset %zu)", pool->name, object, i);
+            __atomic_add_fetch(&pool->errors, 1, __ATOMIC_RELAXED);
+            break;
+        }
+    }
+    memset(object, ARSAL_POOL_POISON_ALLOC, pool->objectSize);
+}
+
+static int ARSAL_Pool_CheckFree(ARSAL_Pool_t *pool, uint8_t *object)
+{
+    ARSAL_Pool_Slab_t *slab = ARSAL_Pool_SlabOf(pool, object);
+    size_t offset, index;
+
+    if ((slab->pool != pool) || (object < slab->objects) ||
+        ((offset = object - slab->objects) % pool->stride != 0) ||
+        ((index = offset / pool->stride) >= slab->nbObjects))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSAL_POOL_TAG, "%s: free of %p which is not an object of the pool", pool->name, object);
+        __atomic_add_fetch(&pool->errors, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+    if (__atomic_exchange_n(&slab->states[index], ARSAL_POOL_STATE_FREE, __ATOMIC_RELAXED) != ARSAL_POOL_STATE_LIVE)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSAL_POOL_TAG, "%s: double free of %p", pool->name, object);
+        __atomic_add_fetch(&pool->errors, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+    memset(object + ARSAL_POOL_LINK_SIZE, ARSAL_POOL_POISON_FREE, pool->objectSize - ARSAL_POOL_LINK_SIZE);
+    return 1;
+}
+
+/*
+ * Public API
+ */
+
+void ARSAL_Pool_Config_Init(ARSAL_Pool_Config_t *config, size_t objectSize, size_t alignment)
+{
+    if (config == NULL)
+    {
+        return;
+    }
+    memset(config, 0, sizeof(*config));
+    config->objectSize = objectSize;
+    config->alignment = alignment;
+}
+
+ARSAL_Pool_t *ARSAL_Pool_New(const ARSAL_Pool_Config_t *config, eARSAL_ERROR *error)
+{
+    ARSAL_Pool_t *pool = NULL;
+    eARSAL_ERROR err = ARSAL_OK;
+    size_t alignment;
+    int keyCreated = 0;
+
+    if ((config == NULL) || (config->objectSize == 0) ||
+        ((config->alignment & (config->alignment - 1)) != 0))
+    {
+        err = ARSAL_ERROR_BAD_PARAMETER;
+    }
+
+    if ((err == ARSAL_OK) && (posix_memalign((void **)&pool, 64, sizeof(*pool)) != 0))
+    {
+        pool = NULL;
+        err = ARSAL_ERROR_ALLOC;
+    }
+
+    if (err == ARSAL_OK)
+    {
+        memset(pool, 0, sizeof(*pool));
+        snprintf(pool->name, sizeof(pool->name), "%s", (config->name != NULL) ? config->name : "pool");
+        pool->debug = config->debug;
+        pool->maxObjects = config->maxObjects;
+        pool->magazineSize = (config->magazineSize > 0) ? config->magazineSize : ARSAL_POOL_DEFAULT_MAGAZINE_SIZE;
+
+        /* Room for the free list link, natural alignment by default */
+        pool->objectSize = (config->objectSize < ARSAL_POOL_LINK_SIZE) ? ARSAL_POOL_LINK_SIZE : config->objectSize;
+        alignment = (config->alignment > 0) ? config->alignment : sizeof(void *);
+        while ((config->alignment == 0) && (alignment < 16) && (alignment < pool->objectSize))
+        {
+            alignment <<= 1;
+        }
+        pool->stride = ARSAL_Pool_RoundUp(pool->objectSize, alignment);
+        pool->headerSize = ARSAL_Pool_RoundUp(sizeof(ARSAL_Pool_Slab_t), alignment);
+
+        pool->slabSize = 4096;
+        while ((pool->slabSize < ((config->slabSize > 0) ? config->slabSize : ARSAL_POOL_DEFAULT_SLAB_SIZE)) ||
+               (pool->slabSize < pool->headerSize + ARSAL_POOL_MIN_OBJECTS_PER_SLAB * pool->stride))
+        {
+            pool->slabSize <<= 1;
+        }
+        pool->objectsPerSlab = (pool->slabSize - pool->headerSize) / pool->stride;
+
+        pool->maxSlabs = ARSAL_POOL_MAX_SLABS;
+        if (pool->maxObjects > 0)
+        {
+            pool->maxSlabs = (pool->maxObjects + pool->objectsPerSlab - 1) / pool->objectsPerSlab;
+        }
+        if (pool->maxSlabs > UINT32_MAX / pool->objectsPerSlab)
+        {
+            pool->maxSlabs = UINT32_MAX / pool->objectsPerSlab;
+        }
+        pool->slabs = calloc(pool->maxSlabs, sizeof(*pool->slabs));
+        if (pool->slabs == NULL)
+        {
+            err = ARSAL_ERROR_ALLOC;
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        if (pthread_key_create(&pool->key, ARSAL_Pool_ThreadExit) != 0)
+        {
+            err = ARSAL_ERROR_SYSTEM;
+        }
+        else
+        {
+            keyCreated = 1;
+        }
+    }
+
+    if ((err == ARSAL_OK) && (ARSAL_Mutex_Init(&pool->mutex) != 0))
+    {
+        err = ARSAL_ERROR_SYSTEM;
+    }
+
+    if ((err != ARSAL_OK) && (pool != NULL))
+    {
+        if (keyCreated)
+        {
+            pthread_key_delete(pool->key);
+        }
+        free(pool->slabs);
+        free(pool);
+        pool = NULL;
+    }
+
+    if (error != NULL)
+    {
+        *error = err;
+    }
+    return pool;
+}
+
+void ARSAL_Pool_Delete(ARSAL_Pool_t **pool)
+{
+    ARSAL_Pool_Stats_t stats;
+    ARSAL_Pool_t *p;
+    size_t i, j;
+
+    if ((pool == NULL) || (*pool == NULL))
+    {
+        return;
+    }
+    p = *pool;
+
+    /* No destructor must run on a deleted pool */
+    pthread_key_delete(p->key);
+
+    ARSAL_Pool_GetStats(p, &stats);
+    if (stats.live > 0)
+    {
+        int listed = 0;
+
+        ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSAL_POOL_TAG, "%s: %" PRIu64 " objects leaked (%" PRIu64 " allocs, %" PRIu64 " frees)",
+                    p->name, stats.live, stats.allocs, stats.frees);
+        for (i = 0; p->debug && (i < p->nbSlabs); i++)
+        {
+            for (j = 0; (j < p->slabs[i]->nbObjects) && (listed < ARSAL_POOL_MAX_LEAKS_LISTED); j++)
+            {
+                if (p->slabs[i]->states[j] == ARSAL_POOL_STATE_LIVE)
+                {
+                    ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSAL_POOL_TAG, "%s: leaked %p", p->name, p->slabs[i]->objects + j * p->stride);
+                    listed++;
+                }
+            }
+        }
+    }
+
+    while (p->caches != NULL)
+    {
+        ARSAL_Pool_Cache_t *cache = p->caches;
+        p->caches = cache->next;
+        free(cache);
+    }
+    for (i = 0; i < p->nbSlabs; i++)
+    {
+        free(p->slabs[i]->states);
+        free(p->slabs[i]);
+    }
+    ARSAL_Mutex_Destroy(&p->mutex);
+    free(p->slabs);
+    free(p);
+    *pool = NULL;
+}
+
+void *ARSAL_Pool_Alloc(ARSAL_Pool_t *pool)
+{
+    ARSAL_Pool_Cache_t *cache;
+    void *object = NULL;
+
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+
+    cache = ARSAL_Pool_GetCache(pool);
+    if (cache == NULL)
+    {
+        if ((ARSAL_Pool_PopChain(pool, &object, 1) == 0) && (ARSAL_Pool_Grow(pool, &object, 1) == 0))
+        {
+            object = NULL;
+        }
+        else
+        {
+            __atomic_add_fetch(&pool->uncachedAllocs, 1, __ATOMIC_RELAXED);
+        }
+    }
+    else
+    {
+        if (cache->count == 0)
+        {
+            /* Refill one magazine */
+            cache->count = ARSAL_Pool_PopChain(pool, cache->objects, pool->magazineSize);
+            if (cache->count == 0)
+            {
+                cache->count = ARSAL_Pool_Grow(pool, cache->objects, pool->magazineSize);
+            }
+        }
+        if (cache->count > 0)
+        {
+            object = cache->objects[--cache->count];
+            cache->allocs++;
+        }
+    }
+
+    if (object == NULL)
+    {
+        __atomic_add_fetch(&pool->failures, 1, __ATOMIC_RELAXED);
+    }
+    else if (pool->debug)
+    {
+        ARSAL_Pool_CheckAlloc(pool, object);
+    }
+    return object;
+}
+
+void ARSAL_Pool_Free(ARSAL_Pool_t *pool, void *object)
+{
+    ARSAL_Pool_Cache_t *cache;
+
+    if ((pool == NULL) || (object == NULL))
+    {
+        return;
+    }
+    if (pool->debug && !ARSAL_Pool_CheckFree(pool, object))
+    {
+        return;
+    }
+
+    cache = ARSAL_Pool_GetCache(pool);
+    if (cache == NULL)
+    {
+        ARSAL_Pool_PushChain(pool, &object, 1);
+        __atomic_add_fetch(&pool->uncachedFrees, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    if (cache->count == 2 * pool->magazineSize)
+    {
+        /* Both magazines full: give the older one back */
+        ARSAL_Pool_PushChain(pool, cache->objects, pool->magazineSize);
+        memmove(cache->objects, cache->objects + pool->magazineSize, pool->magazineSize * sizeof(void *));
+        cache->count = pool->magazineSize;
+    }
+    cache->objects[cache->count++] = object;
+    cache->frees++;
+}
+
+void ARSAL_Pool_ThreadFlush(ARSAL_Pool_t *pool)
+{
+    ARSAL_Pool_Cache_t *cache;
+
+    if (pool == NULL)
+    {
+        return;
+    }
+    cache = pthread_getspecific(pool->key);
+    if (cache != NULL)
+    {
+        ARSAL_Pool_PushChain(pool, cache->objects, cache->count);
+        cache->count = 0;
+    }
+}
+
+void ARSAL_Pool_GetStats(ARSAL_Pool_t *pool, ARSAL_Pool_Stats_t *stats)
+{
+    ARSAL_Pool_Cache_t *cache;
+
+    if ((pool == NULL) || (stats == NULL))
+    {
+        return;
+    }
+    memset(stats, 0, sizeof(*stats));
+
+    /* Counters of live caches are read without synchronization: exact once
+     * the threads are quiescent, approximate otherwise */
+    ARSAL_Mutex_Lock(&pool->mutex);
+    stats->allocs = pool->deadAllocs + __atomic_load_n(&pool->uncachedAllocs, __ATOMIC_RELAXED);
+    stats->frees = pool->deadFrees + __atomic_load_n(&pool->uncachedFrees, __ATOMIC_RELAXED);
+    for (cache = pool->caches; cache != NULL; cache = cache->next)
+    {
+        stats->allocs += cache->allocs;
+        stats->frees += cache->frees;
+    }
+    stats->capacity = pool->capacity;
+    stats->slabs = pool->nbSlabs;
+    ARSAL_Mutex_Unlock(&pool->mutex);
+
+    stats->live = (stats->allocs > stats->frees) ? stats->allocs - stats->frees : 0;
+    stats->failures = pool->failures;
+    stats->errors = pool->errors;
+}
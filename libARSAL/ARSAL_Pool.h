@@ -0,0 +1,180 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_Pool.h
+ * @brief Fixed-size object pool allocator with per-thread caches
+ * @date 10/18/2026
+ */
+#ifndef _ARSAL_POOL_H_
+#define _ARSAL_POOL_H_
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <libARSAL/ARSAL_Error.h>
+
+/**
+ * @brief Default size of a slab, the unit of memory the pool grows by (bytes, power of two)
+ */
+#define ARSAL_POOL_DEFAULT_SLAB_SIZE        (64 * 1024)
+
+/**
+ * @brief Default number of objects moved at once between a thread cache and the global free list
+ */
+#define ARSAL_POOL_DEFAULT_MAGAZINE_SIZE    32
+
+/**
+ * @brief Byte written over freed objects in debug mode
+ */
+#define ARSAL_POOL_POISON_FREE              0x5A
+
+/**
+ * @brief Byte written over newly allocated objects in debug mode
+ */
+#define ARSAL_POOL_POISON_ALLOC             0xA5
+
+/**
+ * @brief Pool type
+ */
+typedef struct ARSAL_Pool_t ARSAL_Pool_t;
+
+/**
+ * @brief Pool configuration
+ * @see ARSAL_Pool_Config_Init (), ARSAL_Pool_New ()
+ */
+typedef struct
+{
+    const char *name;           /**< Name used in the leak reports (optional, may be NULL) */
+    size_t objectSize;          /**< Size of the objects */
+    size_t alignment;           /**< Alignment of the objects (power of two, 0 for the natural alignment) */
+    size_t slabSize;            /**< Size of a slab, rounded up to a power of two. 0 for default */
+    size_t maxObjects;          /**< Maximum number of objects, 0 for no limit but the address space */
+    int magazineSize;           /**< Number of objects moved at once to/from a thread cache. 0 for default */
+    int debug;                  /**< Non zero to poison objects and check double frees, use after free and leaks */
+} ARSAL_Pool_Config_t;
+
+/**
+ * @brief Pool statistics
+ * @see ARSAL_Pool_GetStats ()
+ */
+typedef struct
+{
+    uint64_t allocs;            /**< Number of successful allocations */
+    uint64_t frees;             /**< Number of frees */
+    uint64_t live;              /**< Number of objects currently allocated */
+    uint64_t failures;          /**< Number of allocations failed because the pool is exhausted */
+    uint64_t errors;            /**< Number of double frees, foreign frees and use after free detected (debug mode) */
+    size_t capacity;            /**< Number of objects in the slabs */
+    size_t slabs;               /**< Number of slabs */
+} ARSAL_Pool_Stats_t;
+
+/**
+ * @brief Initialize a pool configuration with the defaults
+ * @param config The configuration to initialize
+ * @param objectSize The size of the objects
+ * @param alignment The alignment of the objects (0 for the natural alignment)
+ */
+void ARSAL_Pool_Config_Init(ARSAL_Pool_Config_t *config, size_t objectSize, size_t alignment);
+
+/**
+ * @brief Initialize a pool configuration for objects of a given type
+ */
+#define ARSAL_POOL_CONFIG_INIT(config, type) ARSAL_Pool_Config_Init((config), sizeof(type), __alignof__(type))
+
+/**
+ * @brief Define type-checked wrappers prefix_Alloc() and prefix_Free() around a pool of type objects
+ */
+#define ARSAL_POOL_DEFINE_TYPED(prefix, type)                           \
+    static inline type *prefix##_Alloc(ARSAL_Pool_t *pool)              \
+    {                                                                   \
+        return (type *)ARSAL_Pool_Alloc(pool);                          \
+    }                                                                   \
+    static inline void prefix##_Free(ARSAL_Pool_t *pool, type *object)  \
+    {                                                                   \
+        ARSAL_Pool_Free(pool, object);                                  \
+    }
+
+/**
+ * @brief Create a pool
+ * @warning This function allocates memory
+ * @param config The configuration
+ * @param[out] error A pointer on the error output (optional, may be NULL)
+ * @return Pointer on the new pool, or NULL on error
+ * @see ARSAL_Pool_Delete ()
+ */
+ARSAL_Pool_t *ARSAL_Pool_New(const ARSAL_Pool_Config_t *config, eARSAL_ERROR *error);
+
+/**
+ * @brief Delete a pool and all its objects
+ *
+ * Objects still allocated are reported as leaks (listed in debug mode).
+ *
+ * @warning No other thread may use the pool anymore
+ * @warning This function frees memory
+ * @param pool The address of the pointer on the pool
+ * @see ARSAL_Pool_New ()
+ */
+void ARSAL_Pool_Delete(ARSAL_Pool_t **pool);
+
+/**
+ * @brief Allocate an object
+ *
+ * Served from the calling thread cache; the global free list is only
+ * touched once every magazineSize allocations.
+ *
+ * @param pool The pool
+ * @return Pointer on the object, or NULL if the pool is exhausted
+ */
+void *ARSAL_Pool_Alloc(ARSAL_Pool_t *pool);
+
+/**
+ * @brief Free an object allocated from the same pool, from any thread
+ * @param pool The pool
+ * @param object The object (may be NULL)
+ */
+void ARSAL_Pool_Free(ARSAL_Pool_t *pool, void *object);
+
+/**
+ * @brief Give the objects cached by the calling thread back to the global free list
+ *
+ * Done automatically when the thread exits.
+ *
+ * @param pool The pool
+ */
+void ARSAL_Pool_ThreadFlush(ARSAL_Pool_t *pool);
+
+/**
+ * @brief Get the statistics of a pool
+ * @param pool The pool
+ * @param[out] stats The statistics
+ */
+void ARSAL_Pool_GetStats(ARSAL_Pool_t *pool, ARSAL_Pool_Stats_t *stats);
+
+#endif /* _ARSAL_POOL_H_ */
@@ -148,6 +148,7 @@ void ARSAL_Print_SetCallback( ARSAL_Print_Callback_t callback);
  * @param size size of data.
  * @param sizeDump size of data to actually dump. 0 to dump everything.
  * @param ts: timestamp of data. NULL to use current time
+ * @note This function writes synchronously. Use ARSAL_Dump_Data() from time critical threads.
  */
 void ARSAL_Print_DumpData(FILE *file, uint8_t tag, const void *data, size_t size, size_t sizeDump, const struct timespec *ts);
 
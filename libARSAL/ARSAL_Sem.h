@@ -38,6 +38,8 @@
 #define _ARSAL_SEM_H_
 
 #include <time.h>
+#include <inttypes.h>
+#include <libARSAL/ARSAL_Time.h>
 
 /**
  * @brief Define a semaphore type.
@@ -105,4 +107,107 @@ int ARSAL_Sem_Post(ARSAL_Sem_t *sem);
  */
 int ARSAL_Sem_Getvalue(ARSAL_Sem_t *sem, int *value);
 
+/**
+ * @brief Define a futex based semaphore type.
+ *
+ * Unlike ARSAL_Sem_t, this is a plain structure: it can be embedded in other
+ * structures, or placed in memory shared between processes when initialized
+ * with the shared flag. Wait and post never enter the kernel unless a thread
+ * actually has to sleep or to be woken up.
+ *
+ * @warning Fields should not be used directly
+ */
+typedef struct
+{
+    volatile uint32_t value;    /**< Current value, also the futex word */
+    volatile uint32_t waiters;  /**< Number of threads sleeping (or about to) on value */
+    int32_t shared;             /**< Non zero for a multi-process shared semaphore */
+} ARSAL_FutexSem_t;
+
+/**
+ * @brief Initializes a futex semaphore.
+ *
+ * @param sem The semaphore to initialize
+ * @param shared Flag asking for a multi-process shared semaphore
+ * @param value Initial value of the semaphore
+ * @retval On success, ARSAL_FutexSem_Init() returns 0. Otherwise, it returns -1 and set errno (See errno.h)
+ */
+int ARSAL_FutexSem_Init(ARSAL_FutexSem_t *sem, int shared, int value);
+
+/**
+ * @brief Destroys a futex semaphore
+ *
+ * @param sem The sem to destroy
+ * @retval On success, ARSAL_FutexSem_Destroy() returns 0. If threads are still waiting, it returns -1 and sets errno to "EBUSY"
+ */
+int ARSAL_FutexSem_Destroy(ARSAL_FutexSem_t *sem);
+
+/**
+ * @brief Wait for a futex semaphore
+ *
+ * @param sem The sem to wait for
+ * @retval On success, ARSAL_FutexSem_Wait() returns 0. Otherwise, it returns -1 and set errno (See errno.h)
+ */
+int ARSAL_FutexSem_Wait(ARSAL_FutexSem_t *sem);
+
+/**
+ * @brief Non blocking wait for a futex semaphore
+ *
+ * @param sem The sem to wait for
+ * @retval If the semaphore was successfully decremented, ARSAL_FutexSem_Trywait() returns 0. If the call would have blocked, it returns -1 and sets errno to "EAGAIN".
+ */
+int ARSAL_FutexSem_Trywait(ARSAL_FutexSem_t *sem);
+
+/**
+ * @brief Wait for a futex semaphore until a deadline
+ *
+ * @param sem The sem to wait for
+ * @param deadline Absolute CLOCK_MONOTONIC deadline, in ns (See ARSAL_Time_GetMonotonicNs())
+ * @note Unlike ARSAL_Sem_Timedwait(), the timeout is absolute, so retrying after EINTR or a spurious wakeup does not extend it
+ * @retval If the semaphore was sucessfully decremented, ARSAL_FutexSem_Timedwait() returns 0. If the deadline has passed, it returns -1 and sets errno to "ETIMEDOUT". On any other error, return -1 and set errno (See errno.h)
+ */
+int ARSAL_FutexSem_Timedwait(ARSAL_FutexSem_t *sem, ARSAL_Time_Ns_t deadline);
+
+/**
+ * @brief Wait for a futex semaphore and take up to count units at once
+ *
+ * Blocks until the value is non zero (or the deadline passes), then
+ * decrements it by min(value, count). This lets a consumer take a whole batch
+ * posted with ARSAL_FutexSem_PostN() in one call.
+ *
+ * @param sem The sem to wait for
+ * @param count Maximum number of units to take (must be > 0)
+ * @param deadline Absolute CLOCK_MONOTONIC deadline, in ns. 0 to wait forever
+ * @retval On success, the number of units taken (between 1 and count). Otherwise, -1 and errno is set ("ETIMEDOUT" if the deadline has passed, or the error of the futex wait)
+ */
+int ARSAL_FutexSem_WaitN(ARSAL_FutexSem_t *sem, int count, ARSAL_Time_Ns_t deadline);
+
+/**
+ * @brief Increment a futex semaphore
+ *
+ * @param sem The semaphore to increment
+ * @retval On success, ARSAL_FutexSem_Post() returns 0. Otherwise, it returns -1 and set errno (See errno.h)
+ */
+int ARSAL_FutexSem_Post(ARSAL_FutexSem_t *sem);
+
+/**
+ * @brief Increment a futex semaphore by count
+ *
+ * Wakes at most count waiters with a single futex call, and none if no thread is sleeping.
+ *
+ * @param sem The semaphore to increment
+ * @param count The increment (must be > 0)
+ * @retval On success, ARSAL_FutexSem_PostN() returns 0. Otherwise, it returns -1 and set errno (See errno.h)
+ */
+int ARSAL_FutexSem_PostN(ARSAL_FutexSem_t *sem, int count);
+
+/**
+ * @brief Get the current value of a futex semaphore
+ *
+ * @param sem The semaphore to get value from
+ * @param value Pointer which will hold the current value of the semaphore
+ * @retval On success, ARSAL_FutexSem_Getvalue() returns 0. Otherwise, it returns -1 and set errno (See errno.h)
+ */
+int ARSAL_FutexSem_Getvalue(ARSAL_FutexSem_t *sem, int *value);
+
 #endif // _ARSAL_SEM_H_
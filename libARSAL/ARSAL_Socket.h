@@ -40,8 +40,11 @@
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <time.h>
 
 struct iovec;
+struct mmsghdr;
+struct msghdr;
 
 /**
  * @brief Type of Service class selector
@@ -233,4 +236,119 @@ int ARSAL_Socket_Getsockopt(int sockfd, int level, int optname, void *optval, so
  */
 int ARSAL_Socket_Getsockname(int sockfd, struct sockaddr *addr, socklen_t *addrlen);
 
+/**
+ * @brief Application channels with a predefined QoS profile
+ * @see ARSAL_Socket_GetQosProfile ()
+ */
+typedef enum {
+    ARSAL_SOCKET_CHANNEL_COMMAND = 0,   /**< Piloting and settings commands: small, latency critical */
+    ARSAL_SOCKET_CHANNEL_ACK,           /**< Acknowledgements: small, latency critical */
+    ARSAL_SOCKET_CHANNEL_VIDEO,         /**< Video stream: bursty, throughput oriented */
+    ARSAL_SOCKET_CHANNEL_BULK,          /**< Media download and other background transfers */
+
+    ARSAL_SOCKET_CHANNEL_MAX,           /**< The maximum of enum, do not use ! */
+} eARSAL_SOCKET_CHANNEL;
+
+/**
+ * @brief Per socket QoS profile
+ *
+ * A 0 value in a field leaves the corresponding kernel setting unchanged.
+ * @see ARSAL_Socket_ApplyQosProfile ()
+ */
+typedef struct {
+    eARSAL_SOCKET_CLASS_SELECTOR classSelector; /**< DSCP class selector written in the IP TOS field (IPv6 traffic class) */
+    int priority;                               /**< SO_PRIORITY, selects the queueing discipline band (0 to 6) */
+    int rcvBufSize;                             /**< SO_RCVBUF size in bytes */
+    int sndBufSize;                             /**< SO_SNDBUF size in bytes */
+    int busyPollUs;                             /**< SO_BUSY_POLL duration in us, for latency critical receivers. Raising it needs CAP_NET_ADMIN (EPERM otherwise), 0 in the default profiles */
+    int udpGro;                                 /**< Non zero to enable UDP GRO on reception, only when every reader of the socket splits the buffers with ARSAL_Socket_GetGroSegmentSize(). Ignored on other than UDP sockets, 0 in the default profiles */
+} ARSAL_Socket_QosProfile_t;
+
+/**
+ * @brief Receive multiple messages on a socket with a single system call
+ *
+ * @param sockfd The socket descriptor used to receive
+ * @param msgvec An array of struct mmsghdr describing the receive buffers
+ * @param vlen The number of elements in msgvec
+ * @param flags The bitwise OR of zero or more of the socket flags
+ * @param timeout Maximum time to wait for vlen messages (NULL for no limit)
+ *
+ * @retval On success, the number of messages received is returned. Otherwise -1 is returned and errno is set appropriately. (See errno.h).
+ * @note Falls back to one recvmsg() per message if recvmmsg() is not available
+ */
+int ARSAL_Socket_Recvmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags, struct timespec *timeout);
+
+/**
+ * @brief Transmit multiple messages on a socket with a single system call
+ *
+ * @param sockfd The socket descriptor used to send
+ * @param msgvec An array of struct mmsghdr describing the messages
+ * @param vlen The number of elements in msgvec
+ * @param flags The bitwise OR of zero or more of the socket flags
+ *
+ * @retval On success, the number of messages sent is returned. Otherwise -1 is returned and errno is set appropriately. (See errno.h).
+ * @note Falls back to one sendmsg() per message if sendmmsg() is not available
+ */
+int ARSAL_Socket_Sendmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags);
+
+/**
+ * @brief Set the UDP generic segmentation offload size of a socket
+ *
+ * Once set, a single send of up to 64KB is split by the kernel (or the NIC)
+ * into datagrams of segmentSize bytes, which is much cheaper than sending
+ * each datagram on its own.
+ *
+ * @param sockfd The UDP socket
+ * @param segmentSize The datagram payload size. 0 to disable
+ * @retval On success, 0 is returned. Otherwise, -1 is returned, and errno is set appropriately (ENOPROTOOPT if the kernel does not support UDP GSO)
+ */
+int ARSAL_Socket_SetUdpSegmentSize(int sockfd, int segmentSize);
+
+/**
+ * @brief Get the GRO segment size of a received coalesced UDP message
+ *
+ * With UDP GRO enabled, one received buffer may hold several datagrams of
+ * the returned size (the last one may be shorter).
+ *
+ * @param msg The received message header, with its control buffer
+ * @retval The segment size, or 0 if the message was not coalesced
+ */
+int ARSAL_Socket_GetGroSegmentSize(const struct msghdr *msg);
+
+/**
+ * @brief Set the socket buffer sizes
+ *
+ * Tries SO_RCVBUFFORCE/SO_SNDBUFFORCE first (allowed with CAP_NET_ADMIN) so
+ * the sizes are not capped by net.core.rmem_max/wmem_max.
+ *
+ * @param sockfd The socket
+ * @param rcvBufSize The receive buffer size in bytes. 0 to keep the current size
+ * @param sndBufSize The send buffer size in bytes. 0 to keep the current size
+ * @retval On success, 0 is returned. Otherwise, -1 is returned, and errno is set appropriately. (See errno.h)
+ */
+int ARSAL_Socket_SetBufferSizes(int sockfd, int rcvBufSize, int sndBufSize);
+
+/**
+ * @brief Get the default QoS profile of an application channel
+ *
+ * @param channel The channel
+ * @param[out] profile The profile
+ * @retval On success, 0 is returned. Otherwise, -1 is returned, and errno is set to EINVAL
+ */
+int ARSAL_Socket_GetQosProfile(eARSAL_SOCKET_CHANNEL channel, ARSAL_Socket_QosProfile_t *profile);
+
+/**
+ * @brief Apply a QoS profile to a socket
+ *
+ * Every setting is attempted even if a previous one failed, so an
+ * unsupported option (e.g. busy poll) does not prevent the others. The
+ * settings which do not apply to the socket family or protocol (TOS of a
+ * non IP socket, UDP GRO of a TCP socket) are skipped.
+ *
+ * @param sockfd The socket
+ * @param profile The profile
+ * @retval If all the settings were applied, 0 is returned. Otherwise, -1 is returned, and errno is set to the error of the last failed setting
+ */
+int ARSAL_Socket_ApplyQosProfile(int sockfd, const ARSAL_Socket_QosProfile_t *profile);
+
 #endif // _ARSAL_SOCKET_H_
@@ -0,0 +1,258 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_SocketBatch.c
+ * @brief Batched socket I/O, UDP offloads and per channel QoS profiles
+ * @date 10/18/2026
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <libARSAL/ARSAL_Socket.h>
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#ifndef SO_BUSY_POLL
+#define SO_BUSY_POLL 46
+#endif
+#ifndef IPV6_TCLASS
+#define IPV6_TCLASS 67
+#endif
+
+static const ARSAL_Socket_QosProfile_t ARSAL_Socket_QosProfiles[ARSAL_SOCKET_CHANNEL_MAX] =
+{
+    /* classSelector,                    priority, rcvBufSize,      sndBufSize,      busyPollUs, udpGro */
+    [ARSAL_SOCKET_CHANNEL_COMMAND] = { ARSAL_SOCKET_CLASS_SELECTOR_CS6, 6, 64 * 1024,       64 * 1024,       0,          0 },
+    [ARSAL_SOCKET_CHANNEL_ACK]     = { ARSAL_SOCKET_CLASS_SELECTOR_CS6, 6, 64 * 1024,       64 * 1024,       0,          0 },
+    [ARSAL_SOCKET_CHANNEL_VIDEO]   = { ARSAL_SOCKET_CLASS_SELECTOR_CS4, 4, 4 * 1024 * 1024, 1024 * 1024,     0,          0 },
+    [ARSAL_SOCKET_CHANNEL_BULK]    = { ARSAL_SOCKET_CLASS_SELECTOR_CS1, 0, 1024 * 1024,     1024 * 1024,     0,          0 },
+};
+
+int ARSAL_Socket_Recvmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags, struct timespec *timeout)
+{
+    unsigned int i;
+    int ret = recvmmsg(sockfd, msgvec, vlen, flags, timeout);
+
+    if ((ret >= 0) || (errno != ENOSYS))
+    {
+        return ret;
+    }
+
+    /* Kernel without recvmmsg(): only block for the first message */
+    for (i = 0; i < vlen; i++)
+    {
+        ssize_t len = recvmsg(sockfd, &msgvec[i].msg_hdr, (i == 0) ? flags : (flags | MSG_DONTWAIT));
+        if (len < 0)
+        {
+            return (i > 0) ? (int)i : -1;
+        }
+        msgvec[i].msg_len = (unsigned int)len;
+    }
+    return (int)vlen;
+}
+
+int ARSAL_Socket_Sendmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+    unsigned int i;
+    int ret = sendmmsg(sockfd, msgvec, vlen, flags);
+
+    if ((ret >= 0) || (errno != ENOSYS))
+    {
+        return ret;
+    }
+
+    for (i = 0; i < vlen; i++)
+    {
+        ssize_t len = sendmsg(sockfd, &msgvec[i].msg_hdr, flags);
+        if (len < 0)
+        {
+            return (i > 0) ? (int)i : -1;
+        }
+        msgvec[i].msg_len = (unsigned int)len;
+    }
+    return (int)vlen;
+}
+
+int ARSAL_Socket_SetUdpSegmentSize(int sockfd, int segmentSize)
+{
+    return setsockopt(sockfd, SOL_UDP, UDP_SEGMENT, &segmentSize, sizeof(segmentSize));
+}
+
+int ARSAL_Socket_GetGroSegmentSize(const struct msghdr *msg)
+{
+    struct cmsghdr *cmsg;
+
+    if (msg == NULL)
+    {
+        return 0;
+    }
+    for (cmsg = CMSG_FIRSTHDR((struct msghdr *)msg); cmsg != NULL; cmsg = CMSG_NXTHDR((struct msghdr *)msg, cmsg))
+    {
+        if ((cmsg->cmsg_level == SOL_UDP) && (cmsg->cmsg_type == UDP_GRO))
+        {
+            int size;
+            memcpy(&size, CMSG_DATA(cmsg), sizeof(size));
+            return size;
+        }
+    }
+    return 0;
+}
+
+int ARSAL_Socket_SetBufferSizes(int sockfd, int rcvBufSize, int sndBufSize)
+{
+    int ret = 0;
+
+    if (rcvBufSize > 0)
+    {
+        if ((setsockopt(sockfd, SOL_SOCKET, SO_RCVBUFFORCE, &rcvBufSize, sizeof(rcvBufSize)) != 0) &&
+            (setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, &rcvBufSize, sizeof(rcvBufSize)) != 0))
+        {
+            ret = -1;
+        }
+    }
+    if (sndBufSize > 0)
+    {
+        if ((setsockopt(sockfd, SOL_SOCKET, SO_SNDBUFFORCE, &sndBufSize, sizeof(sndBufSize)) != 0) &&
+            (setsockopt(sockfd, SOL_SOCKET, SO_SNDBUF, &sndBufSize, sizeof(sndBufSize)) != 0))
+        {
+            ret = -1;
+        }
+    }
+    return ret;
+}
+
+int ARSAL_Socket_GetQosProfile(eARSAL_SOCKET_CHANNEL channel, ARSAL_Socket_QosProfile_t *profile)
+{
+    if ((profile == NULL) || (channel < 0) || (channel >= ARSAL_SOCKET_CHANNEL_MAX))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    *profile = ARSAL_Socket_QosProfiles[channel];
+    return 0;
+}
+
+int ARSAL_Socket_ApplyQosProfile(int sockfd, const ARSAL_Socket_QosProfile_t *profile)
+{
+    int ret = 0;
+    int error = 0;
+    int value;
+    int domain = AF_UNSPEC, type = 0, protocol = 0;
+    socklen_t len;
+
+    if (profile == NULL)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* The same profile applies to TCP and UDP, IPv4 and IPv6 sockets */
+    len = sizeof(domain);
+    if (getsockopt(sockfd, SOL_SOCKET, SO_DOMAIN, &domain, &len) != 0)
+    {
+        return -1;
+    }
+    len = sizeof(type);
+    getsockopt(sockfd, SOL_SOCKET, SO_TYPE, &type, &len);
+    len = sizeof(protocol);
+    getsockopt(sockfd, SOL_SOCKET, SO_PROTOCOL, &protocol, &len);
+
+    if (profile->classSelector != ARSAL_SOCKET_CLASS_SELECTOR_UNSPECIFIED)
+    {
+        value = (int)profile->classSelector;
+        if ((domain == AF_INET) && (setsockopt(sockfd, IPPROTO_IP, IP_TOS, &value, sizeof(value)) != 0))
+        {
+            ret = -1;
+            error = errno;
+        }
+        if (domain == AF_INET6)
+        {
+            if (setsockopt(sockfd, IPPROTO_IPV6, IPV6_TCLASS, &value, sizeof(value)) != 0)
+            {
+                ret = -1;
+                error = errno;
+            }
+            /* IPv4 traffic of a dual stack socket still uses the TOS */
+            setsockopt(sockfd, IPPROTO_IP, IP_TOS, &value, sizeof(value));
+        }
+    }
+    if (profile->priority > 0)
+    {
+        value = profile->priority;
+        if (setsockopt(sockfd, SOL_SOCKET, SO_PRIORITY, &value, sizeof(value)) != 0)
+        {
+            ret = -1;
+            error = errno;
+        }
+    }
+    if (ARSAL_Socket_SetBufferSizes(sockfd, profile->rcvBufSize, profile->sndBufSize) != 0)
+    {
+        ret = -1;
+        error = errno;
+    }
+    if (profile->busyPollUs > 0)
+    {
+        value = profile->busyPollUs;
+        if (setsockopt(sockfd, SOL_SOCKET, SO_BUSY_POLL, &value, sizeof(value)) != 0)
+        {
+            ret = -1;
+            error = errno;
+        }
+    }
+    /* Only a UDP reader which splits the coalesced buffers can take GRO */
+    if (profile->udpGro && (type == SOCK_DGRAM) && (protocol == IPPROTO_UDP))
+    {
+        value = 1;
+        if (setsockopt(sockfd, SOL_UDP, UDP_GRO, &value, sizeof(value)) != 0)
+        {
+            ret = -1;
+            error = errno;
+        }
+    }
+
+    if (ret != 0)
+    {
+        errno = error;
+    }
+    return ret;
+}
@@ -0,0 +1,682 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_TaskPool.c
+ * @brief Work-stealing task scheduler
+ * @date 10/18/2026
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <libARSAL/ARSAL_Futex.h>
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_TaskPool.h>
+#include <libARSAL/ARSAL_Time.h>
+
+#define ARSAL_TASKPOOL_TAG "ARSAL_TaskPool"
+
+#define ARSAL_TASKPOOL_CACHE_LINE       64
+#define ARSAL_TASKPOOL_IDLE_SPINS       64
+#define ARSAL_TASKPOOL_WAITING_FLAG     0x80000000u
+/* Group waiters re-check for stealable work at this period while sleeping */
+#define ARSAL_TASKPOOL_WAIT_SLICE_NS    MSEC_TO_NSEC(1ULL)
+
+typedef struct
+{
+    ARSAL_TaskPool_Task_t task;
+    void *arg;
+    ARSAL_TaskGroup_t *group;
+} ARSAL_TaskPool_Item_t;
+
+/* Chase-Lev deque: the owner pushes and takes at bottom, thieves steal at top */
+typedef struct
+{
+    volatile int64_t top;
+    char pad0[ARSAL_TASKPOOL_CACHE_LINE - sizeof(int64_t)];
+    volatile int64_t bottom;
+    char pad1[ARSAL_TASKPOOL_CACHE_LINE - sizeof(int64_t)];
+    ARSAL_TaskPool_Item_t *items;
+    int64_t mask;
+} ARSAL_TaskPool_Deque_t;
+
+typedef struct
+{
+    ARSAL_TaskPool_Deque_t deque;
+    ARSAL_TaskPool_t *pool;
+    ARSAL_Thread_t thread;
+    int index;
+    uint32_t seed;
+} __attribute__((aligned(ARSAL_TASKPOOL_CACHE_LINE))) ARSAL_TaskPool_Worker_t;
+
+struct ARSAL_TaskPool_t
+{
+    ARSAL_TaskPool_Worker_t *workers;
+    int nbWorkers;
+    volatile int run;
+
+    /* Tasks spawned from threads which are not workers */
+    ARSAL_Mutex_t injectMutex;
+    ARSAL_TaskPool_Item_t *inject;
+    size_t injectSize;
+    size_t injectHead;
+    volatile size_t injectCount;
+
+    /* Idle workers sleep on epoch, which is bumped on each spawn */
+    volatile uint32_t epoch;
+    volatile uint32_t sleepers;
+};
+
+static __thread ARSAL_TaskPool_Worker_t *ARSAL_TaskPool_CurrentWorker = NULL;
+
+/*
+ * Deque
+ */
+
+static void ARSAL_TaskPool_ItemStore(ARSAL_TaskPool_Item_t *dst, const ARSAL_TaskPool_Item_t *src)
+{
+    __atomic_store_n(&dst->task, src->task, __ATOMIC_RELAXED);
+    __atomic_store_n(&dst->arg, src->arg, __ATOMIC_RELAXED);
+    __atomic_store_n(&dst->group, src->group, __ATOMIC_RELAXED);
+}
+
+static void ARSAL_TaskPool_ItemLoad(ARSAL_TaskPool_Item_t *dst, ARSAL_TaskPool_Item_t *src)
+{
+    dst->task = __atomic_load_n(&src->task, __ATOMIC_RELAXED);
+    dst->arg = __atomic_load_n(&src->arg, __ATOMIC_RELAXED);
+    dst->group = __atomic_load_n(&src->group, __ATOMIC_RELAXED);
+}
+
+static int ARSAL_TaskPool_DequePush(ARSAL_TaskPool_Deque_t *deque, const ARSAL_TaskPool_Item_t *item)
+{
+    int64_t b = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+    int64_t t = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+
+    if (b - t > deque->mask)
+    {
+        return -1;
+    }
+    ARSAL_TaskPool_ItemStore(&deque->items[b & deque->mask], item);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&deque->bottom, b + 1, __ATOMIC_RELAXED);
+    return 0;
+}
+
+static int ARSAL_TaskPool_DequeTake(ARSAL_TaskPool_Deque_t *deque, ARSAL_TaskPool_Item_t *item)
+{
+    int64_t b = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+    int64_t t;
+    int found = 1;
+
+    __atomic_store_n(&deque->bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    t = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+
+    if (t <= b)
+    {
+        ARSAL_TaskPool_ItemLoad(item, &deque->items[b & deque->mask]);
+        if (t == b)
+        {
+            /* Last item: race against thieves */
+            if (!__atomic_compare_exchange_n(&deque->top, &t, t + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+            {
+                found = 0;
+            }
+            __atomic_store_n(&deque->bottom, b + 1, __ATOMIC_RELAXED);
+        }
+    }
+    else
+    {
+        found = 0;
+        __atomic_store_n(&deque->bottom, b + 1, __ATOMIC_RELAXED);
+    }
+    return found;
+}
+
+static int ARSAL_TaskPool_DequeSteal(ARSAL_TaskPool_Deque_t *deque, ARSAL_TaskPool_Item_t *item)
+{
+    int64_t t = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    int64_t b;
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    b = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+    if (t >= b)
+    {
+        return 0;
+    }
+    /* The slot cannot be overwritten before top moves past it */
+    ARSAL_TaskPool_ItemLoad(item, &deque->items[t & deque->mask]);
+    return __atomic_compare_exchange_n(&deque->top, &t, t + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+/*
+ * Scheduling
+ */
+
+static void ARSAL_TaskPool_Notify(ARSAL_TaskPool_t *pool)
+{
+    __atomic_add_fetch(&pool->epoch, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&pool->sleepers, __ATOMIC_SEQ_CST) > 0)
+    {
+        ARSAL_Futex_Wake(&pool->epoch, 1, 0);
+    }
+}
+
+static int ARSAL_TaskPool_InjectPop(ARSAL_TaskPool_t *pool, ARSAL_TaskPool_Item_t *item)
+{
+    int found = 0;
+
+    if (__atomic_load_n(&pool->injectCount, __ATOMIC_RELAXED) == 0)
+    {
+        return 0;
+    }
+    ARSAL_Mutex_Lock(&pool->injectMutex);
+    if (pool->injectCount > 0)
+    {
+        *item = pool->inject[pool->injectHead];
+        pool->injectHead = (pool->injectHead + 1) % pool->injectSize;
+        __atomic_store_n(&pool->injectCount, pool->injectCount - 1, __ATOMIC_RELAXED);
+        found = 1;
+    }
+    ARSAL_Mutex_Unlock(&pool->injectMutex);
+    return found;
+}
+
+static int ARSAL_TaskPool_InjectPush(ARSAL_TaskPool_t *pool, const ARSAL_TaskPool_Item_t *item)
+{
+    int ret = -1;
+
+    ARSAL_Mutex_Lock(&pool->injectMutex);
+    if (pool->injectCount < pool->injectSize)
+    {
+        pool->inject[(pool->injectHead + pool->injectCount) % pool->injectSize] = *item;
+        __atomic_store_n(&pool->injectCount, pool->injectCount + 1, __ATOMIC_RELAXED);
+        ret = 0;
+    }
+    ARSAL_Mutex_Unlock(&pool->injectMutex);
+    return ret;
+}
+
+/**
+ * @brief Find a task: own deque first (LIFO, cache hot), then the injection queue, then steal (FIFO, oldest and largest)
+ */
+static int ARSAL_TaskPool_FindTask(ARSAL_TaskPool_t *pool, ARSAL_TaskPool_Worker_t *self, ARSAL_TaskPool_Item_t *item)
+{
+    int start, i;
+
+    if ((self != NULL) && ARSAL_TaskPool_DequeTake(&self->deque, item))
+    {
+        return 1;
+    }
+    if (ARSAL_TaskPool_InjectPop(pool, item))
+    {
+        return 1;
+    }
+
+    if (self != NULL)
+    {
+        /* xorshift: cheap per-worker victim randomization */
+        self->seed ^= self->seed << 13;
+        self->seed ^= self->seed >> 17;
+        self->seed ^= self->seed << 5;
+        start = (int)(self->seed % (uint32_t)pool->nbWorkers);
+    }
+    else
+    {
+        start = 0;
+    }
+    for (i = 0; i < pool->nbWorkers; i++)
+    {
+        ARSAL_TaskPool_Worker_t *victim = &pool->workers[(start + i) % pool->nbWorkers];
+        if ((victim != self) && ARSAL_TaskPool_DequeSteal(&victim->deque, item))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void ARSAL_TaskPool_RunTask(ARSAL_TaskPool_Item_t *item)
+{
+    ARSAL_TaskGroup_t *group = item->group;
+    uint32_t old;
+
+    item->task(item->arg);
+
+    old = __atomic_fetch_sub(&group->state, 1, __ATOMIC_ACQ_REL);
+    if (old == (ARSAL_TASKPOOL_WAITING_FLAG | 1))
+    {
+        ARSAL_Futex_Wake(&group->state, INT_MAX, 0);
+    }
+}
+
+static void *ARSAL_TaskPool_WorkerRun(void *arg)
+{
+    ARSAL_TaskPool_Worker_t *self = arg;
+    ARSAL_TaskPool_t *pool = self->pool;
+    ARSAL_TaskPool_Item_t item;
+    int idle = 0;
+
+    ARSAL_TaskPool_CurrentWorker = self;
+
+    while (__atomic_load_n(&pool->run, __ATOMIC_ACQUIRE))
+    {
+        uint32_t epoch;
+
+        if (ARSAL_TaskPool_FindTask(pool, self, &item))
+        {
+            ARSAL_TaskPool_RunTask(&item);
+            idle = 0;
+            continue;
+        }
+        if (idle++ < ARSAL_TASKPOOL_IDLE_SPINS)
+        {
+            ARSAL_CPU_RELAX();
+            continue;
+        }
+
+        /* Announce we sleep, then re-check: a spawn after the re-check
+         * changes epoch, so the futex wait cannot miss it */
+        epoch = __atomic_load_n(&pool->epoch, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&pool->sleepers, 1, __ATOMIC_SEQ_CST);
+        if (ARSAL_TaskPool_FindTask(pool, self, &item))
+        {
+            __atomic_sub_fetch(&pool->sleepers, 1, __ATOMIC_SEQ_CST);
+            ARSAL_TaskPool_RunTask(&item);
+            idle = 0;
+            continue;
+        }
+        if (__atomic_load_n(&pool->run, __ATOMIC_ACQUIRE))
+        {
+            ARSAL_Futex_Wait(&pool->epoch, epoch, NULL, 0);
+        }
+        __atomic_sub_fetch(&pool->sleepers, 1, __ATOMIC_SEQ_CST);
+        idle = 0;
+    }
+
+    ARSAL_TaskPool_CurrentWorker = NULL;
+    return NULL;
+}
+
+/*
+ * Public API
+ */
+
+ARSAL_TaskPool_t *ARSAL_TaskPool_New(const ARSAL_TaskPool_Config_t *config, eARSAL_ERROR *error)
+{
+    ARSAL_TaskPool_Config_t defaultConfig;
+    ARSAL_TaskPool_t *pool = NULL;
+    eARSAL_ERROR err = ARSAL_OK;
+    int cpus[64];
+    int nbCpus = 0;
+    size_t dequeSize = 1;
+    long online;
+    int i;
+
+    if (config == NULL)
+    {
+        memset(&defaultConfig, 0, sizeof(defaultConfig));
+        ARSAL_Thread_Attr_Init(&defaultConfig.attr);
+        config = &defaultConfig;
+    }
+
+    /* CPUs the workers may run on */
+    online = sysconf(_SC_NPROCESSORS_ONLN);
+    if (online < 1)
+    {
+        online = 1;
+    }
+    for (i = 0; (i < 64) && (i < online || config->attr.cpuMask != 0); i++)
+    {
+        if ((config->attr.cpuMask == 0) || (config->attr.cpuMask & (1ULL << i)))
+        {
+            cpus[nbCpus++] = i;
+        }
+    }
+    if (nbCpus == 0)
+    {
+        cpus[nbCpus++] = 0;
+    }
+
+    while (dequeSize < ((config->dequeSize > 0) ? config->dequeSize : ARSAL_TASKPOOL_DEFAULT_DEQUE_SIZE))
+    {
+        dequeSize <<= 1;
+    }
+
+    pool = calloc(1, sizeof(*pool));
+    if (pool == NULL)
+    {
+        err = ARSAL_ERROR_ALLOC;
+    }
+
+    if (err == ARSAL_OK)
+    {
+        pool->nbWorkers = (config->nbWorkers > 0) ? config->nbWorkers : nbCpus;
+        pool->injectSize = dequeSize;
+        pool->inject = malloc(pool->injectSize * sizeof(*pool->inject));
+        if ((pool->inject == NULL) ||
+            (posix_memalign((void **)&pool->workers, ARSAL_TASKPOOL_CACHE_LINE, pool->nbWorkers * sizeof(*pool->workers)) != 0))
+        {
+            pool->workers = NULL;
+            err = ARSAL_ERROR_ALLOC;
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        memset(pool->workers, 0, pool->nbWorkers * sizeof(*pool->workers));
+        for (i = 0; (i < pool->nbWorkers) && (err == ARSAL_OK); i++)
+        {
+            ARSAL_TaskPool_Worker_t *worker = &pool->workers[i];
+            worker->pool = pool;
+            worker->index = i;
+            worker->seed = 0x9E3779B9u * (uint32_t)(i + 1);
+            worker->deque.mask = (int64_t)dequeSize - 1;
+            worker->deque.items = malloc(dequeSize * sizeof(ARSAL_TaskPool_Item_t));
+            if (worker->deque.items == NULL)
+            {
+                err = ARSAL_ERROR_ALLOC;
+            }
+        }
+    }
+
+    if ((err == ARSAL_OK) && (ARSAL_Mutex_Init(&pool->injectMutex) != 0))
+    {
+        err = ARSAL_ERROR_SYSTEM;
+    }
+
+    if (err == ARSAL_OK)
+    {
+        pool->run = 1;
+        for (i = 0; (i < pool->nbWorkers) && (err == ARSAL_OK); i++)
+        {
+            ARSAL_Thread_Attr_t attr = config->attr;
+            snprintf(attr.name, sizeof(attr.name), "%.10s-%d", (config->attr.name[0] != '\0') ? config->attr.name : "task", i & 0xff);
+            if (config->pinWorkers)
+            {
+                attr.cpuMask = 1ULL << cpus[i % nbCpus];
+            }
+            if (ARSAL_Thread_CreateEx(&pool->workers[i].thread, ARSAL_TaskPool_WorkerRun, &pool->workers[i], &attr) != 0)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSAL_TASKPOOL_TAG, "Unable to create worker %d", i);
+                pool->workers[i].thread = NULL;
+                err = ARSAL_ERROR_SYSTEM;
+            }
+        }
+    }
+
+    if (err != ARSAL_OK)
+    {
+        ARSAL_TaskPool_Delete(&pool);
+    }
+    if (error != NULL)
+    {
+        *error = err;
+    }
+    return pool;
+}
+
+void ARSAL_TaskPool_Delete(ARSAL_TaskPool_t **pool)
+{
+    ARSAL_TaskPool_t *p;
+    int i;
+
+    if ((pool == NULL) || (*pool == NULL))
+    {
+        return;
+    }
+    p = *pool;
+
+    __atomic_store_n(&p->run, 0, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&p->epoch, 1, __ATOMIC_SEQ_CST);
+    ARSAL_Futex_Wake(&p->epoch, INT_MAX, 0);
+
+    if (p->workers != NULL)
+    {
+        for (i = 0; i < p->nbWorkers; i++)
+        {
+            if (p->workers[i].thread != NULL)
+            {
+                ARSAL_Thread_Join(p->workers[i].thread, NULL);
+                ARSAL_Thread_Destroy(&p->workers[i].thread);
+            }
+            free(p->workers[i].deque.items);
+        }
+        free(p->workers);
+    }
+    if (p->injectMutex != NULL)
+    {
+        ARSAL_Mutex_Destroy(&p->injectMutex);
+    }
+    free(p->inject);
+    free(p);
+    *pool = NULL;
+}
+
+int ARSAL_TaskPool_GetNbWorkers(ARSAL_TaskPool_t *pool)
+{
+    return (pool != NULL) ? pool->nbWorkers : 0;
+}
+
+void ARSAL_TaskGroup_Init(ARSAL_TaskGroup_t *group, ARSAL_TaskPool_t *pool)
+{
+    if (group != NULL)
+    {
+        group->pool = pool;
+        group->state = 0;
+    }
+}
+
+eARSAL_ERROR ARSAL_TaskGroup_Spawn(ARSAL_TaskGroup_t *group, ARSAL_TaskPool_Task_t task, void *arg)
+{
+    ARSAL_TaskPool_Worker_t *self = ARSAL_TaskPool_CurrentWorker;
+    ARSAL_TaskPool_Item_t item;
+    int pushed;
+
+    if ((group == NULL) || (group->pool == NULL) || (task == NULL))
+    {
+        return ARSAL_ERROR_BAD_PARAMETER;
+    }
+
+    item.task = task;
+    item.arg = arg;
+    item.group = group;
+    __atomic_add_fetch(&group->state, 1, __ATOMIC_RELAXED);
+
+    if ((self != NULL) && (self->pool == group->pool))
+    {
+        pushed = (ARSAL_TaskPool_DequePush(&self->deque, &item) == 0);
+    }
+    else
+    {
+        pushed = (ARSAL_TaskPool_InjectPush(group->pool, &item) == 0);
+    }
+
+    if (pushed)
+    {
+        ARSAL_TaskPool_Notify(group->pool);
+    }
+    else
+    {
+        /* Queue full: run inline, which also throttles the producer */
+        ARSAL_TaskPool_RunTask(&item);
+    }
+    return ARSAL_OK;
+}
+
+void ARSAL_TaskGroup_Wait(ARSAL_TaskGroup_t *group)
+{
+    ARSAL_TaskPool_Worker_t *self = ARSAL_TaskPool_CurrentWorker;
+    ARSAL_TaskPool_Item_t item;
+    int idle = 0;
+
+    if ((group == NULL) || (group->pool == NULL))
+    {
+        return;
+    }
+    if ((self != NULL) && (self->pool != group->pool))
+    {
+        self = NULL;
+    }
+
+    for (;;)
+    {
+        uint32_t state = __atomic_load_n(&group->state, __ATOMIC_ACQUIRE);
+        struct timespec deadline;
+
+        if ((state & ~ARSAL_TASKPOOL_WAITING_FLAG) == 0)
+        {
+            break;
+        }
+
+        /* Help while waiting: this is what makes nested fork/join safe */
+        if (ARSAL_TaskPool_FindTask(group->pool, self, &item))
+        {
+            ARSAL_TaskPool_RunTask(&item);
+            idle = 0;
+            continue;
+        }
+        if (idle++ < ARSAL_TASKPOOL_IDLE_SPINS)
+        {
+            ARSAL_CPU_RELAX();
+            continue;
+        }
+
+        /* The remaining tasks are running elsewhere: sleep until the last
+         * one completes, waking up periodically in case new work can be helped */
+        if (!(state & ARSAL_TASKPOOL_WAITING_FLAG) &&
+            !__atomic_compare_exchange_n(&group->state, &state, state | ARSAL_TASKPOOL_WAITING_FLAG, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+            continue;
+        }
+        NSEC_TO_TIMESPEC(ARSAL_Time_GetMonotonicNs() + ARSAL_TASKPOOL_WAIT_SLICE_NS, &deadline);
+        ARSAL_Futex_Wait(&group->state, state | ARSAL_TASKPOOL_WAITING_FLAG, &deadline, 0);
+        idle = 0;
+    }
+
+    __atomic_store_n(&group->state, 0, __ATOMIC_RELAXED);
+}
+
+typedef struct
+{
+    ARSAL_TaskPool_Range_t body;
+    void *arg;
+    size_t grain;
+    ARSAL_TaskGroup_t group;
+    struct ARSAL_TaskPool_ForRange_t *ranges;
+    volatile size_t nbRanges;
+} ARSAL_TaskPool_ForContext_t;
+
+typedef struct ARSAL_TaskPool_ForRange_t
+{
+    ARSAL_TaskPool_ForContext_t *context;
+    size_t begin;
+    size_t end;
+} ARSAL_TaskPool_ForRange_t;
+
+static void ARSAL_TaskPool_ForTask(void *arg)
+{
+    ARSAL_TaskPool_ForRange_t *range = arg;
+    ARSAL_TaskPool_ForContext_t *context = range->context;
+    size_t begin = range->begin;
+    size_t end = range->end;
+
+    /* Split in halves, keeping the left half and leaving the right one for
+     * thieves, so the oldest (stolen first) tasks are the largest */
+    while (end - begin > context->grain)
+    {
+        size_t mid = begin + (end - begin) / 2;
+        ARSAL_TaskPool_ForRange_t *child = &context->ranges[__atomic_fetch_add(&context->nbRanges, 1, __ATOMIC_RELAXED)];
+        child->context = context;
+        child->begin = mid;
+        child->end = end;
+        ARSAL_TaskGroup_Spawn(&context->group, ARSAL_TaskPool_ForTask, child);
+        end = mid;
+    }
+    context->body(begin, end, context->arg);
+}
+
+eARSAL_ERROR ARSAL_TaskPool_ParallelFor(ARSAL_TaskPool_t *pool, size_t begin, size_t end, size_t grain, ARSAL_TaskPool_Range_t body, void *arg)
+{
+    ARSAL_TaskPool_ForContext_t context;
+    ARSAL_TaskPool_ForRange_t *ranges;
+    size_t count;
+
+    if ((pool == NULL) || (body == NULL) || (end < begin))
+    {
+        return ARSAL_ERROR_BAD_PARAMETER;
+    }
+    count = end - begin;
+    if (count == 0)
+    {
+        return ARSAL_OK;
+    }
+    if (grain == 0)
+    {
+        /* About 8 chunks per worker balances stealing overhead and load */
+        grain = count / ((size_t)pool->nbWorkers * 8);
+    }
+    if (grain == 0)
+    {
+        grain = 1;
+    }
+    if (count <= grain)
+    {
+        body(begin, end, arg);
+        return ARSAL_OK;
+    }
+
+    /* Leaves hold more than grain / 2 indexes, so there are less than
+     * 2 * count / grain of them, and one descriptor per leaf */
+    ranges = malloc((2 * (count / grain) + 2) * sizeof(*ranges));
+    if (ranges == NULL)
+    {
+        return ARSAL_ERROR_ALLOC;
+    }
+
+    context.body = body;
+    context.arg = arg;
+    context.grain = grain;
+    context.ranges = ranges;
+    context.nbRanges = 1;
+    ARSAL_TaskGroup_Init(&context.group, pool);
+
+    ranges[0].context = &context;
+    ranges[0].begin = begin;
+    ranges[0].end = end;
+    ARSAL_TaskPool_ForTask(&ranges[0]);
+    ARSAL_TaskGroup_Wait(&context.group);
+
+    free(ranges);
+    return ARSAL_OK;
+}
@@ -0,0 +1,165 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_TaskPool.h
+ * @brief Work-stealing task scheduler
+ * @date 10/18/2026
+ */
+#ifndef _ARSAL_TASKPOOL_H_
+#define _ARSAL_TASKPOOL_H_
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <libARSAL/ARSAL_Error.h>
+#include <libARSAL/ARSAL_Thread.h>
+
+/**
+ * @brief Default capacity of each worker deque (tasks, power of two)
+ */
+#define ARSAL_TASKPOOL_DEFAULT_DEQUE_SIZE   1024
+
+/**
+ * @brief Task pool type
+ */
+typedef struct ARSAL_TaskPool_t ARSAL_TaskPool_t;
+
+/**
+ * @brief Task routine
+ * @param arg The argument given at spawn time
+ */
+typedef void (*ARSAL_TaskPool_Task_t) (void *arg);
+
+/**
+ * @brief Parallel-for body, called on sub-ranges [begin, end) of the iteration space
+ * @param begin First index of the sub-range
+ * @param end Index past the last index of the sub-range
+ * @param arg The argument given to ARSAL_TaskPool_ParallelFor()
+ */
+typedef void (*ARSAL_TaskPool_Range_t) (size_t begin, size_t end, void *arg);
+
+/**
+ * @brief Fork/join group: tasks spawned in a group are waited for together
+ * @warning Fields should not be used directly
+ * @see ARSAL_TaskGroup_Init ()
+ */
+typedef struct
+{
+    ARSAL_TaskPool_t *pool;     /**< Pool running the tasks of the group */
+    volatile uint32_t state;    /**< Number of tasks not yet completed, high bit set when a thread sleeps in ARSAL_TaskGroup_Wait() */
+} ARSAL_TaskGroup_t;
+
+/**
+ * @brief Task pool configuration
+ * @see ARSAL_TaskPool_New ()
+ */
+typedef struct
+{
+    int nbWorkers;              /**< Number of worker threads. 0 for one per allowed CPU */
+    ARSAL_Thread_Attr_t attr;   /**< Attributes of the workers (see ARSAL_Thread_GetRoleAttr()). The name is suffixed by the worker index */
+    int pinWorkers;             /**< Non zero to pin worker i to the i-th CPU of attr.cpuMask (or of all CPUs), round robin */
+    size_t dequeSize;           /**< Capacity of each worker deque, rounded up to a power of two. 0 for default */
+} ARSAL_TaskPool_Config_t;
+
+/**
+ * @brief Create a task pool and start its workers
+ * @warning This function allocates memory
+ * @param config The configuration (NULL for defaults)
+ * @param[out] error A pointer on the error output (optional, may be NULL)
+ * @return Pointer on the new task pool, or NULL on error
+ * @see ARSAL_TaskPool_Delete ()
+ */
+ARSAL_TaskPool_t *ARSAL_TaskPool_New(const ARSAL_TaskPool_Config_t *config, eARSAL_ERROR *error);
+
+/**
+ * @brief Stop the workers and delete the task pool
+ * @warning All groups must have been waited for before calling this function
+ * @warning This function frees memory
+ * @param pool The address of the pointer on the task pool
+ * @see ARSAL_TaskPool_New ()
+ */
+void ARSAL_TaskPool_Delete(ARSAL_TaskPool_t **pool);
+
+/**
+ * @brief Get the number of worker threads of a task pool
+ * @param pool The task pool
+ * @return The number of workers
+ */
+int ARSAL_TaskPool_GetNbWorkers(ARSAL_TaskPool_t *pool);
+
+/**
+ * @brief Initialize a fork/join group
+ * @param group The group to initialize
+ * @param pool The pool that will run the tasks of the group
+ */
+void ARSAL_TaskGroup_Init(ARSAL_TaskGroup_t *group, ARSAL_TaskPool_t *pool);
+
+/**
+ * @brief Spawn a task in a group
+ *
+ * From a worker, the task is pushed on the worker's own deque, where idle
+ * workers can steal it. From any other thread, it is pushed on the shared
+ * injection queue. If the deque is full the task runs immediately in the
+ * calling thread.
+ *
+ * @param group The group
+ * @param task The task routine
+ * @param arg The argument passed to task()
+ * @retval On success, returns ARSAL_OK. Otherwise, it returns an error number of eARSAL_ERROR
+ */
+eARSAL_ERROR ARSAL_TaskGroup_Spawn(ARSAL_TaskGroup_t *group, ARSAL_TaskPool_Task_t task, void *arg);
+
+/**
+ * @brief Wait for all the tasks of a group
+ *
+ * The calling thread runs pending tasks while waiting, so groups can be
+ * nested (a task may spawn and wait for a sub-group) without deadlock.
+ *
+ * @param group The group
+ */
+void ARSAL_TaskGroup_Wait(ARSAL_TaskGroup_t *group);
+
+/**
+ * @brief Run body over [begin, end) in parallel and wait for completion
+ *
+ * The range is split recursively in halves: the half that is not processed
+ * right away is left for stealing, so idle workers take large chunks first.
+ *
+ * @param pool The task pool
+ * @param begin First index
+ * @param end Index past the last index
+ * @param grain Sub-ranges smaller than grain are not split further (0 for automatic)
+ * @param body The body called on each sub-range
+ * @param arg The argument passed to body()
+ * @retval On success, returns ARSAL_OK. Otherwise, it returns an error number of eARSAL_ERROR
+ */
+eARSAL_ERROR ARSAL_TaskPool_ParallelFor(ARSAL_TaskPool_t *pool, size_t begin, size_t end, size_t grain, ARSAL_TaskPool_Range_t body, void *arg);
+
+#endif /* _ARSAL_TASKPOOL_H_ */
@@ -37,6 +37,9 @@
 #ifndef _ARSAL_THREAD_H_
 #define _ARSAL_THREAD_H_
 
+#include <inttypes.h>
+#include <stddef.h>
+
 /**
  * @brief Define a thread type.
  */
@@ -74,4 +77,98 @@ int ARSAL_Thread_Join(ARSAL_Thread_t thread, void **retval);
  */
 int ARSAL_Thread_Destroy(ARSAL_Thread_t *thread);
 
+/**
+ * @brief Maximum length of a thread name, including the terminating '\0' (Linux limit)
+ */
+#define ARSAL_THREAD_NAME_SIZE 16
+
+/**
+ * @brief Scheduling policy of a thread
+ */
+typedef enum
+{
+    ARSAL_THREAD_SCHED_DEFAULT = 0,     /**< Keep the policy inherited from the creating thread */
+    ARSAL_THREAD_SCHED_OTHER,           /**< Regular time sharing (SCHED_OTHER) */
+    ARSAL_THREAD_SCHED_FIFO,            /**< Real-time first in first out (SCHED_FIFO) */
+} eARSAL_THREAD_SCHED;
+
+/**
+ * @brief Thread attributes
+ * @see ARSAL_Thread_Attr_Init ()
+ */
+typedef struct
+{
+    uint64_t cpuMask;                   /**< Bit n allows the thread to run on CPU n. 0 to keep the default affinity */
+    eARSAL_THREAD_SCHED policy;         /**< Scheduling policy */
+    int priority;                       /**< SCHED_FIFO priority (1 to 99). Ignored by other policies */
+    size_t stackSize;                   /**< Stack size in bytes, only used at creation. 0 for the default size */
+    char name[ARSAL_THREAD_NAME_SIZE];  /**< Thread name. Empty to keep the default name */
+} ARSAL_Thread_Attr_t;
+
+/**
+ * @brief Initialize thread attributes with default values (inherit everything)
+ *
+ * @param attr The attributes to initialize
+ */
+void ARSAL_Thread_Attr_Init(ARSAL_Thread_Attr_t *attr);
+
+/**
+ * @brief Create a new thread with attributes
+ *
+ * If the real-time policy is not permitted (missing CAP_SYS_NICE or
+ * RLIMIT_RTPRIO), the thread is created with the default policy and a warning
+ * is printed, so that a misconfiguration never prevents the thread from running.
+ *
+ * @param thread The thread to create
+ * @param routine The routine to invoke by thread
+ * @param arg The argument passed to routine()
+ * @param attr The thread attributes (NULL for defaults, same as ARSAL_Thread_Create())
+ * @retval On success, ARSAL_Thread_CreateEx() returns 0. Otherwise, it returns an error number (See errno.h)
+ */
+int ARSAL_Thread_CreateEx(ARSAL_Thread_t *thread, ARSAL_Thread_Routine_t routine, void *arg, const ARSAL_Thread_Attr_t *attr);
+
+/**
+ * @brief Change the attributes of a running thread
+ *
+ * @param thread The thread to modify
+ * @param attr The new attributes. stackSize is ignored
+ * @retval On success, ARSAL_Thread_SetAttr() returns 0. Otherwise, it returns an error number (See errno.h)
+ */
+int ARSAL_Thread_SetAttr(ARSAL_Thread_t thread, const ARSAL_Thread_Attr_t *attr);
+
+/**
+ * @brief Change the attributes of the calling thread
+ *
+ * Useful for threads created by other libraries, from their routine.
+ *
+ * @param attr The new attributes. stackSize is ignored
+ * @retval On success, ARSAL_Thread_SetCurrentAttr() returns 0. Otherwise, it returns an error number (See errno.h)
+ */
+int ARSAL_Thread_SetCurrentAttr(const ARSAL_Thread_Attr_t *attr);
+
+/**
+ * @brief Load the thread roles configuration file
+ *
+ * Each non empty line which does not start with '#' describes one role:
+ * `<role> <cpus> <policy> <priority> <stack> [name]`
+ * - cpus: "*" for all, or a list like "0,2-3"
+ * - policy: "default", "other" or "fifo"
+ * - stack: size in bytes, 0 for default
+ *
+ * Loading replaces the previously loaded roles.
+ *
+ * @param path The configuration file path
+ * @retval On success, the number of roles loaded. Otherwise, -1 and errno is set
+ */
+int ARSAL_Thread_LoadRoles(const char *path);
+
+/**
+ * @brief Get the attributes of a role from the loaded configuration
+ *
+ * @param role The role name
+ * @param[out] attr The attributes. Initialized to defaults if the role is unknown
+ * @retval 0 if the role was found, -1 otherwise
+ */
+int ARSAL_Thread_GetRoleAttr(const char *role, ARSAL_Thread_Attr_t *attr);
+
 #endif // _ARSAL_THREAD_H_
@@ -0,0 +1,445 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_ThreadAttr.c
+ * @brief Thread attributes: affinity, scheduling policy, name and stack size
+ * @date 10/18/2026
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_Thread.h>
+
+#define ARSAL_THREAD_TAG "ARSAL_Thread"
+
+#define ARSAL_THREAD_MAX_ROLES      32
+#define ARSAL_THREAD_ROLE_SIZE      32
+#define ARSAL_THREAD_LINE_SIZE      256
+
+typedef struct
+{
+    char role[ARSAL_THREAD_ROLE_SIZE];
+    ARSAL_Thread_Attr_t attr;
+} ARSAL_Thread_Role_t;
+
+typedef struct
+{
+    ARSAL_Thread_Routine_t routine;
+    void *arg;
+    char name[ARSAL_THREAD_NAME_SIZE];
+} ARSAL_Thread_Start_t;
+
+/* Loaded once at startup, read-only afterwards */
+static ARSAL_Thread_Role_t ARSAL_Thread_Roles[ARSAL_THREAD_MAX_ROLES];
+static int ARSAL_Thread_NbRoles = 0;
+
+static void ARSAL_Thread_MaskToCpuSet(uint64_t mask, cpu_set_t *set)
+{
+    int cpu;
+
+    CPU_ZERO(set);
+    for (cpu = 0; cpu < 64; cpu++)
+    {
+        if (mask & (1ULL << cpu))
+        {
+            CPU_SET(cpu, set);
+        }
+    }
+}
+
+static int ARSAL_Thread_SchedParams(const ARSAL_Thread_Attr_t *attr, int *policy, struct sched_param *param)
+{
+    memset(param, 0, sizeof(*param));
+    switch (attr->policy)
+    {
+    case ARSAL_THREAD_SCHED_FIFO:
+        *policy = SCHED_FIFO;
+        param->sched_priority = attr->priority;
+        if (param->sched_priority < sched_get_priority_min(SCHED_FIFO))
+        {
+            param->sched_priority = sched_get_priority_min(SCHED_FIFO);
+        }
+        if (param->sched_priority > sched_get_priority_max(SCHED_FIFO))
+        {
+            param->sched_priority = sched_get_priority_max(SCHED_FIFO);
+        }
+        return 1;
+    case ARSAL_THREAD_SCHED_OTHER:
+        *policy = SCHED_OTHER;
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+static int ARSAL_Thread_Apply(pthread_t pthread, const ARSAL_Thread_Attr_t *attr)
+{
+    struct sched_param param;
+    cpu_set_t set;
+    int policy;
+    int result = 0;
+    int ret;
+
+    if (attr->cpuMask != 0)
+    {
+        ARSAL_Thread_MaskToCpuSet(attr->cpuMask, &set);
+        ret = pthread_setaffinity_np(pthread, sizeof(set), &set);
+        if (ret == EINVAL)
+        {
+            /* None of the CPUs is online or allowed: the thread runs anywhere */
+            ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSAL_THREAD_TAG, "Affinity 0x%" PRIx64 " not usable, using no affinity", attr->cpuMask);
+        }
+        else if (ret != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSAL_THREAD_TAG, "Unable to set affinity 0x%" PRIx64 ": %s", attr->cpuMask, strerror(ret));
+            result = ret;
+        }
+    }
+
+    if (ARSAL_Thread_SchedParams(attr, &policy, &param))
+    {
+        ret = pthread_setschedparam(pthread, policy, &param);
+        if (ret != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSAL_THREAD_TAG, "Unable to set policy %d priority %d: %s", policy, param.sched_priority, strerror(ret));
+            result = ret;
+        }
+    }
+
+    if (attr->name[0] != '\0')
+    {
+        ret = pthread_setname_np(pthread, attr->name);
+        if (ret != 0)
+        {
+            result = ret;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Names the thread before running the user routine, so the name is
+ * visible from the very first instruction of the routine
+ */
+static void *ARSAL_Thread_Trampoline(void *data)
+{
+    ARSAL_Thread_Start_t start = *(ARSAL_Thread_Start_t *)data;
+
+    free(data);
+    if (start.name[0] != '\0')
+    {
+        pthread_setname_np(pthread_self(), start.name);
+    }
+    return start.routine(start.arg);
+}
+
+void ARSAL_Thread_Attr_Init(ARSAL_Thread_Attr_t *attr)
+{
+    if (attr != NULL)
+    {
+        memset(attr, 0, sizeof(*attr));
+        attr->policy = ARSAL_THREAD_SCHED_DEFAULT;
+    }
+}
+
+int ARSAL_Thread_CreateEx(ARSAL_Thread_t *thread, ARSAL_Thread_Routine_t routine, void *arg, const ARSAL_Thread_Attr_t *attr)
+{
+    ARSAL_Thread_Start_t *start;
+    pthread_attr_t pattr;
+    struct sched_param param;
+    pthread_t *pthread;
+    cpu_set_t set;
+    int useAffinity = 1;
+    int policy;
+    int result;
+
+    if ((thread == NULL) || (routine == NULL))
+    {
+        return EINVAL;
+    }
+
+    /* Same representation as ARSAL_Thread_Create() so that ARSAL_Thread_Join()
+     * and ARSAL_Thread_Destroy() work on the result */
+    pthread = (pthread_t *)malloc(sizeof(pthread_t));
+    start = malloc(sizeof(*start));
+    if ((pthread == NULL) || (start == NULL))
+    {
+        free(pthread);
+        free(start);
+        return ENOMEM;
+    }
+    start->routine = routine;
+    start->arg = arg;
+    snprintf(start->name, sizeof(start->name), "%s", (attr != NULL) ? attr->name : "");
+
+    pthread_attr_init(&pattr);
+    if (attr != NULL)
+    {
+        if (attr->stackSize > 0)
+        {
+            pthread_attr_setstacksize(&pattr, attr->stackSize);
+        }
+        if (attr->cpuMask != 0)
+        {
+            ARSAL_Thread_MaskToCpuSet(attr->cpuMask, &set);
+            if (pthread_attr_setaffinity_np(&pattr, sizeof(set), &set) != 0)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSAL_THREAD_TAG, "Affinity 0x%" PRIx64 " not usable for '%s', using no affinity", attr->cpuMask, attr->name);
+                useAffinity = 0;
+            }
+        }
+        if (ARSAL_Thread_SchedParams(attr, &policy, &param))
+        {
+            pthread_attr_setinheritsched(&pattr, PTHREAD_EXPLICIT_SCHED);
+            pthread_attr_setschedpolicy(&pattr, policy);
+            pthread_attr_setschedparam(&pattr, &param);
+        }
+    }
+
+    result = pthread_create(pthread, &pattr, ARSAL_Thread_Trampoline, start);
+    if ((result == EINVAL) && (attr != NULL) && (attr->cpuMask != 0) && useAffinity)
+    {
+        /* None of the CPUs of the mask is online or allowed (other board,
+         * cpuset of a container): the thread runs anywhere */
+        ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSAL_THREAD_TAG, "Affinity 0x%" PRIx64 " not usable for '%s', using no affinity", attr->cpuMask, attr->name);
+        CPU_ZERO(&set);
+        sched_getaffinity(0, sizeof(set), &set);
+        pthread_attr_setaffinity_np(&pattr, sizeof(set), &set);
+        result = pthread_create(pthread, &pattr, ARSAL_Thread_Trampoline, start);
+    }
+    if ((result == EPERM) && (attr != NULL) && (attr->policy != ARSAL_THREAD_SCHED_DEFAULT))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSAL_THREAD_TAG, "Real-time scheduling not permitted for '%s', using default policy", attr->name);
+        pthread_attr_setinheritsched(&pattr, PTHREAD_INHERIT_SCHED);
+        result = pthread_create(pthread, &pattr, ARSAL_Thread_Trampoline, start);
+    }
+    pthread_attr_destroy(&pattr);
+
+    if (result != 0)
+    {
+        free(pthread);
+        free(start);
+        *thread = NULL;
+        return result;
+    }
+
+    *thread = (ARSAL_Thread_t)pthread;
+    return 0;
+}
+
+int ARSAL_Thread_SetAttr(ARSAL_Thread_t thread, const ARSAL_Thread_Attr_t *attr)
+{
+    if ((thread == NULL) || (attr == NULL))
+    {
+        return EINVAL;
+    }
+    return ARSAL_Thread_Apply(*(pthread_t *)thread, attr);
+}
+
+int ARSAL_Thread_SetCurrentAttr(const ARSAL_Thread_Attr_t *attr)
+{
+    if (attr == NULL)
+    {
+        return EINVAL;
+    }
+    return ARSAL_Thread_Apply(pthread_self(), attr);
+}
+
+static int ARSAL_Thread_ParseCpus(const char *str, uint64_t *mask)
+{
+    char *end;
+
+    *mask = 0;
+    if (strcmp(str, "*") == 0)
+    {
+        return 0;
+    }
+
+    while (*str != '\0')
+    {
+        long first = strtol(str, &end, 10);
+        long last = first;
+        if ((end == str) || (first < 0) || (first > 63))
+        {
+            return -1;
+        }
+        str = end;
+        if (*str == '-')
+        {
+            str++;
+            last = strtol(str, &end, 10);
+            if ((end == str) || (last < first) || (last > 63))
+            {
+                return -1;
+            }
+            str = end;
+        }
+        for (; first <= last; first++)
+        {
+            *mask |= 1ULL << first;
+        }
+        if (*str == ',')
+        {
+            str++;
+        }
+        else if (*str != '\0')
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int ARSAL_Thread_ParsePolicy(const char *str, eARSAL_THREAD_SCHED *policy)
+{
+    if (strcasecmp(str, "default") == 0)
+    {
+        *policy = ARSAL_THREAD_SCHED_DEFAULT;
+    }
+    else if (strcasecmp(str, "other") == 0)
+    {
+        *policy = ARSAL_THREAD_SCHED_OTHER;
+    }
+    else if (strcasecmp(str, "fifo") == 0)
+    {
+        *policy = ARSAL_THREAD_SCHED_FIFO;
+    }
+    else
+    {
+        return -1;
+    }
+    return 0;
+}
+
+int ARSAL_Thread_LoadRoles(const char *path)
+{
+    char line[ARSAL_THREAD_LINE_SIZE];
+    char role[ARSAL_THREAD_ROLE_SIZE], cpus[64], policy[16], name[ARSAL_THREAD_NAME_SIZE];
+    unsigned long stack;
+    int priority;
+    int lineNb = 0;
+    int nbRoles = 0;
+    FILE *file;
+
+    if (path == NULL)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    file = fopen(path, "r");
+    if (file == NULL)
+    {
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        ARSAL_Thread_Role_t *entry;
+        char *start = line;
+        int fields;
+
+        lineNb++;
+        while ((*start == ' ') || (*start == '\t'))
+        {
+            start++;
+        }
+        if ((*start == '#') || (*start == '\n') || (*start == '\r') || (*start == '\0'))
+        {
+            continue;
+        }
+
+        name[0] = '\0';
+        fields = sscanf(start, "%31s %63s %15s %d %lu %15s", role, cpus, policy, &priority, &stack, name);
+        if (fields < 5)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSAL_THREAD_TAG, "%s:%d: expected '<role> <cpus> <policy> <priority> <stack> [name]'", path, lineNb);
+            continue;
+        }
+        if (nbRoles >= ARSAL_THREAD_MAX_ROLES)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSAL_THREAD_TAG, "%s:%d: too many roles (max %d)", path, lineNb, ARSAL_THREAD_MAX_ROLES);
+            break;
+        }
+
+        entry = &ARSAL_Thread_Roles[nbRoles];
+        ARSAL_Thread_Attr_Init(&entry->attr);
+        if ((ARSAL_Thread_ParseCpus(cpus, &entry->attr.cpuMask) != 0) ||
+            (ARSAL_Thread_ParsePolicy(policy, &entry->attr.policy) != 0))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSAL_THREAD_TAG, "%s:%d: invalid cpus '%s' or policy '%s'", path, lineNb, cpus, policy);
+            continue;
+        }
+        snprintf(entry->role, sizeof(entry->role), "%s", role);
+        entry->attr.priority = priority;
+        entry->attr.stackSize = (size_t)stack;
+        snprintf(entry->attr.name, sizeof(entry->attr.name), "%s", name);
+        nbRoles++;
+    }
+    fclose(file);
+
+    ARSAL_Thread_NbRoles = nbRoles;
+    return nbRoles;
+}
+
+int ARSAL_Thread_GetRoleAttr(const char *role, ARSAL_Thread_Attr_t *attr)
+{
+    int i;
+
+    if ((role == NULL) || (attr == NULL))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < ARSAL_Thread_NbRoles; i++)
+    {
+        if (strcmp(ARSAL_Thread_Roles[i].role, role) == 0)
+        {
+            *attr = ARSAL_Thread_Roles[i].attr;
+            if (attr->name[0] == '\0')
+            {
+                snprintf(attr->name, sizeof(attr->name), "%.*s", ARSAL_THREAD_NAME_SIZE - 1, role);
+            }
+            return 0;
+        }
+    }
+
+    ARSAL_Thread_Attr_Init(attr);
+    return -1;
+}
@@ -126,6 +126,115 @@
     } while(0)
 #endif
 
+/**
+ * @brief Convert timespec structure to nanoseconds (uint64_t)
+ */
+#define TIMESPEC_TO_NSEC(ts)                                        \
+    ((uint64_t)(ts)->tv_sec * 1000000000ULL + (uint64_t)(ts)->tv_nsec)
+
+/**
+ * @brief Convert timeval structure to nanoseconds (uint64_t)
+ */
+#define TIMEVAL_TO_NSEC(tv)                                         \
+    ((uint64_t)(tv)->tv_sec * 1000000000ULL + (uint64_t)USEC_TO_NSEC((tv)->tv_usec))
+
+/**
+ * @brief Convert nanoseconds (uint64_t) to timespec structure
+ */
+#define NSEC_TO_TIMESPEC(nsec, ts)                                  \
+    do                                                              \
+    {                                                               \
+        (ts)->tv_sec = (time_t)((nsec) / 1000000000ULL);            \
+        (ts)->tv_nsec = (long)((nsec) % 1000000000ULL);             \
+    } while(0)
+
+/**
+ * @brief Convert nanoseconds (uint64_t) to timeval structure
+ */
+#define NSEC_TO_TIMEVAL(nsec, tv)                                   \
+    do                                                              \
+    {                                                               \
+        (tv)->tv_sec = (time_t)((nsec) / 1000000000ULL);            \
+        (tv)->tv_usec = (suseconds_t)NSEC_TO_USEC((nsec) % 1000000000ULL); \
+    } while(0)
+
+/**
+ * @brief Monotonic timestamp, in nanoseconds
+ *
+ * The origin is the one of CLOCK_MONOTONIC, so a timestamp can be converted
+ * to a timespec and compared with @ref{ARSAL_Time_GetTime} values.
+ */
+typedef uint64_t ARSAL_Time_Ns_t;
+
+/**
+ * @brief Gets the current CLOCK_MONOTONIC time, in nanoseconds
+ *
+ * On Linux this goes through the vDSO and does not enter the kernel.
+ *
+ * @return The current monotonic time in nanoseconds
+ */
+ARSAL_Time_Ns_t ARSAL_Time_GetMonotonicNs(void);
+
+/**
+ * @brief Enables the cycle counter fast path of @ref{ARSAL_Time_GetNs}
+ *
+ * On x86_64 the invariant TSC is calibrated against CLOCK_MONOTONIC (this
+ * blocks for about 10ms). On aarch64 the architected generic timer is used
+ * with its advertised frequency. On other architectures, or if the counter is
+ * not reliable, @ref{ARSAL_Time_GetNs} keeps using @ref{ARSAL_Time_GetMonotonicNs}.
+ *
+ * @note Call once at startup, before any thread uses @ref{ARSAL_Time_GetNs}
+ * @return 0 if the fast path is enabled, -1 otherwise
+ */
+int ARSAL_Time_FastClockInit(void);
+
+/**
+ * @brief Gets the current monotonic time, in nanoseconds, as fast as possible
+ *
+ * Uses the cycle counter when @ref{ARSAL_Time_FastClockInit} succeeded, else
+ * falls back to @ref{ARSAL_Time_GetMonotonicNs}. The fast path may drift from
+ * CLOCK_MONOTONIC by a few ppm: use it for intervals, not to compare with
+ * timestamps taken by other clocks.
+ *
+ * @return The current monotonic time in nanoseconds
+ */
+ARSAL_Time_Ns_t ARSAL_Time_GetNs(void);
+
+/**
+ * @brief Computes the difference between two nanosecond timestamps
+ *
+ * @param start Start of the time interval to compute
+ * @param end End of the time interval to compute
+ * @return The number of ns between start and end (negative if end is before start)
+ */
+static inline int64_t ARSAL_Time_DiffNs(ARSAL_Time_Ns_t start, ARSAL_Time_Ns_t end)
+{
+    return (int64_t)(end - start);
+}
+
+/**
+ * @brief Computes the time elapsed since a nanosecond timestamp
+ *
+ * @param start Timestamp returned by @ref{ARSAL_Time_GetNs}
+ * @return The number of ns elapsed since start
+ */
+static inline int64_t ARSAL_Time_ElapsedNs(ARSAL_Time_Ns_t start)
+{
+    return ARSAL_Time_DiffNs(start, ARSAL_Time_GetNs());
+}
+
+/**
+ * @brief Adds a relative delay, in milliseconds, to a nanosecond timestamp
+ *
+ * @param t The timestamp
+ * @param msec The delay to add
+ * @return The resulting timestamp, typically used as an absolute deadline
+ */
+static inline ARSAL_Time_Ns_t ARSAL_Time_AddMs(ARSAL_Time_Ns_t t, uint32_t msec)
+{
+    return t + (ARSAL_Time_Ns_t)MSEC_TO_NSEC((uint64_t)msec);
+}
+
 /**
  * @brief Gets the current system time as a timespec
  *
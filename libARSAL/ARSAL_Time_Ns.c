@@ -0,0 +1,179 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_Time_Ns.c
+ * @brief Nanosecond monotonic time
+ * @date 10/18/2026
+ */
+#include <time.h>
+#include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_Time.h>
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+#define ARSAL_TIME_TAG "ARSAL_Time"
+
+/* Duration of the TSC calibration against CLOCK_MONOTONIC */
+#define ARSAL_TIME_CALIBRATION_NS   MSEC_TO_NSEC(10ULL)
+
+/* The cycle counter fast path, on the 64 bits architectures only (128 bits products) */
+#if defined(__x86_64__) || defined(__aarch64__)
+#define ARSAL_TIME_HAS_FAST_CLOCK 1
+
+/**
+ * @brief Calibration data of the cycle counter fast path
+ */
+typedef struct
+{
+    int enabled;            /**< 1 if the cycle counter fast path is usable */
+    uint64_t counterBase;   /**< Counter value at calibration time */
+    ARSAL_Time_Ns_t nsBase; /**< CLOCK_MONOTONIC value at calibration time */
+    uint64_t mult;          /**< Counter to ns multiplier, 32.32 fixed point */
+} ARSAL_Time_FastClock_t;
+
+static ARSAL_Time_FastClock_t ARSAL_Time_FastClock = { 0, 0, 0, 0 };
+#endif
+
+ARSAL_Time_Ns_t ARSAL_Time_GetMonotonicNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return TIMESPEC_TO_NSEC(&ts);
+}
+
+#if defined(__x86_64__)
+static int ARSAL_Time_HasInvariantTsc(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+
+    if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007)
+    {
+        return 0;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx & (1 << 8)) != 0;
+}
+
+/**
+ * @brief Reads the TSC together with CLOCK_MONOTONIC, keeping the pair whose reads were the closest
+ */
+static void ARSAL_Time_ReadPair(uint64_t *counter, ARSAL_Time_Ns_t *ns)
+{
+    uint64_t best = UINT64_MAX;
+    int i;
+
+    *counter = 0;
+    *ns = 0;
+    for (i = 0; i < 5; i++)
+    {
+        uint64_t before = __rdtsc();
+        ARSAL_Time_Ns_t now = ARSAL_Time_GetMonotonicNs();
+        uint64_t after = __rdtsc();
+        if (after - before < best)
+        {
+            best = after - before;
+            *counter = before + (after - before) / 2;
+            *ns = now;
+        }
+    }
+}
+#endif
+
+ARSAL_Time_Ns_t ARSAL_Time_GetNs(void)
+{
+#if defined(ARSAL_TIME_HAS_FAST_CLOCK)
+    if (ARSAL_Time_FastClock.enabled)
+    {
+        uint64_t counter;
+#if defined(__x86_64__)
+        counter = __rdtsc();
+#else
+        __asm__ __volatile__ ("isb\n\tmrs %0, cntvct_el0" : "=r" (counter) :: "memory");
+#endif
+        return ARSAL_Time_FastClock.nsBase +
+            (ARSAL_Time_Ns_t)(((unsigned __int128)(counter - ARSAL_Time_FastClock.counterBase) * ARSAL_Time_FastClock.mult) >> 32);
+    }
+#endif
+    return ARSAL_Time_GetMonotonicNs();
+}
+
+int ARSAL_Time_FastClockInit(void)
+{
+#if defined(__x86_64__)
+    uint64_t counterStart, counterEnd;
+    ARSAL_Time_Ns_t nsStart, nsEnd;
+
+    if (!ARSAL_Time_HasInvariantTsc())
+    {
+        ARSAL_PRINT(ARSAL_PRINT_INFO, ARSAL_TIME_TAG, "No invariant TSC, using CLOCK_MONOTONIC");
+        return -1;
+    }
+
+    ARSAL_Time_ReadPair(&counterStart, &nsStart);
+    do
+    {
+        ARSAL_Time_ReadPair(&counterEnd, &nsEnd);
+    } while (nsEnd - nsStart < ARSAL_TIME_CALIBRATION_NS);
+
+    if (counterEnd <= counterStart)
+    {
+        return -1;
+    }
+
+    ARSAL_Time_FastClock.mult = (uint64_t)(((unsigned __int128)(nsEnd - nsStart) << 32) / (counterEnd - counterStart));
+    ARSAL_Time_FastClock.counterBase = counterEnd;
+    ARSAL_Time_FastClock.nsBase = nsEnd;
+    ARSAL_Time_FastClock.enabled = 1;
+    ARSAL_PRINT(ARSAL_PRINT_INFO, ARSAL_TIME_TAG, "TSC fast path enabled (%" PRIu64 " kHz)",
+                (uint64_t)((counterEnd - counterStart) * 1000000ULL / (nsEnd - nsStart)));
+    return 0;
+#elif defined(__aarch64__)
+    uint64_t freq, counter;
+
+    __asm__ __volatile__ ("mrs %0, cntfrq_el0" : "=r" (freq));
+    if (freq == 0)
+    {
+        return -1;
+    }
+    __asm__ __volatile__ ("isb\n\tmrs %0, cntvct_el0" : "=r" (counter) :: "memory");
+    ARSAL_Time_FastClock.nsBase = ARSAL_Time_GetMonotonicNs();
+    ARSAL_Time_FastClock.counterBase = counter;
+    ARSAL_Time_FastClock.mult = (uint64_t)((1000000000ULL << 32) / freq);
+    ARSAL_Time_FastClock.enabled = 1;
+    ARSAL_PRINT(ARSAL_PRINT_INFO, ARSAL_TIME_TAG, "Generic timer fast path enabled (%" PRIu64 " Hz)", freq);
+    return 0;
+#else
+    return -1;
+#endif
+}
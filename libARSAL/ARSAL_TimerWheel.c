@@ -0,0 +1,672 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_TimerWheel.c
+ * @brief Hierarchical timer wheel driven by a single timerfd
+ * @date 10/18/2026
+ *
+ * Four levels of 64 slots: level L holds the timers expiring between 64^L
+ * and 64^(L+1) ticks from now, and is cascaded into the lower levels when
+ * the time reaches its slot. Arm and cancel are list operations; the next
+ * event (expiration or non empty cascade) is found with one bit scan per
+ * level, and the timerfd is only programmed for that event.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+#include <libARSAL/ARSAL_Futex.h>
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_TimerWheel.h>
+
+#define ARSAL_TIMERWHEEL_TAG "ARSAL_TimerWheel"
+
+#define ARSAL_TIMERWHEEL_LEVELS     4
+#define ARSAL_TIMERWHEEL_BITS       6
+#define ARSAL_TIMERWHEEL_SLOTS      (1 << ARSAL_TIMERWHEEL_BITS)
+#define ARSAL_TIMERWHEEL_MASK       (ARSAL_TIMERWHEEL_SLOTS - 1)
+#define ARSAL_TIMERWHEEL_SPAN       (1ULL << (ARSAL_TIMERWHEEL_BITS * ARSAL_TIMERWHEEL_LEVELS))
+#define ARSAL_TIMERWHEEL_NEVER      UINT64_MAX
+
+/* Timer.running values */
+#define ARSAL_TIMER_IDLE            0
+#define ARSAL_TIMER_RUNNING         1
+#define ARSAL_TIMER_RUNNING_WAITED  2
+
+struct ARSAL_TimerWheel_t
+{
+    ARSAL_Mutex_t mutex;
+    int fd;
+    ARSAL_Time_Ns_t tickNs;
+    ARSAL_Time_Ns_t base;           /**< Monotonic time of tick 0 */
+    uint64_t now;                   /**< Last processed tick */
+    uint64_t programmed;            /**< Tick the timerfd is armed for */
+    uint64_t bitmap[ARSAL_TIMERWHEEL_LEVELS];
+    ARSAL_Timer_t *slots[ARSAL_TIMERWHEEL_LEVELS][ARSAL_TIMERWHEEL_SLOTS];
+    ARSAL_Timer_t *fireHead;        /**< Expired timers waiting for their callback */
+    ARSAL_Timer_t *fireTail;
+    ARSAL_TaskPool_t *pool;
+    ARSAL_Thread_t thread;
+    volatile int run;
+};
+
+/* Timer whose callback runs in the current thread */
+static __thread ARSAL_Timer_t *ARSAL_TimerWheel_CurrentTimer = NULL;
+
+static uint64_t ARSAL_TimerWheel_Rotr(uint64_t x, int s)
+{
+    return (s == 0) ? x : ((x >> s) | (x << (64 - s)));
+}
+
+static uint64_t ARSAL_TimerWheel_NsToTick(ARSAL_TimerWheel_t *wheel, ARSAL_Time_Ns_t ns)
+{
+    /* Rounded up: a timer never fires before its deadline */
+    return (ns <= wheel->base) ? 0 : (ns - wheel->base + wheel->tickNs - 1) / wheel->tickNs;
+}
+
+static void ARSAL_TimerWheel_Link(ARSAL_TimerWheel_t *wheel, ARSAL_Timer_t *timer, int level, int index)
+{
+    ARSAL_Timer_t **head = &wheel->slots[level][index];
+
+    timer->prev = NULL;
+    timer->next = *head;
+    if (*head != NULL)
+    {
+        (*head)->prev = timer;
+    }
+    *head = timer;
+    timer->slot = level * ARSAL_TIMERWHEEL_SLOTS + index;
+    wheel->bitmap[level] |= 1ULL << index;
+}
+
+static void ARSAL_TimerWheel_Unlink(ARSAL_TimerWheel_t *wheel, ARSAL_Timer_t *timer)
+{
+    int level = timer->slot / ARSAL_TIMERWHEEL_SLOTS;
+    int index = timer->slot % ARSAL_TIMERWHEEL_SLOTS;
+
+    if (timer->prev != NULL)
+    {
+        timer->prev->next = timer->next;
+    }
+    else
+    {
+        wheel->slots[level][index] = timer->next;
+        if (timer->next == NULL)
+        {
+            wheel->bitmap[level] &= ~(1ULL << index);
+        }
+    }
+    if (timer->next != NULL)
+    {
+        timer->next->prev = timer->prev;
+    }
+    timer->next = timer->prev = NULL;
+    timer->slot = -1;
+}
+
+static void ARSAL_TimerWheel_Queue(ARSAL_TimerWheel_t *wheel, ARSAL_Timer_t *timer)
+{
+    if (timer->queued)
+    {
+        /* Still waiting from a previous expiration: one callback is enough */
+        return;
+    }
+    timer->queued = 1;
+    timer->fireNext = NULL;
+    timer->firePrev = wheel->fireTail;
+    if (wheel->fireTail != NULL)
+    {
+        wheel->fireTail->fireNext = timer;
+    }
+    else
+    {
+        wheel->fireHead = timer;
+    }
+    wheel->fireTail = timer;
+}
+
+static void ARSAL_TimerWheel_Dequeue(ARSAL_TimerWheel_t *wheel, ARSAL_Timer_t *timer)
+{
+    if (timer->firePrev != NULL)
+    {
+        timer->firePrev->fireNext = timer->fireNext;
+    }
+    else
+    {
+        wheel->fireHead = timer->fireNext;
+    }
+    if (timer->fireNext != NULL)
+    {
+        timer->fireNext->firePrev = timer->firePrev;
+    }
+    else
+    {
+        wheel->fireTail = timer->firePrev;
+    }
+    timer->fireNext = timer->firePrev = NULL;
+    timer->queued = 0;
+}
+
+/**
+ * @brief Place a timer in the wheel according to its tick
+ */
+static void ARSAL_TimerWheel_Insert(ARSAL_TimerWheel_t *wheel, ARSAL_Timer_t *timer)
+{
+    uint64_t tick = timer->tick;
+    uint64_t delta;
+    int level = 0;
+
+    if (tick <= wheel->now)
+    {
+        /* Already late: expires on the next processing */
+        tick = wheel->now + 1;
+    }
+    delta = tick - wheel->now;
+    if (delta >= ARSAL_TIMERWHEEL_SPAN)
+    {
+        /* Beyond the wheel: parked in the last level, re-placed on cascade */
+        delta = ARSAL_TIMERWHEEL_SPAN - 1;
+        tick = wheel->now + delta;
+    }
+    while (delta >= (1ULL << (ARSAL_TIMERWHEEL_BITS * (level + 1))))
+    {
+        level++;
+    }
+    ARSAL_TimerWheel_Link(wheel, timer, level, (int)((tick >> (ARSAL_TIMERWHEEL_BITS * level)) & ARSAL_TIMERWHEEL_MASK));
+}
+
+/**
+ * @brief Next tick at which a timer expires or a non empty slot is cascaded
+ */
+static uint64_t ARSAL_TimerWheel_NextEvent(ARSAL_TimerWheel_t *wheel)
+{
+    uint64_t next = ARSAL_TIMERWHEEL_NEVER;
+    int level;
+
+    for (level = 0; level < ARSAL_TIMERWHEEL_LEVELS; level++)
+    {
+        int shift = ARSAL_TIMERWHEEL_BITS * level;
+        uint64_t current, event;
+
+        if (wheel->bitmap[level] == 0)
+        {
+            continue;
+        }
+        current = (wheel->now >> shift) + 1;
+        event = (current + (uint64_t)__builtin_ctzll(ARSAL_TimerWheel_Rotr(wheel->bitmap[level], (int)(current & ARSAL_TIMERWHEEL_MASK)))) << shift;
+        if (event < next)
+        {
+            next = event;
+        }
+    }
+    return next;
+}
+
+static void ARSAL_TimerWheel_Expire(ARSAL_TimerWheel_t *wheel, ARSAL_Timer_t *timer)
+{
+    if (timer->period > 0)
+    {
+        ARSAL_Time_Ns_t nowNs = wheel->base + wheel->now * wheel->tickNs;
+
+        timer->deadline += timer->period;
+        if (timer->deadline <= nowNs)
+        {
+            /* Skip the missed periods */
+            timer->deadline += ((nowNs - timer->deadline) / timer->period + 1) * timer->period;
+        }
+        timer->tick = ARSAL_TimerWheel_NsToTick(wheel, timer->deadline);
+        ARSAL_TimerWheel_Insert(wheel, timer);
+    }
+    ARSAL_TimerWheel_Queue(wheel, timer);
+}
+
+/**
+ * @brief Move the wheel to tick target, queuing the expired timers
+ */
+static void ARSAL_TimerWheel_Advance(ARSAL_TimerWheel_t *wheel, uint64_t target)
+{
+    uint64_t tick;
+
+    while ((tick = ARSAL_TimerWheel_NextEvent(wheel)) <= target)
+    {
+        ARSAL_Timer_t *timer;
+        int level;
+
+        wheel->now = tick;
+
+        /* Cascade the upper slots reached by this tick */
+        for (level = ARSAL_TIMERWHEEL_LEVELS - 1; level > 0; level--)
+        {
+            int shift = ARSAL_TIMERWHEEL_BITS * level;
+            int index = (int)((tick >> shift) & ARSAL_TIMERWHEEL_MASK);
+
+            if ((tick & ((1ULL << shift) - 1)) != 0)
+            {
+                continue;
+            }
+            while ((timer = wheel->slots[level][index]) != NULL)
+            {
+                ARSAL_TimerWheel_Unlink(wheel, timer);
+                if (timer->tick <= tick)
+                {
+                    ARSAL_TimerWheel_Expire(wheel, timer);
+                }
+                else
+                {
+                    ARSAL_TimerWheel_Insert(wheel, timer);
+                }
+            }
+        }
+
+        while ((timer = wheel->slots[0][tick & ARSAL_TIMERWHEEL_MASK]) != NULL)
+        {
+            ARSAL_TimerWheel_Unlink(wheel, timer);
+            ARSAL_TimerWheel_Expire(wheel, timer);
+        }
+    }
+
+    if (target > wheel->now)
+    {
+        wheel->now = target;
+    }
+}
+
+/**
+ * @brief Program the timerfd for the next event if it is earlier than the programmed one
+ */
+static void ARSAL_TimerWheel_Program(ARSAL_TimerWheel_t *wheel)
+{
+    uint64_t next = ARSAL_TimerWheel_NextEvent(wheel);
+    struct itimerspec spec;
+
+    if ((next >= wheel->programmed) || !wheel->run)
+    {
+        return;
+    }
+    memset(&spec, 0, sizeof(spec));
+    NSEC_TO_TIMESPEC(wheel->base + next * wheel->tickNs, &spec.it_value);
+    if (timerfd_settime(wheel->fd, TFD_TIMER_ABSTIME, &spec, NULL) == 0)
+    {
+        wheel->programmed = next;
+    }
+    else
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSAL_TIMERWHEEL_TAG, "timerfd_settime failed: %s", strerror(errno));
+    }
+}
+
+/**
+ * @brief Run the callback of the first expired timer
+ * @return 1 if a callback was run, 0 if there was no expired timer left
+ */
+static int ARSAL_TimerWheel_DispatchOne(ARSAL_TimerWheel_t *wheel)
+{
+    ARSAL_Timer_t *timer;
+    ARSAL_Timer_t *previous;
+
+    ARSAL_Mutex_Lock(&wheel->mutex);
+    timer = wheel->fireHead;
+    if (timer != NULL)
+    {
+        ARSAL_TimerWheel_Dequeue(wheel, timer);
+        timer->running = ARSAL_TIMER_RUNNING;
+    }
+    ARSAL_Mutex_Unlock(&wheel->mutex);
+
+    if (timer == NULL)
+    {
+        return 0;
+    }
+
+    previous = ARSAL_TimerWheel_CurrentTimer;
+    ARSAL_TimerWheel_CurrentTimer = timer;
+    timer->callback(timer, timer->arg);
+    ARSAL_TimerWheel_CurrentTimer = previous;
+
+    if (__atomic_exchange_n(&timer->running, ARSAL_TIMER_IDLE, __ATOMIC_RELEASE) == ARSAL_TIMER_RUNNING_WAITED)
+    {
+        ARSAL_Futex_Wake(&timer->running, INT_MAX, 0);
+    }
+    return 1;
+}
+
+typedef struct
+{
+    ARSAL_TimerWheel_t *wheel;
+    volatile int dispatched;
+} ARSAL_TimerWheel_Dispatch_t;
+
+static void ARSAL_TimerWheel_DispatchTask(void *arg)
+{
+    ARSAL_TimerWheel_Dispatch_t *dispatch = arg;
+
+    if (ARSAL_TimerWheel_DispatchOne(dispatch->wheel))
+    {
+        __atomic_add_fetch(&dispatch->dispatched, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void *ARSAL_TimerWheel_Run(void *arg)
+{
+    ARSAL_TimerWheel_t *wheel = arg;
+    struct pollfd pfd;
+
+    pfd.fd = wheel->fd;
+    pfd.events = POLLIN;
+    while (wheel->run)
+    {
+        if ((poll(&pfd, 1, -1) > 0) && wheel->run)
+        {
+            ARSAL_TimerWheel_Process(wheel);
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Public API
+ */
+
+ARSAL_TimerWheel_t *ARSAL_TimerWheel_New(const ARSAL_TimerWheel_Config_t *config, eARSAL_ERROR *error)
+{
+    ARSAL_TimerWheel_Config_t defaultConfig;
+    ARSAL_TimerWheel_t *wheel = NULL;
+    eARSAL_ERROR err = ARSAL_OK;
+
+    if (config == NULL)
+    {
+        memset(&defaultConfig, 0, sizeof(defaultConfig));
+        defaultConfig.startThread = 1;
+        ARSAL_Thread_Attr_Init(&defaultConfig.attr);
+        config = &defaultConfig;
+    }
+
+    wheel = calloc(1, sizeof(*wheel));
+    if (wheel == NULL)
+    {
+        err = ARSAL_ERROR_ALLOC;
+    }
+
+    if (err == ARSAL_OK)
+    {
+        wheel->tickNs = (config->tickNs > 0) ? config->tickNs : ARSAL_TIMERWHEEL_DEFAULT_TICK_NS;
+        wheel->base = ARSAL_Time_GetMonotonicNs();
+        wheel->programmed = ARSAL_TIMERWHEEL_NEVER;
+        wheel->pool = config->pool;
+        wheel->run = 1;
+        wheel->fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (wheel->fd < 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSAL_TIMERWHEEL_TAG, "timerfd_create failed: %s", strerror(errno));
+            err = ARSAL_ERROR_SYSTEM;
+        }
+    }
+
+    if ((err == ARSAL_OK) && (ARSAL_Mutex_Init(&wheel->mutex) != 0))
+    {
+        close(wheel->fd);
+        wheel->fd = -1;
+        err = ARSAL_ERROR_SYSTEM;
+    }
+
+    if ((err == ARSAL_OK) && config->startThread)
+    {
+        ARSAL_Thread_Attr_t attr = config->attr;
+        if (attr.name[0] == '\0')
+        {
+            snprintf(attr.name, sizeof(attr.name), "timerwheel");
+        }
+        if (ARSAL_Thread_CreateEx(&wheel->thread, ARSAL_TimerWheel_Run, wheel, &attr) != 0)
+        {
+            ARSAL_Mutex_Destroy(&wheel->mutex);
+            close(wheel->fd);
+            wheel->fd = -1;
+            err = ARSAL_ERROR_SYSTEM;
+        }
+    }
+
+    if ((err != ARSAL_OK) && (wheel != NULL))
+    {
+        free(wheel);
+        wheel = NULL;
+    }
+
+    if (error != NULL)
+    {
+        *error = err;
+    }
+    return wheel;
+}
+
+void ARSAL_TimerWheel_Delete(ARSAL_TimerWheel_t **wheel)
+{
+    ARSAL_TimerWheel_t *w;
+
+    if ((wheel == NULL) || (*wheel == NULL))
+    {
+        return;
+    }
+    w = *wheel;
+
+    if (w->thread != NULL)
+    {
+        struct itimerspec spec;
+
+        /* Fire the timerfd now so the thread leaves poll() */
+        ARSAL_Mutex_Lock(&w->mutex);
+        w->run = 0;
+        memset(&spec, 0, sizeof(spec));
+        spec.it_value.tv_nsec = 1;
+        timerfd_settime(w->fd, TFD_TIMER_ABSTIME, &spec, NULL);
+        ARSAL_Mutex_Unlock(&w->mutex);
+
+        ARSAL_Thread_Join(w->thread, NULL);
+        ARSAL_Thread_Destroy(&w->thread);
+    }
+
+    ARSAL_Mutex_Destroy(&w->mutex);
+    close(w->fd);
+    free(w);
+    *wheel = NULL;
+}
+
+int ARSAL_TimerWheel_GetFd(ARSAL_TimerWheel_t *wheel)
+{
+    return (wheel != NULL) ? wheel->fd : -1;
+}
+
+int ARSAL_TimerWheel_Process(ARSAL_TimerWheel_t *wheel)
+{
+    uint64_t expirations;
+    ARSAL_Time_Ns_t nowNs;
+    ARSAL_Timer_t *timer;
+    int count = 0;
+    int dispatched = 0;
+
+    if (wheel == NULL)
+    {
+        return 0;
+    }
+
+    /* Acknowledge the timerfd, it may also have been woken by nothing */
+    if (read(wheel->fd, &expirations, sizeof(expirations)) < 0)
+    {
+        expirations = 0;
+    }
+
+    ARSAL_Mutex_Lock(&wheel->mutex);
+    nowNs = ARSAL_Time_GetMonotonicNs();
+    ARSAL_TimerWheel_Advance(wheel, (nowNs - wheel->base) / wheel->tickNs);
+    wheel->programmed = ARSAL_TIMERWHEEL_NEVER;
+    ARSAL_TimerWheel_Program(wheel);
+    for (timer = wheel->fireHead; timer != NULL; timer = timer->fireNext)
+    {
+        count++;
+    }
+    ARSAL_Mutex_Unlock(&wheel->mutex);
+
+    if ((wheel->pool != NULL) && (count > 1))
+    {
+        ARSAL_TimerWheel_Dispatch_t dispatch;
+        ARSAL_TaskGroup_t group;
+        int i;
+
+        /* One task per expired timer, each takes the first one still queued */
+        dispatch.wheel = wheel;
+        dispatch.dispatched = 0;
+        ARSAL_TaskGroup_Init(&group, wheel->pool);
+        for (i = 0; i < count; i++)
+        {
+            if (ARSAL_TaskGroup_Spawn(&group, ARSAL_TimerWheel_DispatchTask, &dispatch) != ARSAL_OK)
+            {
+                ARSAL_TimerWheel_DispatchTask(&dispatch);
+            }
+        }
+        ARSAL_TaskGroup_Wait(&group);
+        dispatched = dispatch.dispatched;
+    }
+    else
+    {
+        while ((dispatched < count) && ARSAL_TimerWheel_DispatchOne(wheel))
+        {
+            dispatched++;
+        }
+    }
+
+    return dispatched;
+}
+
+void ARSAL_Timer_Init(ARSAL_Timer_t *timer, ARSAL_TimerWheel_t *wheel, ARSAL_Timer_Callback_t callback, void *arg)
+{
+    if (timer == NULL)
+    {
+        return;
+    }
+    memset(timer, 0, sizeof(*timer));
+    timer->wheel = wheel;
+    timer->callback = callback;
+    timer->arg = arg;
+    timer->slot = -1;
+}
+
+eARSAL_ERROR ARSAL_Timer_Arm(ARSAL_Timer_t *timer, ARSAL_Time_Ns_t deadline, ARSAL_Time_Ns_t period)
+{
+    ARSAL_TimerWheel_t *wheel;
+
+    if ((timer == NULL) || (timer->wheel == NULL) || (timer->callback == NULL))
+    {
+        return ARSAL_ERROR_BAD_PARAMETER;
+    }
+    wheel = timer->wheel;
+
+    ARSAL_Mutex_Lock(&wheel->mutex);
+    if (timer->slot >= 0)
+    {
+        ARSAL_TimerWheel_Unlink(wheel, timer);
+    }
+    if (timer->queued)
+    {
+        /* Re-arming supersedes the pending expiration */
+        ARSAL_TimerWheel_Dequeue(wheel, timer);
+    }
+    timer->deadline = deadline;
+    timer->period = period;
+    timer->tick = ARSAL_TimerWheel_NsToTick(wheel, deadline);
+    ARSAL_TimerWheel_Insert(wheel, timer);
+    ARSAL_TimerWheel_Program(wheel);
+    ARSAL_Mutex_Unlock(&wheel->mutex);
+
+    return ARSAL_OK;
+}
+
+eARSAL_ERROR ARSAL_Timer_ArmAfter(ARSAL_Timer_t *timer, ARSAL_Time_Ns_t delay, ARSAL_Time_Ns_t period)
+{
+    return ARSAL_Timer_Arm(timer, ARSAL_Time_GetMonotonicNs() + delay, period);
+}
+
+int ARSAL_Timer_Cancel(ARSAL_Timer_t *timer)
+{
+    ARSAL_TimerWheel_t *wheel;
+    int armed = 0;
+
+    if ((timer == NULL) || (timer->wheel == NULL))
+    {
+        return 0;
+    }
+    wheel = timer->wheel;
+
+    /* Not re-programming the timerfd: an early wakeup finds nothing to do */
+    ARSAL_Mutex_Lock(&wheel->mutex);
+    if (timer->slot >= 0)
+    {
+        ARSAL_TimerWheel_Unlink(wheel, timer);
+        armed = 1;
+    }
+    if (timer->queued)
+    {
+        ARSAL_TimerWheel_Dequeue(wheel, timer);
+        armed = 1;
+    }
+    ARSAL_Mutex_Unlock(&wheel->mutex);
+
+    if (timer != ARSAL_TimerWheel_CurrentTimer)
+    {
+        uint32_t running;
+        while ((running = __atomic_load_n(&timer->running, __ATOMIC_ACQUIRE)) != ARSAL_TIMER_IDLE)
+        {
+            if ((running == ARSAL_TIMER_RUNNING_WAITED) ||
+                __atomic_compare_exchange_n(&timer->running, &running, ARSAL_TIMER_RUNNING_WAITED, 0, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+            {
+                ARSAL_Futex_Wait(&timer->running, ARSAL_TIMER_RUNNING_WAITED, NULL, 0);
+            }
+        }
+    }
+    return armed;
+}
+
+int ARSAL_Timer_IsArmed(ARSAL_Timer_t *timer)
+{
+    int armed;
+
+    if ((timer == NULL) || (timer->wheel == NULL))
+    {
+        return 0;
+    }
+    ARSAL_Mutex_Lock(&timer->wheel->mutex);
+    armed = (timer->slot >= 0) || timer->queued;
+    ARSAL_Mutex_Unlock(&timer->wheel->mutex);
+    return armed;
+}
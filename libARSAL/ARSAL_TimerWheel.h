@@ -0,0 +1,187 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_TimerWheel.h
+ * @brief Hierarchical timer wheel driven by a single timerfd
+ * @date 10/18/2026
+ */
+#ifndef _ARSAL_TIMERWHEEL_H_
+#define _ARSAL_TIMERWHEEL_H_
+
+#include <inttypes.h>
+#include <libARSAL/ARSAL_Error.h>
+#include <libARSAL/ARSAL_TaskPool.h>
+#include <libARSAL/ARSAL_Thread.h>
+#include <libARSAL/ARSAL_Time.h>
+
+/**
+ * @brief Default resolution of the wheel: timers expiring in the same tick fire together
+ */
+#define ARSAL_TIMERWHEEL_DEFAULT_TICK_NS    MSEC_TO_NSEC(1ULL)
+
+/**
+ * @brief Timer wheel type
+ */
+typedef struct ARSAL_TimerWheel_t ARSAL_TimerWheel_t;
+
+struct ARSAL_Timer_t;
+
+/**
+ * @brief Timer callback
+ * @param timer The expired timer. It may be re-armed or cancelled from the callback
+ * @param arg The argument given to ARSAL_Timer_Init()
+ */
+typedef void (*ARSAL_Timer_Callback_t) (struct ARSAL_Timer_t *timer, void *arg);
+
+/**
+ * @brief Timer, usually embedded in the structure of its owner
+ * @warning Fields should not be used directly
+ * @see ARSAL_Timer_Init ()
+ */
+typedef struct ARSAL_Timer_t
+{
+    struct ARSAL_Timer_t *next;         /**< Next timer of the wheel slot */
+    struct ARSAL_Timer_t *prev;         /**< Previous timer of the wheel slot */
+    ARSAL_TimerWheel_t *wheel;          /**< Wheel the timer belongs to */
+    ARSAL_Timer_Callback_t callback;    /**< User callback */
+    void *arg;                          /**< User callback argument */
+    ARSAL_Time_Ns_t deadline;           /**< Absolute monotonic expiration time */
+    ARSAL_Time_Ns_t period;             /**< Period, 0 for one-shot */
+    uint64_t tick;                      /**< Expiration tick */
+    int slot;                           /**< Wheel slot, -1 when not in the wheel */
+    int queued;                         /**< Non zero while expired and waiting for its callback */
+    struct ARSAL_Timer_t *fireNext;     /**< Next expired timer */
+    struct ARSAL_Timer_t *firePrev;     /**< Previous expired timer */
+    volatile uint32_t running;          /**< Non zero while the callback runs */
+} ARSAL_Timer_t;
+
+/**
+ * @brief Timer wheel configuration
+ * @see ARSAL_TimerWheel_New ()
+ */
+typedef struct
+{
+    ARSAL_Time_Ns_t tickNs;     /**< Resolution of the wheel. 0 for ARSAL_TIMERWHEEL_DEFAULT_TICK_NS */
+    int startThread;            /**< Non zero to process the wheel in its own thread, else the owner polls ARSAL_TimerWheel_GetFd() and calls ARSAL_TimerWheel_Process() from its event loop */
+    ARSAL_Thread_Attr_t attr;   /**< Attributes of the wheel thread when startThread is set */
+    ARSAL_TaskPool_t *pool;     /**< Pool to run the callbacks of expired timers on (optional, may be NULL to run them in the processing thread) */
+} ARSAL_TimerWheel_Config_t;
+
+/**
+ * @brief Create a timer wheel
+ * @warning This function allocates memory
+ * @param config The configuration (NULL for defaults: own thread, 1 ms tick)
+ * @param[out] error A pointer on the error output (optional, may be NULL)
+ * @return Pointer on the new timer wheel, or NULL on error
+ * @see ARSAL_TimerWheel_Delete ()
+ */
+ARSAL_TimerWheel_t *ARSAL_TimerWheel_New(const ARSAL_TimerWheel_Config_t *config, eARSAL_ERROR *error);
+
+/**
+ * @brief Stop the wheel thread and delete the timer wheel
+ * @warning Armed timers are dropped without their callback being called
+ * @warning This function frees memory
+ * @param wheel The address of the pointer on the timer wheel
+ * @see ARSAL_TimerWheel_New ()
+ */
+void ARSAL_TimerWheel_Delete(ARSAL_TimerWheel_t **wheel);
+
+/**
+ * @brief Get the file descriptor to poll for POLLIN in an external event loop
+ * @param wheel The timer wheel
+ * @return The timerfd of the wheel
+ */
+int ARSAL_TimerWheel_GetFd(ARSAL_TimerWheel_t *wheel);
+
+/**
+ * @brief Run the callbacks of the expired timers
+ *
+ * Called by the wheel thread, or by the owner's event loop when the wheel
+ * file descriptor is readable. With a task pool, the callbacks run in
+ * parallel and this function returns once all of them have completed.
+ *
+ * @param wheel The timer wheel
+ * @return The number of callbacks run
+ */
+int ARSAL_TimerWheel_Process(ARSAL_TimerWheel_t *wheel);
+
+/**
+ * @brief Initialize a timer
+ * @param timer The timer to initialize
+ * @param wheel The wheel of the timer
+ * @param callback The callback called on expiration
+ * @param arg The argument passed to callback()
+ */
+void ARSAL_Timer_Init(ARSAL_Timer_t *timer, ARSAL_TimerWheel_t *wheel, ARSAL_Timer_Callback_t callback, void *arg);
+
+/**
+ * @brief Arm (or re-arm) a timer, in O(1)
+ *
+ * A periodic timer expires at deadline + n * period. Periods missed while
+ * the process was not scheduled are skipped instead of fired in a burst.
+ *
+ * @param timer The timer
+ * @param deadline The absolute expiration time (see ARSAL_Time_GetMonotonicNs())
+ * @param period The period, 0 for a one-shot timer
+ * @retval On success, returns ARSAL_OK. Otherwise, it returns an error number of eARSAL_ERROR
+ */
+eARSAL_ERROR ARSAL_Timer_Arm(ARSAL_Timer_t *timer, ARSAL_Time_Ns_t deadline, ARSAL_Time_Ns_t period);
+
+/**
+ * @brief Arm (or re-arm) a timer relative to now
+ * @param timer The timer
+ * @param delay The delay before the first expiration
+ * @param period The period, 0 for a one-shot timer
+ * @retval On success, returns ARSAL_OK. Otherwise, it returns an error number of eARSAL_ERROR
+ * @see ARSAL_Timer_Arm ()
+ */
+eARSAL_ERROR ARSAL_Timer_ArmAfter(ARSAL_Timer_t *timer, ARSAL_Time_Ns_t delay, ARSAL_Time_Ns_t period);
+
+/**
+ * @brief Cancel a timer, in O(1)
+ *
+ * If the callback is running in another thread, wait for it to return, so
+ * the timer can be freed once this function returns. Cancelling from the
+ * timer's own callback does not wait.
+ *
+ * @param timer The timer
+ * @return 1 if the timer was armed, 0 otherwise
+ */
+int ARSAL_Timer_Cancel(ARSAL_Timer_t *timer);
+
+/**
+ * @brief Check whether a timer is armed
+ * @param timer The timer
+ * @return 1 if the timer is armed, 0 otherwise
+ */
+int ARSAL_Timer_IsArmed(ARSAL_Timer_t *timer);
+
+#endif /* _ARSAL_TIMERWHEEL_H_ */
@@ -0,0 +1,937 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_Writer.c
+ * @brief Asynchronous batched file writer
+ * @date 10/18/2026
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <libARSAL/ARSAL_Writer.h>
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_Time.h>
+
+#define ARSAL_WRITER_TAG "ARSAL_Writer"
+
+/* Longest idle wait of the I/O thread, bounds the lateness of periodic syncs (ms) */
+#define ARSAL_WRITER_IDLE_WAIT_MS 200
+
+typedef enum
+{
+    ARSAL_WRITER_OP_DATA = 0,
+    ARSAL_WRITER_OP_SYNC,
+    ARSAL_WRITER_OP_CLOSE,
+} eARSAL_WRITER_OP;
+
+typedef struct ARSAL_Writer_Chunk_t
+{
+    struct ARSAL_Writer_Chunk_t *next;
+    ARSAL_Writer_Stream_t *stream;
+    eARSAL_WRITER_OP op;
+    uint8_t *data;
+    size_t len;
+    size_t limit;               /* The chunk ends on a chunkSize boundary of the file */
+    uint64_t offset;            /* File offset of data[0] */
+    ARSAL_Time_Ns_t firstWrite;
+} ARSAL_Writer_Chunk_t;
+
+struct ARSAL_Writer_Stream_t
+{
+    ARSAL_Writer_t *writer;
+    ARSAL_Writer_Stream_t *next;
+    char *path;
+    int fd;
+    eARSAL_WRITER_BACKPRESSURE backpressure;
+    uint32_t blockTimeoutMs;
+    size_t preallocSize;
+    ARSAL_Time_Ns_t flushPeriodNs;
+    ARSAL_Time_Ns_t syncPeriodNs;
+
+    /* Producer side, under the stream mutex */
+    ARSAL_Mutex_t mutex;
+    ARSAL_Writer_Chunk_t *cur;
+    uint64_t offset;
+    ARSAL_Writer_Chunk_t marker;    /* Sync and close requests */
+
+    /* Under the writer mutex */
+    uint64_t queued;                /* Requests queued */
+    uint64_t done;                  /* Requests processed by the I/O thread */
+    eARSAL_ERROR error;             /* Last error of the I/O thread */
+    ARSAL_Writer_Stats_t stats;
+    ARSAL_Time_Ns_t curFirstWrite;  /* First write to the current chunk, 0 if none */
+
+    /* Owned by the I/O thread */
+    uint64_t end;
+    uint64_t allocated;
+    int preallocDisabled;
+    uint64_t unsynced;
+    ARSAL_Time_Ns_t lastSync;
+};
+
+struct ARSAL_Writer_t
+{
+    size_t chunkSize;
+    uint32_t nbChunks;
+    uint8_t *memory;
+    ARSAL_Writer_Chunk_t *chunks;
+
+    ARSAL_Mutex_t mutex;
+    ARSAL_Cond_t ioCond;
+    ARSAL_Cond_t freeCond;
+    ARSAL_Cond_t doneCond;
+    ARSAL_Writer_Chunk_t *freeList;
+    uint32_t nbFree;
+    ARSAL_Writer_Chunk_t *queueHead;
+    ARSAL_Writer_Chunk_t *queueTail;
+    ARSAL_Writer_Stream_t *streams;
+    int run;
+
+    ARSAL_Writer_Stats_t stats;
+    ARSAL_Thread_t thread;
+};
+
+static void ARSAL_Writer_QueueCurrent(ARSAL_Writer_Stream_t *stream);
+
+/*
+ * Queue and chunk pool, called with the writer mutex held
+ */
+
+static void ARSAL_Writer_Enqueue(ARSAL_Writer_t *writer, ARSAL_Writer_Chunk_t *chunk)
+{
+    chunk->next = NULL;
+    if (writer->queueTail != NULL)
+    {
+        writer->queueTail->next = chunk;
+    }
+    else
+    {
+        writer->queueHead = chunk;
+    }
+    writer->queueTail = chunk;
+    chunk->stream->queued++;
+
+    if (chunk->op == ARSAL_WRITER_OP_DATA)
+    {
+        writer->stats.queueDepth++;
+        if (writer->stats.queueDepth > writer->stats.maxQueueDepth)
+        {
+            writer->stats.maxQueueDepth = writer->stats.queueDepth;
+        }
+    }
+    ARSAL_Cond_Signal(&writer->ioCond);
+}
+
+static ARSAL_Writer_Chunk_t *ARSAL_Writer_PopFree(ARSAL_Writer_t *writer)
+{
+    ARSAL_Writer_Chunk_t *chunk = writer->freeList;
+    writer->freeList = chunk->next;
+    writer->nbFree--;
+    chunk->next = NULL;
+    return chunk;
+}
+
+static void ARSAL_Writer_PushFree(ARSAL_Writer_t *writer, ARSAL_Writer_Chunk_t *chunk)
+{
+    chunk->next = writer->freeList;
+    writer->freeList = chunk;
+    writer->nbFree++;
+    ARSAL_Cond_Broadcast(&writer->freeCond);
+}
+
+/*
+ * I/O, called by the I/O thread without the writer mutex held
+ */
+
+static int ARSAL_Writer_DoSync(ARSAL_Writer_Stream_t *stream, ARSAL_Time_Ns_t *latency)
+{
+    ARSAL_Time_Ns_t start = ARSAL_Time_GetMonotonicNs();
+    int ret = fdatasync(stream->fd);
+
+    stream->lastSync = ARSAL_Time_GetMonotonicNs();
+    *latency = stream->lastSync - start;
+    stream->unsynced = 0;
+    if (ret != 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSAL_WRITER_TAG, "fdatasync error on '%s': %s", stream->path, strerror(errno));
+    }
+    return ret;
+}
+
+static int ARSAL_Writer_DoWrite(ARSAL_Writer_Stream_t *stream, ARSAL_Writer_Chunk_t *chunk, ARSAL_Time_Ns_t *latency)
+{
+    uint64_t end = chunk->offset + chunk->len;
+    ARSAL_Time_Ns_t start;
+    size_t done = 0;
+
+    /* Preallocate in large steps: fewer extents, and no block allocation
+     * for fdatasync() to flush on most writes. The file size is kept, so
+     * readers and a crash never see the preallocated tail */
+    if ((!stream->preallocDisabled) && (end > stream->allocated))
+    {
+        uint64_t allocated = ((end + stream->preallocSize - 1) / stream->preallocSize) * stream->preallocSize;
+        int ret = fallocate(stream->fd, FALLOC_FL_KEEP_SIZE, (off_t)stream->allocated, (off_t)(allocated - stream->allocated));
+        if (ret == 0)
+        {
+            stream->allocated = allocated;
+        }
+        else
+        {
+            if ((errno != EOPNOTSUPP) && (errno != ENOSYS))
+            {
+                ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSAL_WRITER_TAG, "fallocate error on '%s': %s", stream->path, strerror(errno));
+            }
+            stream->preallocDisabled = 1;
+        }
+    }
+
+    start = ARSAL_Time_GetMonotonicNs();
+    while (done < chunk->len)
+    {
+        ssize_t ret = pwrite(stream->fd, chunk->data + done, chunk->len - done, (off_t)(chunk->offset + done));
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSAL_WRITER_TAG, "Write error on '%s': %s", stream->path, strerror(errno));
+            break;
+        }
+        done += (size_t)ret;
+    }
+    *latency = ARSAL_Time_GetMonotonicNs() - start;
+
+    if (end > stream->end)
+    {
+        stream->end = end;
+    }
+    stream->unsynced += done;
+    return (done == chunk->len) ? 0 : -1;
+}
+
+static int ARSAL_Writer_DoClose(ARSAL_Writer_Stream_t *stream, ARSAL_Time_Ns_t *latency)
+{
+    int ret = 0;
+
+    *latency = 0;
+    /* Release the blocks preallocated past the end */
+    if ((stream->allocated > stream->end) && (ftruncate(stream->fd, (off_t)stream->end) != 0))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSAL_WRITER_TAG, "Unable to trim '%s': %s", stream->path, strerror(errno));
+        ret = -1;
+    }
+    if ((stream->unsynced > 0) || (stream->allocated > stream->end))
+    {
+        ret |= ARSAL_Writer_DoSync(stream, latency);
+    }
+    close(stream->fd);
+    stream->fd = -1;
+    return ret;
+}
+
+static void ARSAL_Writer_UpdateLatency(ARSAL_Writer_Stats_t *stats, eARSAL_WRITER_OP op, ARSAL_Time_Ns_t latency)
+{
+    if (op == ARSAL_WRITER_OP_DATA)
+    {
+        stats->writes++;
+        stats->writeLatencyNs += latency;
+        if (latency > stats->maxWriteLatencyNs)
+        {
+            stats->maxWriteLatencyNs = latency;
+        }
+    }
+    else if (latency > 0)
+    {
+        stats->syncs++;
+        if (latency > stats->maxSyncLatencyNs)
+        {
+            stats->maxSyncLatencyNs = latency;
+        }
+    }
+}
+
+static void *ARSAL_Writer_Run(void *arg)
+{
+    ARSAL_Writer_t *writer = arg;
+
+    ARSAL_Mutex_Lock(&writer->mutex);
+    for (;;)
+    {
+        ARSAL_Writer_Chunk_t *chunk = writer->queueHead;
+        ARSAL_Writer_Stream_t *stream;
+        ARSAL_Time_Ns_t latency = 0, syncLatency = 0;
+        ARSAL_Time_Ns_t now, waitNs;
+        int ret = 0, syncRet = 0, flushed;
+
+        if (chunk == NULL)
+        {
+            if (!writer->run)
+            {
+                break;
+            }
+
+            /* Idle: queue the partial chunks older than the flush period of
+             * streams which stopped receiving data. A stream is not closed
+             * while the I/O thread is here, its close request is not processed */
+            now = ARSAL_Time_GetMonotonicNs();
+            waitNs = MSEC_TO_NSEC((uint64_t)ARSAL_WRITER_IDLE_WAIT_MS);
+            for (stream = writer->streams; stream != NULL; stream = stream->next)
+            {
+                if ((stream->fd >= 0) && (stream->curFirstWrite != 0))
+                {
+                    if (now - stream->curFirstWrite >= stream->flushPeriodNs)
+                    {
+                        break;
+                    }
+                    if (stream->curFirstWrite + stream->flushPeriodNs - now < waitNs)
+                    {
+                        waitNs = stream->curFirstWrite + stream->flushPeriodNs - now;
+                    }
+                }
+            }
+            if (stream != NULL)
+            {
+                /* The stream mutex is taken before the writer mutex. A busy
+                 * producer checks the flush period itself at the end of its write */
+                ARSAL_Mutex_Unlock(&writer->mutex);
+                flushed = 0;
+                if (ARSAL_Mutex_Trylock(&stream->mutex) == 0)
+                {
+                    if ((stream->cur != NULL) && (now - stream->cur->firstWrite >= stream->flushPeriodNs))
+                    {
+                        ARSAL_Writer_QueueCurrent(stream);
+                        flushed = 1;
+                    }
+                    ARSAL_Mutex_Unlock(&stream->mutex);
+                }
+                ARSAL_Mutex_Lock(&writer->mutex);
+                if (flushed)
+                {
+                    continue;
+                }
+                waitNs = MSEC_TO_NSEC(1);
+            }
+
+            /* Sync the streams which stopped receiving data */
+            for (stream = writer->streams; stream != NULL; stream = stream->next)
+            {
+                if ((stream->fd >= 0) && (stream->unsynced > 0) && (now - stream->lastSync >= stream->syncPeriodNs))
+                {
+                    break;
+                }
+            }
+            if (stream == NULL)
+            {
+                ARSAL_Cond_Timedwait(&writer->ioCond, &writer->mutex, (int)((waitNs + MSEC_TO_NSEC(1) - 1) / MSEC_TO_NSEC(1)));
+                continue;
+            }
+
+            ARSAL_Mutex_Unlock(&writer->mutex);
+            ret = ARSAL_Writer_DoSync(stream, &latency);
+            ARSAL_Mutex_Lock(&writer->mutex);
+            ARSAL_Writer_UpdateLatency(&writer->stats, ARSAL_WRITER_OP_SYNC, latency);
+            ARSAL_Writer_UpdateLatency(&stream->stats, ARSAL_WRITER_OP_SYNC, latency);
+            if (ret != 0)
+            {
+                writer->stats.writeErrors++;
+                stream->stats.writeErrors++;
+                stream->error = ARSAL_ERROR_FILE;
+            }
+            continue;
+        }
+
+        writer->queueHead = chunk->next;
+        if (writer->queueHead == NULL)
+        {
+            writer->queueTail = NULL;
+        }
+        stream = chunk->stream;
+        ARSAL_Mutex_Unlock(&writer->mutex);
+
+        switch (chunk->op)
+        {
+        case ARSAL_WRITER_OP_DATA:
+            ret = ARSAL_Writer_DoWrite(stream, chunk, &latency);
+            if (stream->lastSync + stream->syncPeriodNs <= ARSAL_Time_GetMonotonicNs())
+            {
+                syncRet = ARSAL_Writer_DoSync(stream, &syncLatency);
+            }
+            break;
+        case ARSAL_WRITER_OP_SYNC:
+            ret = ARSAL_Writer_DoSync(stream, &latency);
+            break;
+        case ARSAL_WRITER_OP_CLOSE:
+            ret = ARSAL_Writer_DoClose(stream, &latency);
+            break;
+        }
+
+        ARSAL_Mutex_Lock(&writer->mutex);
+        ARSAL_Writer_UpdateLatency(&writer->stats, chunk->op, latency);
+        ARSAL_Writer_UpdateLatency(&stream->stats, chunk->op, latency);
+        if (syncLatency > 0)
+        {
+            ARSAL_Writer_UpdateLatency(&writer->stats, ARSAL_WRITER_OP_SYNC, syncLatency);
+            ARSAL_Writer_UpdateLatency(&stream->stats, ARSAL_WRITER_OP_SYNC, syncLatency);
+        }
+        if ((ret != 0) || (syncRet != 0))
+        {
+            writer->stats.writeErrors++;
+            stream->stats.writeErrors++;
+            stream->error = ARSAL_ERROR_FILE;
+        }
+        if (chunk->op == ARSAL_WRITER_OP_DATA)
+        {
+            if (ret == 0)
+            {
+                writer->stats.bytesWritten += chunk->len;
+                stream->stats.bytesWritten += chunk->len;
+            }
+            writer->stats.queueDepth--;
+            ARSAL_Writer_PushFree(writer, chunk);
+        }
+        stream->done++;
+        ARSAL_Cond_Broadcast(&writer->doneCond);
+    }
+    ARSAL_Mutex_Unlock(&writer->mutex);
+
+    return NULL;
+}
+
+ARSAL_Writer_t *ARSAL_Writer_New(const ARSAL_Writer_Config_t *config, eARSAL_ERROR *error)
+{
+    ARSAL_Writer_t *writer = NULL;
+    eARSAL_ERROR err = ARSAL_OK;
+    ARSAL_Thread_Attr_t attr;
+    void *memory = NULL;
+    uint32_t i;
+
+    writer = calloc(1, sizeof(*writer));
+    if (writer == NULL)
+    {
+        err = ARSAL_ERROR_ALLOC;
+    }
+
+    if (err == ARSAL_OK)
+    {
+        size_t chunkSize = ((config != NULL) && (config->chunkSize > 0)) ? config->chunkSize : ARSAL_WRITER_DEFAULT_CHUNK_SIZE;
+        writer->chunkSize = (chunkSize + ARSAL_WRITER_ALIGNMENT - 1) & ~(size_t)(ARSAL_WRITER_ALIGNMENT - 1);
+        writer->nbChunks = ((config != NULL) && (config->nbChunks > 0)) ? config->nbChunks : ARSAL_WRITER_DEFAULT_NB_CHUNKS;
+        writer->chunks = calloc(writer->nbChunks, sizeof(*writer->chunks));
+        if ((writer->chunks == NULL) ||
+            (posix_memalign(&memory, ARSAL_WRITER_ALIGNMENT, writer->chunkSize * writer->nbChunks) != 0))
+        {
+            err = ARSAL_ERROR_ALLOC;
+        }
+        else
+        {
+            /* Touch the chunks now so Write() never page faults on them */
+            writer->memory = memory;
+            memset(writer->memory, 0, writer->chunkSize * writer->nbChunks);
+            for (i = 0; i < writer->nbChunks; i++)
+            {
+                writer->chunks[i].data = writer->memory + (size_t)i * writer->chunkSize;
+                writer->chunks[i].next = writer->freeList;
+                writer->freeList = &writer->chunks[i];
+            }
+            writer->nbFree = writer->nbChunks;
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        if ((ARSAL_Mutex_Init(&writer->mutex) != 0) ||
+            (ARSAL_Cond_Init(&writer->ioCond) != 0) ||
+            (ARSAL_Cond_Init(&writer->freeCond) != 0) ||
+            (ARSAL_Cond_Init(&writer->doneCond) != 0))
+        {
+            err = ARSAL_ERROR_SYSTEM;
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        if (config != NULL)
+        {
+            attr = config->attr;
+        }
+        else
+        {
+            ARSAL_Thread_Attr_Init(&attr);
+        }
+        if (attr.name[0] == '\0')
+        {
+            snprintf(attr.name, sizeof(attr.name), "writer");
+        }
+        writer->run = 1;
+        if (ARSAL_Thread_CreateEx(&writer->thread, ARSAL_Writer_Run, writer, &attr) != 0)
+        {
+            writer->thread = NULL;
+            err = ARSAL_ERROR_SYSTEM;
+        }
+    }
+
+    if (err != ARSAL_OK)
+    {
+        ARSAL_Writer_Delete(&writer);
+    }
+
+    if (error != NULL)
+    {
+        *error = err;
+    }
+    return writer;
+}
+
+void ARSAL_Writer_Delete(ARSAL_Writer_t **writer)
+{
+    ARSAL_Writer_t *w;
+
+    if ((writer == NULL) || (*writer == NULL))
+    {
+        return;
+    }
+    w = *writer;
+
+    if (w->streams != NULL)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSAL_WRITER_TAG, "Deleting a writer with open streams ('%s')", w->streams->path);
+    }
+
+    if (w->thread != NULL)
+    {
+        ARSAL_Mutex_Lock(&w->mutex);
+        w->run = 0;
+        ARSAL_Cond_Signal(&w->ioCond);
+        ARSAL_Mutex_Unlock(&w->mutex);
+        ARSAL_Thread_Join(w->thread, NULL);
+        ARSAL_Thread_Destroy(&w->thread);
+    }
+
+    if (w->mutex != NULL)
+    {
+        ARSAL_Mutex_Destroy(&w->mutex);
+    }
+    if (w->ioCond != NULL)
+    {
+        ARSAL_Cond_Destroy(&w->ioCond);
+    }
+    if (w->freeCond != NULL)
+    {
+        ARSAL_Cond_Destroy(&w->freeCond);
+    }
+    if (w->doneCond != NULL)
+    {
+        ARSAL_Cond_Destroy(&w->doneCond);
+    }
+    free(w->memory);
+    free(w->chunks);
+    free(w);
+    *writer = NULL;
+}
+
+ARSAL_Writer_Stream_t *ARSAL_Writer_Open(ARSAL_Writer_t *writer, const char *path, const ARSAL_Writer_Stream_Config_t *config, eARSAL_ERROR *error)
+{
+    ARSAL_Writer_Stream_t *stream = NULL;
+    eARSAL_ERROR err = ARSAL_OK;
+    ARSAL_Writer_Stream_Config_t defaultConfig;
+
+    if ((writer == NULL) || (path == NULL))
+    {
+        err = ARSAL_ERROR_BAD_PARAMETER;
+    }
+
+    if (config == NULL)
+    {
+        memset(&defaultConfig, 0, sizeof(defaultConfig));
+        config = &defaultConfig;
+    }
+
+    if (err == ARSAL_OK)
+    {
+        stream = calloc(1, sizeof(*stream));
+        if (stream == NULL)
+        {
+            err = ARSAL_ERROR_ALLOC;
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        stream->writer = writer;
+        stream->fd = -1;
+        stream->backpressure = config->backpressure;
+        stream->blockTimeoutMs = config->blockTimeoutMs;
+        stream->preallocSize = (config->preallocSize > 0) ? config->preallocSize : ARSAL_WRITER_DEFAULT_PREALLOC_SIZE;
+        stream->preallocDisabled = (config->preallocSize == SIZE_MAX);
+        stream->flushPeriodNs = MSEC_TO_NSEC((uint64_t)((config->flushPeriodMs > 0) ? config->flushPeriodMs : ARSAL_WRITER_DEFAULT_FLUSH_PERIOD_MS));
+        stream->syncPeriodNs = (config->syncPeriodMs == UINT32_MAX) ? UINT64_MAX / 2 :
+            MSEC_TO_NSEC((uint64_t)((config->syncPeriodMs > 0) ? config->syncPeriodMs : ARSAL_WRITER_DEFAULT_SYNC_PERIOD_MS));
+        stream->lastSync = ARSAL_Time_GetMonotonicNs();
+        stream->marker.stream = stream;
+        stream->path = strdup(path);
+        if (stream->path == NULL)
+        {
+            err = ARSAL_ERROR_ALLOC;
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        if (ARSAL_Mutex_Init(&stream->mutex) != 0)
+        {
+            err = ARSAL_ERROR_SYSTEM;
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        stream->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (stream->fd < 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSAL_WRITER_TAG, "Unable to open '%s': %s", path, strerror(errno));
+            err = ARSAL_ERROR_FILE;
+        }
+    }
+
+    if (err == ARSAL_OK)
+    {
+        ARSAL_Mutex_Lock(&writer->mutex);
+        stream->next = writer->streams;
+        writer->streams = stream;
+        ARSAL_Mutex_Unlock(&writer->mutex);
+    }
+    else if (stream != NULL)
+    {
+        if (stream->mutex != NULL)
+        {
+            ARSAL_Mutex_Destroy(&stream->mutex);
+        }
+        free(stream->path);
+        free(stream);
+        stream = NULL;
+    }
+
+    if (error != NULL)
+    {
+        *error = err;
+    }
+    return stream;
+}
+
+/**
+ * @brief Queue the current chunk of a stream, or give it back if it is empty
+ * @note Called with the stream mutex held, takes the writer mutex
+ */
+static void ARSAL_Writer_QueueCurrent(ARSAL_Writer_Stream_t *stream)
+{
+    ARSAL_Writer_t *writer = stream->writer;
+
+    if (stream->cur == NULL)
+    {
+        return;
+    }
+    ARSAL_Mutex_Lock(&writer->mutex);
+    if (stream->cur->len > 0)
+    {
+        ARSAL_Writer_Enqueue(writer, stream->cur);
+    }
+    else
+    {
+        ARSAL_Writer_PushFree(writer, stream->cur);
+    }
+    stream->curFirstWrite = 0;
+    ARSAL_Mutex_Unlock(&writer->mutex);
+    stream->cur = NULL;
+}
+
+/**
+ * @brief Wait until the I/O thread processed every request queued on a stream
+ * @note Called with the stream mutex held, takes the writer mutex
+ */
+static eARSAL_ERROR ARSAL_Writer_WaitDone(ARSAL_Writer_Stream_t *stream, eARSAL_WRITER_OP op)
+{
+    ARSAL_Writer_t *writer = stream->writer;
+    eARSAL_ERROR err;
+
+    ARSAL_Mutex_Lock(&writer->mutex);
+    if (op != ARSAL_WRITER_OP_DATA)
+    {
+        stream->marker.op = op;
+        ARSAL_Writer_Enqueue(writer, &stream->marker);
+    }
+    while (stream->done < stream->queued)
+    {
+        ARSAL_Cond_Wait(&writer->doneCond, &writer->mutex);
+    }
+    err = stream->error;
+    stream->error = ARSAL_OK;
+    ARSAL_Mutex_Unlock(&writer->mutex);
+
+    return err;
+}
+
+eARSAL_ERROR ARSAL_Writer_Close(ARSAL_Writer_Stream_t **stream)
+{
+    ARSAL_Writer_Stream_t *s;
+    ARSAL_Writer_Stream_t **prev;
+    ARSAL_Writer_t *writer;
+    eARSAL_ERROR err;
+
+    if ((stream == NULL) || (*stream == NULL))
+    {
+        return ARSAL_ERROR_BAD_PARAMETER;
+    }
+    s = *stream;
+    writer = s->writer;
+
+    ARSAL_Mutex_Lock(&s->mutex);
+    ARSAL_Writer_QueueCurrent(s);
+    err = ARSAL_Writer_WaitDone(s, ARSAL_WRITER_OP_CLOSE);
+    ARSAL_Mutex_Unlock(&s->mutex);
+
+    ARSAL_Mutex_Lock(&writer->mutex);
+    for (prev = &writer->streams; *prev != NULL; prev = &(*prev)->next)
+    {
+        if (*prev == s)
+        {
+            *prev = s->next;
+            break;
+        }
+    }
+    ARSAL_Mutex_Unlock(&writer->mutex);
+
+    ARSAL_Mutex_Destroy(&s->mutex);
+    free(s->path);
+    free(s);
+    *stream = NULL;
+    return err;
+}
+
+eARSAL_ERROR ARSAL_Writer_Flush(ARSAL_Writer_Stream_t *stream, int sync)
+{
+    eARSAL_ERROR err;
+
+    if (stream == NULL)
+    {
+        return ARSAL_ERROR_BAD_PARAMETER;
+    }
+
+    ARSAL_Mutex_Lock(&stream->mutex);
+    ARSAL_Writer_QueueCurrent(stream);
+    err = ARSAL_Writer_WaitDone(stream, sync ? ARSAL_WRITER_OP_SYNC : ARSAL_WRITER_OP_DATA);
+    ARSAL_Mutex_Unlock(&stream->mutex);
+
+    return err;
+}
+
+/**
+ * @brief Number of chunks a write of size bytes needs once the current chunk is full
+ */
+static uint32_t ARSAL_Writer_ChunksNeeded(ARSAL_Writer_Stream_t *stream, size_t size)
+{
+    size_t chunkSize = stream->writer->chunkSize;
+    uint64_t offset = stream->offset;
+    uint32_t n = 0;
+
+    if (stream->cur != NULL)
+    {
+        size_t room = stream->cur->limit - stream->cur->len;
+        if (size <= room)
+        {
+            return 0;
+        }
+        size -= room;
+        offset += room;
+    }
+    while (size > 0)
+    {
+        size_t limit = chunkSize - (size_t)(offset % chunkSize);
+        size_t len = (size < limit) ? size : limit;
+        size -= len;
+        offset += len;
+        n++;
+    }
+    return n;
+}
+
+eARSAL_ERROR ARSAL_Writer_Write(ARSAL_Writer_Stream_t *stream, const void *data, size_t size)
+{
+    ARSAL_Writer_t *writer;
+    ARSAL_Writer_Chunk_t *reserved = NULL;
+    const uint8_t *src = data;
+    eARSAL_ERROR err = ARSAL_OK;
+    size_t remaining = size;
+    ARSAL_Time_Ns_t now;
+
+    if ((stream == NULL) || ((data == NULL) && (size > 0)))
+    {
+        return ARSAL_ERROR_BAD_PARAMETER;
+    }
+    writer = stream->writer;
+
+    ARSAL_Mutex_Lock(&stream->mutex);
+    now = ARSAL_Time_GetMonotonicNs();
+
+    if (stream->backpressure == ARSAL_WRITER_BACKPRESSURE_DROP)
+    {
+        /* Take every chunk needed now, so the write is all or nothing */
+        uint32_t n = ARSAL_Writer_ChunksNeeded(stream, size);
+        ARSAL_Mutex_Lock(&writer->mutex);
+        if (n > writer->nbFree)
+        {
+            writer->stats.bytesDropped += size;
+            stream->stats.bytesDropped += size;
+            err = ARSAL_ERROR_WRITER_FULL;
+            remaining = 0;
+        }
+        while ((err == ARSAL_OK) && (n-- > 0))
+        {
+            ARSAL_Writer_Chunk_t *chunk = ARSAL_Writer_PopFree(writer);
+            chunk->next = reserved;
+            reserved = chunk;
+        }
+        ARSAL_Mutex_Unlock(&writer->mutex);
+    }
+
+    while (remaining > 0)
+    {
+        ARSAL_Writer_Chunk_t *cur = stream->cur;
+        size_t len;
+
+        if (cur == NULL)
+        {
+            if (reserved != NULL)
+            {
+                cur = reserved;
+                reserved = cur->next;
+            }
+            else
+            {
+                ARSAL_Mutex_Lock(&writer->mutex);
+                if (writer->nbFree == 0)
+                {
+                    ARSAL_Time_Ns_t start = ARSAL_Time_GetNs();
+                    writer->stats.blocked++;
+                    stream->stats.blocked++;
+                    while ((writer->nbFree == 0) &&
+                           ((stream->blockTimeoutMs == 0) || (ARSAL_Time_ElapsedNs(start) < (int64_t)MSEC_TO_NSEC((uint64_t)stream->blockTimeoutMs))))
+                    {
+                        ARSAL_Cond_Timedwait(&writer->freeCond, &writer->mutex, (stream->blockTimeoutMs > 0) ? (int)stream->blockTimeoutMs : ARSAL_WRITER_IDLE_WAIT_MS);
+                    }
+                    writer->stats.blockedNs += ARSAL_Time_ElapsedNs(start);
+                    stream->stats.blockedNs += ARSAL_Time_ElapsedNs(start);
+                }
+                if (writer->nbFree == 0)
+                {
+                    writer->stats.bytesDropped += remaining;
+                    stream->stats.bytesDropped += remaining;
+                    ARSAL_Mutex_Unlock(&writer->mutex);
+                    err = ARSAL_ERROR_WRITER_FULL;
+                    break;
+                }
+                cur = ARSAL_Writer_PopFree(writer);
+                ARSAL_Mutex_Unlock(&writer->mutex);
+                now = ARSAL_Time_GetMonotonicNs();
+            }
+
+            cur->stream = stream;
+            cur->op = ARSAL_WRITER_OP_DATA;
+            cur->offset = stream->offset;
+            cur->len = 0;
+            cur->limit = writer->chunkSize - (size_t)(stream->offset % writer->chunkSize);
+            cur->firstWrite = now;
+            stream->cur = cur;
+        }
+
+        len = cur->limit - cur->len;
+        if (len > remaining)
+        {
+            len = remaining;
+        }
+        memcpy(cur->data + cur->len, src, len);
+        cur->len += len;
+        stream->offset += len;
+        src += len;
+        remaining -= len;
+
+        if (cur->len == cur->limit)
+        {
+            ARSAL_Writer_QueueCurrent(stream);
+        }
+    }
+
+    /* Do not keep a slow stream's data in memory for too long */
+    if ((stream->cur != NULL) && (now - stream->cur->firstWrite >= stream->flushPeriodNs))
+    {
+        ARSAL_Writer_QueueCurrent(stream);
+    }
+
+    ARSAL_Mutex_Lock(&writer->mutex);
+    writer->stats.bytesQueued += (size_t)(src - (const uint8_t *)data);
+    stream->stats.bytesQueued += (size_t)(src - (const uint8_t *)data);
+    /* Lets the I/O thread queue the chunk if no write comes within the flush period */
+    stream->curFirstWrite = (stream->cur != NULL) ? stream->cur->firstWrite : 0;
+    ARSAL_Mutex_Unlock(&writer->mutex);
+
+    ARSAL_Mutex_Unlock(&stream->mutex);
+
+    return err;
+}
+
+void ARSAL_Writer_GetStats(ARSAL_Writer_t *writer, ARSAL_Writer_Stats_t *stats)
+{
+    if ((writer == NULL) || (stats == NULL))
+    {
+        return;
+    }
+    ARSAL_Mutex_Lock(&writer->mutex);
+    *stats = writer->stats;
+    ARSAL_Mutex_Unlock(&writer->mutex);
+}
+
+void ARSAL_Writer_GetStreamStats(ARSAL_Writer_Stream_t *stream, ARSAL_Writer_Stats_t *stats)
+{
+    if ((stream == NULL) || (stats == NULL))
+    {
+        return;
+    }
+    ARSAL_Mutex_Lock(&stream->writer->mutex);
+    *stats = stream->stats;
+    stats->queueDepth = stream->writer->stats.queueDepth;
+    stats->maxQueueDepth = stream->writer->stats.maxQueueDepth;
+    ARSAL_Mutex_Unlock(&stream->writer->mutex);
+}
@@ -0,0 +1,223 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file libARSAL/ARSAL_Writer.h
+ * @brief Asynchronous batched file writer
+ * @date 10/18/2026
+ *
+ * A writer owns one I/O thread and a fixed budget of aligned buffers
+ * (chunks) shared by all its streams. ARSAL_Writer_Write() only copies data
+ * into the current chunk of the stream; full chunks are written by the I/O
+ * thread with one pwrite() each, at chunk aligned file offsets. The I/O
+ * thread also preallocates the files with fallocate() and calls
+ * fdatasync() periodically, so the threads producing the data never wait
+ * for the storage, unless they ask to when the chunk budget is exhausted.
+ */
+#ifndef _ARSAL_WRITER_H_
+#define _ARSAL_WRITER_H_
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <libARSAL/ARSAL_Error.h>
+#include <libARSAL/ARSAL_Thread.h>
+
+/**
+ * @brief Alignment of the chunks in memory and in the files (bytes)
+ */
+#define ARSAL_WRITER_ALIGNMENT                  4096
+
+/**
+ * @brief Default chunk size (bytes)
+ */
+#define ARSAL_WRITER_DEFAULT_CHUNK_SIZE         (1024 * 1024)
+
+/**
+ * @brief Default number of chunks
+ */
+#define ARSAL_WRITER_DEFAULT_NB_CHUNKS          16
+
+/**
+ * @brief Default preallocation step (bytes)
+ */
+#define ARSAL_WRITER_DEFAULT_PREALLOC_SIZE      (64 * 1024 * 1024)
+
+/**
+ * @brief Default maximum time data stays in a partially filled chunk (ms)
+ */
+#define ARSAL_WRITER_DEFAULT_FLUSH_PERIOD_MS    1000
+
+/**
+ * @brief Default fdatasync() period (ms)
+ */
+#define ARSAL_WRITER_DEFAULT_SYNC_PERIOD_MS     2000
+
+/**
+ * @brief Writer object type
+ */
+typedef struct ARSAL_Writer_t ARSAL_Writer_t;
+
+/**
+ * @brief Writer stream (an open file) object type
+ */
+typedef struct ARSAL_Writer_Stream_t ARSAL_Writer_Stream_t;
+
+/**
+ * @brief Behavior of ARSAL_Writer_Write() when no chunk is free
+ */
+typedef enum
+{
+    ARSAL_WRITER_BACKPRESSURE_DROP = 0,     /**< Drop the data and return ARSAL_ERROR_WRITER_FULL */
+    ARSAL_WRITER_BACKPRESSURE_BLOCK,        /**< Wait for a chunk, up to blockTimeoutMs */
+} eARSAL_WRITER_BACKPRESSURE;
+
+/**
+ * @brief Writer configuration
+ * @see ARSAL_Writer_New ()
+ */
+typedef struct
+{
+    size_t chunkSize;           /**< Chunk size, rounded up to ARSAL_WRITER_ALIGNMENT. 0 for default */
+    uint32_t nbChunks;          /**< Number of chunks, the memory budget of all streams. 0 for default */
+    ARSAL_Thread_Attr_t attr;   /**< Attributes of the I/O thread */
+} ARSAL_Writer_Config_t;
+
+/**
+ * @brief Stream configuration
+ * @see ARSAL_Writer_Open ()
+ */
+typedef struct
+{
+    eARSAL_WRITER_BACKPRESSURE backpressure;    /**< Behavior when no chunk is free */
+    uint32_t blockTimeoutMs;    /**< Maximum wait for a chunk with ARSAL_WRITER_BACKPRESSURE_BLOCK. 0 to wait forever */
+    size_t preallocSize;        /**< Preallocation step, the file is trimmed on close. 0 for default, SIZE_MAX to disable */
+    uint32_t flushPeriodMs;     /**< Maximum time data stays in a partially filled chunk. 0 for default */
+    uint32_t syncPeriodMs;      /**< fdatasync() period while data is written. 0 for default, UINT32_MAX to disable */
+} ARSAL_Writer_Stream_Config_t;
+
+/**
+ * @brief Writer statistics, for a stream or for all the streams of a writer
+ * @see ARSAL_Writer_GetStats ()
+ */
+typedef struct
+{
+    uint64_t bytesQueued;       /**< Bytes accepted by ARSAL_Writer_Write() */
+    uint64_t bytesWritten;      /**< Bytes written to the files */
+    uint64_t bytesDropped;      /**< Bytes dropped because no chunk was free */
+    uint64_t writes;            /**< Number of pwrite() calls */
+    uint64_t syncs;             /**< Number of fdatasync() calls */
+    uint32_t writeErrors;       /**< Number of failed writes, preallocations or syncs */
+    uint32_t queueDepth;        /**< Chunks waiting for the I/O thread now */
+    uint32_t maxQueueDepth;     /**< Highest queueDepth seen */
+    uint64_t blocked;           /**< Number of times a producer waited for a free chunk */
+    uint64_t blockedNs;         /**< Total time producers waited for free chunks */
+    uint64_t writeLatencyNs;    /**< Total pwrite() time, divide by writes for the average */
+    uint64_t maxWriteLatencyNs; /**< Longest pwrite() */
+    uint64_t maxSyncLatencyNs;  /**< Longest fdatasync() */
+} ARSAL_Writer_Stats_t;
+
+/**
+ * @brief Create a new writer and start its I/O thread
+ * @warning This function allocates memory
+ * @param config The writer configuration (NULL for defaults)
+ * @param[out] error A pointer on the error output (optional, may be NULL)
+ * @return Pointer on the new writer, or NULL on error
+ * @see ARSAL_Writer_Delete ()
+ */
+ARSAL_Writer_t *ARSAL_Writer_New(const ARSAL_Writer_Config_t *config, eARSAL_ERROR *error);
+
+/**
+ * @brief Stop the I/O thread and delete the writer
+ * @warning This function frees memory
+ * @warning All the streams must be closed
+ * @param writer The address of the pointer on the writer
+ * @see ARSAL_Writer_New ()
+ */
+void ARSAL_Writer_Delete(ARSAL_Writer_t **writer);
+
+/**
+ * @brief Create (or truncate) a file and open a stream on it
+ * @warning This function allocates memory
+ * @param writer The writer
+ * @param path The file path
+ * @param config The stream configuration (NULL for defaults: drop on backpressure)
+ * @param[out] error A pointer on the error output (optional, may be NULL)
+ * @return Pointer on the new stream, or NULL on error
+ * @see ARSAL_Writer_Close ()
+ */
+ARSAL_Writer_Stream_t *ARSAL_Writer_Open(ARSAL_Writer_t *writer, const char *path, const ARSAL_Writer_Stream_Config_t *config, eARSAL_ERROR *error);
+
+/**
+ * @brief Write everything queued, sync, trim the preallocated space and close the stream
+ * @warning This function frees memory
+ * @param stream The address of the pointer on the stream
+ * @retval On success, returns ARSAL_OK. Otherwise, it returns an error number of eARSAL_ERROR
+ * @see ARSAL_Writer_Open ()
+ */
+eARSAL_ERROR ARSAL_Writer_Close(ARSAL_Writer_Stream_t **stream);
+
+/**
+ * @brief Queue data to be appended to a stream
+ *
+ * The data is copied into chunks. A write is either queued entirely or,
+ * with ARSAL_WRITER_BACKPRESSURE_DROP, dropped entirely. With
+ * ARSAL_WRITER_BACKPRESSURE_BLOCK a timeout can leave it partially queued.
+ * A stream is written by one thread at a time.
+ *
+ * @param stream The stream
+ * @param data The data
+ * @param size The size of the data
+ * @retval ARSAL_OK if the data was queued, ARSAL_ERROR_WRITER_FULL if it was dropped. Otherwise, it returns an error number of eARSAL_ERROR
+ */
+eARSAL_ERROR ARSAL_Writer_Write(ARSAL_Writer_Stream_t *stream, const void *data, size_t size);
+
+/**
+ * @brief Queue the partially filled chunk of a stream and wait until everything queued is written
+ * @param stream The stream
+ * @param sync Also fdatasync() the file when non zero
+ * @retval On success, returns ARSAL_OK. Otherwise, it returns an error number of eARSAL_ERROR
+ */
+eARSAL_ERROR ARSAL_Writer_Flush(ARSAL_Writer_Stream_t *stream, int sync);
+
+/**
+ * @brief Get the statistics of all the streams of a writer
+ * @param writer The writer
+ * @param[out] stats The statistics
+ */
+void ARSAL_Writer_GetStats(ARSAL_Writer_t *writer, ARSAL_Writer_Stats_t *stats);
+
+/**
+ * @brief Get the statistics of a stream
+ * @param stream The stream
+ * @param[out] stats The statistics (queueDepth and maxQueueDepth are those of the writer, the chunks are shared)
+ */
+void ARSAL_Writer_GetStreamStats(ARSAL_Writer_Stream_t *stream, ARSAL_Writer_Stats_t *stats);
+
+#endif /* _ARSAL_WRITER_H_ */
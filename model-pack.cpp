@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "modelPack.h"
+#include "tiledNet.h"
+#include "commandLine.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <libARSAL/ARSAL_Time.h>
+}
+
+
+#define DEFAULT_MAX_BATCH 2	// imageNet::Create() default
+
+
+/*
+ * Convert a network to a model pack (see modelPack.h) for instant startup.
+ *
+ * The engine is the one tensorNet serialized to its cache on a previous run
+ * (<model>.<max batch>.tensorcache), or with --precision=INT8 the one written
+ * by int8-calibrate (<model>.<max batch>.int8.tensorcache); the
+ * pack adds its bindings, the labels and the device it was built for. The
+ * pack is then loaded back once to check it and time the startup.
+ *
+ * model-pack --model=<caffemodel> --labels=<labels> [--max_batch=2]
+ *            [--engine=<engine>] [--precision=FP16] [--output=<model>.pack]
+ */
+
+
+class Logger : public nvinfer1::ILogger
+{
+	void log( Severity severity, const char* msg )
+	{
+		if( severity != Severity::kINFO )
+			printf("[TRT] %s\n", msg);
+	}
+} gLogger;
+
+
+static bool readFile( const char* path, std::vector<char>& data )
+{
+	FILE* file = path ? fopen(path, "rb") : NULL;
+
+	if( !file )
+		return false;
+
+	char buffer[65536];
+	size_t n;
+
+	while( (n = fread(buffer, 1, sizeof(buffer), file)) > 0 )
+		data.insert(data.end(), buffer, buffer + n);
+
+	fclose(file);
+	return true;
+}
+
+
+int main( int argc, char** argv )
+{
+	commandLine cmdLine(argc, argv);
+
+	const char* model     = cmdLine.GetString("model");
+	const char* labels    = cmdLine.GetString("labels");
+	const char* precision = cmdLine.GetString("precision");
+	const int   maxBatch  = cmdLine.GetInt("max_batch", DEFAULT_MAX_BATCH);
+
+	if( !model && !cmdLine.GetString("engine") )
+	{
+		printf("model-pack:  --model or --engine is required\n");
+		return 1;
+	}
+
+	const bool int8 = (precision != NULL && strcasecmp(precision, "INT8") == 0);
+	const std::string enginePath = cmdLine.GetString("engine") ? cmdLine.GetString("engine") : std::string(model) + "." + std::to_string(maxBatch) + (int8 ? ".int8" : "") + ".tensorcache";
+	const std::string outputPath = cmdLine.GetString("output") ? cmdLine.GetString("output") : std::string(model ? model : enginePath.c_str()) + ".pack";
+
+	std::vector<char> engine;
+	std::vector<char> labelText;
+
+	if( !readFile(enginePath.c_str(), engine) || engine.empty() )
+	{
+		printf("model-pack:  failed to read the engine %s (run the network once to build it, or int8-calibrate)\n", enginePath.c_str());
+		return 1;
+	}
+
+	if( labels != NULL && !readFile(labels, labelText) )
+	{
+		printf("model-pack:  failed to read %s\n", labels);
+		return 1;
+	}
+
+
+	/*
+	 * describe the bindings of the engine
+	 */
+	nvinfer1::IRuntime* runtime = nvinfer1::createInferRuntime(gLogger);
+	nvinfer1::ICudaEngine* cudaEngine = runtime->deserializeCudaEngine(&engine[0], engine.size(), NULL);
+
+	if( !cudaEngine )
+	{
+		printf("model-pack:  %s is not an engine of this TensorRT version\n", enginePath.c_str());
+		return 1;
+	}
+
+	std::string graph = "batch " + std::to_string(cudaEngine->getMaxBatchSize()) + "\n";
+
+	for( int n=0; n < cudaEngine->getNbBindings(); n++ )
+	{
+		const nvinfer1::Dims dims = cudaEngine->getBindingDimensions(n);
+		int chw[3] = { 1, 1, 1 };
+
+		// classifier bindings are CHW, or a flat C
+		for( int d=0; d < dims.nbDims && d < 3; d++ )
+			chw[d] = dims.d[d];
+
+		graph += std::string(cudaEngine->bindingIsInput(n) ? "input " : "output ") + cudaEngine->getBindingName(n) + " "
+			  + std::to_string(chw[0]) + " " + std::to_string(chw[1]) + " " + std::to_string(chw[2]) + "\n";
+	}
+
+	cudaEngine->destroy();
+	runtime->destroy();
+
+	int device = 0;
+	cudaDeviceProp props;
+
+	if( CUDA_FAILED(cudaGetDevice(&device)) || CUDA_FAILED(cudaGetDeviceProperties(&props, device)) )
+		return 1;
+
+	char meta[1024];
+
+	snprintf(meta, sizeof(meta), "tensorrt %i.%i.%i\ndevice %i.%i %s\nsource %s\nprecision %s\n",
+		    NV_TENSORRT_MAJOR, NV_TENSORRT_MINOR, NV_TENSORRT_PATCH, props.major, props.minor, props.name,
+		    enginePath.c_str(), precision ? precision : "unknown");
+
+	printf("model-pack:  graph\n%s", graph.c_str());
+
+
+	/*
+	 * write, then load it back
+	 */
+	const modelPack::Section sections[] = {
+		{ modelPack::ENGINE, &engine[0], engine.size() },
+		{ modelPack::GRAPH,  graph.data(), graph.size() },
+		{ modelPack::LABELS, labelText.empty() ? NULL : &labelText[0], labelText.size() },
+		{ modelPack::META,   meta, strlen(meta) }
+	};
+
+	if( !modelPack::Write(outputPath.c_str(), sections, sizeof(sections) / sizeof(sections[0])) )
+		return 1;
+
+	const ARSAL_Time_Ns_t start = ARSAL_Time_GetMonotonicNs();
+	tiledNet* net = tiledNet::CreateFromPack(outputPath.c_str());
+	const ARSAL_Time_Ns_t elapsed = ARSAL_Time_GetMonotonicNs() - start;
+
+	if( !net )
+	{
+		printf("model-pack:  failed to load %s back\n", outputPath.c_str());
+		return 1;
+	}
+
+	printf("model-pack:  %s loads in %.1f ms, %u classes\n", outputPath.c_str(), elapsed / 1000000.0, net->GetNumClasses());
+
+	delete net;
+	return 0;
+}
@@ -0,0 +1,392 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "modelHolder.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+
+#define LOG_HOLDER "[model] "
+
+#define RELOAD_MESSAGE "reload"
+
+
+static uint64_t monotonicMs()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+
+static bool socketAddress( const char* path, struct sockaddr_un* addr )
+{
+	if( !path || strlen(path) >= sizeof(addr->sun_path) )
+		return false;
+
+	memset(addr, 0, sizeof(*addr));
+	addr->sun_family = AF_UNIX;
+	strcpy(addr->sun_path, path);
+	return true;
+}
+
+
+// constructor
+modelHolder::modelHolder() : mCurrent(NULL), mQuiescent(0), mSwaps(0), mFailures(0), mRun(false), mReload(false)
+{
+	mWidth      = 0;
+	mHeight     = 0;
+	mWarmupCUDA = NULL;
+	mThread     = NULL;
+	mSocketFd   = -1;
+	mWatchFd    = -1;
+	mWakeFd     = -1;
+}
+
+
+// destructor
+modelHolder::~modelHolder()
+{
+	if( mThread != NULL )
+	{
+		mRun = false;
+
+		const uint64_t one = 1;
+		if( write(mWakeFd, &one, sizeof(one)) < 0 )
+			printf(LOG_HOLDER "failed to wake the loader thread\n");
+
+		ARSAL_Thread_Join(mThread, NULL);
+		ARSAL_Thread_Destroy(&mThread);
+	}
+
+	if( mSocketFd >= 0 )
+	{
+		close(mSocketFd);
+		unlink(mSocketPath.c_str());
+	}
+
+	if( mWatchFd >= 0 )
+		close(mWatchFd);
+
+	if( mWakeFd >= 0 )
+		close(mWakeFd);
+
+	if( mWarmupCUDA != NULL )
+		CUDA(cudaFree(mWarmupCUDA));
+
+	delete mCurrent.exchange(NULL);
+}
+
+
+// Create
+modelHolder* modelHolder::Create( imageNet* initial, const Factory& factory, uint32_t width, uint32_t height,
+						    const char* socket, const char* watch )
+{
+	if( !initial || !factory || width == 0 || height == 0 )
+		return NULL;
+
+	modelHolder* holder = new modelHolder();
+
+	holder->mFactory = factory;
+	holder->mWidth   = width;
+	holder->mHeight  = height;
+
+	if( (holder->mWakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) < 0 )
+	{
+		printf(LOG_HOLDER "failed to create the wake up event\n");
+		delete holder;
+		return NULL;
+	}
+
+	if( CUDA_FAILED(cudaMalloc((void**)&holder->mWarmupCUDA, width * height * sizeof(float4))) ||
+	    CUDA_FAILED(cudaMemset(holder->mWarmupCUDA, 0, width * height * sizeof(float4))) )
+	{
+		printf(LOG_HOLDER "failed to allocate the warm up frame\n");
+		delete holder;
+		return NULL;
+	}
+
+	/*
+	 * control socket, replacing the one a previous instance left behind
+	 */
+	struct sockaddr_un addr;
+
+	if( socket != NULL && socketAddress(socket, &addr) )
+	{
+		unlink(socket);
+
+		holder->mSocketFd = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+
+		if( holder->mSocketFd < 0 || bind(holder->mSocketFd, (struct sockaddr*)&addr, sizeof(addr)) != 0 )
+		{
+			printf(LOG_HOLDER "failed to bind the control socket %s\n", socket);
+
+			if( holder->mSocketFd >= 0 )
+				close(holder->mSocketFd);
+
+			holder->mSocketFd = -1;
+		}
+		else
+			holder->mSocketPath = socket;
+	}
+
+	/*
+	 * watch the directory, so replacing the file by a rename is seen too
+	 */
+	if( watch != NULL )
+	{
+		const std::string path(watch);
+		const size_t slash = path.rfind('/');
+
+		holder->mWatchDir  = (slash == std::string::npos) ? "." : path.substr(0, slash + 1);
+		holder->mWatchName = (slash == std::string::npos) ? path : path.substr(slash + 1);
+		holder->mWatchFd   = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+
+		if( holder->mWatchFd < 0 || inotify_add_watch(holder->mWatchFd, holder->mWatchDir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0 )
+		{
+			printf(LOG_HOLDER "failed to watch %s\n", watch);
+
+			if( holder->mWatchFd >= 0 )
+				close(holder->mWatchFd);
+
+			holder->mWatchFd = -1;
+		}
+	}
+
+	ARSAL_Thread_Attr_t attr;
+	ARSAL_Thread_GetRoleAttr("model_loader", &attr);
+
+	if( attr.name[0] == '\0' )
+		strncpy(attr.name, "model-loader", sizeof(attr.name) - 1);
+
+	// the holder owns the network from now on, unless it fails to start
+	holder->mCurrent = initial;
+	holder->mRun     = true;
+
+	if( ARSAL_Thread_CreateEx(&holder->mThread, threadEntry, holder, &attr) != 0 )
+	{
+		printf(LOG_HOLDER "failed to start the loader thread\n");
+		holder->mThread  = NULL;
+		holder->mCurrent = NULL;
+		delete holder;
+		return NULL;
+	}
+
+	printf(LOG_HOLDER "hot swap on %s%s%s\n", holder->mSocketFd >= 0 ? socket : "Reload()",
+		  holder->mWatchFd >= 0 ? " and changes of " : "", holder->mWatchFd >= 0 ? watch : "");
+
+	return holder;
+}
+
+
+// Acquire
+imageNet* modelHolder::Acquire()
+{
+	// quiescent state first: the loader may free what was acquired before this point
+	mQuiescent.fetch_add(1);
+	return mCurrent.load();
+}
+
+
+// Reload
+void modelHolder::Reload()
+{
+	// the loader thread is the only one which loads
+	mReload = true;
+
+	const uint64_t one = 1;
+
+	if( write(mWakeFd, &one, sizeof(one)) < 0 )
+		printf(LOG_HOLDER "failed to wake the loader thread\n");
+}
+
+
+// SendReload
+bool modelHolder::SendReload( const char* socket )
+{
+	struct sockaddr_un addr;
+
+	if( !socketAddress(socket, &addr) )
+		return false;
+
+	const int fd = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+
+	if( fd < 0 )
+		return false;
+
+	const bool ok = sendto(fd, RELOAD_MESSAGE, strlen(RELOAD_MESSAGE), 0, (struct sockaddr*)&addr, sizeof(addr)) >= 0;
+
+	close(fd);
+	return ok;
+}
+
+
+// threadEntry
+void* modelHolder::threadEntry( void* arg )
+{
+	((modelHolder*)arg)->run();
+	return NULL;
+}
+
+
+// run
+void modelHolder::run()
+{
+	uint64_t settleDeadline = 0;	// pending file change, reloaded when quiet
+
+	while( mRun )
+	{
+		struct pollfd fds[3];
+		int count = 0;
+
+		fds[count].fd = mWakeFd;   fds[count++].events = POLLIN;
+
+		if( mSocketFd >= 0 ) { fds[count].fd = mSocketFd; fds[count++].events = POLLIN; }
+		if( mWatchFd >= 0 )  { fds[count].fd = mWatchFd;  fds[count++].events = POLLIN; }
+
+		int timeout = -1;
+
+		if( settleDeadline != 0 )
+		{
+			const uint64_t now = monotonicMs();
+			timeout = (settleDeadline > now) ? (int)(settleDeadline - now) : 0;
+		}
+
+		if( poll(fds, count, timeout) < 0 )
+			continue;
+
+		if( !mRun )
+			break;
+
+		bool reload = false;
+
+		for( int n=0; n < count; n++ )
+		{
+			if( !(fds[n].revents & POLLIN) )
+				continue;
+
+			if( fds[n].fd == mWakeFd )
+			{
+				uint64_t value = 0;
+
+				if( read(mWakeFd, &value, sizeof(value)) == sizeof(value) )
+					reload |= mReload.exchange(false);
+			}
+			else if( fds[n].fd == mSocketFd )
+			{
+				char message[64];
+				ssize_t size;
+
+				while( (size = recv(mSocketFd, message, sizeof(message) - 1, 0)) > 0 )
+				{
+					message[size] = 0;
+
+					if( strncmp(message, RELOAD_MESSAGE, strlen(RELOAD_MESSAGE)) == 0 )
+						reload = true;
+					else
+						printf(LOG_HOLDER "unknown control message '%s'\n", message);
+				}
+			}
+			else if( fds[n].fd == mWatchFd )
+			{
+				char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+				ssize_t size;
+
+				while( (size = read(mWatchFd, events, sizeof(events))) > 0 )
+				{
+					for( char* p=events; p < events + size; p += sizeof(struct inotify_event) + ((struct inotify_event*)p)->len )
+					{
+						const struct inotify_event* event = (const struct inotify_event*)p;
+
+						// a copy in progress keeps pushing the deadline back
+						if( event->len > 0 && mWatchName == event->name )
+							settleDeadline = monotonicMs() + MODEL_HOLDER_SETTLE_MS;
+					}
+				}
+			}
+		}
+
+		if( settleDeadline != 0 && monotonicMs() >= settleDeadline )
+		{
+			settleDeadline = 0;
+			reload = true;
+		}
+
+		if( reload )
+			load();
+	}
+}
+
+
+// warmup
+bool modelHolder::warmup( imageNet* net )
+{
+	float confidence = 0.0f;
+
+	if( net->Classify((float*)mWarmupCUDA, mWidth, mHeight, &confidence) < 0 )
+		return false;
+
+	return !CUDA_FAILED(cudaDeviceSynchronize());
+}
+
+
+// load
+void modelHolder::load()
+{
+	const uint64_t start = monotonicMs();
+
+	printf(LOG_HOLDER "loading the new network\n");
+
+	imageNet* net = mFactory();
+
+	if( !net || !warmup(net) )
+	{
+		printf(LOG_HOLDER "failed to load the new network, keeping the current one\n");
+		delete net;
+		mFailures++;
+		return;
+	}
+
+	/*
+	 * publish, then wait for the inference loop to go through a quiescent
+	 * state: any Acquire() after the snapshot returns the new network
+	 */
+	imageNet* old = mCurrent.exchange(net);
+	const uint64_t snapshot = mQuiescent.load();
+
+	mSwaps++;
+	printf(LOG_HOLDER "new network swapped in after %llu ms\n", (unsigned long long)(monotonicMs() - start));
+
+	while( mQuiescent.load() == snapshot && mRun )
+		usleep(1000);
+
+	// on shutdown the loop is gone, nothing holds the old network either
+	delete old;
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __MODEL_HOLDER_H__
+#define __MODEL_HOLDER_H__
+
+
+#include "imageNet.h"
+
+#include <atomic>
+#include <functional>
+#include <string>
+
+extern "C" {
+#include <libARSAL/ARSAL_Thread.h>
+}
+
+
+/**
+ * Default control socket of the holder
+ */
+#define MODEL_HOLDER_DEFAULT_SOCKET "/tmp/imagenet_model.sock"
+
+/**
+ * Quiet time after the last change of a watched file before it is reloaded
+ */
+#define MODEL_HOLDER_SETTLE_MS 500
+
+
+/**
+ * Network which can be replaced while the capture pipeline keeps running.
+ *
+ * A reload is requested with Reload(), by a "reload" datagram on the control
+ * socket (see SendReload()) or by a change of the watched model file. The new
+ * network is created and warmed up (one classification, which allocates
+ * everything TensorRT defers to the first run) on a background thread, then
+ * published atomically: the inference loop picks it up at its next Acquire().
+ *
+ * The old network is freed RCU style, once the loop has gone through a
+ * quiescent state, i.e. called Acquire() again, which proves it is done with
+ * the pointer it had. The loop never waits for a load, and if the new network
+ * fails to load the old one just stays.
+ */
+class modelHolder
+{
+public:
+	/**
+	 * Creates a network, NULL on failure. Called from the background thread on reloads.
+	 */
+	typedef std::function<imageNet*()> Factory;
+
+	/**
+	 * Create a holder.
+	 * @param initial network in use until the first reload, owned by the holder once created
+	 * @param width, height frame size used for the warm up
+	 * @param socket control socket path, NULL for none
+	 * @param watch file whose replacement triggers a reload, NULL for none
+	 */
+	static modelHolder* Create( imageNet* initial, const Factory& factory, uint32_t width, uint32_t height,
+						   const char* socket=MODEL_HOLDER_DEFAULT_SOCKET, const char* watch=NULL );
+
+	/**
+	 * Stop the background thread, free the networks
+	 */
+	~modelHolder();
+
+	/**
+	 * Get the network for this frame, only from the inference loop. Also a
+	 * quiescent state: the network returned by the previous call may be freed.
+	 */
+	imageNet* Acquire();
+
+	/**
+	 * Ask for a reload
+	 */
+	void Reload();
+
+	/**
+	 * Ask the holder listening on a control socket for a reload
+	 */
+	static bool SendReload( const char* socket=MODEL_HOLDER_DEFAULT_SOCKET );
+
+	/**
+	 * Number of networks swapped in, and of reloads which failed
+	 */
+	inline uint32_t GetNumSwaps() const			{ return mSwaps.load(); }
+	inline uint32_t GetNumFailures() const			{ return mFailures.load(); }
+
+protected:
+	modelHolder();
+
+	static void* threadEntry( void* arg );
+
+	void run();
+	void load();
+	bool warmup( imageNet* net );
+
+	Factory     mFactory;
+	std::string mSocketPath;
+	std::string mWatchDir;
+	std::string mWatchName;
+
+	uint32_t mWidth;
+	uint32_t mHeight;
+	float4*  mWarmupCUDA;
+
+	std::atomic<imageNet*> mCurrent;
+	std::atomic<uint64_t>  mQuiescent;
+	std::atomic<uint32_t>  mSwaps;
+	std::atomic<uint32_t>  mFailures;
+	std::atomic<bool>      mRun;
+	std::atomic<bool>      mReload;
+
+	ARSAL_Thread_t mThread;
+	int mSocketFd;
+	int mWatchFd;
+	int mWakeFd;
+};
+
+
+#endif
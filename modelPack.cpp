@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "modelPack.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+#define LOG_PACK "[pack] "
+
+
+static inline size_t alignUp( size_t value )
+{
+	return (value + MODEL_PACK_ALIGNMENT - 1) & ~(size_t)(MODEL_PACK_ALIGNMENT - 1);
+}
+
+
+// constructor
+modelPack::modelPack()
+{
+	mData = NULL;
+	mSize = 0;
+}
+
+
+// destructor
+modelPack::~modelPack()
+{
+	if( mData != NULL )
+	{
+		munmap((void*)mData, mSize);
+		mData = NULL;
+	}
+}
+
+
+// Open
+modelPack* modelPack::Open( const char* path )
+{
+	const int fd = path ? open(path, O_RDONLY | O_CLOEXEC) : -1;
+
+	if( fd < 0 )
+	{
+		printf(LOG_PACK "failed to open %s\n", path);
+		return NULL;
+	}
+
+	struct stat st;
+	void* data = MAP_FAILED;
+
+	if( fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(Header) )
+		data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+	// the mapping holds its own reference to the file
+	close(fd);
+
+	if( data == MAP_FAILED )
+	{
+		printf(LOG_PACK "failed to map %s\n", path);
+		return NULL;
+	}
+
+	modelPack* pack = new modelPack();
+
+	pack->mPath = path;
+	pack->mData = (const uint8_t*)data;
+	pack->mSize = st.st_size;
+
+	const Header* header = (const Header*)pack->mData;
+	const size_t  table  = sizeof(Header) + (size_t)header->numSections * sizeof(Entry);
+
+	bool valid = memcmp(header->magic, MODEL_PACK_MAGIC, 8) == 0
+			  && header->version == MODEL_PACK_VERSION
+			  && header->fileSize == pack->mSize
+			  && header->numSections < 1024
+			  && table <= pack->mSize;
+
+	const Entry* entries = (const Entry*)(pack->mData + sizeof(Header));
+
+	for( uint32_t n=0; valid && n < header->numSections; n++ )
+		valid = (entries[n].offset >= table && entries[n].size <= pack->mSize && entries[n].offset <= pack->mSize - entries[n].size);
+
+	if( !valid )
+	{
+		printf(LOG_PACK "%s is not a version %i model pack\n", path, MODEL_PACK_VERSION);
+		delete pack;
+		return NULL;
+	}
+
+	// the whole engine is read right away
+	madvise(data, pack->mSize, MADV_WILLNEED);
+
+	return pack;
+}
+
+
+// GetSection
+const void* modelPack::GetSection( uint32_t type, size_t* size ) const
+{
+	const Header* header  = (const Header*)mData;
+	const Entry*  entries = (const Entry*)(mData + sizeof(Header));
+
+	for( uint32_t n=0; n < header->numSections; n++ )
+	{
+		if( entries[n].type != type )
+			continue;
+
+		if( size != NULL )
+			*size = entries[n].size;
+
+		return mData + entries[n].offset;
+	}
+
+	return NULL;
+}
+
+
+// GetLines
+bool modelPack::GetLines( uint32_t type, std::vector<std::vector<std::string> >& lines ) const
+{
+	size_t size = 0;
+	const char* text = (const char*)GetSection(type, &size);
+
+	if( !text )
+		return false;
+
+	const char* end = text + size;
+
+	while( text < end )
+	{
+		const char* eol = (const char*)memchr(text, '\n', end - text);
+
+		if( !eol )
+			eol = end;
+
+		std::vector<std::string> words;
+		const char* p = text;
+
+		while( p < eol )
+		{
+			while( p < eol && (*p == ' ' || *p == '\t' || *p == '\r') )
+				p++;
+
+			const char* word = p;
+
+			while( p < eol && *p != ' ' && *p != '\t' && *p != '\r' )
+				p++;
+
+			if( p > word )
+				words.push_back(std::string(word, p - word));
+		}
+
+		if( !words.empty() )
+			lines.push_back(words);
+
+		text = eol + 1;
+	}
+
+	return true;
+}
+
+
+// Write
+bool modelPack::Write( const char* path, const Section* sections, uint32_t numSections )
+{
+	if( !path || (!sections && numSections > 0) )
+		return false;
+
+	// layout
+	std::vector<Entry> entries(numSections);
+	size_t offset = alignUp(sizeof(Header) + numSections * sizeof(Entry));
+
+	for( uint32_t n=0; n < numSections; n++ )
+	{
+		entries[n].type     = sections[n].type;
+		entries[n].reserved = 0;
+		entries[n].offset   = offset;
+		entries[n].size     = sections[n].size;
+
+		offset = alignUp(offset + sections[n].size);
+	}
+
+	Header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, MODEL_PACK_MAGIC, 8);
+
+	header.version     = MODEL_PACK_VERSION;
+	header.numSections = numSections;
+	header.alignment   = MODEL_PACK_ALIGNMENT;
+	header.fileSize    = offset;
+
+	const std::string tmpPath = std::string(path) + ".tmp";
+	FILE* file = fopen(tmpPath.c_str(), "wb");
+
+	if( !file )
+	{
+		printf(LOG_PACK "failed to create %s\n", tmpPath.c_str());
+		return false;
+	}
+
+	bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+		   && (numSections == 0 || fwrite(&entries[0], sizeof(Entry), numSections, file) == numSections);
+
+	for( uint32_t n=0; ok && n < numSections; n++ )
+	{
+		ok = fseek(file, entries[n].offset, SEEK_SET) == 0
+		  && (sections[n].size == 0 || fwrite(sections[n].data, sections[n].size, 1, file) == 1);
+	}
+
+	// pad the last section to the announced size
+	ok = ok && ftruncate(fileno(file), header.fileSize) == 0;
+	ok = (fclose(file) == 0) && ok;
+
+	if( !ok || rename(tmpPath.c_str(), path) != 0 )
+	{
+		printf(LOG_PACK "failed to write %s\n", path);
+		unlink(tmpPath.c_str());
+		return false;
+	}
+
+	printf(LOG_PACK "wrote %s (%u sections, %zu bytes)\n", path, numSections, (size_t)header.fileSize);
+	return true;
+}
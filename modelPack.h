@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __MODEL_PACK_H__
+#define __MODEL_PACK_H__
+
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+
+/**
+ * Alignment of the sections in the file, one page
+ */
+#define MODEL_PACK_ALIGNMENT 4096
+
+#define MODEL_PACK_MAGIC   "MODLPACK"
+#define MODEL_PACK_VERSION 1
+
+
+/**
+ * Single file model package, read in place through mmap().
+ *
+ * A pack holds everything needed to run a network without parsing or
+ * building anything: the serialized TensorRT engine (layers already fused,
+ * weights already converted to the engine precision and layout), the
+ * bindings of the network, the class descriptions and the build metadata.
+ *
+ * Layout: a header, a section table, then the page aligned sections.
+ * Integers are little endian. Text sections are plain "key values" lines.
+ *
+ *   header   magic[8] version:u32 numSections:u32 alignment:u32 reserved:u32 fileSize:u64
+ *   section  type:u32 reserved:u32 offset:u64 size:u64
+ *
+ * Since the file is mapped read-only, every process loading the same pack
+ * shares the one copy of it in the page cache.
+ */
+class modelPack
+{
+public:
+	/**
+	 * Section types
+	 */
+	enum SectionType
+	{
+		ENGINE = 1,	/**< Serialized TensorRT engine */
+		GRAPH  = 2,	/**< Bindings: "batch <n>", "input <name> <c> <h> <w>", "output <name> <c> <h> <w>" */
+		LABELS = 3,	/**< Class descriptions, one per line */
+		META   = 4	/**< Build information: "tensorrt <version>", "device <cc> <name>", "source <path>", "precision <p>" */
+	};
+
+	/**
+	 * Section to write
+	 */
+	struct Section
+	{
+		uint32_t    type;
+		const void* data;
+		size_t      size;
+	};
+
+	/**
+	 * Map a pack and check its header and section table.
+	 */
+	static modelPack* Open( const char* path );
+
+	/**
+	 * Write a pack, to a temporary file renamed over path, so the processes
+	 * which mapped the previous version keep a consistent copy.
+	 */
+	static bool Write( const char* path, const Section* sections, uint32_t numSections );
+
+	/**
+	 * Unmap
+	 */
+	~modelPack();
+
+	/**
+	 * Find a section.
+	 * @returns the section in the mapping, NULL if the pack has none of this type
+	 */
+	const void* GetSection( uint32_t type, size_t* size ) const;
+
+	/**
+	 * Lines of a text section, split in words
+	 */
+	bool GetLines( uint32_t type, std::vector<std::vector<std::string> >& lines ) const;
+
+	/**
+	 * Path and size of the mapped file
+	 */
+	inline const char* GetPath() const			{ return mPath.c_str(); }
+	inline size_t GetSize() const				{ return mSize; }
+
+protected:
+	modelPack();
+
+	struct Header
+	{
+		char     magic[8];
+		uint32_t version;
+		uint32_t numSections;
+		uint32_t alignment;
+		uint32_t reserved;
+		uint64_t fileSize;
+	};
+
+	struct Entry
+	{
+		uint32_t type;
+		uint32_t reserved;
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	std::string    mPath;
+	const uint8_t* mData;
+	size_t         mSize;
+};
+
+
+#endif
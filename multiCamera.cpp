@@ -0,0 +1,464 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "multiCamera.h"
+
+#include "gstCamera.h"
+#include "ringCamera.h"
+#include "cudaUtility.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+
+#define LOG_MULTI "[multi] "
+
+#define CAPTURE_TIMEOUT_MS 1000	// capture threads check for shutdown at this rate
+#define LATENCY_WEIGHT 0.2f		// weight of the last pass in the average cost of a batch size
+
+
+// constructor
+multiCamera::multiCamera()
+{
+	mRun      = false;
+	mDeadline = 0;
+	mBatches  = 0;
+	mFrames   = 0;
+	mLate     = 0;
+
+	memset(mLatency, 0, sizeof(mLatency));
+
+	ARSAL_Mutex_Init(&mMutex);
+	ARSAL_Cond_Init(&mCond);
+}
+
+
+// destructor
+multiCamera::~multiCamera()
+{
+	mRun = false;
+
+	for( size_t n=0; n < mSources.size(); n++ )
+	{
+		Source* source = mSources[n];
+
+		if( source->thread != NULL )
+		{
+			ARSAL_Thread_Join(source->thread, NULL);
+			ARSAL_Thread_Destroy(&source->thread);
+		}
+
+		delete source->camera;
+		delete source->ring;
+
+		for( int i=0; i < 3; i++ )
+		{
+			if( source->buffers[i] != NULL )
+				CUDA(cudaFree(source->buffers[i]));
+		}
+
+		delete source;
+	}
+
+	ARSAL_Cond_Destroy(&mCond);
+	ARSAL_Mutex_Destroy(&mMutex);
+}
+
+
+// Create
+multiCamera* multiCamera::Create( const char* sources, uint32_t deadlineMs )
+{
+	if( !sources || deadlineMs == 0 )
+		return NULL;
+
+	multiCamera* cam = new multiCamera();
+
+	cam->mDeadline = MSEC_TO_NSEC((ARSAL_Time_Ns_t)deadlineMs);
+
+	const std::string list(sources);
+	size_t begin = 0;
+
+	while( begin <= list.size() )
+	{
+		size_t end = list.find(',', begin);
+
+		if( end == std::string::npos )
+			end = list.size();
+
+		if( end > begin && !cam->addSource(list.substr(begin, end - begin)) )
+		{
+			delete cam;
+			return NULL;
+		}
+
+		begin = end + 1;
+	}
+
+	if( cam->mSources.empty() )
+	{
+		printf(LOG_MULTI "no source in '%s'\n", sources);
+		delete cam;
+		return NULL;
+	}
+
+	/*
+	 * start one capture thread per source
+	 */
+	cam->mRun = true;
+
+	for( size_t n=0; n < cam->mSources.size(); n++ )
+	{
+		Source* source = cam->mSources[n];
+
+		ARSAL_Thread_Attr_t attr;
+		ARSAL_Thread_GetRoleAttr("capture", &attr);
+
+		if( attr.name[0] == '\0' )
+			snprintf(attr.name, sizeof(attr.name), "capture-%u", (uint32_t)n);
+
+		if( ARSAL_Thread_CreateEx(&source->thread, threadEntry, source, &attr) != 0 )
+		{
+			printf(LOG_MULTI "failed to start the capture thread of %s\n", source->name.c_str());
+			source->thread = NULL;
+			delete cam;
+			return NULL;
+		}
+	}
+
+	printf(LOG_MULTI "%zu sources, %u ms deadline\n", cam->mSources.size(), deadlineMs);
+	return cam;
+}
+
+
+// addSource
+bool multiCamera::addSource( const std::string& spec )
+{
+	if( mSources.size() >= MULTI_MAX_SOURCES )
+	{
+		printf(LOG_MULTI "too many sources, at most %i\n", MULTI_MAX_SOURCES);
+		return false;
+	}
+
+	Source* source = new Source();
+
+	source->name     = spec;
+	source->index    = mSources.size();
+	source->camera   = NULL;
+	source->ring     = NULL;
+	source->thread   = NULL;
+	source->owner    = this;
+	source->width    = 0;
+	source->height   = 0;
+	source->write    = 0;
+	source->ready    = 1;
+	source->read     = 2;
+	source->fresh    = false;
+	source->sequence = 0;
+	source->dropped  = 0;
+
+	source->readySequence  = 0;
+	source->readyTimestamp = 0;
+
+	memset(source->buffers, 0, sizeof(source->buffers));
+	mSources.push_back(source);
+
+	/*
+	 * csi, v4l2:<n> or ring:<name>
+	 */
+	if( spec == "csi" || spec == "csi:0" )
+	{
+		// gstCamera only knows one onboard camera
+		for( size_t n=0; n + 1 < mSources.size(); n++ )
+		{
+			if( mSources[n]->camera != NULL && mSources[n]->name.compare(0, 3, "csi") == 0 )
+			{
+				printf(LOG_MULTI "the onboard camera is already a source, csi can only be given once\n");
+				return false;
+			}
+		}
+
+		source->camera = gstCamera::Create(-1);
+	}
+	else if( spec.compare(0, 5, "v4l2:") == 0 )
+		source->camera = gstCamera::Create(atoi(spec.c_str() + 5));
+	else if( spec.compare(0, 5, "ring:") == 0 )
+		source->ring = ringCamera::Create(spec.c_str() + 5);
+	else
+	{
+		printf(LOG_MULTI "unknown source '%s', expected csi, v4l2:<n> or ring:<name>\n", spec.c_str());
+		return false;
+	}
+
+	if( !source->camera && !source->ring )
+	{
+		printf(LOG_MULTI "failed to open %s\n", spec.c_str());
+		return false;
+	}
+
+	if( source->camera != NULL && !source->camera->Open() )
+	{
+		printf(LOG_MULTI "failed to open %s for streaming\n", spec.c_str());
+		return false;
+	}
+
+	source->width  = source->ring ? source->ring->GetWidth()  : source->camera->GetWidth();
+	source->height = source->ring ? source->ring->GetHeight() : source->camera->GetHeight();
+
+	for( int i=0; i < 3; i++ )
+	{
+		if( CUDA_FAILED(cudaMalloc((void**)&source->buffers[i], source->width * source->height * sizeof(float4))) )
+		{
+			printf(LOG_MULTI "failed to allocate the frames of %s\n", spec.c_str());
+			return false;
+		}
+	}
+
+	printf(LOG_MULTI "source %u: %s, %ux%u\n", source->index, spec.c_str(), source->width, source->height);
+	return true;
+}
+
+
+// threadEntry
+void* multiCamera::threadEntry( void* arg )
+{
+	Source* source = (Source*)arg;
+	source->owner->capture(source);
+	return NULL;
+}
+
+
+// capture
+void multiCamera::capture( Source* source )
+{
+	const size_t size = source->width * source->height * sizeof(float4);
+
+	while( mRun )
+	{
+		void* imgCPU  = NULL;
+		void* imgCUDA = NULL;
+		void* imgRGBA = NULL;
+		bool  ok      = false;
+
+		ARSAL_Time_Ns_t timestamp;
+
+		if( source->ring != NULL )
+		{
+			if( !source->ring->Capture(&imgCPU, &imgCUDA, CAPTURE_TIMEOUT_MS) )
+				continue;
+
+			timestamp = source->ring->GetTimestamp();
+			ok = source->ring->ConvertRGBA(imgCUDA, &imgRGBA);
+		}
+		else
+		{
+			if( !source->camera->Capture(&imgCPU, &imgCUDA, CAPTURE_TIMEOUT_MS) )
+				continue;
+
+			timestamp = ARSAL_Time_GetMonotonicNs();
+			ok = source->camera->ConvertRGBA(imgCUDA, &imgRGBA);
+		}
+
+		// the camera reuses its RGBA buffer on the next capture, keep a copy
+		if( ok )
+			ok = !CUDA_FAILED(cudaMemcpy(source->buffers[source->write], imgRGBA, size, cudaMemcpyDeviceToDevice));
+
+		if( source->ring != NULL )
+			source->ring->Release();
+
+		if( !ok )
+		{
+			printf(LOG_MULTI "failed to convert a frame of %s\n", source->name.c_str());
+			continue;
+		}
+
+		/*
+		 * publish: the frame becomes the ready one, replacing any frame
+		 * which was not picked up in time
+		 */
+		ARSAL_Mutex_Lock(&mMutex);
+
+		if( source->fresh )
+			source->dropped++;
+
+		std::swap(source->write, source->ready);
+
+		source->fresh          = true;
+		source->readySequence  = ++source->sequence;
+		source->readyTimestamp = timestamp;
+
+		ARSAL_Cond_Signal(&mCond);
+		ARSAL_Mutex_Unlock(&mMutex);
+	}
+}
+
+
+// predict
+float multiCamera::predict( uint32_t batch ) const
+{
+	if( mLatency[batch] > 0.0f )
+		return mLatency[batch];
+
+	// scale up the biggest smaller batch measured
+	for( uint32_t n=batch-1; n > 0; n-- )
+	{
+		if( mLatency[n] > 0.0f )
+			return mLatency[n] * batch / n;
+	}
+
+	// a bigger batch costs at least as much
+	for( uint32_t n=batch+1; n <= MULTI_MAX_SOURCES; n++ )
+	{
+		if( mLatency[n] > 0.0f )
+			return mLatency[n];
+	}
+
+	// nothing measured yet: run right away with what is there
+	return (float)mDeadline;
+}
+
+
+// Process
+int multiCamera::Process( tiledNet* net, Result* results )
+{
+	if( !net || !results )
+		return -1;
+
+	const uint32_t numSources = mSources.size();
+	const uint32_t maxBatch   = std::min(net->GetMaxBatchSize(), numSources);
+
+	Source* pending[MULTI_MAX_SOURCES];
+	uint32_t numPending = 0;
+
+	// oldest frame first
+	auto collect = [&]()
+	{
+		numPending = 0;
+
+		for( uint32_t n=0; n < numSources; n++ )
+		{
+			if( mSources[n]->fresh )
+				pending[numPending++] = mSources[n];
+		}
+
+		std::sort(pending, pending + numPending, [](const Source* a, const Source* b) { return a->readyTimestamp < b->readyTimestamp; });
+	};
+
+	ARSAL_Mutex_Lock(&mMutex);
+
+	/*
+	 * wait for a first frame
+	 */
+	const ARSAL_Time_Ns_t start = ARSAL_Time_GetMonotonicNs();
+
+	for( collect(); numPending == 0; collect() )
+	{
+		const ARSAL_Time_Ns_t now = ARSAL_Time_GetMonotonicNs();
+
+		if( now >= start + mDeadline )
+		{
+			ARSAL_Mutex_Unlock(&mMutex);
+			return 0;
+		}
+
+		ARSAL_Cond_Timedwait(&mCond, &mMutex, (int)NSEC_TO_MSEC(start + mDeadline - now) + 1);
+	}
+
+	/*
+	 * wait for more sources as long as the next bigger batch would still
+	 * finish before the deadline of the oldest frame
+	 */
+	const ARSAL_Time_Ns_t deadline = pending[0]->readyTimestamp + mDeadline;
+
+	while( numPending < maxBatch )
+	{
+		const ARSAL_Time_Ns_t now    = ARSAL_Time_GetMonotonicNs();
+		const ARSAL_Time_Ns_t latest = deadline - std::min((ARSAL_Time_Ns_t)predict(numPending + 1), mDeadline);
+
+		if( now + MSEC_TO_NSEC(1) >= latest )
+			break;
+
+		ARSAL_Cond_Timedwait(&mCond, &mMutex, (int)NSEC_TO_MSEC(latest - now));
+		collect();
+	}
+
+	/*
+	 * the biggest batch which fits in the slack, at least one frame
+	 */
+	const ARSAL_Time_Ns_t now = ARSAL_Time_GetMonotonicNs();
+	uint32_t batch = std::min(numPending, maxBatch);
+
+	while( batch > 1 && now + predict(batch) > deadline )
+		batch--;
+
+	float*   frames[MULTI_MAX_SOURCES];
+	uint32_t widths[MULTI_MAX_SOURCES];
+	uint32_t heights[MULTI_MAX_SOURCES];
+
+	for( uint32_t n=0; n < batch; n++ )
+	{
+		Source* source = pending[n];
+
+		std::swap(source->ready, source->read);
+		source->fresh = false;
+
+		frames[n]  = source->buffers[source->read];
+		widths[n]  = source->width;
+		heights[n] = source->height;
+
+		results[n].source     = source->index;
+		results[n].sequence   = source->readySequence;
+		results[n].timestamp  = source->readyTimestamp;
+		results[n].classID    = -1;
+		results[n].confidence = 0.0f;
+	}
+
+	ARSAL_Mutex_Unlock(&mMutex);
+
+	/*
+	 * one pass for every source, then learn its cost
+	 */
+	tiledNet::Result classes[MULTI_MAX_SOURCES];
+
+	if( !net->ClassifyFrames(frames, widths, heights, classes, batch) )
+		return -1;
+
+	const ARSAL_Time_Ns_t end = ARSAL_Time_GetMonotonicNs();
+	const float elapsed = (float)(end - now);
+
+	mLatency[batch] = (mLatency[batch] > 0.0f) ? (1.0f - LATENCY_WEIGHT) * mLatency[batch] + LATENCY_WEIGHT * elapsed : elapsed;
+
+	for( uint32_t n=0; n < batch; n++ )
+	{
+		results[n].classID    = classes[n].classID;
+		results[n].confidence = classes[n].confidence;
+
+		if( end > results[n].timestamp + mDeadline )
+			mLate++;
+	}
+
+	mBatches++;
+	mFrames += batch;
+
+	return batch;
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __MULTI_CAMERA_H__
+#define __MULTI_CAMERA_H__
+
+
+#include "tiledNet.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Thread.h>
+#include <libARSAL/ARSAL_Time.h>
+}
+
+class gstCamera;
+class ringCamera;
+
+
+/**
+ * Maximum number of sources
+ */
+#define MULTI_MAX_SOURCES 8
+
+/**
+ * Default time a frame may wait for its result, capture to classification
+ */
+#define MULTI_DEFAULT_DEADLINE_MS 100
+
+
+/**
+ * Several cameras feeding one network.
+ *
+ * Sources are given as a comma separated list of csi (the onboard camera,
+ * at most once), v4l2:<n> (/dev/video<n>) and ring:<name> (frames published
+ * by the stream receiver, see ringCamera). Each source is read by its own capture thread,
+ * which converts the frame to RGBA and keeps only the latest one, so a slow
+ * network drops frames rather than queueing them.
+ *
+ * Process() classifies the pending frames of every source in a single
+ * batched pass. The batch size follows the deadline slack of the oldest
+ * pending frame: while a bigger batch still fits before the deadline, it
+ * waits for more sources to deliver, otherwise it runs with what it has.
+ * The cost of each batch size is learned from the passes already run.
+ */
+class multiCamera
+{
+public:
+	/**
+	 * Classification of the latest frame of one source
+	 */
+	struct Result
+	{
+		uint32_t        source;
+		uint64_t        sequence;	// frame number of this source
+		ARSAL_Time_Ns_t timestamp;	// capture time, CLOCK_MONOTONIC
+		int             classID;
+		float           confidence;
+	};
+
+	/**
+	 * Open and start the sources, NULL if any of them fails.
+	 */
+	static multiCamera* Create( const char* sources, uint32_t deadlineMs=MULTI_DEFAULT_DEADLINE_MS );
+
+	/**
+	 * Destroy
+	 */
+	~multiCamera();
+
+	/**
+	 * Classify the pending frames in one batch.
+	 * @param results array of at least GetNumSources() entries, one per classified frame
+	 * @returns the number of results, 0 when no frame came in within the deadline, -1 on error
+	 */
+	int Process( tiledNet* net, Result* results );
+
+	/**
+	 * Number of sources
+	 */
+	inline uint32_t GetNumSources() const			{ return mSources.size(); }
+
+	/**
+	 * Frame size of a source
+	 */
+	inline uint32_t GetWidth( uint32_t source ) const	{ return mSources[source]->width; }
+	inline uint32_t GetHeight( uint32_t source ) const	{ return mSources[source]->height; }
+
+	/**
+	 * Source description, as given to Create()
+	 */
+	inline const char* GetName( uint32_t source ) const	{ return mSources[source]->name.c_str(); }
+
+	/**
+	 * True if the source reads the frames of the stream receiver (ring:<name>)
+	 */
+	inline bool IsRing( uint32_t source ) const		{ return mSources[source]->ring != NULL; }
+
+	/**
+	 * Frames a source captured but which were replaced before being classified
+	 */
+	inline uint64_t GetDropped( uint32_t source ) const	{ return mSources[source]->dropped; }
+
+	/**
+	 * Statistics: batched passes, and frames classified by them
+	 */
+	inline uint64_t GetNumBatches() const			{ return mBatches; }
+	inline uint64_t GetNumFrames() const			{ return mFrames; }
+
+	/**
+	 * Classified frames which missed the deadline
+	 */
+	inline uint64_t GetNumLate() const			{ return mLate; }
+
+protected:
+	multiCamera();
+
+	struct Source
+	{
+		std::string     name;
+		uint32_t        index;
+		gstCamera*      camera;
+		ringCamera*     ring;
+		ARSAL_Thread_t  thread;
+		multiCamera*    owner;
+
+		uint32_t width;
+		uint32_t height;
+
+		// latest frame: the capture thread fills write, then swaps it with ready
+		float*   buffers[3];
+		int      write;
+		int      ready;
+		int      read;
+		bool     fresh;
+
+		uint64_t        sequence;
+		uint64_t        readySequence;
+		ARSAL_Time_Ns_t readyTimestamp;
+		uint64_t        dropped;
+	};
+
+	bool  addSource( const std::string& spec );
+	float predict( uint32_t batch ) const;
+	void  capture( Source* source );
+
+	static void* threadEntry( void* arg );
+
+	std::vector<Source*> mSources;
+
+	ARSAL_Mutex_t mMutex;
+	ARSAL_Cond_t  mCond;
+	std::atomic<bool> mRun;
+
+	ARSAL_Time_Ns_t mDeadline;
+
+	float mLatency[MULTI_MAX_SOURCES + 1];	// average pass time per batch size, ns, 0 until measured
+
+	uint64_t mBatches;
+	uint64_t mFrames;
+	uint64_t mLate;
+};
+
+#endif
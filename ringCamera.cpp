@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ringCamera.h"
+
+#include "cudaUtility.h"
+#include "cudaYUV.h"
+#include "cudaRGB.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+#define LOG_RING "[ringCamera] "
+
+
+// constructor
+ringCamera::ringCamera()
+{
+	mRing        = NULL;
+	mCaptured    = false;
+	mConverting  = false;
+	mSequence    = 0;
+	mSkipped     = 0;
+	mTimestamp   = 0;
+	mSegmentCPU  = NULL;
+	mSegmentCUDA = NULL;
+	mSegmentSize = 0;
+	mWidth       = 0;
+	mHeight      = 0;
+	mDepth       = 0;
+	mFormat      = ARSAL_FRAMERING_FORMAT_RAW;
+	mRGBA        = NULL;
+
+	memset(&mFrame, 0, sizeof(mFrame));
+}
+
+
+// destructor
+ringCamera::~ringCamera()
+{
+	Release();
+
+	if( mRGBA != NULL )
+	{
+		CUDA(cudaFree(mRGBA));
+		mRGBA = NULL;
+	}
+
+	if( mSegmentCPU != NULL )
+	{
+		CUDA(cudaHostUnregister(mSegmentCPU));
+		mSegmentCPU = NULL;
+	}
+
+	ARSAL_FrameRing_Delete(&mRing);
+}
+
+
+// Create
+ringCamera* ringCamera::Create( const char* name, unsigned long timeout )
+{
+	ringCamera* cam = new ringCamera();
+
+	if( !cam )
+		return NULL;
+
+	if( !cam->init(name, timeout) )
+	{
+		printf(LOG_RING "failed to open frame ring %s\n", name);
+		delete cam;
+		return NULL;
+	}
+
+	printf(LOG_RING "opened frame ring %s  (%ux%u, format %u)\n", name, cam->mWidth, cam->mHeight, cam->mFormat);
+	return cam;
+}
+
+
+// init
+bool ringCamera::init( const char* name, unsigned long timeout )
+{
+	eARSAL_ERROR err = ARSAL_OK;
+
+	mRing = ARSAL_FrameRing_Open(name, &err);
+
+	if( !mRing )
+	{
+		printf(LOG_RING "%s\n", ARSAL_Error_ToString(err));
+		return false;
+	}
+
+	// map the whole segment once: the GPU then reads the frames where they were published
+	void* segment = ARSAL_FrameRing_GetSegment(mRing, &mSegmentSize);
+
+	if( CUDA_FAILED(cudaHostRegister(segment, mSegmentSize, cudaHostRegisterMapped)) )
+		return false;
+
+	mSegmentCPU = (uint8_t*)segment;
+
+	void* segmentCUDA = NULL;
+
+	if( CUDA_FAILED(cudaHostGetDevicePointer(&segmentCUDA, segment, 0)) )
+		return false;
+
+	mSegmentCUDA = (uint8_t*)segmentCUDA;
+
+	// the geometry is the one of the first frame
+	void* cpu  = NULL;
+	void* cuda = NULL;
+
+	if( !Capture(&cpu, &cuda, timeout) )
+	{
+		printf(LOG_RING "no frame published within %lu ms\n", timeout);
+		return false;
+	}
+
+	Release();
+
+	if( CUDA_FAILED(cudaMalloc(&mRGBA, mWidth * mHeight * sizeof(float4))) )
+	{
+		mRGBA = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+
+// Capture
+bool ringCamera::Capture( void** cpu, void** cuda, unsigned long timeout )
+{
+	if( !mRing || !cpu || !cuda )
+		return false;
+
+	Release();
+
+	const ARSAL_Time_Ns_t deadline = (timeout == ULONG_MAX) ? 0 : ARSAL_Time_GetMonotonicNs() + MSEC_TO_NSEC((ARSAL_Time_Ns_t)timeout);
+
+	while( true )
+	{
+		if( ARSAL_FrameRing_WaitLatest(mRing, &mFrame, mSequence, deadline) != ARSAL_OK )
+			return false;
+
+		if( mSequence != 0 && mFrame.sequence > mSequence + 1 )
+			mSkipped += mFrame.sequence - mSequence - 1;
+
+		mSequence = mFrame.sequence;
+		mCaptured = true;
+
+		const bool supported = (mFrame.format == ARSAL_FRAMERING_FORMAT_NV12 || mFrame.format == ARSAL_FRAMERING_FORMAT_RGB8);
+
+		if( supported && mWidth == 0 )
+		{
+			mWidth  = mFrame.width;
+			mHeight = mFrame.height;
+			mFormat = mFrame.format;
+			mDepth  = (mFormat == ARSAL_FRAMERING_FORMAT_NV12) ? 12 : 24;
+		}
+
+		if( supported && mFrame.format == mFormat && mFrame.width == mWidth && mFrame.height == mHeight )
+			break;
+
+		// encoded or resized frames are not for us
+		Release();
+	}
+
+	mTimestamp = mFrame.timestamp;
+
+	*cpu  = mFrame.data;
+	*cuda = mSegmentCUDA + (mFrame.data - mSegmentCPU);
+
+	return true;
+}
+
+
+// Release
+void ringCamera::Release()
+{
+	if( !mCaptured )
+		return;
+
+	// the conversion kernel may still be reading the slot
+	if( mConverting )
+	{
+		CUDA(cudaStreamSynchronize(NULL));
+		mConverting = false;
+	}
+
+	ARSAL_FrameRing_Release(mRing, &mFrame);
+	mCaptured = false;
+}
+
+
+// ConvertRGBA
+bool ringCamera::ConvertRGBA( void* input, void** output )
+{
+	if( !input || !output || !mRGBA )
+		return false;
+
+	if( mFormat == ARSAL_FRAMERING_FORMAT_NV12 )
+	{
+		if( CUDA_FAILED(cudaNV12ToRGBAf((uint8_t*)input, (float4*)mRGBA, mWidth, mHeight)) )
+			return false;
+	}
+	else
+	{
+		if( CUDA_FAILED(cudaRGBToRGBAf((uchar3*)input, (float4*)mRGBA, mWidth, mHeight)) )
+			return false;
+	}
+
+	mConverting = true;
+	*output = mRGBA;
+	return true;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __RING_CAMERA_H__
+#define __RING_CAMERA_H__
+
+#include <stdint.h>
+#include <limits.h>
+
+extern "C" {
+#include <libARSAL/ARSAL_FrameRing.h>
+}
+
+
+/**
+ * Camera reading the frames published by another process (the Bebop
+ * stream receiver or a decoder) in an ARSAL_FrameRing shared memory
+ * segment. The segment is mapped into the GPU address space once, so
+ * frames are converted straight from the slot they were published in.
+ *
+ * Supports NV12 and RGB8 frames; other formats are skipped.
+ */
+class ringCamera
+{
+public:
+	/**
+	 * Open the frame ring and wait for its first frame to learn the geometry.
+	 */
+	static ringCamera* Create( const char* name, unsigned long timeout=5000 );
+
+	/**
+	 * Destroy
+	 */
+	~ringCamera();
+
+	/**
+	 * Get the latest frame, in place. CPU and CUDA pointers both point to
+	 * the shared memory slot, which stays valid until Release().
+	 */
+	bool Capture( void** cpu, void** cuda, unsigned long timeout=ULONG_MAX );
+
+	/**
+	 * Give the slot of the last captured frame back to the publisher,
+	 * once a pending ConvertRGBA() is done with it.
+	 */
+	void Release();
+
+	/**
+	 * Convert the captured frame to float4 RGBA, for the networks.
+	 */
+	bool ConvertRGBA( void* input, void** output );
+
+	/**
+	 * Image dimensions and format
+	 */
+	inline uint32_t GetWidth() const	  { return mWidth; }
+	inline uint32_t GetHeight() const	  { return mHeight; }
+	inline uint32_t GetPixelDepth() const { return mDepth; }
+	inline uint32_t GetFormat() const	  { return mFormat; }
+
+	/**
+	 * Number of frames skipped because newer ones were published first
+	 */
+	inline uint64_t GetSkipped() const	  { return mSkipped; }
+
+	/**
+	 * Reception time of the last captured frame, on the publisher clock
+	 * (CLOCK_MONOTONIC, shared by every process)
+	 */
+	inline ARSAL_Time_Ns_t GetTimestamp() const { return mTimestamp; }
+
+private:
+	ringCamera();
+
+	bool init( const char* name, unsigned long timeout );
+
+	ARSAL_FrameRing_t*      mRing;
+	ARSAL_FrameRing_Frame_t mFrame;
+	bool                    mCaptured;
+	bool                    mConverting;
+	uint64_t                mSequence;
+	uint64_t                mSkipped;
+	ARSAL_Time_Ns_t         mTimestamp;
+
+	uint8_t* mSegmentCPU;
+	uint8_t* mSegmentCUDA;
+	size_t   mSegmentSize;
+
+	uint32_t mWidth;
+	uint32_t mHeight;
+	uint32_t mDepth;
+	uint32_t mFormat;
+
+	void* mRGBA;
+};
+
+#endif
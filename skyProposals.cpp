@@ -0,0 +1,558 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "skyProposals.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SKY_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SKY_SSE2 1
+#endif
+
+
+#define LOG_SKY "[sky] "
+
+// chroma differences count this much more than luma: the sky is bright or dark, but always the same hue
+#define SKY_CHROMA_WEIGHT 4.0f
+
+// floor of the sky deviation, so a flat synthetic or overexposed sky does not turn its noise into blobs
+#define SKY_MIN_SIGMA 2.0f
+
+
+// acc[n] += row[n]
+static void accumulateRow( uint16_t* acc, const uint8_t* row, uint32_t count )
+{
+	uint32_t n = 0;
+
+#if defined(SKY_NEON)
+	for( ; n + 16 <= count; n += 16 )
+	{
+		const uint8x16_t v = vld1q_u8(row + n);
+
+		vst1q_u16(acc + n,     vaddw_u8(vld1q_u16(acc + n),     vget_low_u8(v)));
+		vst1q_u16(acc + n + 8, vaddw_u8(vld1q_u16(acc + n + 8), vget_high_u8(v)));
+	}
+#elif defined(SKY_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+
+	for( ; n + 16 <= count; n += 16 )
+	{
+		const __m128i v = _mm_loadu_si128((const __m128i*)(row + n));
+		__m128i* a = (__m128i*)(acc + n);
+
+		_mm_storeu_si128(a,     _mm_add_epi16(_mm_loadu_si128(a),     _mm_unpacklo_epi8(v, zero)));
+		_mm_storeu_si128(a + 1, _mm_add_epi16(_mm_loadu_si128(a + 1), _mm_unpackhi_epi8(v, zero)));
+	}
+#endif
+
+	for( ; n < count; n++ )
+		acc[n] += row[n];
+}
+
+
+// acc[n] += |a[n] - b[n]|
+static void accumulateAbsDiff( uint16_t* acc, const uint8_t* a, const uint8_t* b, uint32_t count )
+{
+	uint32_t n = 0;
+
+#if defined(SKY_NEON)
+	for( ; n + 16 <= count; n += 16 )
+	{
+		const uint8x16_t d = vabdq_u8(vld1q_u8(a + n), vld1q_u8(b + n));
+
+		vst1q_u16(acc + n,     vaddw_u8(vld1q_u16(acc + n),     vget_low_u8(d)));
+		vst1q_u16(acc + n + 8, vaddw_u8(vld1q_u16(acc + n + 8), vget_high_u8(d)));
+	}
+#elif defined(SKY_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+
+	for( ; n + 16 <= count; n += 16 )
+	{
+		const __m128i va = _mm_loadu_si128((const __m128i*)(a + n));
+		const __m128i vb = _mm_loadu_si128((const __m128i*)(b + n));
+		const __m128i d  = _mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va));
+		__m128i* s = (__m128i*)(acc + n);
+
+		_mm_storeu_si128(s,     _mm_add_epi16(_mm_loadu_si128(s),     _mm_unpacklo_epi8(d, zero)));
+		_mm_storeu_si128(s + 1, _mm_add_epi16(_mm_loadu_si128(s + 1), _mm_unpackhi_epi8(d, zero)));
+	}
+#endif
+
+	for( ; n < count; n++ )
+		acc[n] += (a[n] > b[n]) ? (a[n] - b[n]) : (b[n] - a[n]);
+}
+
+
+// constructor
+skyProposals::skyProposals( uint32_t width, uint32_t height, uint32_t cellSize )
+{
+	mWidth      = width;
+	mHeight     = height;
+	mCellSize   = cellSize;
+	mGridWidth  = width / cellSize;
+	mGridHeight = height / cellSize;
+
+	const uint32_t columns = mGridWidth * cellSize;
+	const uint32_t cells   = mGridWidth * mGridHeight;
+
+	mAccLuma.resize(columns);
+	mAccGradient.resize(columns);
+	mAccChroma.resize(columns);
+
+	mLuma.resize(cells);
+	mChromaU.resize(cells);
+	mChromaV.resize(cells);
+	mGradient.resize(cells);
+	mResidual.resize(cells);
+	mMask.resize(cells);
+	mParent.resize(cells);
+	mBlobIndex.resize(cells);
+
+	memset(mModel, 0, sizeof(mModel));
+
+	mTextureThreshold = 6.0f;
+	mColorThreshold   = 4.0f;
+	mMinSkyFraction   = 0.3f;
+	mMaxBlobFraction  = 0.05f;
+	mPadding          = 0.5f;
+	mMinCropSize      = 64;
+	mSkyFraction      = 0.0f;
+	mNumBlobs         = 0;
+}
+
+
+// destructor
+skyProposals::~skyProposals()
+{
+
+}
+
+
+// Create
+skyProposals* skyProposals::Create( uint32_t width, uint32_t height, uint32_t cellSize )
+{
+	// 16 bits column accumulators hold up to 64 rows of two gradients
+	if( cellSize < 2 || cellSize > 64 || (cellSize & 1) != 0 )
+	{
+		printf(LOG_SKY "invalid cell size %u (even, 2 to 64)\n", cellSize);
+		return NULL;
+	}
+
+	if( (width & 1) != 0 || width / cellSize < 2 || height / cellSize < 2 )
+	{
+		printf(LOG_SKY "invalid frame size %ux%u for %u pixels cells\n", width, height, cellSize);
+		return NULL;
+	}
+
+	skyProposals* sky = new skyProposals(width, height, cellSize);
+
+	printf(LOG_SKY "%ux%u frames, %ux%u cells of %u pixels\n", width, height, sky->mGridWidth, sky->mGridHeight, cellSize);
+	return sky;
+}
+
+
+// reduceNV12
+void skyProposals::reduceNV12( const uint8_t* frame )
+{
+	const uint32_t cell    = mCellSize;
+	const uint32_t columns = mGridWidth * cell;
+	const uint8_t* chroma  = frame + mWidth * mHeight;
+
+	const float lumaScale   = 1.0f / (cell * cell);
+	const float chromaScale = 4.0f / (cell * cell);
+
+	for( uint32_t gy=0; gy < mGridHeight; gy++ )
+	{
+		memset(&mAccLuma[0], 0, columns * sizeof(uint16_t));
+		memset(&mAccGradient[0], 0, columns * sizeof(uint16_t));
+		memset(&mAccChroma[0], 0, columns * sizeof(uint16_t));
+
+		// one pass down the rows of the cells: luma, horizontal and vertical gradients
+		for( uint32_t r=0; r < cell; r++ )
+		{
+			const uint32_t y   = gy * cell + r;
+			const uint8_t* row = frame + y * mWidth;
+
+			accumulateRow(&mAccLuma[0], row, columns);
+			accumulateAbsDiff(&mAccGradient[0], row, row + 1, columns - 1);
+
+			if( y + 1 < mHeight )
+				accumulateAbsDiff(&mAccGradient[0], row, row + mWidth, columns);
+		}
+
+		// half as many chroma rows, U and V interleaved
+		for( uint32_t r=0; r < cell / 2; r++ )
+			accumulateRow(&mAccChroma[0], chroma + (gy * cell / 2 + r) * mWidth, columns);
+
+		for( uint32_t gx=0; gx < mGridWidth; gx++ )
+		{
+			const uint32_t x0 = gx * cell;
+
+			uint32_t luma = 0, gradient = 0, u = 0, v = 0;
+
+			for( uint32_t x=x0; x < x0 + cell; x += 2 )
+			{
+				luma     += mAccLuma[x] + mAccLuma[x+1];
+				gradient += mAccGradient[x] + mAccGradient[x+1];
+				u        += mAccChroma[x];
+				v        += mAccChroma[x+1];
+			}
+
+			const uint32_t n = gy * mGridWidth + gx;
+
+			mLuma[n]     = luma * lumaScale;
+			mGradient[n] = gradient * lumaScale;
+			mChromaU[n]  = u * chromaScale;
+			mChromaV[n]  = v * chromaScale;
+		}
+	}
+}
+
+
+// reduceRGB8
+void skyProposals::reduceRGB8( const uint8_t* frame )
+{
+	const uint32_t cell   = mCellSize;
+	const uint32_t stride = mWidth * 3;
+	const float    scale  = 1.0f / (cell * cell);
+
+	for( uint32_t gy=0; gy < mGridHeight; gy++ )
+	{
+		for( uint32_t gx=0; gx < mGridWidth; gx++ )
+		{
+			uint32_t r = 0, g = 0, b = 0, gradient = 0;
+
+			for( uint32_t y=gy * cell; y < (gy + 1) * cell; y++ )
+			{
+				const uint8_t* px = frame + y * stride + gx * cell * 3;
+
+				for( uint32_t x=0; x < cell; x++, px += 3 )
+				{
+					r += px[0];
+					g += px[1];
+					b += px[2];
+
+					// gradients of green, the closest to luma
+					if( gx * cell + x + 1 < mWidth )
+						gradient += abs((int)px[4] - (int)px[1]);
+
+					if( y + 1 < mHeight )
+						gradient += abs((int)px[stride + 1] - (int)px[1]);
+				}
+			}
+
+			// averaging commutes with the (linear) color conversion
+			const float fr = r * scale;
+			const float fg = g * scale;
+			const float fb = b * scale;
+			const uint32_t n = gy * mGridWidth + gx;
+
+			mLuma[n]     =  0.299f * fr + 0.587f * fg + 0.114f * fb;
+			mChromaU[n]  = -0.169f * fr - 0.331f * fg + 0.500f * fb + 128.0f;
+			mChromaV[n]  =  0.500f * fr - 0.419f * fg - 0.081f * fb + 128.0f;
+			mGradient[n] = gradient * scale;
+		}
+	}
+}
+
+
+// fitSky
+bool skyProposals::fitSky( float limit )
+{
+	// least squares plane through the smooth cells (and within limit of the previous fit)
+	double s1 = 0, sx = 0, sy = 0, sxx = 0, sxy = 0, syy = 0;
+	double sv[3]  = { 0, 0, 0 };
+	double sxv[3] = { 0, 0, 0 };
+	double syv[3] = { 0, 0, 0 };
+
+	const float* channels[3] = { &mLuma[0], &mChromaU[0], &mChromaV[0] };
+
+	for( uint32_t gy=0; gy < mGridHeight; gy++ )
+	{
+		for( uint32_t gx=0; gx < mGridWidth; gx++ )
+		{
+			const uint32_t n = gy * mGridWidth + gx;
+
+			if( mGradient[n] > mTextureThreshold || (limit > 0.0f && mResidual[n] > limit) )
+				continue;
+
+			const double x = (double)gx / mGridWidth;
+			const double y = (double)gy / mGridHeight;
+
+			s1 += 1; sx += x; sy += y;
+			sxx += x * x; sxy += x * y; syy += y * y;
+
+			for( int c=0; c < 3; c++ )
+			{
+				const double v = channels[c][n];
+				sv[c] += v; sxv[c] += x * v; syv[c] += y * v;
+			}
+		}
+	}
+
+	const uint32_t cells = mGridWidth * mGridHeight;
+
+	if( s1 < std::max(16.0, cells * 0.1) )
+		return false;
+
+	// Cramer's rule on the normal equations, or a constant when the cells are all in a line
+	const double det = s1 * (sxx * syy - sxy * sxy) - sx * (sx * syy - sxy * sy) + sy * (sx * sxy - sxx * sy);
+
+	for( int c=0; c < 3; c++ )
+	{
+		if( fabs(det) < 1e-9 * s1 * s1 * s1 )
+		{
+			mModel[c][0] = sv[c] / s1;
+			mModel[c][1] = 0.0f;
+			mModel[c][2] = 0.0f;
+			continue;
+		}
+
+		const double a = sv[c] * (sxx * syy - sxy * sxy) - sx * (sxv[c] * syy - sxy * syv[c]) + sy * (sxv[c] * sxy - sxx * syv[c]);
+		const double b = s1 * (sxv[c] * syy - syv[c] * sxy) - sv[c] * (sx * syy - sxy * sy) + sy * (sx * syv[c] - sxv[c] * sy);
+		const double d = s1 * (sxx * syv[c] - sxy * sxv[c]) - sx * (sx * syv[c] - sxv[c] * sy) + sv[c] * (sx * sxy - sxx * sy);
+
+		mModel[c][0] = a / det;
+		mModel[c][1] = b / det;
+		mModel[c][2] = d / det;
+	}
+
+	return true;
+}
+
+
+// residuals
+float skyProposals::residuals()
+{
+	double sum = 0;
+	uint32_t count = 0;
+
+	for( uint32_t gy=0; gy < mGridHeight; gy++ )
+	{
+		const float y = (float)gy / mGridHeight;
+
+		for( uint32_t gx=0; gx < mGridWidth; gx++ )
+		{
+			const float x = (float)gx / mGridWidth;
+			const uint32_t n = gy * mGridWidth + gx;
+
+			const float dy = mLuma[n]    - (mModel[0][0] + mModel[0][1] * x + mModel[0][2] * y);
+			const float du = mChromaU[n] - (mModel[1][0] + mModel[1][1] * x + mModel[1][2] * y);
+			const float dv = mChromaV[n] - (mModel[2][0] + mModel[2][1] * x + mModel[2][2] * y);
+
+			mResidual[n] = sqrtf(dy * dy + SKY_CHROMA_WEIGHT * (du * du + dv * dv));
+
+			if( mGradient[n] <= mTextureThreshold )
+			{
+				sum += mResidual[n];
+				count++;
+			}
+		}
+	}
+
+	return count > 0 ? sum / count : 0.0f;
+}
+
+
+// findRoot
+uint32_t skyProposals::findRoot( uint32_t cell )
+{
+	while( mParent[cell] != cell )
+	{
+		mParent[cell] = mParent[mParent[cell]];
+		cell = mParent[cell];
+	}
+
+	return cell;
+}
+
+
+// findBlobs
+uint32_t skyProposals::findBlobs( float sigma )
+{
+	const float    limit = mColorThreshold * sigma;
+	const uint32_t cells = mGridWidth * mGridHeight;
+
+	uint32_t sky = 0;
+
+	for( uint32_t n=0; n < cells; n++ )
+	{
+		mMask[n] = (mGradient[n] > mTextureThreshold || mResidual[n] > limit);
+
+		if( !mMask[n] )
+			sky++;
+	}
+
+	mSkyFraction = (float)sky / cells;
+
+	// 8-connected components, union-find in raster order
+	for( uint32_t gy=0; gy < mGridHeight; gy++ )
+	{
+		for( uint32_t gx=0; gx < mGridWidth; gx++ )
+		{
+			const uint32_t n = gy * mGridWidth + gx;
+
+			mParent[n] = n;
+
+			if( !mMask[n] )
+				continue;
+
+			const int neighbours[4][2] = { {-1, 0}, {-1, -1}, {0, -1}, {1, -1} };
+
+			for( int k=0; k < 4; k++ )
+			{
+				const int x = (int)gx + neighbours[k][0];
+				const int y = (int)gy + neighbours[k][1];
+
+				if( x < 0 || y < 0 || x >= (int)mGridWidth )
+					continue;
+
+				const uint32_t m = y * mGridWidth + x;
+
+				if( !mMask[m] )
+					continue;
+
+				const uint32_t a = findRoot(n);
+				const uint32_t b = findRoot(m);
+
+				if( a != b )
+					mParent[std::max(a, b)] = std::min(a, b);
+			}
+		}
+	}
+
+	mBlobs.clear();
+
+	for( uint32_t n=0; n < cells; n++ )
+	{
+		mBlobIndex[n] = -1;
+
+		if( !mMask[n] )
+			continue;
+
+		const uint32_t root = findRoot(n);
+		const int gx = n % mGridWidth;
+		const int gy = n / mGridWidth;
+
+		// roots come first in raster order, so their blob already exists for the other cells
+		if( root == n )
+		{
+			Blob blob = { gx, gy, gx, gy, 0, 0.0f };
+			mBlobIndex[n] = mBlobs.size();
+			mBlobs.push_back(blob);
+		}
+
+		Blob& blob = mBlobs[mBlobIndex[root]];
+
+		blob.x0 = std::min(blob.x0, gx);
+		blob.y0 = std::min(blob.y0, gy);
+		blob.x1 = std::max(blob.x1, gx);
+		blob.y1 = std::max(blob.y1, gy);
+		blob.area++;
+		blob.strength += std::max(mResidual[n] / limit, mGradient[n] / mTextureThreshold);
+	}
+
+	return mBlobs.size();
+}
+
+
+// Process
+int skyProposals::Process( const void* frame, Format format, Region* regions, uint32_t maxRegions )
+{
+	if( !frame || !regions )
+		return -1;
+
+	if( format == RGB8 )
+		reduceRGB8((const uint8_t*)frame);
+	else
+		reduceNV12((const uint8_t*)frame);
+
+	/*
+	 * fit the sky to the smooth cells, then again without the smooth cells
+	 * which are far from the first fit (clouds, a uniformly painted target)
+	 */
+	mSkyFraction = 0.0f;
+	mNumBlobs    = 0;
+
+	if( !fitSky(-1.0f) )
+		return -1;
+
+	const float first = residuals();
+
+	if( !fitSky(std::max(3.0f * first, SKY_MIN_SIGMA)) )
+		return -1;
+
+	const float sigma = std::max(residuals() * 1.25f, SKY_MIN_SIGMA);
+
+	mNumBlobs = findBlobs(sigma);
+
+	if( mSkyFraction < mMinSkyFraction )
+		return -1;
+
+	// compact blobs only, strongest first
+	const int maxArea = std::max(1, (int)(mMaxBlobFraction * mGridWidth * mGridHeight));
+
+	std::vector<Blob> blobs;
+
+	for( size_t n=0; n < mBlobs.size(); n++ )
+	{
+		if( mBlobs[n].area <= maxArea )
+			blobs.push_back(mBlobs[n]);
+	}
+
+	std::sort(blobs.begin(), blobs.end(), [](const Blob& a, const Blob& b) { return a.strength > b.strength; });
+
+	const uint32_t count = std::min((uint32_t)blobs.size(), maxRegions);
+	const int      frame_side = std::min(mWidth, mHeight);
+
+	for( uint32_t n=0; n < count; n++ )
+	{
+		const Blob& blob = blobs[n];
+
+		const int x0 = blob.x0 * mCellSize;
+		const int y0 = blob.y0 * mCellSize;
+		const int x1 = (blob.x1 + 1) * mCellSize;
+		const int y1 = (blob.y1 + 1) * mCellSize;
+
+		// square crop around the blob with some context, inside the frame
+		int side = (int)(std::max(x1 - x0, y1 - y0) * (1.0f + 2.0f * mPadding));
+		side = std::min(std::max(side, (int)mMinCropSize), frame_side);
+
+		const int cx = (x0 + x1) / 2;
+		const int cy = (y0 + y1) / 2;
+
+		regions[n].x      = std::min(std::max(cx - side / 2, 0), (int)mWidth - side);
+		regions[n].y      = std::min(std::max(cy - side / 2, 0), (int)mHeight - side);
+		regions[n].width  = side;
+		regions[n].height = side;
+	}
+
+	return count;
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __SKY_PROPOSALS_H__
+#define __SKY_PROPOSALS_H__
+
+
+#include "tiledNet.h"
+
+#include <vector>
+
+
+/**
+ * Default cell size, in pixels: the frame is segmented at 1/8 resolution
+ */
+#define SKY_DEFAULT_CELL 8
+
+
+/**
+ * Region proposals for a camera looking at the sky.
+ *
+ * The frame is reduced on the CPU to a grid of cells (mean color and mean
+ * luma gradient of each cell). The sky is modelled as a smooth color
+ * gradient, a plane per YUV channel fitted to the untextured cells, and
+ * every cell which is textured or too far from the model is not sky.
+ * Connected groups of such cells are compact blobs which may be targets;
+ * each becomes a square crop for tiledNet::DetectRegions(), so inference
+ * cost follows the number of candidates instead of the frame area.
+ *
+ * When too little of the frame is sky (camera looking at the ground)
+ * Process() returns -1 and the caller should fall back to tiledNet::Detect().
+ */
+class skyProposals
+{
+public:
+	/**
+	 * Layout of the CPU frame
+	 */
+	enum Format
+	{
+		NV12,	/**< Y plane then interleaved UV plane, stride = width */
+		RGB8	/**< Packed 8 bits RGB */
+	};
+
+	typedef tiledNet::Region Region;
+
+	/**
+	 * Create for frames of the given size.
+	 * @param cellSize cell size in pixels, even, from 2 to 64
+	 */
+	static skyProposals* Create( uint32_t width, uint32_t height, uint32_t cellSize=SKY_DEFAULT_CELL );
+
+	/**
+	 * Destroy
+	 */
+	~skyProposals();
+
+	/**
+	 * Segment a frame and propose the crops to classify, strongest first.
+	 * @param frame frame in CPU memory
+	 * @param regions array of maxRegions entries
+	 * @returns the number of regions, or -1 when the frame is not mostly sky
+	 */
+	int Process( const void* frame, Format format, Region* regions, uint32_t maxRegions );
+
+	/**
+	 * Mean luma gradient (levels per pixel) above which a cell is textured, not sky (default 6)
+	 */
+	inline void SetTextureThreshold( float threshold )	{ mTextureThreshold = threshold; }
+
+	/**
+	 * Distance to the sky model, in deviations of the sky cells, above which a cell is not sky (default 4)
+	 */
+	inline void SetColorThreshold( float sigmas )		{ mColorThreshold = sigmas; }
+
+	/**
+	 * Fraction of sky cells below which the frame is not segmented (default 0.3)
+	 */
+	inline void SetMinSkyFraction( float fraction )	{ mMinSkyFraction = fraction; }
+
+	/**
+	 * Blobs larger than this fraction of the frame are scenery, not targets (default 0.05)
+	 */
+	inline void SetMaxBlobFraction( float fraction )	{ mMaxBlobFraction = fraction; }
+
+	/**
+	 * Context added around a blob, as a fraction of its size on each side (default 0.5)
+	 */
+	inline void SetPadding( float padding )			{ mPadding = padding; }
+
+	/**
+	 * Minimum crop size in pixels (default 64)
+	 */
+	inline void SetMinCropSize( uint32_t size )		{ mMinCropSize = size; }
+
+	/**
+	 * Segmentation of the last frame: one byte per cell, non-zero when not sky
+	 */
+	inline const uint8_t* GetMask() const			{ return &mMask[0]; }
+
+	inline uint32_t GetGridWidth() const			{ return mGridWidth; }
+	inline uint32_t GetGridHeight() const			{ return mGridHeight; }
+	inline uint32_t GetCellSize() const			{ return mCellSize; }
+
+	/**
+	 * Fraction of the last frame found to be sky
+	 */
+	inline float GetSkyFraction() const			{ return mSkyFraction; }
+
+	/**
+	 * Number of blobs in the last frame, before the size filter and the maxRegions limit
+	 */
+	inline uint32_t GetNumBlobs() const			{ return mNumBlobs; }
+
+protected:
+	skyProposals( uint32_t width, uint32_t height, uint32_t cellSize );
+
+	struct Blob
+	{
+		int   x0, y0, x1, y1;	// bounds, in cells, inclusive
+		int   area;
+		float strength;
+	};
+
+	void reduceNV12( const uint8_t* frame );
+	void reduceRGB8( const uint8_t* frame );
+	bool fitSky( float limit );
+	float residuals();
+	uint32_t findBlobs( float sigma );
+	uint32_t findRoot( uint32_t cell );
+
+	uint32_t mWidth;
+	uint32_t mHeight;
+	uint32_t mCellSize;
+	uint32_t mGridWidth;
+	uint32_t mGridHeight;
+
+	// column accumulators of one row of cells
+	std::vector<uint16_t> mAccLuma;
+	std::vector<uint16_t> mAccGradient;
+	std::vector<uint16_t> mAccChroma;
+
+	// per cell
+	std::vector<float>    mLuma;
+	std::vector<float>    mChromaU;
+	std::vector<float>    mChromaV;
+	std::vector<float>    mGradient;
+	std::vector<float>    mResidual;
+	std::vector<uint8_t>  mMask;
+	std::vector<uint32_t> mParent;
+	std::vector<int>      mBlobIndex;
+	std::vector<Blob>     mBlobs;
+
+	// sky model, v = a + b * x + c * y for Y, U and V
+	float mModel[3][3];
+
+	float    mTextureThreshold;
+	float    mColorThreshold;
+	float    mMinSkyFraction;
+	float    mMaxBlobFraction;
+	float    mPadding;
+	uint32_t mMinCropSize;
+	float    mSkyFraction;
+	uint32_t mNumBlobs;
+};
+
+
+#endif
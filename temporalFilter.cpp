@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "temporalFilter.h"
+
+#include <math.h>
+
+
+// constructor
+temporalFilter::temporalFilter()
+{
+	mTau         = 150.0f * 1000000.0f;
+	mEnter       = 0.6f;
+	mExit        = 0.3f;
+	mDwell       = MSEC_TO_NSEC((ARSAL_Time_Ns_t)300);
+	mRefresh     = 0;
+	mLastFrame   = 0;
+	mFrames      = 0;
+	mTransitions = 0;
+}
+
+
+// destructor
+temporalFilter::~temporalFilter()
+{
+
+}
+
+
+// Create
+temporalFilter* temporalFilter::Create( uint32_t numClasses )
+{
+	if( numClasses == 0 )
+		return NULL;
+
+	temporalFilter* filter = new temporalFilter();
+	filter->Reset(numClasses);
+	return filter;
+}
+
+
+// Reset
+void temporalFilter::Reset( uint32_t numClasses )
+{
+	State state;
+
+	state.score     = 0.0f;
+	state.updated   = 0;
+	state.since     = 0;
+	state.refreshed = 0;
+	state.active    = false;
+
+	mStates.assign(numClasses, state);
+	mActive.clear();
+	mActive.reserve(numClasses);
+	mLastFrame = 0;
+}
+
+
+// decay
+inline float temporalFilter::decay( const State& state, ARSAL_Time_Ns_t timestamp ) const
+{
+	if( state.score == 0.0f || timestamp <= state.updated )
+		return state.score;
+
+	return state.score * expf(-(float)(timestamp - state.updated) / mTau);
+}
+
+
+// Update
+uint32_t temporalFilter::Update( int classID, float confidence, ARSAL_Time_Ns_t timestamp, Transition* transitions, uint32_t maxTransitions )
+{
+	if( !transitions )
+		return 0;
+
+	// weight of this frame, from the time it stands for (a time constant for the first one)
+	const float alpha = 1.0f - ((mLastFrame != 0 && timestamp > mLastFrame) ? expf(-(float)(timestamp - mLastFrame) / mTau) : expf(-1.0f));
+
+	uint32_t count = 0;
+
+	mLastFrame = timestamp;
+	mFrames++;
+
+	/*
+	 * only the class of the frame gains: it may enter
+	 */
+	if( classID >= 0 && classID < (int)mStates.size() )
+	{
+		State& state = mStates[classID];
+
+		state.score   = decay(state, timestamp) + alpha * confidence;
+		state.updated = timestamp;
+
+		if( !state.active && state.score >= mEnter && timestamp >= state.since + mDwell && count < maxTransitions )
+		{
+			state.active    = true;
+			state.since     = timestamp;
+			state.refreshed = timestamp;
+
+			mActive.push_back(classID);
+			mTransitions++;
+
+			const Transition t = { classID, true, false, state.score, timestamp };
+			transitions[count++] = t;
+		}
+	}
+
+	/*
+	 * the active ones may leave, or be refreshed
+	 */
+	for( size_t n=0; n < mActive.size() && count < maxTransitions; )
+	{
+		const int id = mActive[n];
+		State& state = mStates[id];
+
+		state.score   = decay(state, timestamp);
+		state.updated = timestamp;
+
+		if( state.score < mExit && timestamp >= state.since + mDwell )
+		{
+			state.active = false;
+			state.since  = timestamp;
+
+			mActive[n] = mActive.back();
+			mActive.pop_back();
+			mTransitions++;
+
+			const Transition t = { id, false, false, state.score, timestamp };
+			transitions[count++] = t;
+			continue;
+		}
+
+		if( mRefresh > 0 && timestamp >= state.refreshed + mRefresh )
+		{
+			state.refreshed = timestamp;
+
+			const Transition t = { id, true, true, state.score, timestamp };
+			transitions[count++] = t;
+		}
+
+		n++;
+	}
+
+	return count;
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __TEMPORAL_FILTER_H__
+#define __TEMPORAL_FILTER_H__
+
+
+#include <stdint.h>
+#include <vector>
+
+extern "C" {
+#include <libARSAL/ARSAL_Time.h>
+}
+
+
+/**
+ * Maximum number of transitions returned by one Update()
+ */
+#define FILTER_MAX_TRANSITIONS 8
+
+
+/**
+ * Per class hysteresis over the classifications of a stream, so a noisy
+ * classifier does not flip a decision every frame.
+ *
+ * Each class has a score, an exponential average of its confidence over
+ * time (0 on the frames where another class won). A class becomes active
+ * when its score reaches the enter threshold, and inactive when it falls
+ * under the lower exit threshold; either way it keeps its state for at
+ * least the dwell time. Only these transitions are reported, plus an
+ * optional periodic refresh while a class stays active.
+ *
+ * Scores of the classes not seen are decayed lazily, so a frame costs the
+ * update of its class and of the active ones, whatever the number of classes.
+ */
+class temporalFilter
+{
+public:
+	/**
+	 * Change of state of a class
+	 */
+	struct Transition
+	{
+		int             classID;
+		bool            active;		// entered, or left
+		bool            refresh;		// still active, see SetRefresh()
+		float           score;
+		ARSAL_Time_Ns_t timestamp;
+	};
+
+	/**
+	 * Create a filter for the classes of a network
+	 */
+	static temporalFilter* Create( uint32_t numClasses );
+
+	/**
+	 * Destroy
+	 */
+	~temporalFilter();
+
+	/**
+	 * Forget every class, for a network with other classes. No transition is reported.
+	 */
+	void Reset( uint32_t numClasses );
+
+	/**
+	 * Classification of the next frame of the stream.
+	 * @param classID winning class, -1 when nothing was recognized
+	 * @param timestamp capture time of the frame, increasing
+	 * @param transitions array of maxTransitions entries
+	 * @returns the number of transitions
+	 */
+	uint32_t Update( int classID, float confidence, ARSAL_Time_Ns_t timestamp, Transition* transitions, uint32_t maxTransitions=FILTER_MAX_TRANSITIONS );
+
+	/**
+	 * Whether a class is active
+	 */
+	inline bool IsActive( int classID ) const		{ return classID >= 0 && classID < (int)mStates.size() && mStates[classID].active; }
+
+	/**
+	 * Time constant of the score average (default 150 ms)
+	 */
+	inline void SetTimeConstant( uint32_t ms )		{ mTau = ms > 0 ? ms * 1000000.0f : 1.0f; }
+
+	/**
+	 * Thresholds of the score, enter above exit (default 0.6 and 0.3)
+	 */
+	inline void SetThresholds( float enter, float exit )	{ mEnter = enter; mExit = exit < enter ? exit : enter; }
+
+	/**
+	 * Minimum time in a state before the next transition (default 300 ms)
+	 */
+	inline void SetDwell( uint32_t ms )			{ mDwell = MSEC_TO_NSEC((ARSAL_Time_Ns_t)ms); }
+
+	/**
+	 * Period of the refresh of the active classes, 0 for none (default)
+	 */
+	inline void SetRefresh( uint32_t ms )			{ mRefresh = MSEC_TO_NSEC((ARSAL_Time_Ns_t)ms); }
+
+	/**
+	 * Statistics: frames filtered, and transitions reported (refreshes excluded)
+	 */
+	inline uint64_t GetNumFrames() const			{ return mFrames; }
+	inline uint64_t GetNumTransitions() const		{ return mTransitions; }
+
+protected:
+	temporalFilter();
+
+	struct State
+	{
+		float           score;
+		ARSAL_Time_Ns_t updated;	// time of the score
+		ARSAL_Time_Ns_t since;		// time of the last transition
+		ARSAL_Time_Ns_t refreshed;
+		bool            active;
+	};
+
+	float decay( const State& state, ARSAL_Time_Ns_t timestamp ) const;
+
+	std::vector<State> mStates;
+	std::vector<int>   mActive;
+
+	float           mTau;		// ns
+	float           mEnter;
+	float           mExit;
+	ARSAL_Time_Ns_t mDwell;
+	ARSAL_Time_Ns_t mRefresh;
+	ARSAL_Time_Ns_t mLastFrame;
+
+	uint64_t mFrames;
+	uint64_t mTransitions;
+};
+
+#endif
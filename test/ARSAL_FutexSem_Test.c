@@ -0,0 +1,155 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file test/ARSAL_FutexSem_Test.c
+ * @brief Behaviour of ARSAL_FutexSem: post, batched waits, timeouts and errors
+ * @date 10/18/2026
+ *
+ * Usage: ARSAL_FutexSem_Test
+ *
+ * Exits with 0 when every check passed.
+ */
+
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include <libARSAL/ARSAL_Sem.h>
+#include <libARSAL/ARSAL_Thread.h>
+#include <libARSAL/ARSAL_Time.h>
+
+#define TEST_TIMEOUT_MS 50
+#define TEST_UNITS 100000
+#define TEST_BATCH 64
+
+static int failures = 0;
+
+#define CHECK(cond)                                                         \
+    do                                                                      \
+    {                                                                       \
+        if (!(cond))                                                        \
+        {                                                                   \
+            fprintf (stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                     \
+        }                                                                   \
+    } while (0)
+
+static ARSAL_FutexSem_t sem;
+
+static void *consumerRun (void *arg)
+{
+    int *units = arg;
+    int taken;
+
+    while (*units < TEST_UNITS)
+    {
+        taken = ARSAL_FutexSem_WaitN (&sem, TEST_BATCH, 0);
+        if (taken <= 0)
+        {
+            break;
+        }
+        *units += taken;
+    }
+    return NULL;
+}
+
+static void testPostWait (void)
+{
+    int value = -1;
+
+    CHECK (ARSAL_FutexSem_Init (&sem, 0, 0) == 0);
+    CHECK ((ARSAL_FutexSem_Trywait (&sem) == -1) && (errno == EAGAIN));
+
+    CHECK (ARSAL_FutexSem_Post (&sem) == 0);
+    CHECK (ARSAL_FutexSem_Wait (&sem) == 0);
+
+    /* WaitN takes min(value, count) */
+    CHECK (ARSAL_FutexSem_PostN (&sem, 5) == 0);
+    CHECK (ARSAL_FutexSem_WaitN (&sem, 3, 0) == 3);
+    CHECK (ARSAL_FutexSem_WaitN (&sem, 10, 0) == 2);
+    CHECK ((ARSAL_FutexSem_Getvalue (&sem, &value) == 0) && (value == 0));
+
+    CHECK ((ARSAL_FutexSem_WaitN (&sem, 0, 0) == -1) && (errno == EINVAL));
+    CHECK ((ARSAL_FutexSem_PostN (&sem, 0) == -1) && (errno == EINVAL));
+    CHECK (ARSAL_FutexSem_Destroy (&sem) == 0);
+}
+
+static void testTimeout (void)
+{
+    ARSAL_Time_Ns_t start, elapsed;
+
+    CHECK (ARSAL_FutexSem_Init (&sem, 0, 0) == 0);
+
+    start = ARSAL_Time_GetMonotonicNs ();
+    CHECK ((ARSAL_FutexSem_Timedwait (&sem, ARSAL_Time_AddMs (start, TEST_TIMEOUT_MS)) == -1) && (errno == ETIMEDOUT));
+    elapsed = ARSAL_Time_GetMonotonicNs () - start;
+    CHECK (elapsed >= MSEC_TO_NSEC ((ARSAL_Time_Ns_t)TEST_TIMEOUT_MS));
+    CHECK (elapsed < MSEC_TO_NSEC ((ARSAL_Time_Ns_t)TEST_TIMEOUT_MS * 20));
+
+    /* A deadline in the past fails at once, but still takes what is there */
+    CHECK ((ARSAL_FutexSem_WaitN (&sem, 4, start) == -1) && (errno == ETIMEDOUT));
+    CHECK (ARSAL_FutexSem_PostN (&sem, 2) == 0);
+    CHECK (ARSAL_FutexSem_WaitN (&sem, 4, start) == 2);
+
+    CHECK (ARSAL_FutexSem_Destroy (&sem) == 0);
+}
+
+static void testWakeup (void)
+{
+    ARSAL_Thread_t consumer;
+    int units = 0;
+    int n;
+
+    CHECK (ARSAL_FutexSem_Init (&sem, 0, 0) == 0);
+    CHECK (ARSAL_Thread_Create (&consumer, consumerRun, &units) == 0);
+
+    /* Let the consumer sleep before the first post */
+    usleep (20000);
+    for (n = 0; n < TEST_UNITS; n++)
+    {
+        CHECK (ARSAL_FutexSem_Post (&sem) == 0);
+    }
+
+    ARSAL_Thread_Join (consumer, NULL);
+    ARSAL_Thread_Destroy (&consumer);
+    CHECK (units == TEST_UNITS);
+    CHECK (ARSAL_FutexSem_Destroy (&sem) == 0);
+}
+
+int main (void)
+{
+    testPostWait ();
+    testTimeout ();
+    testWakeup ();
+
+    printf ("ARSAL_FutexSem_Test: %s\n", (failures == 0) ? "passed" : "FAILED");
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,241 @@
+/*
+    Copyright (C) 2014 Parrot SA
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the 
+      distribution.
+    * Neither the name of Parrot nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED 
+    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+*/
+/**
+ * @file test/ARSAL_Pool_Test.c
+ * @brief Accounting of ARSAL_Pool: allocations, frees, failures and debug errors
+ * @date 10/18/2026
+ *
+ * Usage: ARSAL_Pool_Test
+ *
+ * Exits with 0 when every check passed. The debug errors are expected to be
+ * printed on the way.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <libARSAL/ARSAL_Pool.h>
+#include <libARSAL/ARSAL_Thread.h>
+
+#define TEST_OBJECT_SIZE 64
+#define TEST_OBJECTS 10
+#define TEST_FREED 4
+#define TEST_CROSS_OBJECTS 1000
+#define TEST_MAX_OBJECTS 16
+
+static int failures = 0;
+
+#define CHECK(cond)                                                         \
+    do                                                                      \
+    {                                                                       \
+        if (!(cond))                                                        \
+        {                                                                   \
+            fprintf (stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                     \
+        }                                                                   \
+    } while (0)
+
+typedef struct
+{
+    ARSAL_Pool_t *pool;
+    void **objects;
+    int nbObjects;
+} TestFreeArgs_t;
+
+static ARSAL_Pool_t *testNewPool (size_t maxObjects, int debug)
+{
+    ARSAL_Pool_Config_t config;
+    eARSAL_ERROR error = ARSAL_OK;
+    ARSAL_Pool_t *pool;
+
+    ARSAL_Pool_Config_Init (&config, TEST_OBJECT_SIZE, 0);
+    config.name = "test";
+    config.maxObjects = maxObjects;
+    config.debug = debug;
+    pool = ARSAL_Pool_New (&config, &error);
+    CHECK ((pool != NULL) && (error == ARSAL_OK));
+    return pool;
+}
+
+static void *freeRun (void *arg)
+{
+    TestFreeArgs_t *args = arg;
+    int i;
+
+    for (i = 0; i < args->nbObjects; i++)
+    {
+        ARSAL_Pool_Free (args->pool, args->objects[i]);
+    }
+    ARSAL_Pool_ThreadFlush (args->pool);
+    return NULL;
+}
+
+static void testAccounting (void)
+{
+    ARSAL_Pool_t *pool = testNewPool (0, 1);
+    ARSAL_Pool_Stats_t stats;
+    void *objects[TEST_OBJECTS];
+    int i;
+
+    for (i = 0; i < TEST_OBJECTS; i++)
+    {
+        objects[i] = ARSAL_Pool_Alloc (pool);
+        CHECK (objects[i] != NULL);
+    }
+    for (i = 0; i < TEST_FREED; i++)
+    {
+        ARSAL_Pool_Free (pool, objects[i]);
+    }
+
+    ARSAL_Pool_GetStats (pool, &stats);
+    CHECK (stats.allocs == TEST_OBJECTS);
+    CHECK (stats.frees == TEST_FREED);
+    CHECK (stats.live == TEST_OBJECTS - TEST_FREED);
+    CHECK (stats.failures == 0);
+    CHECK (stats.errors == 0);
+
+    for (i = TEST_FREED; i < TEST_OBJECTS; i++)
+    {
+        ARSAL_Pool_Free (pool, objects[i]);
+    }
+    ARSAL_Pool_GetStats (pool, &stats);
+    CHECK (stats.live == 0);
+    ARSAL_Pool_Delete (&pool);
+    CHECK (pool == NULL);
+}
+
+static void testDebugErrors (void)
+{
+    ARSAL_Pool_t *pool = testNewPool (0, 1);
+    ARSAL_Pool_Stats_t stats;
+    uint8_t *object, *other;
+
+    /* Double free: reported, not counted as a free */
+    object = ARSAL_Pool_Alloc (pool);
+    other = ARSAL_Pool_Alloc (pool);
+    ARSAL_Pool_Free (pool, object);
+    ARSAL_Pool_Free (pool, object);
+    ARSAL_Pool_GetStats (pool, &stats);
+    CHECK (stats.errors == 1);
+    CHECK (stats.frees == 1);
+    CHECK (stats.live == 1);
+
+    /* Pointer inside an object */
+    ARSAL_Pool_Free (pool, other + 1);
+    ARSAL_Pool_GetStats (pool, &stats);
+    CHECK (stats.errors == 2);
+    CHECK (stats.live == 1);
+    ARSAL_Pool_Free (pool, other);
+
+    /* Write after free, seen when the object is handed out again (LIFO cache) */
+    object = ARSAL_Pool_Alloc (pool);
+    ARSAL_Pool_Free (pool, object);
+    object[TEST_OBJECT_SIZE - 1] = 0;
+    CHECK (ARSAL_Pool_Alloc (pool) == object);
+    ARSAL_Pool_GetStats (pool, &stats);
+    CHECK (stats.errors == 3);
+    ARSAL_Pool_Free (pool, object);
+
+    ARSAL_Pool_GetStats (pool, &stats);
+    CHECK (stats.live == 0);
+    ARSAL_Pool_Delete (&pool);
+}
+
+static void testCrossThreadFree (void)
+{
+    ARSAL_Pool_t *pool = testNewPool (0, 1);
+    ARSAL_Pool_Stats_t stats;
+    ARSAL_Thread_t thread;
+    void *objects[TEST_CROSS_OBJECTS];
+    TestFreeArgs_t args = { pool, objects, TEST_CROSS_OBJECTS };
+    int i;
+
+    for (i = 0; i < TEST_CROSS_OBJECTS; i++)
+    {
+        objects[i] = ARSAL_Pool_Alloc (pool);
+        CHECK (objects[i] != NULL);
+    }
+    CHECK (ARSAL_Thread_Create (&thread, freeRun, &args) == 0);
+    ARSAL_Thread_Join (thread, NULL);
+    ARSAL_Thread_Destroy (&thread);
+
+    ARSAL_Pool_GetStats (pool, &stats);
+    CHECK (stats.allocs == TEST_CROSS_OBJECTS);
+    CHECK (stats.frees == TEST_CROSS_OBJECTS);
+    CHECK (stats.live == 0);
+    CHECK (stats.errors == 0);
+    ARSAL_Pool_Delete (&pool);
+}
+
+static void testExhaustion (void)
+{
+    ARSAL_Pool_t *pool = testNewPool (TEST_MAX_OBJECTS, 0);
+    ARSAL_Pool_Stats_t stats;
+    void *objects[TEST_MAX_OBJECTS];
+    int i;
+
+    for (i = 0; i < TEST_MAX_OBJECTS; i++)
+    {
+        objects[i] = ARSAL_Pool_Alloc (pool);
+        CHECK (objects[i] != NULL);
+    }
+    CHECK (ARSAL_Pool_Alloc (pool) == NULL);
+    CHECK (ARSAL_Pool_Alloc (pool) == NULL);
+
+    ARSAL_Pool_GetStats (pool, &stats);
+    CHECK (stats.allocs == TEST_MAX_OBJECTS);
+    CHECK (stats.failures == 2);
+    CHECK (stats.capacity == TEST_MAX_OBJECTS);
+
+    /* A freed object can be allocated again */
+    ARSAL_Pool_Free (pool, objects[0]);
+    objects[0] = ARSAL_Pool_Alloc (pool);
+    CHECK (objects[0] != NULL);
+
+    for (i = 0; i < TEST_MAX_OBJECTS; i++)
+    {
+        ARSAL_Pool_Free (pool, objects[i]);
+    }
+    ARSAL_Pool_GetStats (pool, &stats);
+    CHECK (stats.live == 0);
+    ARSAL_Pool_Delete (&pool);
+}
+
+int main (void)
+{
+    testAccounting ();
+    testDebugErrors ();
+    testCrossThreadFree ();
+    testExhaustion ();
+
+    printf ("ARSAL_Pool_Test: %s\n", (failures == 0) ? "passed" : "FAILED");
+    return (failures == 0) ? 0 : 1;
+}
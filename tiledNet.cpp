@@ -0,0 +1,703 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "tiledNet.h"
+#include "cudaTiles.h"
+#include "cudaMappedMemory.h"
+#include "commandLine.h"
+#include "modelPack.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <functional>
+
+
+#define LOG_TILED "[tiledNet] "
+
+// a tile overlaps its neighbours by a quarter of its size, so a target on a seam is whole in one of them
+#define TILE_OVERLAP 0.25f
+
+// zoomed tiles are this fraction of their parent, overlapping in the middle
+#define ZOOM_SIZE 0.625f
+
+
+// constructor
+tiledNet::tiledNet() : imageNet()
+{
+	mRegionsCPU  = NULL;
+	mRegionsCUDA = NULL;
+	mFrameWidth  = 0;
+	mFrameHeight = 0;
+	mNumNative   = 0;
+	mThreshold   = 0.5f;
+	mOverlap     = 0.5f;
+	mBudget      = TILED_DEFAULT_BUDGET;
+	mIgnoreClass = -1;
+}
+
+
+// destructor
+tiledNet::~tiledNet()
+{
+	if( mRegionsCPU != NULL )
+	{
+		CUDA(cudaFreeHost(mRegionsCPU));
+		mRegionsCPU = NULL;
+	}
+}
+
+
+// Create
+tiledNet* tiledNet::Create( int argc, char** argv )
+{
+	commandLine cmdLine(argc, argv);
+
+	const char* pack     = cmdLine.GetString("pack");
+	const char* prototxt = cmdLine.GetString("prototxt");
+	const char* model    = cmdLine.GetString("model");
+	const char* labels   = cmdLine.GetString("labels");
+	const char* input    = cmdLine.GetString("input_blob");
+	const char* output   = cmdLine.GetString("output_blob");
+
+	if( !pack && (!prototxt || !model || !labels) )
+	{
+		printf(LOG_TILED "tiled inference needs --prototxt, --model and --labels, or --pack\n");
+		return NULL;
+	}
+
+	if( !input )  input  = IMAGENET_DEFAULT_INPUT;
+	if( !output ) output = IMAGENET_DEFAULT_OUTPUT;
+
+	const int budget = cmdLine.GetInt("tiles");
+	int batchSize    = cmdLine.GetInt("batch_size");
+
+	if( batchSize < 1 )
+		batchSize = budget > 0 ? budget : TILED_DEFAULT_BUDGET;
+
+	// a pack comes with the batch size it was built for
+	tiledNet* net = pack ? CreateFromPack(pack) : Create(prototxt, model, NULL, labels, input, output, batchSize);
+
+	if( net != NULL && budget > 0 )
+		net->SetTileBudget(budget);
+
+	// a classifier has no "nothing here" output unless it was trained with one
+	const char* ignore = cmdLine.GetString("ignore_class");
+
+	if( net != NULL && ignore != NULL )
+	{
+		for( uint32_t n=0; n < net->GetNumClasses(); n++ )
+		{
+			if( strcmp(net->GetClassDesc(n), ignore) == 0 )
+				net->SetIgnoreClass(n);
+		}
+	}
+
+	return net;
+}
+
+
+// Create
+tiledNet* tiledNet::Create( const char* prototxt, const char* model, const char* mean, const char* labels,
+					   const char* input, const char* output, uint32_t maxBatchSize )
+{
+	tiledNet* net = new tiledNet();
+
+	if( !net )
+		return NULL;
+
+	if( !net->init(prototxt, model, mean, labels, input, output, maxBatchSize) )
+	{
+		printf(LOG_TILED "failed to load %s\n", model);
+		delete net;
+		return NULL;
+	}
+
+	if( !net->initRegions() )
+	{
+		delete net;
+		return NULL;
+	}
+
+	printf(LOG_TILED "%s loaded, batches of %u tiles of %ux%u\n", model, maxBatchSize, net->mWidth, net->mHeight);
+	return net;
+}
+
+
+// CreateFromPack
+tiledNet* tiledNet::CreateFromPack( const char* path )
+{
+	tiledNet* net = new tiledNet();
+
+	if( !net )
+		return NULL;
+
+	if( !net->initPack(path) || !net->initRegions() )
+	{
+		printf(LOG_TILED "failed to load %s\n", path);
+		delete net;
+		return NULL;
+	}
+
+	printf(LOG_TILED "%s loaded, batches of %u tiles of %ux%u\n", path, net->mMaxBatchSize, net->mWidth, net->mHeight);
+	return net;
+}
+
+
+// initRegions
+bool tiledNet::initRegions()
+{
+	// the regions of a batch are read by the crop kernel straight from host memory
+	if( !cudaAllocMapped((void**)&mRegionsCPU, (void**)&mRegionsCUDA, mMaxBatchSize * sizeof(int4)) )
+	{
+		printf(LOG_TILED "failed to allocate %u regions\n", mMaxBatchSize);
+		return false;
+	}
+
+	SetTileBudget(mMaxBatchSize);
+	return true;
+}
+
+
+// initPack
+bool tiledNet::initPack( const char* path )
+{
+	modelPack* pack = modelPack::Open(path);
+
+	if( !pack )
+		return false;
+
+	std::vector<std::vector<std::string> > graph;
+	std::vector<std::vector<std::string> > meta;
+	std::vector<std::vector<std::string> > labels;
+
+	size_t engineSize = 0;
+	const void* engine = pack->GetSection(modelPack::ENGINE, &engineSize);
+
+	if( !engine || !pack->GetLines(modelPack::GRAPH, graph) )
+	{
+		printf(LOG_TILED "%s has no engine or no graph\n", path);
+		delete pack;
+		return false;
+	}
+
+	pack->GetLines(modelPack::META, meta);
+	pack->GetLines(modelPack::LABELS, labels);
+
+	/*
+	 * an engine only runs on the TensorRT version and GPU it was built for
+	 */
+	char version[32];
+	sprintf(version, "%i.%i.%i", NV_TENSORRT_MAJOR, NV_TENSORRT_MINOR, NV_TENSORRT_PATCH);
+
+	int device = 0;
+	cudaDeviceProp props;
+
+	if( CUDA_FAILED(cudaGetDevice(&device)) || CUDA_FAILED(cudaGetDeviceProperties(&props, device)) )
+	{
+		delete pack;
+		return false;
+	}
+
+	char capability[16];
+	sprintf(capability, "%i.%i", props.major, props.minor);
+
+	for( size_t n=0; n < meta.size(); n++ )
+	{
+		const std::vector<std::string>& line = meta[n];
+
+		if( line.size() >= 2 && ((line[0] == "tensorrt" && line[1] != version) || (line[0] == "device" && line[1] != capability)) )
+		{
+			printf(LOG_TILED "%s was built for %s %s, this is TensorRT %s on compute %s, rebuild it with model-pack\n",
+				  path, line[0].c_str(), line[1].c_str(), version, capability);
+			delete pack;
+			return false;
+		}
+	}
+
+	/*
+	 * bindings
+	 */
+	std::string inputName, outputName;
+	uint32_t batch = 0, inputDims[3] = { 0, 0, 0 }, outputDims[3] = { 0, 0, 0 };
+
+	for( size_t n=0; n < graph.size(); n++ )
+	{
+		const std::vector<std::string>& line = graph[n];
+
+		if( line[0] == "batch" && line.size() == 2 )
+			batch = atoi(line[1].c_str());
+		else if( (line[0] == "input" || line[0] == "output") && line.size() == 5 )
+		{
+			uint32_t* dims = (line[0] == "input") ? inputDims : outputDims;
+
+			(line[0] == "input" ? inputName : outputName) = line[1];
+
+			for( int d=0; d < 3; d++ )
+				dims[d] = atoi(line[2+d].c_str());
+		}
+	}
+
+	const uint32_t numClasses = outputDims[0] * outputDims[1] * outputDims[2];
+
+	if( batch == 0 || inputName.empty() || outputName.empty() || inputDims[0] != 3 || numClasses == 0 )
+	{
+		printf(LOG_TILED "%s has an invalid graph\n", path);
+		delete pack;
+		return false;
+	}
+
+	/*
+	 * deserialize from the mapping, TensorRT keeps its own copy of the weights
+	 */
+	mInfer  = nvinfer1::createInferRuntime(gLogger);
+	mEngine = mInfer ? mInfer->deserializeCudaEngine(engine, engineSize, NULL) : NULL;
+
+	delete pack;
+
+	if( !mEngine || !(mContext = mEngine->createExecutionContext()) )
+	{
+		printf(LOG_TILED "failed to deserialize the engine of %s\n", path);
+		return false;
+	}
+
+	mModelPath     = path;
+	mInputBlobName = inputName;
+	mMaxBatchSize  = batch;
+	mWidth         = inputDims[2];
+	mHeight        = inputDims[1];
+	mInputSize     = batch * inputDims[0] * inputDims[1] * inputDims[2] * sizeof(float);
+
+	if( !cudaAllocMapped((void**)&mInputCPU, (void**)&mInputCUDA, mInputSize) )
+		return false;
+
+	outputLayer layer;
+	layer.name = outputName;
+	layer.dims = nvinfer1::Dims3(outputDims[0], outputDims[1], outputDims[2]);
+	layer.size = batch * numClasses * sizeof(float);
+
+	if( !cudaAllocMapped((void**)&layer.CPU, (void**)&layer.CUDA, layer.size) )
+		return false;
+
+	mOutputs.push_back(layer);
+
+	/*
+	 * class descriptions, numbered when the pack has fewer than the network
+	 */
+	mOutputClasses = numClasses;
+
+	for( uint32_t n=0; n < numClasses; n++ )
+	{
+		std::string desc;
+
+		if( n < labels.size() )
+		{
+			for( size_t w=0; w < labels[n].size(); w++ )
+				desc += (w > 0 ? " " : "") + labels[n][w];
+		}
+		else
+			desc = std::to_string(n);
+
+		mClassSynset.push_back(desc);
+		mClassDesc.push_back(desc);
+	}
+
+	return true;
+}
+
+
+// same mean as imageNet::Classify()
+static inline float3 imageNetMean()
+{
+	return make_float3(104.0069879317889f, 116.6687676607272f, 122.6789143406786f);
+}
+
+
+// ClassifyRegions
+bool tiledNet::ClassifyRegions( float* rgba, uint32_t width, uint32_t height, const Region* regions, Result* results, uint32_t count )
+{
+	if( !rgba || !regions || !results )
+		return false;
+
+	for( uint32_t first=0; first < count; first += mMaxBatchSize )
+	{
+		const uint32_t batch = std::min(mMaxBatchSize, count - first);
+
+		for( uint32_t n=0; n < batch; n++ )
+			mRegionsCPU[n] = make_int4(regions[first+n].x, regions[first+n].y, regions[first+n].width, regions[first+n].height);
+
+		// same preprocessing as imageNet::Classify(), one input per region
+		if( CUDA_FAILED(cudaPreTilesMean((float4*)rgba, width, height, mRegionsCUDA, batch, mInputCUDA, mWidth, mHeight, imageNetMean())) )
+		{
+			printf(LOG_TILED "cudaPreTilesMean failed\n");
+			return false;
+		}
+
+		if( !executeBatch(batch, results + first) )
+			return false;
+	}
+
+	return true;
+}
+
+
+// ClassifyFrames
+bool tiledNet::ClassifyFrames( float* const* frames, const uint32_t* widths, const uint32_t* heights, Result* results, uint32_t count )
+{
+	if( !frames || !widths || !heights || !results )
+		return false;
+
+	const size_t inputSize = 3 * mWidth * mHeight;
+
+	for( uint32_t first=0; first < count; first += mMaxBatchSize )
+	{
+		const uint32_t batch = std::min(mMaxBatchSize, count - first);
+
+		// one whole frame region per input of the batch
+		for( uint32_t n=0; n < batch; n++ )
+		{
+			mRegionsCPU[n] = make_int4(0, 0, widths[first+n], heights[first+n]);
+
+			if( CUDA_FAILED(cudaPreTilesMean((float4*)frames[first+n], widths[first+n], heights[first+n], mRegionsCUDA + n, 1,
+									   mInputCUDA + n * inputSize, mWidth, mHeight, imageNetMean())) )
+			{
+				printf(LOG_TILED "cudaPreTilesMean failed\n");
+				return false;
+			}
+		}
+
+		if( !executeBatch(batch, results + first) )
+			return false;
+	}
+
+	return true;
+}
+
+
+// executeBatch
+bool tiledNet::executeBatch( uint32_t batch, Result* results )
+{
+	void* inferenceBuffers[] = { mInputCUDA, mOutputs[0].CUDA };
+
+	if( !mContext->execute(batch, inferenceBuffers) )
+	{
+		printf(LOG_TILED "failed to execute TensorRT context\n");
+		return false;
+	}
+
+	// the output is mapped memory, the batch is contiguous
+	for( uint32_t n=0; n < batch; n++ )
+	{
+		const float* prob = mOutputs[0].CPU + n * mOutputClasses;
+		Result& result    = results[n];
+
+		result.classID    = -1;
+		result.confidence = 0.0f;
+
+		for( uint32_t c=0; c < mOutputClasses; c++ )
+		{
+			if( prob[c] > result.confidence || result.classID < 0 )
+			{
+				result.classID    = c;
+				result.confidence = prob[c];
+			}
+		}
+	}
+
+	return true;
+}
+
+
+// evenly spread tiles of size tile over len, overlapping by at least TILE_OVERLAP
+static void spreadTiles( int len, int tile, std::vector<int>& positions )
+{
+	positions.clear();
+
+	if( len <= tile )
+	{
+		positions.push_back(0);
+		return;
+	}
+
+	const float stride = tile * (1.0f - TILE_OVERLAP);
+	const int count    = (int)ceilf((len - tile) / stride) + 1;
+
+	for( int n=0; n < count; n++ )
+		positions.push_back(n * (len - tile) / (count - 1));
+}
+
+
+// initTiles
+void tiledNet::initTiles( uint32_t width, uint32_t height )
+{
+	mTiles.clear();
+	mFrameWidth  = width;
+	mFrameHeight = height;
+
+	Tile tile;
+	tile.parent  = -1;
+	tile.classID = -1;
+	tile.score   = 0.0f;
+	tile.age     = 0;
+
+	// level 0: the whole frame, what imageNet::Classify() sees
+	tile.level  = 0;
+	tile.region = { 0, 0, (int)width, (int)height };
+	mTiles.push_back(tile);
+
+	// level 1: network sized tiles, one frame pixel per network pixel
+	const int tileWidth  = std::min(mWidth, width);
+	const int tileHeight = std::min(mHeight, height);
+
+	std::vector<int> xs, ys;
+	spreadTiles(width, tileWidth, xs);
+	spreadTiles(height, tileHeight, ys);
+
+	if( xs.size() * ys.size() > 1 )
+	{
+		for( size_t j=0; j < ys.size(); j++ )
+		{
+			for( size_t i=0; i < xs.size(); i++ )
+			{
+				tile.level  = 1;
+				tile.parent = 0;
+				tile.region = { xs[i], ys[j], tileWidth, tileHeight };
+				mTiles.push_back(tile);
+			}
+		}
+	}
+
+	mNumNative = mTiles.size() - 1;
+
+	// level 2: 2x2 zoomed tiles inside each native tile
+	const int zoomWidth  = (int)(tileWidth * ZOOM_SIZE);
+	const int zoomHeight = (int)(tileHeight * ZOOM_SIZE);
+
+	for( uint32_t p=1; p <= mNumNative; p++ )
+	{
+		const Region parent = mTiles[p].region;
+
+		for( int n=0; n < 4; n++ )
+		{
+			tile.level  = 2;
+			tile.parent = p;
+			tile.region = { parent.x + (n % 2) * (parent.width - zoomWidth),
+						 parent.y + (n / 2) * (parent.height - zoomHeight),
+						 zoomWidth, zoomHeight };
+			mTiles.push_back(tile);
+		}
+	}
+
+	printf(LOG_TILED "%ux%u frame: %u native tiles, %zu zoomed tiles\n", width, height, mNumNative, mTiles.size() - mNumNative - 1);
+}
+
+
+// Detect
+int tiledNet::Detect( float* rgba, uint32_t width, uint32_t height, Detection* detections, uint32_t* numDetections, float* confidence )
+{
+	if( !rgba || !detections || !numDetections )
+		return -1;
+
+	if( width != mFrameWidth || height != mFrameHeight )
+		initTiles(width, height);
+
+	/*
+	 * schedule: the whole frame, then up to half of the remaining budget for
+	 * the tiles which scored high last time (tracking), then the rest by
+	 * priority (sweep). Sweep priority is the last score plus the age, scaled
+	 * so an idle tile waits about as long as a full sweep of the native tiles.
+	 */
+	const uint32_t slots = mBudget - 1;
+	const float revisit  = std::max(1.0f, (float)mNumNative / slots);
+
+	std::vector<std::pair<float, uint32_t> > hot;
+	std::vector<std::pair<float, uint32_t> > sweep;
+
+	for( uint32_t n=1; n < mTiles.size(); n++ )
+	{
+		const Tile& tile = mTiles[n];
+
+		// coarse to fine: zoom only into native tiles which saw something
+		if( tile.level == 2 && mTiles[tile.parent].score < mThreshold * 0.5f )
+			continue;
+
+		if( tile.score >= mThreshold * 0.5f )
+			hot.push_back(std::make_pair(tile.score, n));
+		else
+			sweep.push_back(std::make_pair(tile.score + tile.age / revisit, n));
+	}
+
+	const uint32_t tracked = std::min((uint32_t)hot.size(), std::max(1U, slots / 2));
+
+	std::partial_sort(hot.begin(), hot.begin() + tracked, hot.end(), std::greater<std::pair<float, uint32_t> >());
+
+	// hot tiles which did not make it compete in the sweep
+	for( size_t n=tracked; n < hot.size(); n++ )
+		sweep.push_back(std::make_pair(hot[n].first + mTiles[hot[n].second].age / revisit, hot[n].second));
+
+	const uint32_t swept = std::min((uint32_t)sweep.size(), slots - tracked);
+
+	std::partial_sort(sweep.begin(), sweep.begin() + swept, sweep.end(), std::greater<std::pair<float, uint32_t> >());
+
+	mSchedule.clear();
+	mSchedule.push_back(0);
+
+	for( uint32_t n=0; n < tracked; n++ )
+		mSchedule.push_back(hot[n].second);
+
+	for( uint32_t n=0; n < swept; n++ )
+		mSchedule.push_back(sweep[n].second);
+
+	mScheduleRegions.resize(mSchedule.size());
+	mScheduleResults.resize(mSchedule.size());
+
+	for( size_t n=0; n < mSchedule.size(); n++ )
+		mScheduleRegions[n] = mTiles[mSchedule[n]].region;
+
+	if( !ClassifyRegions(rgba, width, height, &mScheduleRegions[0], &mScheduleResults[0], mSchedule.size()) )
+		return -1;
+
+	// update the tiles, collect the detections
+	for( size_t n=0; n < mTiles.size(); n++ )
+		mTiles[n].age++;
+
+	mDetections.clear();
+
+	for( size_t n=0; n < mSchedule.size(); n++ )
+	{
+		Tile& tile          = mTiles[mSchedule[n]];
+		const Result result = mScheduleResults[n];
+
+		tile.age     = 0;
+		tile.classID = result.classID;
+		tile.score   = (result.classID != mIgnoreClass) ? result.confidence : 0.0f;
+
+		if( tile.level > 0 && tile.score >= mThreshold )
+		{
+			Detection detection;
+			detection.box        = tile.region;
+			detection.classID    = result.classID;
+			detection.confidence = result.confidence;
+			mDetections.push_back(detection);
+		}
+	}
+
+	// a tile detection is better evidence than the shrunk whole frame
+	return mergeDetections(detections, numDetections, confidence, mScheduleResults[0]);
+}
+
+
+// DetectRegions
+int tiledNet::DetectRegions( float* rgba, uint32_t width, uint32_t height, const Region* regions, uint32_t count,
+					    Detection* detections, uint32_t* numDetections, float* confidence )
+{
+	if( !rgba || !detections || !numDetections )
+		return -1;
+
+	mDetections.clear();
+
+	if( count > 0 )
+	{
+		mScheduleResults.resize(count);
+
+		if( !ClassifyRegions(rgba, width, height, regions, &mScheduleResults[0], count) )
+			return -1;
+
+		for( uint32_t n=0; n < count; n++ )
+		{
+			const Result result = mScheduleResults[n];
+
+			if( result.classID == mIgnoreClass || result.confidence < mThreshold )
+				continue;
+
+			Detection detection;
+			detection.box        = regions[n];
+			detection.classID    = result.classID;
+			detection.confidence = result.confidence;
+			mDetections.push_back(detection);
+		}
+	}
+
+	return mergeDetections(detections, numDetections, confidence, Result{ -1, 0.0f });
+}
+
+
+// mergeDetections
+int tiledNet::mergeDetections( Detection* detections, uint32_t* numDetections, float* confidence, const Result& fallback )
+{
+	const uint32_t kept = mDetections.empty() ? 0 : NMS(&mDetections[0], mDetections.size(), mOverlap);
+	const uint32_t count = std::min(kept, *numDetections);
+
+	for( uint32_t n=0; n < count; n++ )
+		detections[n] = mDetections[n];
+
+	*numDetections = count;
+
+	const Result best = (count > 0) ? Result{ detections[0].classID, detections[0].confidence } : fallback;
+
+	if( confidence != NULL )
+		*confidence = best.confidence;
+
+	return best.classID;
+}
+
+
+// overlap of two regions, over the smaller one
+static float overlapMin( const tiledNet::Region& a, const tiledNet::Region& b )
+{
+	const int x0 = std::max(a.x, b.x);
+	const int y0 = std::max(a.y, b.y);
+	const int x1 = std::min(a.x + a.width, b.x + b.width);
+	const int y1 = std::min(a.y + a.height, b.y + b.height);
+
+	if( x1 <= x0 || y1 <= y0 )
+		return 0.0f;
+
+	const float inter = (float)(x1 - x0) * (y1 - y0);
+	const float area  = (float)std::min(a.width * a.height, b.width * b.height);
+
+	return inter / area;
+}
+
+
+// NMS
+uint32_t tiledNet::NMS( Detection* detections, uint32_t count, float overlap )
+{
+	std::sort(detections, detections + count, [](const Detection& a, const Detection& b) { return a.confidence > b.confidence; });
+
+	uint32_t kept = 0;
+
+	for( uint32_t n=0; n < count; n++ )
+	{
+		bool suppressed = false;
+
+		for( uint32_t k=0; k < kept && !suppressed; k++ )
+			suppressed = (detections[k].classID == detections[n].classID && overlapMin(detections[k].box, detections[n].box) > overlap);
+
+		if( !suppressed )
+			detections[kept++] = detections[n];
+	}
+
+	return kept;
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2018 Christopher Ohara
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __TILED_NET_H__
+#define __TILED_NET_H__
+
+
+#include "imageNet.h"
+
+#include <vector>
+
+
+/**
+ * Default number of tiles classified per frame
+ */
+#define TILED_DEFAULT_BUDGET 8
+
+
+/**
+ * Image recognition on full resolution tiles of the frame.
+ *
+ * imageNet::Classify() shrinks the whole frame to the network input, so a
+ * distant target ends up a couple of pixels wide. tiledNet cuts the frame
+ * into overlapping tiles of the network input size, classifies them as
+ * one batch, and merges the tiles that recognized something with
+ * non-maximum suppression.
+ *
+ * Every tile does not run every frame: a coarse-to-fine scheduler spends
+ * the tile budget on the tiles that scored high last time, on half size
+ * (zoomed) tiles inside them, and on the tiles not seen for the longest.
+ */
+class tiledNet : public imageNet
+{
+public:
+	/**
+	 * Region of the frame, in pixels
+	 */
+	struct Region
+	{
+		int x;
+		int y;
+		int width;
+		int height;
+	};
+
+	/**
+	 * Classification of one region
+	 */
+	struct Result
+	{
+		int   classID;
+		float confidence;
+	};
+
+	/**
+	 * Region where a class was recognized
+	 */
+	struct Detection
+	{
+		Region box;
+		int    classID;
+		float  confidence;
+	};
+
+	/**
+	 * Load the network given with --prototxt, --model and --labels, or --pack.
+	 * --batch_size sets the number of tiles per network pass, --tiles the
+	 * number of tiles per frame, --ignore_class the label of a background
+	 * class which never makes a detection.
+	 */
+	static tiledNet* Create( int argc, char** argv );
+
+	/**
+	 * Load a network, see imageNet::Create()
+	 */
+	static tiledNet* Create( const char* prototxt_path, const char* model_path, const char* mean_binary,
+						const char* class_labels, const char* input=IMAGENET_DEFAULT_INPUT,
+						const char* output=IMAGENET_DEFAULT_OUTPUT, uint32_t maxBatchSize=TILED_DEFAULT_BUDGET );
+
+	/**
+	 * Load a network from a model pack made by model-pack: the engine is
+	 * deserialized straight from the mapped file, nothing is parsed or built.
+	 */
+	static tiledNet* CreateFromPack( const char* path );
+
+	/**
+	 * Destroy
+	 */
+	virtual ~tiledNet();
+
+	/**
+	 * Classify regions of an RGBA image, in batches of up to GetMaxBatchSize().
+	 * @param rgba float4 RGBA image in device memory
+	 */
+	bool ClassifyRegions( float* rgba, uint32_t width, uint32_t height, const Region* regions, Result* results, uint32_t count );
+
+	/**
+	 * Classify whole frames of different sources as one batch (or as few
+	 * batches of up to GetMaxBatchSize() as possible).
+	 * @param frames count float4 RGBA images in device memory
+	 */
+	bool ClassifyFrames( float* const* frames, const uint32_t* widths, const uint32_t* heights, Result* results, uint32_t count );
+
+	/**
+	 * Classify the whole frame and the tiles scheduled for this frame.
+	 * @param detections array of *numDetections entries, filled with the merged tile detections, best first
+	 * @param numDetections in: size of detections, out: number of detections
+	 * @param confidence confidence of the returned class
+	 * @returns the class of the best detection, or of the whole frame when no tile
+	 *          recognized anything, -1 on error
+	 */
+	int Detect( float* rgba, uint32_t width, uint32_t height, Detection* detections, uint32_t* numDetections, float* confidence=NULL );
+
+	/**
+	 * Classify regions proposed by another stage (see skyProposals), instead
+	 * of the scheduled tiles. Every region above the threshold is a detection.
+	 * @returns the class of the best detection, -1 when nothing was recognized or on error
+	 */
+	int DetectRegions( float* rgba, uint32_t width, uint32_t height, const Region* regions, uint32_t count,
+				    Detection* detections, uint32_t* numDetections, float* confidence=NULL );
+
+	/**
+	 * Non-maximum suppression, in place. Overlap is the intersection over the
+	 * smaller area, since tiles of different sizes nest inside each other.
+	 * @returns the number of detections kept, sorted by decreasing confidence
+	 */
+	static uint32_t NMS( Detection* detections, uint32_t count, float overlap );
+
+	/**
+	 * Minimum confidence of a tile detection (default 0.5)
+	 */
+	inline void SetThreshold( float threshold )		{ mThreshold = threshold; }
+
+	/**
+	 * Overlap above which NMS merges two detections (default 0.5)
+	 */
+	inline void SetOverlap( float overlap )			{ mOverlap = overlap; }
+
+	/**
+	 * Number of tiles classified per frame, the whole frame included
+	 */
+	inline void SetTileBudget( uint32_t budget )		{ mBudget = budget < 2 ? 2 : budget; }
+	inline uint32_t GetTileBudget() const			{ return mBudget; }
+
+	/**
+	 * Class which never makes a detection, such as a sky/background class (default none)
+	 */
+	inline void SetIgnoreClass( int classID )		{ mIgnoreClass = classID; }
+
+	/**
+	 * Number of tiles of the current frame geometry, all levels
+	 */
+	inline uint32_t GetNumTiles() const			{ return mTiles.size(); }
+
+protected:
+	tiledNet();
+
+	struct Tile
+	{
+		Region   region;
+		int      level;		// 0 whole frame, 1 native resolution, 2 zoomed
+		int      parent;
+		int      classID;
+		float    score;
+		uint32_t age;		// frames since it was last classified
+	};
+
+	bool initPack( const char* path );
+	bool initRegions();
+	bool executeBatch( uint32_t batch, Result* results );
+	void initTiles( uint32_t width, uint32_t height );
+	int  mergeDetections( Detection* detections, uint32_t* numDetections, float* confidence, const Result& fallback );
+
+	int4* mRegionsCPU;
+	int4* mRegionsCUDA;
+
+	std::vector<Tile>      mTiles;
+	std::vector<uint32_t>  mSchedule;
+	std::vector<Region>    mScheduleRegions;
+	std::vector<Result>    mScheduleResults;
+	std::vector<Detection> mDetections;
+
+	uint32_t mFrameWidth;
+	uint32_t mFrameHeight;
+	uint32_t mNumNative;
+
+	float    mThreshold;
+	float    mOverlap;
+	uint32_t mBudget;
+	int      mIgnoreClass;
+};
+
+
+#endif